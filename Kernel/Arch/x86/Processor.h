@@ -103,7 +103,8 @@ struct DeferredCallEntry {
 class Processor;
 // Note: We only support 8 processors at most at the moment,
 // so allocate 8 slots of inline capacity in the container.
-using ProcessorContainer = Array<Processor*, 8>;
+constexpr size_t max_processor_count = 8;
+using ProcessorContainer = Array<Processor*, max_processor_count>;
 
 class Processor {
     friend class ProcessorInfo;
@@ -76,9 +76,9 @@ void AsyncDeviceRequest::add_sub_request(NonnullRefPtr<AsyncDeviceRequest> sub_r
 
     ScopedSpinLock lock(m_lock);
     VERIFY(!is_completed_result(m_result));
+    // NOTE: Sub-requests are started by the request queue of their own device (which may well have
+    //       done so already), as that's what limits how many requests a device has in flight.
     m_sub_requests_pending.append(sub_request);
-    if (m_result == Started)
-        sub_request->do_start(move(lock));
 }
 
 void AsyncDeviceRequest::sub_request_finished(AsyncDeviceRequest& sub_request)
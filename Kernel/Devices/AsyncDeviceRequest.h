@@ -60,6 +60,7 @@ public:
     void add_sub_request(NonnullRefPtr<AsyncDeviceRequest>);
 
     [[nodiscard]] RequestWaitResult wait(Time* = nullptr);
+    [[nodiscard]] bool is_completed() const { return is_completed_result(get_request_result()); }
 
     void do_start(ScopedSpinLock<SpinLock<u8>>&& requests_lock)
     {
@@ -64,11 +64,25 @@ String Device::absolute_path(const FileDescription&) const
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, const AsyncDeviceRequest& completed_request)
 {
     ScopedSpinLock lock(m_requests_lock);
-    VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
-    if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
+    VERIFY(m_started_requests_count > 0);
+    auto it = m_requests.begin();
+    while (it != m_requests.end() && it->ptr() != &completed_request)
+        ++it;
+    VERIFY(it != m_requests.end());
+    m_requests.remove(it);
+    --m_started_requests_count;
+
+    // Requests are started in order, so the ones that are still in flight are at the front of the queue.
+    AsyncDeviceRequest* next_request = nullptr;
+    size_t index = 0;
+    for (auto& request : m_requests) {
+        if (index++ == m_started_requests_count) {
+            next_request = request.ptr();
+            break;
+        }
+    }
+    if (next_request) {
+        ++m_started_requests_count;
         next_request->do_start(move(lock));
     }
 
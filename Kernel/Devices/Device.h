@@ -48,15 +48,20 @@ public:
 
     void process_next_queued_request(Badge<AsyncDeviceRequest>, const AsyncDeviceRequest&);
 
+    // Requests are started in the order they were made, but devices that can have more than one
+    // of them in flight may complete them in any order.
+    virtual size_t max_concurrent_requests() const { return 1; }
+
     template<typename AsyncRequestType, typename... Args>
     NonnullRefPtr<AsyncRequestType> make_request(Args&&... args)
     {
         auto request = adopt_ref(*new AsyncRequestType(*this, forward<Args>(args)...));
         ScopedSpinLock lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
         m_requests.append(request);
-        if (was_empty)
+        if (m_started_requests_count < max_concurrent_requests()) {
+            ++m_started_requests_count;
             request->do_start(move(lock));
+        }
         return request;
     }
 
@@ -75,6 +80,7 @@ private:
 
     SpinLock<u8> m_requests_lock;
     DoublyLinkedList<RefPtr<AsyncDeviceRequest>> m_requests;
+    size_t m_started_requests_count { 0 };
 };
 
 }
@@ -5,103 +5,378 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
+#include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/Process.h>
+#include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
 
 struct CacheEntry {
+    // Links the entry into one of the LRU lists (or the free list when unused).
     IntrusiveListNode<CacheEntry> list_node;
+    // Links the entry into the dirty list, oldest first.
+    IntrusiveListNode<CacheEntry> dirty_list_node;
     BlockBasedFS::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_in_use { false };
+    // Entries that have been referenced at least twice live in the protected list.
+    bool is_protected { false };
+    // Entries that were brought in by read-ahead don't count the first access as a re-reference.
+    bool is_read_ahead { false };
+    // Set while a read-ahead request is asynchronously filling in the data.
+    RefPtr<AsyncBlockDeviceRequest> pending_read;
+
+    bool is_dirty() const { return dirty_list_node.is_in_list(); }
+    bool has_read_in_flight() const { return pending_read && !pending_read->is_completed(); }
 };
 
+// The cache grows and shrinks in segments, each with its own block data buffer.
+class DiskCacheSegment {
+    AK_MAKE_NONCOPYABLE(DiskCacheSegment);
+    AK_MAKE_NONMOVABLE(DiskCacheSegment);
+
+public:
+    static constexpr size_t entry_count = 256;
+
+    static OwnPtr<DiskCacheSegment> try_create(size_t block_size)
+    {
+        auto data = KBuffer::try_create_with_size(entry_count * block_size, Region::Access::Read | Region::Access::Write, "DiskCache");
+        if (!data)
+            return {};
+        auto segment = adopt_own_if_nonnull(new (nothrow) DiskCacheSegment(data.release_nonnull()));
+        if (!segment)
+            return {};
+        for (size_t i = 0; i < entry_count; ++i)
+            segment->entries[i].data = segment->m_data->data() + i * block_size;
+        return segment;
+    }
+
+    CacheEntry entries[entry_count];
+
+private:
+    explicit DiskCacheSegment(NonnullOwnPtr<KBuffer>&& data)
+        : m_data(move(data))
+    {
+    }
+
+    NonnullOwnPtr<KBuffer> m_data;
+};
+
+// All disk caches together may use up to an eighth of physical memory, however many file systems are mounted.
+// Every cache gets its first segment regardless, so it can always work.
+static Atomic<size_t> s_total_disk_cache_bytes { 0 };
+
+static size_t disk_cache_memory_budget()
+{
+    return (size_t)MM.user_physical_pages() * PAGE_SIZE / 8;
+}
+
+// A block cache using a segmented LRU (an approximation of LRU-2): Blocks enter the
+// probationary list, and only move to the protected list once they are referenced a
+// second time. Victims are taken from the probationary list first, so a single large
+// scan through the disk can't push the frequently used blocks out of the cache.
 class DiskCache {
+    AK_MAKE_NONCOPYABLE(DiskCache);
+    AK_MAKE_NONMOVABLE(DiskCache);
+
 public:
     explicit DiskCache(BlockBasedFS& fs)
         : m_fs(fs)
-        , m_cached_block_data(KBuffer::create_with_size(m_entry_count * m_fs.block_size()))
-        , m_entries(KBuffer::create_with_size(m_entry_count * sizeof(CacheEntry)))
+        , m_maximum_capacity(compute_maximum_capacity(fs.block_size()))
+        , m_capacity(m_maximum_capacity)
     {
-        for (size_t i = 0; i < m_entry_count; ++i) {
-            entries()[i].data = m_cached_block_data.data() + i * m_fs.block_size();
-            m_clean_list.append(entries()[i]);
-        }
+        // We need at least one segment to work with at all times.
+        auto did_grow = try_grow();
+        VERIFY(did_grow);
     }
 
-    ~DiskCache() = default;
-
-    bool is_dirty() const { return m_dirty; }
-    void set_dirty(bool b) { m_dirty = b; }
-
-    void mark_all_clean()
+    ~DiskCache()
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
-        m_dirty = false;
+        // Requests still in flight are writing into our segments, so let them finish.
+        for (auto& segment : m_segments) {
+            for (auto& entry : segment.entries) {
+                while (entry.has_read_in_flight())
+                    (void)entry.pending_read->wait();
+            }
+        }
+        // The entries live in the segments, which go away before the lists do, so unlink them all first.
+        m_probation_list.clear();
+        m_protected_list.clear();
+        m_free_list.clear();
+        m_dirty_list.clear();
+        s_total_disk_cache_bytes.fetch_sub(m_segments.size() * segment_size());
     }
 
+    bool is_dirty() const { return !m_dirty_list.is_empty(); }
+
     void mark_dirty(CacheEntry& entry)
     {
-        m_dirty_list.prepend(entry);
-        m_dirty = true;
+        VERIFY(entry.is_in_use);
+        VERIFY(!entry.has_read_in_flight());
+        if (entry.is_dirty())
+            return;
+        m_dirty_list.append(entry);
+        ++m_dirty_count;
     }
 
     void mark_clean(CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        if (!entry.is_dirty())
+            return;
+        m_dirty_list.remove(entry);
+        --m_dirty_count;
     }
 
-    CacheEntry& get(BlockBasedFS::BlockIndex block_index) const
+    CacheEntry* find(BlockBasedFS::BlockIndex block_index) const
     {
-        if (auto it = m_hash.find(block_index); it != m_hash.end()) {
-            auto& entry = const_cast<CacheEntry&>(*it->value);
-            VERIFY(entry.block_index == block_index);
-            return entry;
+        if (auto it = m_hash.find(block_index); it != m_hash.end())
+            return it->value;
+        return nullptr;
+    }
+
+    CacheEntry& get(BlockBasedFS::BlockIndex block_index, bool for_read_ahead = false)
+    {
+        if (auto* entry = find(block_index)) {
+            VERIFY(entry->block_index == block_index);
+            if (!for_read_ahead) {
+                ++m_statistics.hit_count;
+                did_reference(*entry);
+            }
+            return *entry;
         }
 
-        if (m_clean_list.is_empty()) {
+        if (!for_read_ahead)
+            ++m_statistics.miss_count;
+
+        auto* new_entry = m_free_list.first();
+        if (!new_entry && m_entry_count < m_capacity && try_grow())
+            new_entry = m_free_list.first();
+        if (!new_entry)
+            new_entry = find_victim();
+        if (!new_entry) {
             // Not a single clean entry! Flush writes and try again.
             // NOTE: We want to make sure we only call FileBackedFS flush here,
             //       not some FileBackedFS subclass flush!
             m_fs.flush_writes_impl();
-            return get(block_index);
+            new_entry = find_victim();
+        }
+        if (!new_entry) {
+            // Everything that's clean is being filled in by read-ahead, this should be exceedingly rare.
+            new_entry = m_probation_list.last() ? m_probation_list.last() : m_protected_list.last();
+            VERIFY(new_entry);
+            while (new_entry->has_read_in_flight())
+                (void)new_entry->pending_read->wait();
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
+        if (new_entry->is_in_use) {
+            evict(*new_entry);
+            ++m_statistics.eviction_count;
+        }
 
-        m_hash.remove(new_entry.block_index);
-        m_hash.set(block_index, &new_entry);
+        new_entry->block_index = block_index;
+        new_entry->has_data = false;
+        new_entry->is_in_use = true;
+        new_entry->is_read_ahead = for_read_ahead;
+        new_entry->pending_read = nullptr;
+        m_hash.set(block_index, new_entry);
+        m_probation_list.prepend(*new_entry);
 
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
+        return *new_entry;
+    }
 
-        return new_entry;
+    // Waits for a read-ahead request that is filling in this entry to complete.
+    KResult finish_pending_read(CacheEntry& entry)
+    {
+        if (!entry.pending_read)
+            return KSuccess;
+        auto result = entry.pending_read->wait();
+        if (!entry.pending_read->is_completed())
+            return EINTR;
+        entry.has_data = result.request_result() == AsyncDeviceRequest::Success;
+        entry.pending_read = nullptr;
+        return KSuccess;
     }
 
-    const CacheEntry* entries() const { return (const CacheEntry*)m_entries.data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries.data(); }
+    // Returns up to max_count of the least recently dirtied entries, sorted by block index.
+    Vector<CacheEntry*> oldest_dirty_entries(size_t max_count) const
+    {
+        Vector<CacheEntry*> entries;
+        entries.ensure_capacity(min(max_count, m_dirty_count));
+        for (auto& entry : m_dirty_list) {
+            if (entries.size() >= max_count)
+                break;
+            entries.unchecked_append(const_cast<CacheEntry*>(&entry));
+        }
+        quick_sort(entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+        return entries;
+    }
+
+    size_t dirty_count() const { return m_dirty_count; }
 
-    template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    // Shrinks the cache while the system is low on memory, and lets it grow back once the pressure is gone.
+    void adapt_to_memory_pressure()
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        auto total_pages = MM.user_physical_pages();
+        auto used_pages = MM.user_physical_pages_used();
+        auto available_pages = total_pages > used_pages ? total_pages - used_pages : 0;
+
+        if (available_pages < total_pages / 16) {
+            m_capacity = max(m_capacity / 2, DiskCacheSegment::entry_count);
+            while (m_entry_count > m_capacity) {
+                if (!try_release_last_segment())
+                    break;
+            }
+        } else if (available_pages > total_pages / 4 && m_capacity < m_maximum_capacity) {
+            m_capacity = min(m_capacity + DiskCacheSegment::entry_count, m_maximum_capacity);
+        }
     }
 
+    DiskCacheStatistics statistics() const
+    {
+        auto statistics = m_statistics;
+        statistics.entry_count = m_entry_count;
+        statistics.capacity = m_capacity;
+        statistics.dirty_count = m_dirty_count;
+        return statistics;
+    }
+
+    void did_write_back(size_t count) { m_statistics.writeback_count += count; }
+
 private:
+    static size_t compute_maximum_capacity(size_t block_size)
+    {
+        // A single cache may use the whole budget, as long as the others don't need it.
+        auto entry_count = disk_cache_memory_budget() / block_size;
+        return max(entry_count - entry_count % DiskCacheSegment::entry_count, DiskCacheSegment::entry_count);
+    }
+
+    size_t maximum_protected_count() const { return m_entry_count * 3 / 4; }
+
+    void did_reference(CacheEntry& entry)
+    {
+        if (entry.is_read_ahead) {
+            // This is the first real access of a block brought in by read-ahead.
+            entry.is_read_ahead = false;
+            m_probation_list.prepend(entry);
+            return;
+        }
+        if (entry.is_protected) {
+            m_protected_list.prepend(entry);
+            return;
+        }
+
+        entry.is_protected = true;
+        m_protected_list.prepend(entry);
+        ++m_protected_count;
+
+        // Demote the least recently used protected entries to make room.
+        while (m_protected_count > maximum_protected_count()) {
+            auto* demoted_entry = m_protected_list.last();
+            VERIFY(demoted_entry);
+            demoted_entry->is_protected = false;
+            m_probation_list.prepend(*demoted_entry);
+            --m_protected_count;
+        }
+    }
+
+    static CacheEntry* find_victim_in(IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::list_node>& list)
+    {
+        // Skip over dirty entries and entries that are still being filled in by a read-ahead request,
+        // since the device is writing into their data buffer.
+        for (auto it = list.rbegin(); it != list.rend(); ++it) {
+            auto& entry = *it;
+            if (!entry.is_dirty() && !entry.has_read_in_flight())
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    CacheEntry* find_victim()
+    {
+        if (auto* entry = find_victim_in(m_probation_list))
+            return entry;
+        return find_victim_in(m_protected_list);
+    }
+
+    void evict(CacheEntry& entry)
+    {
+        VERIFY(entry.is_in_use);
+        VERIFY(!entry.is_dirty());
+        VERIFY(!entry.has_read_in_flight());
+        m_hash.remove(entry.block_index);
+        if (entry.is_protected) {
+            entry.is_protected = false;
+            --m_protected_count;
+        }
+        entry.is_in_use = false;
+        entry.has_data = false;
+        entry.pending_read = nullptr;
+        m_free_list.append(entry);
+    }
+
+    size_t segment_size() const { return DiskCacheSegment::entry_count * m_fs.block_size(); }
+
+    bool try_grow()
+    {
+        auto size = segment_size();
+        auto total_bytes = s_total_disk_cache_bytes.fetch_add(size);
+        if (!m_segments.is_empty() && total_bytes + size > disk_cache_memory_budget()) {
+            s_total_disk_cache_bytes.fetch_sub(size);
+            return false;
+        }
+        auto segment = DiskCacheSegment::try_create(m_fs.block_size());
+        if (!segment) {
+            s_total_disk_cache_bytes.fetch_sub(size);
+            return false;
+        }
+        for (auto& entry : segment->entries)
+            m_free_list.append(entry);
+        m_segments.append(segment.release_nonnull());
+        m_entry_count += DiskCacheSegment::entry_count;
+        return true;
+    }
+
+    bool try_release_last_segment()
+    {
+        if (m_segments.size() <= 1)
+            return false;
+        auto& segment = m_segments.last();
+        for (auto& entry : segment.entries) {
+            if (entry.is_dirty() || entry.has_read_in_flight())
+                return false;
+        }
+        for (auto& entry : segment.entries) {
+            if (entry.is_in_use) {
+                evict(entry);
+                ++m_statistics.eviction_count;
+            }
+            m_free_list.remove(entry);
+        }
+        m_segments.take_last();
+        m_entry_count -= DiskCacheSegment::entry_count;
+        s_total_disk_cache_bytes.fetch_sub(segment_size());
+        return true;
+    }
+
+    using CacheEntryList = IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::list_node>;
+
     BlockBasedFS& m_fs;
-    size_t m_entry_count { 10000 };
-    mutable HashMap<BlockBasedFS::BlockIndex, CacheEntry*> m_hash;
-    mutable IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::list_node> m_clean_list;
-    mutable IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::list_node> m_dirty_list;
-    KBuffer m_cached_block_data;
-    KBuffer m_entries;
-    bool m_dirty { false };
+    HashMap<BlockBasedFS::BlockIndex, CacheEntry*> m_hash;
+    CacheEntryList m_probation_list;
+    CacheEntryList m_protected_list;
+    CacheEntryList m_free_list;
+    IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::dirty_list_node> m_dirty_list;
+    NonnullOwnPtrVector<DiskCacheSegment> m_segments;
+    size_t m_entry_count { 0 };
+    size_t m_protected_count { 0 };
+    size_t m_dirty_count { 0 };
+    size_t m_maximum_capacity { 0 };
+    size_t m_capacity { 0 };
+    DiskCacheStatistics m_statistics;
 };
 
 BlockBasedFS::BlockBasedFS(FileDescription& file_description)
@@ -123,6 +398,14 @@ KResult BlockBasedFS::write_block(BlockIndex index, const UserOrKernelBuffer& da
 
     if (!allow_cache) {
         flush_specific_block_if_needed(index);
+        // Whatever we have cached for this block is stale once we've written it. A read-ahead of the old
+        // contents that is still in flight would otherwise complete afterwards and make them valid again.
+        if (auto* entry = cache().find(index)) {
+            while (entry->has_read_in_flight())
+                (void)entry->pending_read->wait();
+            entry->pending_read = nullptr;
+            entry->has_data = false;
+        }
         auto base_offset = index.value() * block_size() + offset;
         auto seek_result = file_description().seek(base_offset, SEEK_SET);
         if (seek_result.is_error())
@@ -135,9 +418,11 @@ KResult BlockBasedFS::write_block(BlockIndex index, const UserOrKernelBuffer& da
     }
 
     auto& entry = cache().get(index);
-    if (count < block_size()) {
+    if (auto result = cache().finish_pending_read(entry); result.is_error())
+        return result;
+    if (count < block_size() && !entry.has_data) {
         // Fill the cache first.
-        auto result = read_block(index, nullptr, block_size());
+        auto result = fill_cache_entry(entry);
         if (result.is_error())
             return result;
     }
@@ -210,6 +495,62 @@ KResult BlockBasedFS::write_blocks(BlockIndex index, unsigned count, const UserO
     return KSuccess;
 }
 
+KResult BlockBasedFS::fill_cache_entry(CacheEntry& entry) const
+{
+    VERIFY(m_lock.is_locked());
+    auto base_offset = entry.block_index.value() * block_size();
+    auto seek_result = file_description().seek(base_offset, SEEK_SET);
+    if (seek_result.is_error())
+        return seek_result.error();
+    auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+    auto nread = file_description().read(entry_data_buffer, block_size());
+    if (nread.is_error())
+        return nread.error();
+    VERIFY(nread.value() == block_size());
+    entry.has_data = true;
+    return KSuccess;
+}
+
+KResult BlockBasedFS::write_back_cache_entry(CacheEntry& entry)
+{
+    VERIFY(m_lock.is_locked());
+    auto base_offset = entry.block_index.value() * block_size();
+    auto seek_result = file_description().seek(base_offset, SEEK_SET);
+    if (seek_result.is_error())
+        return seek_result.error();
+    auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+    auto nwritten = file_description().write(entry_data_buffer, block_size());
+    if (nwritten.is_error())
+        return nwritten.error();
+    return KSuccess;
+}
+
+bool BlockBasedFS::write_back_cache_entries_concurrently(Span<CacheEntry*> entries)
+{
+    VERIFY(m_lock.is_locked());
+    auto* device = device_for_block_requests();
+    if (!device)
+        return false;
+    auto device_blocks_per_block = block_size() / device->block_size();
+
+    // Submit all of the writes before waiting for any of them, so that devices which can
+    // have more than one request in flight get to work on (and reorder) them together.
+    NonnullRefPtrVector<AsyncBlockDeviceRequest> requests;
+    requests.ensure_capacity(entries.size());
+    for (auto* entry : entries) {
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+        requests.unchecked_append(device->make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Write,
+            entry->block_index.value() * device_blocks_per_block, device_blocks_per_block, entry_data_buffer, block_size()));
+    }
+    // NOTE: The requests write straight out of the cache entries, so we can't leave before they're all done.
+    // FIXME: Should failed writes be surfaced somehow?
+    for (auto& request : requests) {
+        while (!request.is_completed())
+            (void)request.wait();
+    }
+    return true;
+}
+
 KResult BlockBasedFS::read_block(BlockIndex index, UserOrKernelBuffer* buffer, size_t count, size_t offset, bool allow_cache) const
 {
     Locker locker(m_lock);
@@ -231,17 +572,11 @@ KResult BlockBasedFS::read_block(BlockIndex index, UserOrKernelBuffer* buffer, s
     }
 
     auto& entry = cache().get(index);
+    if (auto result = cache().finish_pending_read(entry); result.is_error())
+        return result;
     if (!entry.has_data) {
-        auto base_offset = index.value() * block_size();
-        auto seek_result = file_description().seek(base_offset, SEEK_SET);
-        if (seek_result.is_error())
-            return seek_result.error();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-        auto nread = file_description().read(entry_data_buffer, block_size());
-        if (nread.is_error())
-            return nread.error();
-        VERIFY(nread.value() == block_size());
-        entry.has_data = true;
+        if (auto result = fill_cache_entry(entry); result.is_error())
+            return result;
     }
     if (buffer && !buffer->write(entry.data + offset, count))
         return EFAULT;
@@ -267,27 +602,73 @@ KResult BlockBasedFS::read_blocks(BlockIndex index, unsigned count, UserOrKernel
     return KSuccess;
 }
 
+BlockDevice* BlockBasedFS::device_for_block_requests() const
+{
+    if (!file_description().file().is_block_device())
+        return nullptr;
+    auto& device = static_cast<BlockDevice&>(const_cast<File&>(file_description().file()));
+    // Storage drivers can't transfer more than a page per request (see StorageDevice::read).
+    if (block_size() > PAGE_SIZE || block_size() % device.block_size() != 0)
+        return nullptr;
+    return &device;
+}
+
+void BlockBasedFS::read_ahead_blocks(Span<const BlockIndex> indices) const
+{
+    auto* device_pointer = device_for_block_requests();
+    if (!device_pointer)
+        return;
+    auto& device = *device_pointer;
+    auto device_blocks_per_block = block_size() / device.block_size();
+
+    Locker locker(m_lock);
+    size_t submitted_count = 0;
+    for (auto index : indices) {
+        if (auto* entry = cache().find(index); entry && (entry->has_data || entry->pending_read))
+            continue;
+        // NOTE: The requests are queued on the device back to back, and we don't wait for
+        //       any of them here. Whoever reads one of these blocks next will wait for its
+        //       request to finish in DiskCache::finish_pending_read().
+        auto& entry = cache().get(index, true);
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        entry.pending_read = device.make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Read,
+            index.value() * device_blocks_per_block, device_blocks_per_block, entry_data_buffer, block_size());
+        ++submitted_count;
+    }
+    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_ahead_blocks: {} requested, {} submitted", indices.size(), submitted_count);
+}
+
 void BlockBasedFS::flush_specific_block_if_needed(BlockIndex index)
 {
     Locker locker(m_lock);
     if (!cache().is_dirty())
         return;
-    Vector<CacheEntry*, 32> cleaned_entries;
-    cache().for_each_dirty_entry([&](CacheEntry& entry) {
-        if (entry.block_index != index) {
-            size_t base_offset = entry.block_index.value() * block_size();
-            auto seek_result = file_description().seek(base_offset, SEEK_SET);
-            VERIFY(!seek_result.is_error());
+    auto* entry = cache().find(index);
+    if (!entry || !entry->is_dirty())
+        return;
+    // FIXME: Should this error path be surfaced somehow?
+    [[maybe_unused]] auto result = write_back_cache_entry(*entry);
+    cache().mark_clean(*entry);
+    cache().did_write_back(1);
+}
+
+size_t BlockBasedFS::flush_some_writes(size_t max_block_count)
+{
+    Locker locker(m_lock);
+    if (!cache().is_dirty())
+        return 0;
+    // Writing the blocks in ascending order keeps the disk heads moving in one direction.
+    auto entries = cache().oldest_dirty_entries(max_block_count);
+    if (!write_back_cache_entries_concurrently(entries)) {
+        for (auto* entry : entries) {
             // FIXME: Should this error path be surfaced somehow?
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(entry_data_buffer, block_size());
-            cleaned_entries.append(&entry);
+            [[maybe_unused]] auto result = write_back_cache_entry(*entry);
         }
-    });
-    // NOTE: We make a separate pass to mark entries clean since marking them clean
-    //       moves them out of the dirty list which would disturb the iteration above.
-    for (auto* entry : cleaned_entries)
+    }
+    for (auto* entry : entries)
         cache().mark_clean(*entry);
+    cache().did_write_back(entries.size());
+    return entries.size();
 }
 
 void BlockBasedFS::flush_writes_impl()
@@ -295,17 +676,7 @@ void BlockBasedFS::flush_writes_impl()
     Locker locker(m_lock);
     if (!cache().is_dirty())
         return;
-    u32 count = 0;
-    cache().for_each_dirty_entry([&](CacheEntry& entry) {
-        auto base_offset = entry.block_index.value() * block_size();
-        auto seek_result = file_description().seek(base_offset, SEEK_SET);
-        VERIFY(!seek_result.is_error());
-        // FIXME: Should this error path be surfaced somehow?
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-        [[maybe_unused]] auto rc = file_description().write(entry_data_buffer, block_size());
-        ++count;
-    });
-    cache().mark_all_clean();
+    auto count = flush_some_writes(cache().dirty_count());
     dbgln("{}: Flushed {} blocks to disk", class_name(), count);
 }
 
@@ -314,6 +685,22 @@ void BlockBasedFS::flush_writes()
     flush_writes_impl();
 }
 
+void BlockBasedFS::write_back_dirty_blocks()
+{
+    Locker locker(m_lock);
+    cache().adapt_to_memory_pressure();
+    auto count = flush_some_writes(max_writeback_block_count);
+    dbgln_if(BBFS_DEBUG, "{}: Wrote back {} blocks, {} still dirty", class_name(), count, cache().dirty_count());
+}
+
+DiskCacheStatistics BlockBasedFS::disk_cache_statistics() const
+{
+    Locker locker(m_lock);
+    if (!m_cache)
+        return {};
+    return m_cache->statistics();
+}
+
 DiskCache& BlockBasedFS::cache() const
 {
     if (!m_cache)
@@ -10,6 +10,18 @@
 
 namespace Kernel {
 
+struct CacheEntry;
+
+struct DiskCacheStatistics {
+    size_t entry_count { 0 };
+    size_t capacity { 0 };
+    size_t dirty_count { 0 };
+    u64 hit_count { 0 };
+    u64 miss_count { 0 };
+    u64 eviction_count { 0 };
+    u64 writeback_count { 0 };
+};
+
 class BlockBasedFS : public FileBackedFS {
 public:
     TYPEDEF_DISTINCT_ORDERED_ID(u64, BlockIndex);
@@ -21,12 +33,21 @@ public:
     virtual void flush_writes() override;
     void flush_writes_impl();
 
+    // Writes back up to the given number of the least recently dirtied blocks, returns how many were written.
+    size_t flush_some_writes(size_t max_block_count);
+    virtual void write_back_dirty_blocks() override;
+
+    DiskCacheStatistics disk_cache_statistics() const;
+
 protected:
     explicit BlockBasedFS(FileDescription&);
 
     KResult read_block(BlockIndex, UserOrKernelBuffer*, size_t count, size_t offset = 0, bool allow_cache = true) const;
     KResult read_blocks(BlockIndex, unsigned count, UserOrKernelBuffer&, bool allow_cache = true) const;
 
+    // Asynchronously pulls the given blocks into the cache without waiting for them.
+    void read_ahead_blocks(Span<const BlockIndex>) const;
+
     bool raw_read(BlockIndex, UserOrKernelBuffer&);
     bool raw_write(BlockIndex, const UserOrKernelBuffer&);
 
@@ -39,8 +60,17 @@ protected:
     u64 m_logical_block_size { 512 };
 
 private:
+    // How many blocks a single round of background writeback may write to disk.
+    static constexpr size_t max_writeback_block_count = 256;
+
+    virtual bool is_block_based() const override { return true; }
+
     DiskCache& cache() const;
     void flush_specific_block_if_needed(BlockIndex index);
+    KResult fill_cache_entry(CacheEntry&) const;
+    KResult write_back_cache_entry(CacheEntry&);
+    bool write_back_cache_entries_concurrently(Span<CacheEntry*>);
+    BlockDevice* device_for_block_requests() const;
 
     mutable OwnPtr<DiskCache> m_cache;
 };
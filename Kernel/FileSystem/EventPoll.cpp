@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/FileDescription.h>
+
+namespace Kernel {
+
+// Protects the link between watches and the descriptions they watch, i.e. EventPollWatch::m_description
+// and the list of watches of every description.
+static SpinLock<u8> s_watch_lock;
+
+static u32 epoll_events_from_block_flags(Thread::FileBlocker::BlockFlags flags)
+{
+    using BlockFlags = Thread::FileBlocker::BlockFlags;
+    u32 events = 0;
+    if (has_flag(flags, BlockFlags::Read))
+        events |= EPOLLIN;
+    if (has_flag(flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    if (has_flag(flags, BlockFlags::Write))
+        events |= EPOLLOUT;
+    if (has_flag(flags, BlockFlags::ReadHangUp))
+        events |= EPOLLRDHUP;
+    if (has_flag(flags, BlockFlags::WriteError))
+        events |= EPOLLERR;
+    if (has_flag(flags, BlockFlags::WriteHangUp))
+        events |= EPOLLHUP;
+    return events;
+}
+
+EventPollWatch::EventPollWatch(EventPoll& event_poll, int fd, FileDescription& description, u32 events, u64 data)
+    : m_event_poll(event_poll)
+    , m_fd(fd)
+    , m_file(description.file())
+    , m_block_condition(description.block_condition())
+    , m_events(events)
+    , m_data(data)
+{
+    {
+        ScopedSpinLock lock(s_watch_lock);
+        m_description = &description;
+        description.event_poll_watches({}).append(*this);
+    }
+
+    // This checks whether the description is ready already, and we never ask to be removed again.
+    auto did_register = set_block_condition(m_block_condition);
+    VERIFY(did_register);
+}
+
+EventPollWatch::~EventPollWatch()
+{
+    // Stop listening to the file first, nothing looks at the description once this returns.
+    m_block_condition.remove_blocker(*this, nullptr);
+
+    {
+        ScopedSpinLock lock(s_watch_lock);
+        if (m_description) {
+            m_description->event_poll_watches({}).remove(*this);
+            m_description = nullptr;
+        }
+    }
+
+    ScopedSpinLock lock(m_event_poll.m_ready_lock);
+    m_event_poll.m_ready_watches.remove(*this);
+}
+
+auto EventPollWatch::block_flags() const -> BlockFlags
+{
+    auto events = m_events.load(AK::MemoryOrder::memory_order_relaxed);
+    // Errors and hang-ups are always reported, just like poll() does.
+    auto flags = BlockFlags::Exception;
+    if (events & EPOLLIN)
+        flags |= BlockFlags::Read;
+    if (events & EPOLLPRI)
+        flags |= BlockFlags::ReadPriority;
+    if (events & EPOLLOUT)
+        flags |= BlockFlags::Write;
+    return flags;
+}
+
+bool EventPollWatch::unblock(bool, void*)
+{
+    // We are called with the block condition of the file locked, so the description can't go away under us:
+    // it has to remove us from that block condition before it is destroyed.
+    VERIFY(m_description);
+    if (m_description->should_unblock(block_flags()) != BlockFlags::None)
+        m_event_poll.watch_became_ready({}, *this);
+
+    // Returning true would remove us from the block condition, but we want to hear about every future change too.
+    return false;
+}
+
+void EventPollWatch::detach_all(Badge<FileDescription>, FileDescription& description)
+{
+    ScopedSpinLock lock(s_watch_lock);
+    auto& watches = description.event_poll_watches({});
+    while (auto* watch = watches.take_first()) {
+        watch->m_block_condition.remove_blocker(*watch, nullptr);
+        watch->m_description = nullptr;
+
+        // Let the next collect_events() throw the watch away, it will never fire again.
+        ScopedSpinLock ready_lock(watch->m_event_poll.m_ready_lock);
+        watch->m_event_poll.m_ready_watches.append(*watch);
+    }
+}
+
+KResultOr<NonnullRefPtr<EventPoll>> EventPoll::create()
+{
+    auto event_poll = adopt_ref_if_nonnull(new (nothrow) EventPoll);
+    if (event_poll)
+        return event_poll.release_nonnull();
+    return ENOMEM;
+}
+
+EventPoll::~EventPoll()
+{
+    m_watches.clear();
+}
+
+bool EventPoll::can_read(const FileDescription&, size_t) const
+{
+    ScopedSpinLock lock(m_ready_lock);
+    return !m_ready_watches.is_empty();
+}
+
+void EventPoll::watch_became_ready(Badge<EventPollWatch>, EventPollWatch& watch)
+{
+    {
+        ScopedSpinLock lock(m_ready_lock);
+        if (!watch.m_is_armed || m_ready_watches.contains(watch))
+            return;
+        m_ready_watches.append(watch);
+    }
+    evaluate_block_conditions();
+}
+
+EventPollWatch* EventPoll::find_watch(int fd, FileDescription& description)
+{
+    auto it = m_watches.find(fd);
+    if (it == m_watches.end())
+        return nullptr;
+
+    {
+        ScopedSpinLock lock(s_watch_lock);
+        if (it->value->m_description == &description)
+            return it->value.ptr();
+    }
+
+    // The watched description has been closed, or the fd was reused for another one since.
+    m_watches.remove(it);
+    return nullptr;
+}
+
+KResult EventPoll::add_watch(int fd, FileDescription& description, u32 events, u64 data)
+{
+    Locker locker(m_lock);
+    if (find_watch(fd, description))
+        return EEXIST;
+
+    auto watch = adopt_own_if_nonnull(new (nothrow) EventPollWatch(*this, fd, description, events, data));
+    if (!watch)
+        return ENOMEM;
+    m_watches.set(fd, watch.release_nonnull());
+    return KSuccess;
+}
+
+KResult EventPoll::modify_watch(int fd, FileDescription& description, u32 events, u64 data)
+{
+    Locker locker(m_lock);
+    auto* watch = find_watch(fd, description);
+    if (!watch)
+        return ENOENT;
+
+    watch->m_events.store(events, AK::MemoryOrder::memory_order_relaxed);
+    watch->m_data = data;
+    {
+        // The description may be ready for the new events already, collect_events() will find out.
+        ScopedSpinLock lock(m_ready_lock);
+        watch->m_is_armed = true;
+        m_ready_watches.append(*watch);
+    }
+    evaluate_block_conditions();
+    return KSuccess;
+}
+
+KResult EventPoll::remove_watch(int fd, FileDescription& description)
+{
+    Locker locker(m_lock);
+    if (!find_watch(fd, description))
+        return ENOENT;
+    m_watches.remove(fd);
+    return KSuccess;
+}
+
+size_t EventPoll::collect_events(Span<epoll_event> events)
+{
+    using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+    Locker locker(m_lock);
+    size_t count = 0;
+    EventPollWatch::ReadyList still_ready;
+
+    while (count < events.size()) {
+        EventPollWatch* watch;
+        bool is_armed;
+        {
+            ScopedSpinLock lock(m_ready_lock);
+            watch = m_ready_watches.take_first();
+            if (!watch)
+                break;
+            is_armed = watch->m_is_armed;
+        }
+
+        RefPtr<FileDescription> description;
+        {
+            ScopedSpinLock lock(s_watch_lock);
+            if (watch->m_description && watch->m_description->try_ref())
+                description = adopt_ref(*watch->m_description);
+        }
+        if (!description) {
+            // The description is gone, so this watch will never fire again.
+            m_watches.remove(watch->m_fd);
+            continue;
+        }
+        if (!is_armed)
+            continue;
+
+        auto unblocked_flags = description->should_unblock(watch->block_flags());
+        if (unblocked_flags == BlockFlags::None) {
+            // Not ready (anymore), the block condition will queue the watch again once that changes.
+            continue;
+        }
+
+        auto& event = events[count++];
+        event.events = epoll_events_from_block_flags(unblocked_flags);
+        event.data.u64 = watch->m_data;
+
+        auto watched_events = watch->m_events.load(AK::MemoryOrder::memory_order_relaxed);
+        ScopedSpinLock lock(m_ready_lock);
+        if (watched_events & EPOLLONESHOT)
+            watch->m_is_armed = false;
+        else if (!(watched_events & EPOLLET))
+            still_ready.append(*watch);
+    }
+
+    ScopedSpinLock lock(m_ready_lock);
+    while (auto* watch = still_ready.take_first())
+        m_ready_watches.append(*watch);
+    return count;
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Badge.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Span.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Lock.h>
+#include <Kernel/SpinLock.h>
+
+namespace Kernel {
+
+class EventPoll;
+
+// A file description watched by an EventPoll.
+// It stays registered with the block condition of the watched file for as long as it exists, so every state change
+// of the file puts it on the ready list of its EventPoll, and waiting for events never has to look at any other watch.
+class EventPollWatch final : public Thread::FileBlocker {
+    friend class EventPoll;
+
+public:
+    virtual ~EventPollWatch() override;
+
+    virtual const char* state_string() const override { return "Polling"; }
+    virtual void not_blocking(bool) override { }
+    virtual bool unblock(bool, void*) override;
+
+    // Called when the description is destroyed, none of its watches can fire anymore after this.
+    static void detach_all(Badge<FileDescription>, FileDescription&);
+
+private:
+    EventPollWatch(EventPoll&, int fd, FileDescription&, u32 events, u64 data);
+
+    BlockFlags block_flags() const;
+
+    EventPoll& m_event_poll;
+    const int m_fd;
+    // Cleared once the watched description is destroyed, protected by the global watch lock.
+    FileDescription* m_description { nullptr };
+    // Keeps the block condition we are registered with alive, even after the description is gone.
+    NonnullRefPtr<File> m_file;
+    FileBlockCondition& m_block_condition;
+    Atomic<u32> m_events { 0 };
+    u64 m_data { 0 };
+    // One-shot watches are disarmed once they have been reported, until they are modified again.
+    // Protected by the ready lock of the EventPoll.
+    bool m_is_armed { true };
+
+    IntrusiveListNode<EventPollWatch> m_ready_list_node;
+    IntrusiveListNode<EventPollWatch> m_description_list_node;
+
+public:
+    using ReadyList = IntrusiveList<EventPollWatch, RawPtr<EventPollWatch>, &EventPollWatch::m_ready_list_node>;
+    using DescriptionList = IntrusiveList<EventPollWatch, RawPtr<EventPollWatch>, &EventPollWatch::m_description_list_node>;
+};
+
+// A persistent set of file descriptors to wait on, the kernel side of epoll(7).
+// Unlike select() and poll(), interest is registered once, and waiting only costs as much as the number of
+// descriptors that actually became ready.
+class EventPoll final : public File {
+    friend class EventPollWatch;
+
+public:
+    static KResultOr<NonnullRefPtr<EventPoll>> create();
+    virtual ~EventPoll() override;
+
+    virtual bool can_read(const FileDescription&, size_t) const override;
+    virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(const FileDescription&, size_t) const override { return false; }
+    virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) override { return EINVAL; }
+
+    virtual String absolute_path(const FileDescription&) const override { return "EventPoll"; }
+    virtual const char* class_name() const override { return "EventPoll"; }
+    virtual bool is_event_poll() const override { return true; }
+
+    KResult add_watch(int fd, FileDescription&, u32 events, u64 data);
+    KResult modify_watch(int fd, FileDescription&, u32 events, u64 data);
+    KResult remove_watch(int fd, FileDescription&);
+
+    // Fills `events` with the watches that are ready, and returns how many there were.
+    // Level-triggered watches stay on the ready list and are checked again the next time.
+    size_t collect_events(Span<epoll_event> events);
+
+    void watch_became_ready(Badge<EventPollWatch>, EventPollWatch&);
+
+private:
+    EventPoll() { }
+
+    EventPollWatch* find_watch(int fd, FileDescription&);
+
+    // Protects the set of watches and their settings.
+    Lock m_lock { "EventPoll" };
+    HashMap<int, NonnullOwnPtr<EventPollWatch>> m_watches;
+
+    // Taken from the block conditions of the watched files, so this can't be a Lock.
+    mutable SpinLock<u8> m_ready_lock;
+    EventPollWatch::ReadyList m_ready_watches;
+};
+
+}
@@ -889,6 +889,36 @@ KResultOr<size_t> Ext2FSInode::read_bytes(off_t offset, size_t count, UserOrKern
     return nread;
 }
 
+void Ext2FSInode::read_ahead(off_t offset, size_t count) const
+{
+    Locker inode_locker(m_lock);
+    VERIFY(offset >= 0);
+    if (count == 0 || static_cast<u64>(offset) >= size())
+        return;
+    if (is_symlink() && size() < max_inline_symlink_length)
+        return;
+
+    if (m_block_list.is_empty())
+        m_block_list = compute_block_list();
+    if (m_block_list.is_empty())
+        return;
+
+    const int block_size = fs().block_size();
+    size_t first_block_logical_index = offset / block_size;
+    size_t last_block_logical_index = min((offset + count - 1) / block_size, m_block_list.size() - 1);
+
+    Vector<BlockBasedFS::BlockIndex, 64> block_indices;
+    for (auto bi = first_block_logical_index; bi <= last_block_logical_index; ++bi) {
+        auto block_index = m_block_list[bi];
+        // Holes don't need to be read from disk.
+        if (block_index.value() != 0)
+            block_indices.append(block_index);
+    }
+
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_ahead(): Reading ahead {} blocks at offset {}", identifier(), block_indices.size(), offset);
+    fs().read_ahead_blocks(block_indices.span());
+}
+
 KResult Ext2FSInode::resize(u64 new_size)
 {
     auto old_size = size();
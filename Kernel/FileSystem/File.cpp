@@ -38,6 +38,40 @@ int File::ioctl(FileDescription&, unsigned, FlatPtr)
     return -ENOTTY;
 }
 
+KResultOr<size_t> File::read_vectored(FileDescription& description, u64 offset, Span<FileIOVector> vectors)
+{
+    size_t total_nread = 0;
+    for (auto& vector : vectors) {
+        auto nread_or_error = read(description, offset + total_nread, vector.buffer, vector.size);
+        if (nread_or_error.is_error()) {
+            if (total_nread > 0)
+                return total_nread;
+            return nread_or_error.error();
+        }
+        total_nread += nread_or_error.value();
+        if (nread_or_error.value() < vector.size)
+            break;
+    }
+    return total_nread;
+}
+
+KResultOr<size_t> File::write_vectored(FileDescription& description, u64 offset, Span<const FileIOVector> vectors)
+{
+    size_t total_nwritten = 0;
+    for (auto& vector : vectors) {
+        auto nwritten_or_error = write(description, offset + total_nwritten, vector.buffer, vector.size);
+        if (nwritten_or_error.is_error()) {
+            if (total_nwritten > 0)
+                return total_nwritten;
+            return nwritten_or_error.error();
+        }
+        total_nwritten += nwritten_or_error.value();
+        if (nwritten_or_error.value() < vector.size)
+            break;
+    }
+    return total_nwritten;
+}
+
 KResultOr<Region*> File::mmap(Process&, FileDescription&, const Range&, u64, int, bool)
 {
     return ENODEV;
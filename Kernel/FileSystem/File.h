@@ -8,6 +8,7 @@
 
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
+#include <AK/Span.h>
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <AK/Weakable.h>
@@ -43,6 +44,12 @@ public:
     }
 };
 
+// One buffer of a vectored read or write.
+struct FileIOVector {
+    UserOrKernelBuffer buffer;
+    size_t size { 0 };
+};
+
 // File is the base class for anything that can be referenced by a FileDescription.
 //
 // The most important functions in File are:
@@ -51,6 +58,10 @@ public:
 //   - Implement reading and writing.
 //   - Return the number of bytes read/written, OR a negative error code.
 //
+// read_vectored() and write_vectored()
+//   - Transfer a whole list of buffers, back to back starting at the given offset, as one request.
+//   - The default implementations call read() or write() for each buffer and stop at the first short transfer.
+//
 // can_read() and can_write()
 //
 //   - Used to implement blocking I/O, and the select() and poll() syscalls.
@@ -87,6 +98,8 @@ public:
     virtual void did_seek(FileDescription&, off_t) { }
     virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) = 0;
     virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) = 0;
+    virtual KResultOr<size_t> read_vectored(FileDescription&, u64, Span<FileIOVector>);
+    virtual KResultOr<size_t> write_vectored(FileDescription&, u64, Span<const FileIOVector>);
     virtual int ioctl(FileDescription&, unsigned request, FlatPtr arg);
     virtual KResultOr<Region*> mmap(Process&, FileDescription&, const Range&, u64 offset, int prot, bool shared);
     virtual KResult stat(::stat&) const { return EBADF; }
@@ -110,6 +123,7 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_event_poll() const { return false; }
 
     virtual FileBlockCondition& block_condition() { return m_block_condition; }
 
@@ -67,6 +67,8 @@ FileDescription::FileDescription(File& file)
 
 FileDescription::~FileDescription()
 {
+    if (!m_event_poll_watches.is_empty())
+        EventPollWatch::detach_all({}, *this);
     m_file->detach(*this);
     if (is_fifo())
         static_cast<FIFO*>(m_file.ptr())->detach(m_fifo_direction);
@@ -157,6 +159,14 @@ KResultOr<off_t> FileDescription::seek(off_t offset, int whence)
     return m_current_offset;
 }
 
+ReadaheadState* FileDescription::readahead_state()
+{
+    Locker locker(m_lock);
+    if (!m_readahead_state)
+        m_readahead_state = adopt_own_if_nonnull(new (nothrow) ReadaheadState);
+    return m_readahead_state.ptr();
+}
+
 KResultOr<size_t> FileDescription::read(UserOrKernelBuffer& buffer, size_t count)
 {
     Locker locker(m_lock);
@@ -171,6 +181,46 @@ KResultOr<size_t> FileDescription::read(UserOrKernelBuffer& buffer, size_t count
     return nread_or_error;
 }
 
+static bool io_would_overflow(u64 offset, Span<const FileIOVector> vectors)
+{
+    Checked<off_t> end = offset;
+    for (auto& vector : vectors)
+        end += Checked<off_t>(vector.size);
+    return end.has_overflow();
+}
+
+KResultOr<size_t> FileDescription::read_vectored(Span<FileIOVector> vectors)
+{
+    Locker locker(m_lock);
+    if (io_would_overflow(m_current_offset, vectors))
+        return EOVERFLOW;
+    auto nread_or_error = m_file->read_vectored(*this, offset(), vectors);
+    if (!nread_or_error.is_error()) {
+        if (m_file->is_seekable())
+            m_current_offset += nread_or_error.value();
+        evaluate_block_conditions();
+    }
+    return nread_or_error;
+}
+
+KResultOr<size_t> FileDescription::read(UserOrKernelBuffer& buffer, u64 offset, size_t count)
+{
+    FileIOVector vector { buffer, count };
+    return read_vectored({ &vector, 1 }, offset);
+}
+
+// Positional I/O leaves the offset of the description alone, so it doesn't take the description lock either,
+// letting threads that share a description read and write different parts of a file at the same time.
+KResultOr<size_t> FileDescription::read_vectored(Span<FileIOVector> vectors, u64 offset)
+{
+    if (io_would_overflow(offset, vectors))
+        return EOVERFLOW;
+    auto nread_or_error = m_file->read_vectored(*this, offset, vectors);
+    if (!nread_or_error.is_error())
+        evaluate_block_conditions();
+    return nread_or_error;
+}
+
 KResultOr<size_t> FileDescription::write(const UserOrKernelBuffer& data, size_t size)
 {
     Locker locker(m_lock);
@@ -185,6 +235,22 @@ KResultOr<size_t> FileDescription::write(const UserOrKernelBuffer& data, size_t
     return nwritten_or_error;
 }
 
+KResultOr<size_t> FileDescription::write(const UserOrKernelBuffer& data, u64 offset, size_t size)
+{
+    FileIOVector vector { data, size };
+    return write_vectored({ &vector, 1 }, offset);
+}
+
+KResultOr<size_t> FileDescription::write_vectored(Span<const FileIOVector> vectors, u64 offset)
+{
+    if (io_would_overflow(offset, vectors))
+        return EOVERFLOW;
+    auto nwritten_or_error = m_file->write_vectored(*this, offset, vectors);
+    if (!nwritten_or_error.is_error())
+        evaluate_block_conditions();
+    return nwritten_or_error;
+}
+
 bool FileDescription::can_write() const
 {
     return m_file->can_write(*this, offset());
@@ -323,6 +389,25 @@ InodeWatcher* FileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool FileDescription::is_event_poll() const
+{
+    return m_file->is_event_poll();
+}
+
+const EventPoll* FileDescription::event_poll() const
+{
+    if (!is_event_poll())
+        return nullptr;
+    return static_cast<const EventPoll*>(m_file.ptr());
+}
+
+EventPoll* FileDescription::event_poll()
+{
+    if (!is_event_poll())
+        return nullptr;
+    return static_cast<EventPoll*>(m_file.ptr());
+}
+
 bool FileDescription::is_master_pty() const
 {
     return m_file->is_master_pty();
@@ -9,9 +9,11 @@
 #include <AK/Badge.h>
 #include <AK/ByteBuffer.h>
 #include <AK/RefCounted.h>
+#include <Kernel/FileSystem/EventPoll.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/ReadaheadState.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/VirtualAddress.h>
@@ -49,6 +51,12 @@ public:
     KResultOr<off_t> seek(off_t, int whence);
     KResultOr<size_t> read(UserOrKernelBuffer&, size_t);
     KResultOr<size_t> write(const UserOrKernelBuffer& data, size_t);
+    KResultOr<size_t> read_vectored(Span<FileIOVector>);
+    // These read or write at the given offset, the offset of the description is neither used nor updated.
+    KResultOr<size_t> read(UserOrKernelBuffer&, u64 offset, size_t);
+    KResultOr<size_t> write(const UserOrKernelBuffer& data, u64 offset, size_t);
+    KResultOr<size_t> read_vectored(Span<FileIOVector>, u64 offset);
+    KResultOr<size_t> write_vectored(Span<const FileIOVector>, u64 offset);
     KResult stat(::stat&);
 
     KResult chmod(mode_t);
@@ -81,6 +89,10 @@ public:
     const InodeWatcher* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_event_poll() const;
+    const EventPoll* event_poll() const;
+    EventPoll* event_poll();
+
     bool is_master_pty() const;
     const MasterPTY* master_pty() const;
     MasterPTY* master_pty();
@@ -123,6 +135,11 @@ public:
 
     FileBlockCondition& block_condition();
 
+    // NOTE: This is allocated on first use, and may return nullptr under memory pressure.
+    ReadaheadState* readahead_state();
+
+    EventPollWatch::DescriptionList& event_poll_watches(Badge<EventPollWatch>) { return m_event_poll_watches; }
+
 private:
     friend class VFS;
     explicit FileDescription(File&);
@@ -142,6 +159,11 @@ private:
 
     OwnPtr<FileDescriptionData> m_data;
 
+    OwnPtr<ReadaheadState> m_readahead_state;
+
+    // The EventPolls watching this description, which have to forget about it once it's destroyed.
+    EventPollWatch::DescriptionList m_event_poll_watches;
+
     u32 m_file_flags { 0 };
 
     bool m_readable : 1 { false };
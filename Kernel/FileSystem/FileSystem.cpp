@@ -67,6 +67,19 @@ void FS::sync()
         fs.flush_writes();
 }
 
+void FS::write_back_dirty_blocks_everywhere()
+{
+    NonnullRefPtrVector<FS, 32> fses;
+    {
+        InterruptDisabler disabler;
+        for (auto& it : all_fses())
+            fses.append(*it.value);
+    }
+
+    for (auto& fs : fses)
+        fs.write_back_dirty_blocks();
+}
+
 void FS::lock_all()
 {
     for (auto& it : all_fses()) {
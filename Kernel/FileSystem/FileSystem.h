@@ -34,6 +34,7 @@ public:
     unsigned fsid() const { return m_fsid; }
     static FS* from_fsid(u32);
     static void sync();
+    static void write_back_dirty_blocks_everywhere();
     static void lock_all();
 
     virtual bool initialize() = 0;
@@ -59,11 +60,13 @@ public:
     };
 
     virtual void flush_writes() { }
+    virtual void write_back_dirty_blocks() { }
 
     u64 block_size() const { return m_block_size; }
     size_t fragment_size() const { return m_fragment_size; }
 
     virtual bool is_file_backed() const { return false; }
+    virtual bool is_block_based() const { return false; }
 
     // Converts file types that are used internally by the filesystem to DT_* types
     virtual u8 internal_file_type_to_directory_entry_type(const DirectoryEntryView& entry) const { return entry.file_type; }
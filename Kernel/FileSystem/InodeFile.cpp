@@ -28,38 +28,80 @@ InodeFile::~InodeFile()
 
 KResultOr<size_t> InodeFile::read(FileDescription& description, u64 offset, UserOrKernelBuffer& buffer, size_t count)
 {
-    if (Checked<off_t>::addition_would_overflow(offset, count))
-        return EOVERFLOW;
-
-    auto result = m_inode->read_bytes(offset, count, buffer, &description);
-    if (result.is_error())
-        return result.error();
-    auto nread = result.value();
-    if (nread > 0) {
-        Thread::current()->did_file_read(nread);
-        evaluate_block_conditions();
-    }
-    return nread;
+    FileIOVector vector { buffer, count };
+    return read_vectored(description, offset, { &vector, 1 });
 }
 
 KResultOr<size_t> InodeFile::write(FileDescription& description, u64 offset, const UserOrKernelBuffer& data, size_t count)
 {
-    if (Checked<off_t>::addition_would_overflow(offset, count))
-        return EOVERFLOW;
-
-    auto result = m_inode->write_bytes(offset, count, data, &description);
-    if (result.is_error())
-        return result.error();
-
-    auto nwritten = result.value();
-    if (nwritten > 0) {
-        auto mtime_result = m_inode->set_mtime(kgettimeofday().to_truncated_seconds());
-        Thread::current()->did_file_write(nwritten);
-        evaluate_block_conditions();
-        if (mtime_result.is_error())
-            return mtime_result;
+    FileIOVector vector { data, count };
+    return write_vectored(description, offset, { &vector, 1 });
+}
+
+KResultOr<size_t> InodeFile::read_vectored(FileDescription& description, u64 offset, Span<FileIOVector> vectors)
+{
+    size_t total_nread = 0;
+    KResult error = KSuccess;
+    for (auto& vector : vectors) {
+        if (Checked<off_t>::addition_would_overflow(offset + total_nread, vector.size)) {
+            error = EOVERFLOW;
+            break;
+        }
+        auto result = m_inode->read_bytes(offset + total_nread, vector.size, vector.buffer, &description);
+        if (result.is_error()) {
+            error = result.error();
+            break;
+        }
+        total_nread += result.value();
+        if (result.value() < vector.size)
+            break;
+    }
+    if (total_nread == 0) {
+        if (error.is_error())
+            return error;
+        return 0;
+    }
+
+    // The whole list counts as one read, both for accounting and for the read-ahead heuristic.
+    Thread::current()->did_file_read(total_nread);
+    evaluate_block_conditions();
+    if (auto* readahead_state = description.readahead_state(); readahead_state && !description.is_direct()) {
+        if (auto range = readahead_state->did_read(offset, total_nread, m_inode->size()); range.has_value())
+            m_inode->read_ahead(range->offset, range->size);
     }
-    return nwritten;
+    return total_nread;
+}
+
+KResultOr<size_t> InodeFile::write_vectored(FileDescription& description, u64 offset, Span<const FileIOVector> vectors)
+{
+    size_t total_nwritten = 0;
+    KResult error = KSuccess;
+    for (auto& vector : vectors) {
+        if (Checked<off_t>::addition_would_overflow(offset + total_nwritten, vector.size)) {
+            error = EOVERFLOW;
+            break;
+        }
+        auto result = m_inode->write_bytes(offset + total_nwritten, vector.size, vector.buffer, &description);
+        if (result.is_error()) {
+            error = result.error();
+            break;
+        }
+        total_nwritten += result.value();
+        if (result.value() < vector.size)
+            break;
+    }
+    if (total_nwritten == 0) {
+        if (error.is_error())
+            return error;
+        return 0;
+    }
+
+    auto mtime_result = m_inode->set_mtime(kgettimeofday().to_truncated_seconds());
+    Thread::current()->did_file_write(total_nwritten);
+    evaluate_block_conditions();
+    if (mtime_result.is_error())
+        return mtime_result;
+    return total_nwritten;
 }
 
 int InodeFile::ioctl(FileDescription& description, unsigned request, FlatPtr arg)
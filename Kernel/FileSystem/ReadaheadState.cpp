@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/ReadaheadState.h>
+
+namespace Kernel {
+
+void ReadaheadState::adjust_window_size()
+{
+    if (m_window_size == 0) {
+        m_window_size = minimum_window_size;
+        return;
+    }
+
+    auto total_bytes = m_hit_bytes + m_wasted_bytes;
+    if (total_bytes == 0)
+        return;
+
+    if (m_hit_bytes * 4 >= total_bytes * 3)
+        m_window_size = min(m_window_size * 2, maximum_window_size);
+    else if (m_hit_bytes * 2 < total_bytes)
+        m_window_size = max(m_window_size / 2, minimum_window_size);
+
+    // Let old history fade out so we adapt when the access pattern changes.
+    if (total_bytes > 4 * maximum_window_size) {
+        m_hit_bytes /= 2;
+        m_wasted_bytes /= 2;
+    }
+}
+
+Optional<ReadaheadState::Range> ReadaheadState::did_read(u64 offset, size_t size, u64 file_size)
+{
+    if (size == 0)
+        return {};
+
+    ScopedSpinLock lock(m_lock);
+    u64 end = offset + size;
+
+    if (offset < m_readahead_end && end > m_readahead_start)
+        m_hit_bytes += min(end, m_readahead_end) - max(offset, m_readahead_start);
+
+    bool is_sequential = offset <= m_next_offset && end > m_next_offset;
+    if (!is_sequential) {
+        // Anything we read ahead past the previous position is most likely never going to be used.
+        if (m_readahead_end > m_next_offset)
+            m_wasted_bytes += m_readahead_end - max(m_next_offset, m_readahead_start);
+        m_next_offset = end;
+        m_readahead_start = 0;
+        m_readahead_end = 0;
+        if (m_window_size != 0)
+            adjust_window_size();
+        return {};
+    }
+
+    m_next_offset = end;
+    if (end >= file_size)
+        return {};
+
+    // Only start the next batch once the reader has made its way through half of the
+    // previous one. This keeps the individual batches large.
+    if (m_readahead_end >= end + m_window_size / 2)
+        return {};
+
+    adjust_window_size();
+
+    Range range;
+    range.offset = max(end, m_readahead_end);
+    if (range.offset >= file_size)
+        return {};
+    range.size = min<u64>(m_window_size, file_size - range.offset);
+    m_readahead_start = range.offset;
+    m_readahead_end = range.offset + range.size;
+    return range;
+}
+
+}
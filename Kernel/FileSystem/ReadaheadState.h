@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <Kernel/SpinLock.h>
+
+namespace Kernel {
+
+// Detects sequential access patterns on a file (per FileDescription or InodeVMObject)
+// and decides how far ahead of the reader we should fetch data. The read-ahead window
+// grows while the data we fetch ahead of time actually gets read, and shrinks when the
+// reader jumps away and leaves it unused.
+class ReadaheadState {
+public:
+    static constexpr size_t minimum_window_size = 4 * PAGE_SIZE;
+    static constexpr size_t maximum_window_size = 64 * PAGE_SIZE;
+
+    struct Range {
+        u64 offset { 0 };
+        size_t size { 0 };
+    };
+
+    // Records a read of [offset, offset + size) and returns the range that should be read ahead, if any.
+    Optional<Range> did_read(u64 offset, size_t size, u64 file_size);
+
+    size_t window_size() const { return m_window_size; }
+
+private:
+    void adjust_window_size();
+
+    u64 m_next_offset { 0 };
+    u64 m_readahead_start { 0 };
+    u64 m_readahead_end { 0 };
+    u64 m_hit_bytes { 0 };
+    u64 m_wasted_bytes { 0 };
+    size_t m_window_size { 0 };
+    SpinLock<u8> m_lock;
+};
+
+}
@@ -15,6 +15,8 @@ class Custody;
 class Device;
 class DiskCache;
 class DoubleBuffer;
+class EventPoll;
+class EventPollWatch;
 class File;
 class FileDescription;
 class FutexQueue;
@@ -13,9 +13,11 @@
 #include <Kernel/CommandLine.h>
 #include <Kernel/ConsoleDevice.h>
 #include <Kernel/Devices/HID/HIDManagement.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Heap/SlabAllocator.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/Interrupts/GenericInterruptHandler.h>
 #include <Kernel/Interrupts/InterruptManagement.h>
@@ -28,6 +30,8 @@
 #include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Net/UDPSocket.h>
 #include <Kernel/ProcessExposed.h>
+#include <Kernel/VM/PhysicalRegion.h>
+#include <Kernel/Scheduler.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -362,6 +366,36 @@ private:
     }
 };
 
+class ProcFSDiskCache final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSDiskCache> must_create();
+
+private:
+    ProcFSDiskCache();
+    virtual bool output(KBufferBuilder& builder) override
+    {
+        JsonArraySerializer array { builder };
+        VFS::the().for_each_mount([&array](auto& mount) {
+            auto& fs = mount.guest_fs();
+            if (!fs.is_block_based())
+                return;
+            auto statistics = static_cast<const BlockBasedFS&>(fs).disk_cache_statistics();
+            auto fs_object = array.add_object();
+            fs_object.add("mount_point", mount.absolute_path());
+            fs_object.add("block_size", static_cast<u64>(fs.block_size()));
+            fs_object.add("entry_count", statistics.entry_count);
+            fs_object.add("capacity", statistics.capacity);
+            fs_object.add("dirty_count", statistics.dirty_count);
+            fs_object.add("hit_count", statistics.hit_count);
+            fs_object.add("miss_count", statistics.miss_count);
+            fs_object.add("eviction_count", statistics.eviction_count);
+            fs_object.add("writeback_count", statistics.writeback_count);
+        });
+        array.finish();
+        return true;
+    }
+};
+
 class ProcFSMemoryStatus final : public ProcFSGlobalInformation {
 public:
     static NonnullRefPtr<ProcFSMemoryStatus> must_create();
@@ -397,16 +431,98 @@ private:
         json.add("super_physical_available", super_physical_total - super_physical_used);
         json.add("kmalloc_call_count", stats.kmalloc_call_count);
         json.add("kfree_call_count", stats.kfree_call_count);
-        slab_alloc_stats([&json](size_t slab_size, size_t num_allocated, size_t num_free) {
-            auto prefix = String::formatted("slab_{}", slab_size);
-            json.add(String::formatted("{}_num_allocated", prefix), num_allocated);
-            json.add(String::formatted("{}_num_free", prefix), num_free);
+        slab_alloc_stats([&json](auto& slab_stats) {
+            auto prefix = String::formatted("slab_{}", slab_stats.slab_size);
+            json.add(String::formatted("{}_num_allocated", prefix), slab_stats.num_allocated);
+            json.add(String::formatted("{}_num_free", prefix), slab_stats.num_free);
         });
         json.finish();
         return true;
     }
 };
 
+class ProcFSKmalloc final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSKmalloc> must_create();
+
+private:
+    ProcFSKmalloc();
+    virtual bool output(KBufferBuilder& builder) override
+    {
+        JsonArraySerializer array { builder };
+        slab_alloc_stats([&array](auto& slab_stats) {
+            auto obj = array.add_object();
+            obj.add("slab_size", slab_stats.slab_size);
+            obj.add("slab_count", slab_stats.slab_count);
+            obj.add("num_allocated", slab_stats.num_allocated);
+            obj.add("num_free", slab_stats.num_free);
+            obj.add("num_cached", slab_stats.num_cached);
+            obj.add("alloc_count", slab_stats.alloc_count);
+            obj.add("dealloc_count", slab_stats.dealloc_count);
+            obj.add("magazine_refill_count", slab_stats.magazine_refill_count);
+            obj.add("magazine_flush_count", slab_stats.magazine_flush_count);
+            obj.add("exhausted_count", slab_stats.exhausted_count);
+        });
+        array.finish();
+        return true;
+    }
+};
+
+class ProcFSBuddyInfo final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSBuddyInfo> must_create();
+
+private:
+    ProcFSBuddyInfo();
+
+    struct RegionInfo {
+        bool supervisor;
+        PhysicalAddress lower;
+        PhysicalAddress upper;
+        size_t page_count;
+        size_t free_page_count;
+        size_t cached_page_count;
+        Optional<size_t> largest_free_order;
+        Array<size_t, PhysicalZone::max_order + 1> free_block_counts;
+    };
+
+    virtual bool output(KBufferBuilder& builder) override
+    {
+        Vector<RegionInfo> regions;
+        {
+            ScopedSpinLock mm_lock(s_mm_lock);
+            MM.for_each_physical_region([&](auto& region, bool supervisor) {
+                if (!region.size())
+                    return;
+                auto& zone = region.zone();
+                RegionInfo info { supervisor, region.lower(), region.upper(), region.size(), zone.free_page_count(), region.cached_page_count(), zone.largest_free_order(), {} };
+                for (size_t order = 0; order <= PhysicalZone::max_order; ++order)
+                    info.free_block_counts[order] = zone.free_block_count(order);
+                regions.append(info);
+            });
+        }
+
+        JsonArraySerializer array { builder };
+        for (auto& info : regions) {
+            auto obj = array.add_object();
+            obj.add("type", info.supervisor ? "supervisor" : "user");
+            obj.add("lower", info.lower.get());
+            obj.add("upper", info.upper.get());
+            obj.add("page_count", info.page_count);
+            obj.add("free_page_count", info.free_page_count);
+            obj.add("cached_page_count", info.cached_page_count);
+            if (info.largest_free_order.has_value())
+                obj.add("largest_free_order", info.largest_free_order.value());
+            auto free_blocks = obj.add_array("free_blocks");
+            for (auto count : info.free_block_counts)
+                free_blocks.add(count);
+            free_blocks.finish();
+        }
+        array.finish();
+        return true;
+    }
+};
+
 class ProcFSOverallProcesses final : public ProcFSGlobalInformation {
 public:
     static NonnullRefPtr<ProcFSOverallProcesses> must_create();
@@ -536,6 +652,26 @@ private:
         return true;
     }
 };
+class ProcFSScheduler final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSScheduler> must_create();
+
+private:
+    ProcFSScheduler();
+    virtual bool output(KBufferBuilder& builder) override
+    {
+        JsonArraySerializer array { builder };
+        Scheduler::for_each_ready_queue([&](auto& statistics) {
+            auto obj = array.add_object();
+            obj.add("processor", statistics.processor);
+            obj.add("queue_depth", statistics.depth);
+            obj.add("steal_count", statistics.steal_count);
+            obj.add("stolen_count", statistics.stolen_count);
+        });
+        array.finish();
+        return true;
+    }
+};
 class ProcFSDmesg final : public ProcFSGlobalInformation {
 public:
     static NonnullRefPtr<ProcFSDmesg> must_create();
@@ -716,10 +852,22 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSDiskUsage> ProcFSDiskUsage::must_create()
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSDiskUsage).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSDiskCache> ProcFSDiskCache::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSDiskCache).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSMemoryStatus> ProcFSMemoryStatus::must_create()
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSMemoryStatus).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSKmalloc> ProcFSKmalloc::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSKmalloc).release_nonnull();
+}
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSBuddyInfo> ProcFSBuddyInfo::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSBuddyInfo).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSOverallProcesses> ProcFSOverallProcesses::must_create()
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSOverallProcesses).release_nonnull();
@@ -728,6 +876,10 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSCPUInformation> ProcFSCPUInformation::must_
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSCPUInformation).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSScheduler> ProcFSScheduler::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSScheduler).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSDmesg> ProcFSDmesg::must_create()
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSDmesg).release_nonnull();
@@ -773,10 +925,22 @@ UNMAP_AFTER_INIT ProcFSDiskUsage::ProcFSDiskUsage()
     : ProcFSGlobalInformation("df"sv)
 {
 }
+UNMAP_AFTER_INIT ProcFSDiskCache::ProcFSDiskCache()
+    : ProcFSGlobalInformation("diskcache"sv)
+{
+}
 UNMAP_AFTER_INIT ProcFSMemoryStatus::ProcFSMemoryStatus()
     : ProcFSGlobalInformation("memstat"sv)
 {
 }
+UNMAP_AFTER_INIT ProcFSKmalloc::ProcFSKmalloc()
+    : ProcFSGlobalInformation("kmalloc"sv)
+{
+}
+UNMAP_AFTER_INIT ProcFSBuddyInfo::ProcFSBuddyInfo()
+    : ProcFSGlobalInformation("buddyinfo"sv)
+{
+}
 UNMAP_AFTER_INIT ProcFSOverallProcesses::ProcFSOverallProcesses()
     : ProcFSGlobalInformation("all"sv)
 {
@@ -785,6 +949,10 @@ UNMAP_AFTER_INIT ProcFSCPUInformation::ProcFSCPUInformation()
     : ProcFSGlobalInformation("cpuinfo"sv)
 {
 }
+UNMAP_AFTER_INIT ProcFSScheduler::ProcFSScheduler()
+    : ProcFSGlobalInformation("scheduler"sv)
+{
+}
 UNMAP_AFTER_INIT ProcFSDmesg::ProcFSDmesg()
     : ProcFSGlobalInformation("dmesg"sv)
 {
@@ -851,9 +1019,13 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSRootFolder> ProcFSRootFolder::must_create()
     auto folder = adopt_ref(*new (nothrow) ProcFSRootFolder);
     folder->m_components.append(ProcFSSelfProcessFolder::must_create());
     folder->m_components.append(ProcFSDiskUsage::must_create());
+    folder->m_components.append(ProcFSDiskCache::must_create());
     folder->m_components.append(ProcFSMemoryStatus::must_create());
+    folder->m_components.append(ProcFSKmalloc::must_create());
+    folder->m_components.append(ProcFSBuddyInfo::must_create());
     folder->m_components.append(ProcFSOverallProcesses::must_create());
     folder->m_components.append(ProcFSCPUInformation::must_create());
+    folder->m_components.append(ProcFSScheduler::must_create());
     folder->m_components.append(ProcFSDmesg::must_create());
     folder->m_components.append(ProcFSInterrupts::must_create());
     folder->m_components.append(ProcFSKeymap::must_create());
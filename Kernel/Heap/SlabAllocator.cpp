@@ -6,6 +6,7 @@
 
 #include <AK/Assertions.h>
 #include <AK/Memory.h>
+#include <Kernel/Arch/x86/InterruptDisabler.h>
 #include <Kernel/Heap/SlabAllocator.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/Sections.h>
@@ -16,15 +17,21 @@
 
 namespace Kernel {
 
+// Every processor keeps a magazine of free slabs for each size class, so most allocations and frees
+// never touch shared state. When a magazine runs empty (or full), half of it is refilled from (or
+// flushed to) the size class' shared freelist in one go, so a processor that alternates between
+// allocating and freeing doesn't bounce on the shared lock.
+static constexpr size_t magazine_capacity = 32;
+
 template<size_t templated_slab_size>
 class SlabAllocator {
 public:
     SlabAllocator() = default;
 
-    void init(size_t size)
+    void init(u8* base, size_t size)
     {
-        m_base = kmalloc_eternal(size);
-        m_end = (u8*)m_base + size;
+        m_base = base;
+        m_end = base + size;
         FreeSlab* slabs = (FreeSlab*)m_base;
         m_slab_count = size / templated_slab_size;
         for (size_t i = 1; i < m_slab_count; ++i) {
@@ -32,31 +39,29 @@ public:
         }
         slabs[0].next = nullptr;
         m_freelist = &slabs[m_slab_count - 1];
-        m_num_allocated = 0;
+        m_freelist_count = m_slab_count;
     }
 
     constexpr size_t slab_size() const { return templated_slab_size; }
     size_t slab_count() const { return m_slab_count; }
 
+    bool owns(const void* ptr) const { return ptr >= m_base && ptr < m_end; }
+    const void* end() const { return m_end; }
+
     void* alloc()
     {
         FreeSlab* free_slab;
         {
-            // We want to avoid being swapped out in the middle of this
-            ScopedCritical critical;
-            FreeSlab* next_free;
-            free_slab = m_freelist.load(AK::memory_order_consume);
-            do {
-                if (!free_slab)
-                    return kmalloc(slab_size());
-                // It's possible another processor is doing the same thing at
-                // the same time, so next_free *can* be a bogus pointer. However,
-                // in that case compare_exchange_strong would fail and we would
-                // try again.
-                next_free = free_slab->next;
-            } while (!m_freelist.compare_exchange_strong(free_slab, next_free, AK::memory_order_acq_rel));
-
-            m_num_allocated++;
+            // Interrupt handlers allocate too, so keep them away from this processor's magazine while we're using it.
+            // This also keeps us from being moved to another processor.
+            InterruptDisabler disabler;
+            auto& magazine = m_magazines[Processor::id()];
+            if (magazine.count == 0 && !refill(magazine)) {
+                ++magazine.exhausted_count;
+                return nullptr;
+            }
+            free_slab = magazine.rounds[--magazine.count];
+            ++magazine.alloc_count;
         }
 
 #ifdef SANITIZE_SLABS
@@ -67,29 +72,40 @@ public:
 
     void dealloc(void* ptr)
     {
-        VERIFY(ptr);
-        if (ptr < m_base || ptr >= m_end) {
-            kfree(ptr);
-            return;
-        }
-        FreeSlab* free_slab = (FreeSlab*)ptr;
+        VERIFY(owns(ptr));
+        VERIFY(((FlatPtr)ptr - (FlatPtr)m_base) % slab_size() == 0);
 #ifdef SANITIZE_SLABS
-        if (slab_size() > sizeof(FreeSlab*))
-            memset(free_slab->padding, SLAB_DEALLOC_SCRUB_BYTE, sizeof(FreeSlab::padding));
+        memset(ptr, SLAB_DEALLOC_SCRUB_BYTE, slab_size());
 #endif
 
-        // We want to avoid being swapped out in the middle of this
-        ScopedCritical critical;
-        FreeSlab* next_free = m_freelist.load(AK::memory_order_consume);
-        do {
-            free_slab->next = next_free;
-        } while (!m_freelist.compare_exchange_strong(next_free, free_slab, AK::memory_order_acq_rel));
-
-        m_num_allocated--;
+        InterruptDisabler disabler;
+        auto& magazine = m_magazines[Processor::id()];
+        if (magazine.count == magazine_capacity)
+            flush(magazine);
+        magazine.rounds[magazine.count++] = (FreeSlab*)ptr;
+        ++magazine.dealloc_count;
     }
 
-    size_t num_allocated() const { return m_num_allocated; }
-    size_t num_free() const { return m_slab_count - m_num_allocated; }
+    SlabAllocatorStats stats()
+    {
+        SlabAllocatorStats stats;
+        stats.slab_size = slab_size();
+        stats.slab_count = m_slab_count;
+        for (auto& magazine : m_magazines) {
+            stats.num_cached += magazine.count;
+            stats.alloc_count += magazine.alloc_count;
+            stats.dealloc_count += magazine.dealloc_count;
+            stats.magazine_refill_count += magazine.refill_count;
+            stats.magazine_flush_count += magazine.flush_count;
+            stats.exhausted_count += magazine.exhausted_count;
+        }
+        {
+            ScopedSpinLock lock(m_lock);
+            stats.num_free = m_freelist_count + stats.num_cached;
+        }
+        stats.num_allocated = m_slab_count - min(stats.num_free, m_slab_count);
+        return stats;
+    }
 
 private:
     struct FreeSlab {
@@ -97,80 +113,217 @@ private:
         char padding[templated_slab_size - sizeof(FreeSlab*)];
     };
 
-    Atomic<FreeSlab*> m_freelist { nullptr };
-    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> m_num_allocated;
-    size_t m_slab_count;
-    void* m_base { nullptr };
-    void* m_end { nullptr };
+    struct Magazine {
+        size_t count { 0 };
+        FreeSlab* rounds[magazine_capacity];
+        u64 alloc_count { 0 };
+        u64 dealloc_count { 0 };
+        u64 refill_count { 0 };
+        u64 flush_count { 0 };
+        u64 exhausted_count { 0 };
+    };
+
+    bool refill(Magazine& magazine)
+    {
+        ScopedSpinLock lock(m_lock);
+        while (m_freelist && magazine.count < magazine_capacity / 2) {
+            magazine.rounds[magazine.count++] = m_freelist;
+            m_freelist = m_freelist->next;
+            --m_freelist_count;
+        }
+        ++magazine.refill_count;
+        return magazine.count != 0;
+    }
+
+    void flush(Magazine& magazine)
+    {
+        ScopedSpinLock lock(m_lock);
+        while (magazine.count > magazine_capacity / 2) {
+            auto* free_slab = magazine.rounds[--magazine.count];
+            free_slab->next = m_freelist;
+            m_freelist = free_slab;
+            ++m_freelist_count;
+        }
+        ++magazine.flush_count;
+    }
+
+    Magazine m_magazines[max_processor_count];
+
+    SpinLock<u8> m_lock;
+    FreeSlab* m_freelist { nullptr };
+    size_t m_freelist_count { 0 };
+
+    size_t m_slab_count { 0 };
+    u8* m_base { nullptr };
+    u8* m_end { nullptr };
 
     static_assert(sizeof(FreeSlab) == templated_slab_size);
 };
 
 static SlabAllocator<16> s_slab_allocator_16;
 static SlabAllocator<32> s_slab_allocator_32;
+static SlabAllocator<48> s_slab_allocator_48;
 static SlabAllocator<64> s_slab_allocator_64;
+static SlabAllocator<96> s_slab_allocator_96;
 static SlabAllocator<128> s_slab_allocator_128;
+static SlabAllocator<192> s_slab_allocator_192;
 static SlabAllocator<256> s_slab_allocator_256;
+static SlabAllocator<384> s_slab_allocator_384;
+static SlabAllocator<512> s_slab_allocator_512;
+
+static_assert(max_slab_size == s_slab_allocator_512.slab_size());
 
 #if ARCH(I386)
 static_assert(sizeof(Region) <= s_slab_allocator_128.slab_size());
 #endif
 
+// All slabs live in one contiguous arena, in the order of the allocators above,
+// so kfree() can tell whether a pointer belongs to a slab with a single range check.
+static constexpr size_t slab_arena_size = 2304 * KiB;
+READONLY_AFTER_INIT static u8* s_slab_arena_start;
+READONLY_AFTER_INIT static u8* s_slab_arena_end;
+
 template<typename Callback>
 void for_each_allocator(Callback callback)
 {
     callback(s_slab_allocator_16);
     callback(s_slab_allocator_32);
+    callback(s_slab_allocator_48);
     callback(s_slab_allocator_64);
+    callback(s_slab_allocator_96);
     callback(s_slab_allocator_128);
+    callback(s_slab_allocator_192);
     callback(s_slab_allocator_256);
+    callback(s_slab_allocator_384);
+    callback(s_slab_allocator_512);
+}
+
+template<typename Callback>
+static ALWAYS_INLINE decltype(auto) with_allocator_for_size(size_t size, Callback callback)
+{
+    if (size <= 16)
+        return callback(s_slab_allocator_16);
+    if (size <= 32)
+        return callback(s_slab_allocator_32);
+    if (size <= 48)
+        return callback(s_slab_allocator_48);
+    if (size <= 64)
+        return callback(s_slab_allocator_64);
+    if (size <= 96)
+        return callback(s_slab_allocator_96);
+    if (size <= 128)
+        return callback(s_slab_allocator_128);
+    if (size <= 192)
+        return callback(s_slab_allocator_192);
+    if (size <= 256)
+        return callback(s_slab_allocator_256);
+    if (size <= 384)
+        return callback(s_slab_allocator_384);
+    if (size <= 512)
+        return callback(s_slab_allocator_512);
+    VERIFY_NOT_REACHED();
+}
+
+template<typename Callback>
+static ALWAYS_INLINE decltype(auto) with_allocator_for_pointer(const void* ptr, Callback callback)
+{
+    VERIFY(slab_owns(ptr));
+    if (ptr < s_slab_allocator_16.end())
+        return callback(s_slab_allocator_16);
+    if (ptr < s_slab_allocator_32.end())
+        return callback(s_slab_allocator_32);
+    if (ptr < s_slab_allocator_48.end())
+        return callback(s_slab_allocator_48);
+    if (ptr < s_slab_allocator_64.end())
+        return callback(s_slab_allocator_64);
+    if (ptr < s_slab_allocator_96.end())
+        return callback(s_slab_allocator_96);
+    if (ptr < s_slab_allocator_128.end())
+        return callback(s_slab_allocator_128);
+    if (ptr < s_slab_allocator_192.end())
+        return callback(s_slab_allocator_192);
+    if (ptr < s_slab_allocator_256.end())
+        return callback(s_slab_allocator_256);
+    if (ptr < s_slab_allocator_384.end())
+        return callback(s_slab_allocator_384);
+    return callback(s_slab_allocator_512);
 }
 
 UNMAP_AFTER_INIT void slab_alloc_init()
 {
-    s_slab_allocator_16.init(128 * KiB);
-    s_slab_allocator_32.init(128 * KiB);
-    s_slab_allocator_64.init(512 * KiB);
-    s_slab_allocator_128.init(512 * KiB);
-    s_slab_allocator_256.init(128 * KiB);
+    // Align the arena to a cache line, so that no slab of 64 bytes or more straddles one.
+    constexpr size_t arena_alignment = 64;
+    auto* arena = (u8*)kmalloc_eternal(slab_arena_size + arena_alignment);
+    arena = (u8*)round_up_to_power_of_two((FlatPtr)arena, arena_alignment);
+
+    s_slab_arena_start = arena;
+    auto init = [&](auto& allocator, size_t size) {
+        allocator.init(arena, size);
+        arena += size;
+    };
+    init(s_slab_allocator_16, 128 * KiB);
+    init(s_slab_allocator_32, 256 * KiB);
+    init(s_slab_allocator_48, 128 * KiB);
+    init(s_slab_allocator_64, 512 * KiB);
+    init(s_slab_allocator_96, 128 * KiB);
+    init(s_slab_allocator_128, 512 * KiB);
+    init(s_slab_allocator_192, 128 * KiB);
+    init(s_slab_allocator_256, 256 * KiB);
+    init(s_slab_allocator_384, 128 * KiB);
+    init(s_slab_allocator_512, 128 * KiB);
+    s_slab_arena_end = arena;
+    VERIFY(s_slab_arena_end == s_slab_arena_start + slab_arena_size);
+}
+
+void* slab_try_alloc(size_t size)
+{
+    if (size > max_slab_size || !s_slab_arena_start)
+        return nullptr;
+    return with_allocator_for_size(size, [](auto& allocator) { return allocator.alloc(); });
 }
 
 void* slab_alloc(size_t slab_size)
 {
-    if (slab_size <= 16)
-        return s_slab_allocator_16.alloc();
-    if (slab_size <= 32)
-        return s_slab_allocator_32.alloc();
-    if (slab_size <= 64)
-        return s_slab_allocator_64.alloc();
-    if (slab_size <= 128)
-        return s_slab_allocator_128.alloc();
-    if (slab_size <= 256)
-        return s_slab_allocator_256.alloc();
-    VERIFY_NOT_REACHED();
+    if (auto* ptr = slab_try_alloc(slab_size))
+        return ptr;
+    return kmalloc(slab_size);
 }
 
-void slab_dealloc(void* ptr, size_t slab_size)
+bool slab_owns(const void* ptr)
 {
-    if (slab_size <= 16)
-        return s_slab_allocator_16.dealloc(ptr);
-    if (slab_size <= 32)
-        return s_slab_allocator_32.dealloc(ptr);
-    if (slab_size <= 64)
-        return s_slab_allocator_64.dealloc(ptr);
-    if (slab_size <= 128)
-        return s_slab_allocator_128.dealloc(ptr);
-    if (slab_size <= 256)
-        return s_slab_allocator_256.dealloc(ptr);
-    VERIFY_NOT_REACHED();
+    return ptr >= s_slab_arena_start && ptr < s_slab_arena_end;
+}
+
+size_t slab_size_of(const void* ptr)
+{
+    return with_allocator_for_pointer(ptr, [](auto& allocator) { return allocator.slab_size(); });
+}
+
+void slab_dealloc(void* ptr)
+{
+    with_allocator_for_pointer(ptr, [&](auto& allocator) { allocator.dealloc(ptr); });
+}
+
+void slab_dealloc(void* ptr, size_t)
+{
+    if (!slab_owns(ptr)) {
+        kfree(ptr);
+        return;
+    }
+    slab_dealloc(ptr);
+}
+
+size_t slab_good_size(size_t size)
+{
+    if (size > max_slab_size)
+        return size;
+    return with_allocator_for_size(size, [](auto& allocator) { return allocator.slab_size(); });
 }
 
-void slab_alloc_stats(Function<void(size_t slab_size, size_t allocated, size_t free)> callback)
+void slab_alloc_stats(Function<void(const SlabAllocatorStats&)> callback)
 {
     for_each_allocator([&](auto& allocator) {
-        auto num_allocated = allocator.num_allocated();
-        auto num_free = allocator.slab_count() - num_allocated;
-        callback(allocator.slab_size(), num_allocated, num_free);
+        callback(allocator.stats());
     });
 }
 
@@ -14,10 +14,37 @@ namespace Kernel {
 #define SLAB_ALLOC_SCRUB_BYTE 0xab
 #define SLAB_DEALLOC_SCRUB_BYTE 0xbc
 
+// kmalloc() serves every allocation up to this size from the slab allocators, as long as they have room.
+constexpr size_t max_slab_size = 512;
+
+struct SlabAllocatorStats {
+    size_t slab_size { 0 };
+    size_t slab_count { 0 };
+    size_t num_allocated { 0 };
+    size_t num_free { 0 };
+    // How many of the free slabs are sitting in per-processor magazines.
+    size_t num_cached { 0 };
+    u64 alloc_count { 0 };
+    u64 dealloc_count { 0 };
+    u64 magazine_refill_count { 0 };
+    u64 magazine_flush_count { 0 };
+    // Allocations that found the size class empty and went to the kmalloc heap instead.
+    u64 exhausted_count { 0 };
+};
+
 void* slab_alloc(size_t slab_size);
 void slab_dealloc(void*, size_t slab_size);
 void slab_alloc_init();
-void slab_alloc_stats(Function<void(size_t slab_size, size_t allocated, size_t free)>);
+void slab_alloc_stats(Function<void(const SlabAllocatorStats&)>);
+
+// These let kmalloc() and friends put small allocations into slabs.
+// slab_try_alloc() returns null if the size is too large for a slab, or its size class has run out.
+void* slab_try_alloc(size_t);
+bool slab_owns(const void*);
+// Only valid for pointers that slab_owns().
+size_t slab_size_of(const void*);
+void slab_dealloc(void*);
+size_t slab_good_size(size_t);
 
 #define MAKE_SLAB_ALLOCATED(type)                                            \
 public:                                                                      \
@@ -14,6 +14,7 @@
 #include <AK/Types.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
+#include <Kernel/Heap/SlabAllocator.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Panic.h>
@@ -27,7 +28,7 @@
 
 #define CHUNK_SIZE 32
 #define POOL_SIZE (2 * MiB)
-#define ETERNAL_RANGE_SIZE (3 * MiB)
+#define ETERNAL_RANGE_SIZE (4 * MiB)
 
 namespace std {
 const nothrow_t nothrow;
@@ -245,28 +246,49 @@ void* kmalloc_eternal(size_t size)
     return ptr;
 }
 
+static void add_kmalloc_perf_event(size_t size, void* ptr)
+{
+    Thread* current_thread = Thread::current();
+    if (!current_thread)
+        current_thread = Processor::idle_thread();
+    if (current_thread)
+        PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
+}
+
+static void add_kfree_perf_event(void* ptr)
+{
+    Thread* current_thread = Thread::current();
+    if (!current_thread)
+        current_thread = Processor::idle_thread();
+    if (current_thread)
+        PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
+}
+
 void* kmalloc(size_t size)
 {
     kmalloc_verify_nospinlock_held();
-    ScopedSpinLock lock(s_lock);
-    ++g_kmalloc_call_count;
 
     if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
+        ScopedSpinLock lock(s_lock);
         dbgln("kmalloc({})", size);
         Kernel::dump_backtrace();
     }
 
+    // Small allocations come out of the slab allocators, which usually don't need to take any lock.
+    if (void* ptr = slab_try_alloc(size)) {
+        add_kmalloc_perf_event(size, ptr);
+        return ptr;
+    }
+
+    ScopedSpinLock lock(s_lock);
+    ++g_kmalloc_call_count;
+
     void* ptr = g_kmalloc_global->m_heap.allocate(size);
     if (!ptr) {
         PANIC("kmalloc: Out of memory (requested size: {})", size);
     }
 
-    Thread* current_thread = Thread::current();
-    if (!current_thread)
-        current_thread = Processor::idle_thread();
-    if (current_thread)
-        PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
-
+    add_kmalloc_perf_event(size, ptr);
     return ptr;
 }
 
@@ -276,17 +298,19 @@ void kfree(void* ptr)
         return;
 
     kmalloc_verify_nospinlock_held();
+
+    if (slab_owns(ptr)) {
+        add_kfree_perf_event(ptr);
+        slab_dealloc(ptr);
+        return;
+    }
+
     ScopedSpinLock lock(s_lock);
     ++g_kfree_call_count;
     ++g_nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
-        Thread* current_thread = Thread::current();
-        if (!current_thread)
-            current_thread = Processor::idle_thread();
-        if (current_thread)
-            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
-    }
+    if (g_nested_kfree_calls == 1)
+        add_kfree_perf_event(ptr);
 
     g_kmalloc_global->m_heap.deallocate(ptr);
     --g_nested_kfree_calls;
@@ -295,13 +319,24 @@ void kfree(void* ptr)
 void* krealloc(void* ptr, size_t new_size)
 {
     kmalloc_verify_nospinlock_held();
+
+    if (slab_owns(ptr)) {
+        auto old_size = slab_size_of(ptr);
+        if (new_size <= old_size)
+            return ptr;
+        void* new_ptr = kmalloc(new_size);
+        memcpy(new_ptr, ptr, old_size);
+        kfree(ptr);
+        return new_ptr;
+    }
+
     ScopedSpinLock lock(s_lock);
     return g_kmalloc_global->m_heap.reallocate(ptr, new_size);
 }
 
 size_t kmalloc_good_size(size_t size)
 {
-    return size;
+    return slab_good_size(size);
 }
 
 void* operator new(size_t size)
@@ -356,4 +391,10 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_eternal = g_kmalloc_bytes_eternal;
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+    lock.unlock();
+
+    slab_alloc_stats([&](auto& slab_stats) {
+        stats.kmalloc_call_count += slab_stats.alloc_count;
+        stats.kfree_call_count += slab_stats.dealloc_count;
+    });
 }
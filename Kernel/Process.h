@@ -315,6 +315,12 @@ public:
     KResultOr<FlatPtr> sys$purge(int mode);
     KResultOr<FlatPtr> sys$select(Userspace<const Syscall::SC_select_params*>);
     KResultOr<FlatPtr> sys$poll(Userspace<const Syscall::SC_poll_params*>);
+    KResultOr<FlatPtr> sys$epoll_create1(int flags);
+    KResultOr<FlatPtr> sys$epoll_ctl(Userspace<const Syscall::SC_epoll_ctl_params*>);
+    KResultOr<FlatPtr> sys$epoll_pwait(Userspace<const Syscall::SC_epoll_pwait_params*>);
+    KResultOr<FlatPtr> sys$sendfile(Userspace<const Syscall::SC_sendfile_params*>);
+    KResultOr<FlatPtr> sys$preadv(Userspace<const Syscall::SC_preadv_params*>);
+    KResultOr<FlatPtr> sys$pwritev(Userspace<const Syscall::SC_pwritev_params*>);
     KResultOr<FlatPtr> sys$get_dir_entries(int fd, Userspace<void*>, size_t);
     KResultOr<FlatPtr> sys$getcwd(Userspace<char*>, size_t);
     KResultOr<FlatPtr> sys$chdir(Userspace<const char*>, size_t);
@@ -527,6 +533,7 @@ private:
 
     KResult do_exec(NonnullRefPtr<FileDescription> main_program_description, Vector<String> arguments, Vector<String> environment, RefPtr<FileDescription> interpreter_description, Thread*& new_main_thread, u32& prev_flags, const ElfW(Ehdr) & main_program_header);
     KResultOr<FlatPtr> do_write(FileDescription&, const UserOrKernelBuffer&, size_t);
+    KResult copy_io_vectors_from_user(Vector<FileIOVector, 32>&, Userspace<const struct iovec*>, int iov_count);
 
     KResultOr<FlatPtr> do_statvfs(String path, statvfs* buf);
 
@@ -52,16 +52,60 @@ READONLY_AFTER_INIT static Process* s_colonel_process;
 struct ThreadReadyQueue {
     IntrusiveList<Thread, RawPtr<Thread>, &Thread::m_ready_queue_node> thread_list;
 };
-static SpinLock<u8> g_ready_queues_lock;
-static u32 g_ready_queues_mask;
-static constexpr u32 g_ready_queue_buckets = sizeof(g_ready_queues_mask) * 8;
-READONLY_AFTER_INIT static ThreadReadyQueue* g_ready_queues; // g_ready_queue_buckets entries
+static constexpr u32 g_ready_queue_buckets = sizeof(u32) * 8;
+
+// Every processor owns a set of priority-bucketed ready queues, each set guarded by
+// its own lock. A processor picks threads from its own queues without taking
+// g_scheduler_lock, which keeps threads on the processor whose caches they have warmed
+// up and keeps processors from contending over a single lock. Only once its own queues
+// are empty does it take work from another processor; moving a thread between
+// processors like that happens under g_scheduler_lock.
+class ThreadReadyQueues {
+    AK_MAKE_NONCOPYABLE(ThreadReadyQueues);
+    AK_MAKE_NONMOVABLE(ThreadReadyQueues);
+
+public:
+    ThreadReadyQueues() = default;
+
+    u32 depth() const { return m_depth.load(AK::MemoryOrder::memory_order_relaxed); }
+    u32 priority_mask() const { return m_mask.load(AK::MemoryOrder::memory_order_relaxed); }
+
+    Thread* pull_next(u32 for_cpu);
+    void enqueue(Thread&, u32 priority, u32 cpu);
+    bool dequeue(Thread&);
+
+    // Where the owning processor starts looking for work to steal. Only used by that processor, with g_scheduler_lock held.
+    u32 next_steal_offset() { return m_steal_offset++; }
+
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> steal_count { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> stolen_count { 0 };
+
+private:
+    void remove_locked(Thread&);
+
+    SpinLock<u8> m_lock;
+    // These are only atomic so that other processors can look at them without taking m_lock.
+    Atomic<u32, AK::MemoryOrder::memory_order_relaxed> m_mask { 0 };
+    Atomic<u32, AK::MemoryOrder::memory_order_relaxed> m_depth { 0 };
+    ThreadReadyQueue m_queues[g_ready_queue_buckets];
+    u32 m_steal_offset { 0 };
+};
+
+READONLY_AFTER_INIT static ThreadReadyQueues* g_ready_queues; // max_processor_count entries
+
+// Only queue a thread on a processor other than the one it last ran on if that one has at least
+// this many fewer runnable threads. This keeps threads from ping-ponging between processors.
+static constexpr u32 g_load_balance_threshold = 2;
+
+// How many other processors' queues a processor that ran out of work tries to take a thread from.
+static constexpr u32 g_steal_attempts = 2;
+
 static void dump_thread_list();
 
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into the ready queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -70,26 +114,36 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static inline u32 scheduling_processors_mask()
 {
-    auto affinity_mask = 1u << Processor::current().id();
+#if SCHEDULE_ON_ALL_PROCESSORS
+    auto count = min(Processor::count(), max_processor_count);
+    if (count >= 32)
+        return 0xffffffff;
+    return (1u << count) - 1;
+#else
+    // Only the bootstrap processor picks threads to run.
+    return 1u;
+#endif
+}
 
-    ScopedSpinLock lock(g_ready_queues_lock);
-    auto priority_mask = g_ready_queues_mask;
+Thread* ThreadReadyQueues::pull_next(u32 for_cpu)
+{
+    auto affinity_mask = 1u << for_cpu;
+
+    ScopedSpinLock lock(m_lock);
+    auto priority_mask = m_mask.load();
     while (priority_mask != 0) {
         auto priority = __builtin_ffsl(priority_mask);
         VERIFY(priority > 0);
-        auto& ready_queue = g_ready_queues[--priority];
+        auto& ready_queue = m_queues[--priority];
         for (auto& thread : ready_queue.thread_list) {
             VERIFY(thread.m_runnable_priority == (int)priority);
             if (thread.is_active())
                 continue;
             if (!(thread.affinity() & affinity_mask))
                 continue;
-            thread.m_runnable_priority = -1;
-            ready_queue.thread_list.remove(thread);
-            if (ready_queue.thread_list.is_empty())
-                g_ready_queues_mask &= ~(1u << priority);
+            remove_locked(thread);
             // Mark it as active because we are using this thread. This is similar
             // to comparing it with Processor::current_thread, but when there are
             // multiple processors there's no easy way to check whether the thread
@@ -101,34 +155,153 @@ Thread& Scheduler::pull_next_runnable_thread()
             // switching to it.
             // FIXME: Figure out a better way maybe?
             thread.set_active(true);
-            return thread;
+            return &thread;
         }
         priority_mask &= ~(1u << priority);
     }
+    return nullptr;
+}
+
+void ThreadReadyQueues::enqueue(Thread& thread, u32 priority, u32 cpu)
+{
+    ScopedSpinLock lock(m_lock);
+    VERIFY(thread.m_runnable_priority < 0);
+    thread.m_runnable_priority = (int)priority;
+    thread.m_runnable_cpu = cpu;
+    VERIFY(!thread.m_ready_queue_node.is_in_list());
+    auto& ready_queue = m_queues[priority];
+    bool was_empty = ready_queue.thread_list.is_empty();
+    ready_queue.thread_list.append(thread);
+    if (was_empty)
+        m_mask.fetch_or(1u << priority);
+    m_depth.fetch_add(1);
+}
+
+bool ThreadReadyQueues::dequeue(Thread& thread)
+{
+    ScopedSpinLock lock(m_lock);
+    if (thread.m_runnable_priority < 0) {
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        return false;
+    }
+    remove_locked(thread);
+    return true;
+}
+
+void ThreadReadyQueues::remove_locked(Thread& thread)
+{
+    VERIFY(m_lock.is_locked());
+    auto priority = thread.m_runnable_priority;
+    VERIFY(priority >= 0);
+    VERIFY(m_mask.load() & (1u << priority));
+    auto& ready_queue = m_queues[priority];
+    thread.m_runnable_priority = -1;
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty())
+        m_mask.fetch_and(~(1u << priority));
+    VERIFY(m_depth.load() > 0);
+    m_depth.fetch_sub(1);
+}
+
+// Takes a thread that may run on `cpu` from another processor. Rather than looking for the busiest
+// processor, this only tries the first few that have anything queued, starting at a different one
+// every time so that the same processor isn't always the one that gets robbed.
+static Thread* steal_runnable_thread(u32 cpu)
+{
+    VERIFY(g_scheduler_lock.own_lock());
+    u32 processor_count = min(Processor::count(), max_processor_count);
+    if (processor_count < 2)
+        return nullptr;
+
+    auto& local_queues = g_ready_queues[cpu];
+    auto offset = local_queues.next_steal_offset();
+    u32 attempts = 0;
+    for (u32 i = 0; i < processor_count - 1 && attempts < g_steal_attempts; i++) {
+        auto victim_cpu = (cpu + 1 + (offset + i) % (processor_count - 1)) % processor_count;
+        auto& victim_queues = g_ready_queues[victim_cpu];
+        if (victim_queues.depth() == 0)
+            continue;
+        attempts++;
+        if (auto* thread = victim_queues.pull_next(cpu)) {
+            victim_queues.stolen_count++;
+            local_queues.steal_count++;
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", cpu, *thread, victim_cpu);
+            return thread;
+        }
+    }
+    return nullptr;
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    VERIFY(g_scheduler_lock.own_lock());
+    auto cpu = Processor::current().id();
+    if (auto* thread = g_ready_queues[cpu].pull_next(cpu))
+        return *thread;
+
+    // Nothing (eligible) on our own queues, see if anyone else has work for us.
+    if (auto* thread = steal_runnable_thread(cpu))
+        return *thread;
+
     return *Processor::idle_thread();
 }
 
+// A thread taken off our queues before we held g_scheduler_lock may have been stopped or killed
+// in the meantime. Whoever makes it runnable again will queue it again, so just let go of it.
+static bool is_still_runnable(Thread& thread)
+{
+    VERIFY(g_scheduler_lock.own_lock());
+    if (thread.state() == Thread::Runnable)
+        return true;
+    thread.set_active(false);
+    if (thread.state() == Thread::Dying && thread.is_finalizable())
+        Scheduler::notify_finalizer();
+    return false;
+}
+
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
 {
     if (thread.is_idle_thread())
         return true;
-    ScopedSpinLock lock(g_ready_queues_lock);
-    auto priority = thread.m_runnable_priority;
-    if (priority < 0) {
-        VERIFY(!thread.m_ready_queue_node.is_in_list());
-        return false;
-    }
 
     if (check_affinity && !(thread.affinity() & (1 << Processor::current().id())))
         return false;
 
-    VERIFY(g_ready_queues_mask & (1u << priority));
-    auto& ready_queue = g_ready_queues[priority];
-    thread.m_runnable_priority = -1;
-    ready_queue.thread_list.remove(thread);
-    if (ready_queue.thread_list.is_empty())
-        g_ready_queues_mask &= ~(1u << priority);
-    return true;
+    // NOTE: m_runnable_cpu only changes when a thread is queued, which is done while
+    //       holding g_scheduler_lock, so it can't change under us here.
+    VERIFY(thread.m_runnable_cpu < max_processor_count);
+    return g_ready_queues[thread.m_runnable_cpu].dequeue(thread);
+}
+
+static u32 select_ready_queue_for(const Thread& thread)
+{
+    auto eligible_mask = thread.affinity() & scheduling_processors_mask();
+    if (eligible_mask == 0) {
+        // Nobody that is currently scheduling can run this thread; park it on the
+        // first processor it has an affinity for.
+        auto affinity = thread.affinity();
+        VERIFY(affinity != 0);
+        return min((u32)__builtin_ffsl(affinity) - 1, max_processor_count - 1);
+    }
+
+    // Prefer the processor the thread last ran on to keep its caches warm, unless
+    // another processor it may run on has a considerably shorter queue.
+    u32 preferred_cpu = thread.cpu();
+    if (preferred_cpu >= max_processor_count || !(eligible_mask & (1u << preferred_cpu)))
+        preferred_cpu = __builtin_ffsl(eligible_mask) - 1;
+
+    u32 selected_cpu = preferred_cpu;
+    u32 selected_depth = g_ready_queues[preferred_cpu].depth();
+    for (u32 cpu = 0; cpu < max_processor_count; cpu++) {
+        if (!(eligible_mask & (1u << cpu)) || cpu == preferred_cpu)
+            continue;
+        auto depth = g_ready_queues[cpu].depth();
+        if (depth + g_load_balance_threshold <= selected_depth) {
+            selected_cpu = cpu;
+            selected_depth = depth;
+        }
+    }
+    return selected_cpu;
 }
 
 void Scheduler::queue_runnable_thread(Thread& thread)
@@ -137,16 +310,22 @@ void Scheduler::queue_runnable_thread(Thread& thread)
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    auto cpu = select_ready_queue_for(thread);
+    g_ready_queues[cpu].enqueue(thread, priority, cpu);
+}
 
-    ScopedSpinLock lock(g_ready_queues_lock);
-    VERIFY(thread.m_runnable_priority < 0);
-    thread.m_runnable_priority = (int)priority;
-    VERIFY(!thread.m_ready_queue_node.is_in_list());
-    auto& ready_queue = g_ready_queues[priority];
-    bool was_empty = ready_queue.thread_list.is_empty();
-    ready_queue.thread_list.append(thread);
-    if (was_empty)
-        g_ready_queues_mask |= (1u << priority);
+void Scheduler::for_each_ready_queue(Function<void(const ReadyQueueStatistics&)> callback)
+{
+    for (u32 cpu = 0; cpu < min(Processor::count(), max_processor_count); cpu++) {
+        auto& queues = g_ready_queues[cpu];
+        ReadyQueueStatistics statistics {
+            .processor = cpu,
+            .depth = queues.depth(),
+            .steal_count = queues.steal_count.load(),
+            .stolen_count = queues.stolen_count.load(),
+        };
+        callback(statistics);
+    }
 }
 
 UNMAP_AFTER_INIT void Scheduler::start()
@@ -191,6 +370,10 @@ bool Scheduler::pick_next()
             scheduler_data.m_in_scheduler = false;
         });
 
+    // Picking a thread from our own queues doesn't need g_scheduler_lock, only switching to it does.
+    auto cpu = Processor::current().id();
+    auto* thread_to_schedule = g_ready_queues[cpu].pull_next(cpu);
+
     ScopedSpinLock lock(g_scheduler_lock);
 
     auto current_thread = Thread::current();
@@ -204,13 +387,16 @@ bool Scheduler::pick_next()
         dump_thread_list();
     }
 
-    auto& thread_to_schedule = pull_next_runnable_thread();
+    if (thread_to_schedule && !is_still_runnable(*thread_to_schedule))
+        thread_to_schedule = nullptr;
+    if (!thread_to_schedule)
+        thread_to_schedule = &pull_next_runnable_thread();
     if constexpr (SCHEDULER_DEBUG) {
 #if ARCH(I386)
         dbgln("Scheduler[{}]: Switch to {} @ {:04x}:{:08x}",
             Processor::id(),
-            thread_to_schedule,
-            thread_to_schedule.regs().cs, thread_to_schedule.regs().eip);
+            *thread_to_schedule,
+            thread_to_schedule->regs().cs, thread_to_schedule->regs().eip);
 #else
         PANIC("Scheduler::pick_next() not implemented");
 #endif
@@ -220,8 +406,8 @@ bool Scheduler::pick_next()
     // but since we're still holding the scheduler lock we're still in a critical section
     critical.leave();
 
-    thread_to_schedule.set_ticks_left(time_slice_for(thread_to_schedule));
-    return context_switch(&thread_to_schedule);
+    thread_to_schedule->set_ticks_left(time_slice_for(*thread_to_schedule));
+    return context_switch(thread_to_schedule);
 }
 
 bool Scheduler::yield()
@@ -377,7 +563,7 @@ UNMAP_AFTER_INIT void Scheduler::initialize()
 
     RefPtr<Thread> idle_thread;
     g_finalizer_wait_queue = new WaitQueue;
-    g_ready_queues = new ThreadReadyQueue[g_ready_queue_buckets];
+    g_ready_queues = new ThreadReadyQueues[max_processor_count];
 
     g_finalizer_has_work.store(false, AK::MemoryOrder::memory_order_release);
     s_colonel_process = Process::create_kernel_process(idle_thread, "colonel", idle_loop, nullptr, 1).leak_ref();
@@ -504,6 +690,15 @@ void dump_thread_list()
 {
     dbgln("Scheduler thread list for processor {}:", Processor::id());
 
+    Scheduler::for_each_ready_queue([](auto& statistics) {
+        dmesgln("  Ready queue #{}: depth: {}, steals: {}, stolen: {}, priority steals: {}",
+            statistics.processor,
+            statistics.depth,
+            statistics.steal_count,
+            statistics.stolen_count,
+            statistics.priority_steal_count);
+    });
+
     auto get_cs = [](Thread& thread) -> u16 {
         if (!thread.current_trap())
             return thread.regs().cs;
@@ -26,6 +26,13 @@ extern WaitQueue* g_finalizer_wait_queue;
 extern Atomic<bool> g_finalizer_has_work;
 extern RecursiveSpinLock g_scheduler_lock;
 
+struct ReadyQueueStatistics {
+    u32 processor { 0 };
+    u32 depth { 0 };
+    u64 steal_count { 0 };
+    u64 stolen_count { 0 };
+};
+
 class Scheduler {
 public:
     static void initialize();
@@ -48,6 +55,7 @@ public:
     static Thread& pull_next_runnable_thread();
     static bool dequeue_runnable_thread(Thread&, bool = false);
     static void queue_runnable_thread(Thread&);
+    static void for_each_ready_queue(Function<void(const ReadyQueueStatistics&)>);
     static void dump_scheduler_state();
     static bool is_initialized();
 };
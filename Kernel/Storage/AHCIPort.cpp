@@ -45,7 +45,8 @@ AHCIPort::AHCIPort(const AHCIPortHandler& handler, volatile AHCI::PortRegisters&
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Command list page at {}", representative_port_index(), m_command_list_page->paddr());
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: FIS receive page at {}", representative_port_index(), m_command_list_page->paddr());
 
-    for (size_t index = 0; index < 1; index++) {
+    // NOTE: This is enough for the first command slot, the others get their pages once we know that the device supports NCQ.
+    for (size_t index = 0; index < dma_pages_per_command_slot; index++) {
         m_dma_buffers.append(MM.allocate_supervisor_physical_page().release_nonnull());
     }
     for (size_t index = 0; index < 1; index++) {
@@ -85,31 +86,23 @@ void AHCIPort::handle_interrupt()
         });
         return;
     }
-    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS)) {
+    // NOTE: Queued commands complete with a Set Device Bits FIS rather than a Device to Host Register FIS.
+    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::SDB)) {
         m_wait_for_completion = false;
 
+        // Clear the interrupt status before looking at which commands are done, so that
+        // a command that completes right after that raises another interrupt.
+        m_interrupt_status.clear();
+        auto completed_slots = take_completed_command_slots();
+
         // Now schedule reading/writing the buffer as soon as we leave the irq handler.
         // This is important so that we can safely access the buffers, which could
         // trigger page faults
-        if (!m_current_request) {
+        if (!completed_slots) {
             dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled, probably identify request", representative_port_index());
         } else {
-            g_io_work->queue([this]() {
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled", representative_port_index());
-                Locker locker(m_lock);
-                VERIFY(m_current_request);
-                VERIFY(m_current_scatter_list);
-                if (m_current_request->request_type() == AsyncBlockDeviceRequest::Read) {
-                    if (!m_current_request->write_to_buffer(m_current_request->buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * m_current_request->block_count())) {
-                        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
-                        m_current_scatter_list = nullptr;
-                        complete_current_request(AsyncDeviceRequest::MemoryFault);
-                        return;
-                    }
-                }
-                m_current_scatter_list = nullptr;
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                complete_current_request(AsyncDeviceRequest::Success);
+            g_io_work->queue([this, completed_slots]() {
+                finish_completed_command_slots(completed_slots);
             });
         }
     }
@@ -125,12 +118,15 @@ bool AHCIPort::is_interrupts_enabled() const
 void AHCIPort::recover_from_fatal_error()
 {
     Locker locker(m_lock);
-    ScopedSpinLock lock(m_hard_lock);
-    dmesgln("{}: AHCI Port {} fatal error, shutting down!", m_parent_handler->hba_controller()->pci_address(), representative_port_index());
-    dmesgln("{}: AHCI Port {} fatal error, SError {}", m_parent_handler->hba_controller()->pci_address(), representative_port_index(), (u32)m_port_registers.serr);
-    stop_command_list_processing();
-    stop_fis_receiving();
-    m_interrupt_enable.clear();
+    {
+        ScopedSpinLock lock(m_hard_lock);
+        dmesgln("{}: AHCI Port {} fatal error, shutting down!", m_parent_handler->hba_controller()->pci_address(), representative_port_index());
+        dmesgln("{}: AHCI Port {} fatal error, SError {}", m_parent_handler->hba_controller()->pci_address(), representative_port_index(), (u32)m_port_registers.serr);
+        stop_command_list_processing();
+        stop_fis_receiving();
+        m_interrupt_enable.clear();
+    }
+    fail_issued_command_slots();
 }
 
 void AHCIPort::eject()
@@ -292,6 +288,8 @@ bool AHCIPort::initialize(ScopedSpinLock<SpinLock<u8>>& main_lock)
 
         dmesgln("AHCI Port {}: Device found, Capacity={}, Bytes per logical sector={}, Bytes per physical sector={}", representative_port_index(), max_addressable_sector * logical_sector_size, logical_sector_size, physical_sector_size);
 
+        configure_command_slots(*identify_block);
+
         // FIXME: We don't support ATAPI devices yet, so for now we don't "create" them
         if (!is_atapi_attached()) {
             m_connected_device = SATADiskDevice::create(m_parent_handler->hba_controller(), *this, logical_sector_size, max_addressable_sector);
@@ -424,25 +422,26 @@ size_t AHCIPort::calculate_descriptors_count(size_t block_count) const
 {
     VERIFY(m_connected_device);
     size_t needed_dma_regions_count = page_round_up((block_count * m_connected_device->block_size())) / PAGE_SIZE;
-    VERIFY(needed_dma_regions_count <= m_dma_buffers.size());
+    VERIFY(needed_dma_regions_count <= dma_pages_per_command_slot);
     return needed_dma_regions_count;
 }
 
-Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request)
+Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request, u8 slot_index)
 {
     VERIFY(m_lock.is_locked());
     VERIFY(request.block_count() > 0);
 
     NonnullRefPtrVector<PhysicalPage> allocated_dma_regions;
     for (size_t index = 0; index < calculate_descriptors_count(request.block_count()); index++) {
-        allocated_dma_regions.append(m_dma_buffers.at(index));
+        allocated_dma_regions.append(m_dma_buffers.at(slot_index * dma_pages_per_command_slot + index));
     }
 
-    m_current_scatter_list = ScatterGatherList::create(request, move(allocated_dma_regions), m_connected_device->block_size());
-    if (!m_current_scatter_list)
+    auto& scatter_list = m_command_slots[slot_index].scatter_list;
+    scatter_list = ScatterGatherList::create(request, move(allocated_dma_regions), m_connected_device->block_size());
+    if (!scatter_list)
         return AsyncDeviceRequest::Failure;
     if (request.request_type() == AsyncBlockDeviceRequest::Write) {
-        if (!request.read_from_buffer(request.buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count())) {
+        if (!request.read_from_buffer(request.buffer(), scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count())) {
             return AsyncDeviceRequest::MemoryFault;
         }
     }
@@ -453,34 +452,82 @@ void AHCIPort::start_request(AsyncBlockDeviceRequest& request)
 {
     Locker locker(m_lock);
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request start", representative_port_index());
-    VERIFY(!m_current_request);
-    VERIFY(!m_current_scatter_list);
 
-    m_current_request = request;
+    if (!is_operable()) {
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, port is not operable.", representative_port_index());
+        locker.unlock();
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
+
+    // NOTE: The device never has more requests in flight than we have command slots.
+    auto slot_index = try_to_reserve_command_slot();
+    VERIFY(slot_index.has_value());
+    m_command_slots[slot_index.value()].request = request;
 
-    auto result = prepare_and_set_scatter_list(request);
+    auto result = prepare_and_set_scatter_list(request, slot_index.value());
     if (result.has_value()) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
         locker.unlock();
-        complete_current_request(result.value());
+        complete_request_in_command_slot(slot_index.value(), result.value());
         return;
     }
 
-    auto success = access_device(request.request_type(), request.block_index(), request.block_count());
+    auto success = access_device(request.request_type(), request.block_index(), request.block_count(), slot_index.value());
     if (!success) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
         locker.unlock();
-        complete_current_request(AsyncDeviceRequest::Failure);
+        complete_request_in_command_slot(slot_index.value(), AsyncDeviceRequest::Failure);
         return;
     }
 }
 
-void AHCIPort::complete_current_request(AsyncDeviceRequest::RequestResult result)
+void AHCIPort::complete_request_in_command_slot(u8 slot_index, AsyncDeviceRequest::RequestResult result)
+{
+    auto& slot = m_command_slots[slot_index];
+    VERIFY(slot.request);
+    auto request = slot.request.release_nonnull();
+    slot.scatter_list = nullptr;
+    // NOTE: Completing the request may start the next one, which can then reuse this slot right away.
+    release_command_slot(slot_index);
+    request->complete(result);
+}
+
+void AHCIPort::finish_completed_command_slots(u32 completed_slots)
+{
+    Locker locker(m_lock);
+    for (u8 slot_index = 0; slot_index < m_command_slot_count; ++slot_index) {
+        if (!(completed_slots & (1u << slot_index)))
+            continue;
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request in command slot {} handled", representative_port_index(), slot_index);
+        auto& slot = m_command_slots[slot_index];
+        VERIFY(slot.request);
+        VERIFY(slot.scatter_list);
+        if (slot.request->request_type() == AsyncBlockDeviceRequest::Read) {
+            if (!slot.request->write_to_buffer(slot.request->buffer(), slot.scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * slot.request->block_count())) {
+                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
+                complete_request_in_command_slot(slot_index, AsyncDeviceRequest::MemoryFault);
+                continue;
+            }
+        }
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
+        complete_request_in_command_slot(slot_index, AsyncDeviceRequest::Success);
+    }
+}
+
+void AHCIPort::fail_issued_command_slots()
 {
-    VERIFY(m_current_request);
-    auto current_request = m_current_request;
-    m_current_request.clear();
-    current_request->complete(result);
+    VERIFY(m_lock.is_locked());
+    u32 issued_slots;
+    {
+        ScopedSpinLock lock(m_hard_lock);
+        issued_slots = m_issued_command_slots;
+        m_issued_command_slots = 0;
+    }
+    for (u8 slot_index = 0; slot_index < m_command_slot_count; ++slot_index) {
+        if (issued_slots & (1u << slot_index))
+            complete_request_in_command_slot(slot_index, AsyncDeviceRequest::Failure);
+    }
 }
 
 bool AHCIPort::spin_until_ready() const
@@ -499,35 +546,35 @@ bool AHCIPort::spin_until_ready() const
     return true;
 }
 
-bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
+bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count, u8 slot_index)
 {
     VERIFY(m_connected_device);
     VERIFY(is_operable());
     VERIFY(m_lock.is_locked());
-    VERIFY(m_current_scatter_list);
+    auto& scatter_list = m_command_slots[slot_index].scatter_list;
+    VERIFY(scatter_list);
     ScopedSpinLock lock(m_hard_lock);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count);
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}, command slot {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, slot_index);
     if (!spin_until_ready())
         return false;
 
-    auto unused_command_header = try_to_find_unused_command_header();
-    VERIFY(unused_command_header.has_value());
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
-    command_list_entries[unused_command_header.value()].ctbau = 0;
-    command_list_entries[unused_command_header.value()].prdbc = 0;
-    command_list_entries[unused_command_header.value()].prdtl = m_current_scatter_list->scatters_count();
+    command_list_entries[slot_index].ctba = m_command_table_pages[slot_index].paddr().get();
+    command_list_entries[slot_index].ctbau = 0;
+    command_list_entries[slot_index].prdbc = 0;
+    command_list_entries[slot_index].prdtl = scatter_list->scatters_count();
 
     // Note: we must set the correct Dword count in this register. Real hardware
     // AHCI controllers do care about this field! QEMU doesn't care if we don't
     // set the correct CFL field in this register, real hardware will set an
     // handshake error bit in PxSERR register if CFL is incorrect.
-    command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
+    // The prefetchable bit must not be set for queued commands.
+    command_list_entries[slot_index].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | (m_native_command_queuing_enabled ? 0 : AHCI::CommandHeaderAttributes::P) | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba=0x{:08x}, ctbau=0x{:08x}, prdbc=0x{:08x}, prdtl=0x{:04x}, attributes=0x{:04x}", representative_port_index(), (u32)command_list_entries[unused_command_header.value()].ctba, (u32)command_list_entries[unused_command_header.value()].ctbau, (u32)command_list_entries[unused_command_header.value()].prdbc, (u16)command_list_entries[unused_command_header.value()].prdtl, (u16)command_list_entries[unused_command_header.value()].attributes);
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba=0x{:08x}, ctbau=0x{:08x}, prdbc=0x{:08x}, prdtl=0x{:04x}, attributes=0x{:04x}", representative_port_index(), (u32)command_list_entries[slot_index].ctba, (u32)command_list_entries[slot_index].ctbau, (u32)command_list_entries[slot_index].prdbc, (u16)command_list_entries[slot_index].prdtl, (u16)command_list_entries[slot_index].attributes);
 
-    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[unused_command_header.value()].paddr().page_base(), page_round_up(sizeof(AHCI::CommandTable)), "AHCI Command Table", Region::Access::Read | Region::Access::Write, Region::Cacheable::No);
+    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[slot_index].paddr().page_base(), page_round_up(sizeof(AHCI::CommandTable)), "AHCI Command Table", Region::Access::Read | Region::Access::Write, Region::Cacheable::No);
     auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
 
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Allocated command table at {}", representative_port_index(), command_table_region->vaddr());
@@ -536,7 +583,7 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
 
     size_t scatter_entry_index = 0;
     size_t data_transfer_count = (block_count * m_connected_device->block_size());
-    for (auto scatter_page : m_current_scatter_list->vmobject().physical_pages()) {
+    for (auto scatter_page : scatter_list->vmobject().physical_pages()) {
         VERIFY(data_transfer_count != 0);
         VERIFY(scatter_page);
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Add a transfer scatter entry @ {}", representative_port_index(), scatter_page->paddr());
@@ -560,6 +607,11 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     if (is_atapi_attached()) {
         fis.command = ATA_CMD_PACKET;
         TODO();
+    } else if (m_native_command_queuing_enabled) {
+        if (direction == AsyncBlockDeviceRequest::RequestType::Write)
+            fis.command = ATA_CMD_WRITE_FPDMA_QUEUED;
+        else
+            fis.command = ATA_CMD_READ_FPDMA_QUEUED;
     } else {
         if (direction == AsyncBlockDeviceRequest::RequestType::Write)
             fis.command = ATA_CMD_WRITE_DMA_EXT;
@@ -578,17 +630,25 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     fis.lba_low[0] = lba & 0xff;
     fis.lba_low[1] = (lba >> 8) & 0xff;
     fis.lba_low[2] = (lba >> 16) & 0xff;
-    fis.count = (block_count);
+    if (m_native_command_queuing_enabled) {
+        // Queued commands take their sector count in the features register, and their tag
+        // (which has to match the command slot) in the sector count register.
+        fis.features_low = block_count;
+        fis.features_high = 0;
+        fis.count = slot_index << 3;
+    } else {
+        fis.count = (block_count);
+    }
 
     // The below loop waits until the port is no longer busy before issuing a new command
     if (!spin_until_ready())
         return false;
 
     full_memory_barrier();
-    mark_command_header_ready_to_process(unused_command_header.value());
+    mark_command_header_ready_to_process(slot_index);
     full_memory_barrier();
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[0].paddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[slot_index * dma_pages_per_command_slot].paddr());
     return true;
 }
 
@@ -661,6 +721,61 @@ bool AHCIPort::shutdown()
     return true;
 }
 
+void AHCIPort::configure_command_slots(const ATAIdentifyBlock& identify_block)
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(m_hard_lock.is_locked());
+
+    m_command_slot_count = 1;
+    m_native_command_queuing_enabled = false;
+
+    // Without NCQ, the drive can only work on one command at a time anyway.
+    bool device_supports_native_command_queuing = identify_block.serial_ata_capabilities != 0xffff && (identify_block.serial_ata_capabilities & (1 << 8));
+    if (is_atapi_attached() || !device_supports_native_command_queuing || !m_parent_handler->hba_capabilities().native_command_queuing_supported)
+        return;
+
+    size_t device_queue_depth = (identify_block.queue_depth & 0x1f) + 1;
+    m_command_slot_count = min(min(device_queue_depth, m_parent_handler->hba_capabilities().max_command_list_entries_count), max_command_slots);
+    m_native_command_queuing_enabled = true;
+
+    while (m_command_table_pages.size() < m_command_slot_count)
+        m_command_table_pages.append(MM.allocate_supervisor_physical_page().release_nonnull());
+    while (m_dma_buffers.size() < m_command_slot_count * dma_pages_per_command_slot)
+        m_dma_buffers.append(MM.allocate_supervisor_physical_page().release_nonnull());
+
+    dmesgln("AHCI Port {}: Native command queuing enabled, {} command slots", representative_port_index(), m_command_slot_count);
+}
+
+Optional<u8> AHCIPort::try_to_reserve_command_slot()
+{
+    ScopedSpinLock lock(m_hard_lock);
+    for (u8 slot_index = 0; slot_index < m_command_slot_count; slot_index++) {
+        if (!(m_used_command_slots & (1u << slot_index))) {
+            m_used_command_slots |= 1u << slot_index;
+            return slot_index;
+        }
+    }
+    return {};
+}
+
+void AHCIPort::release_command_slot(u8 slot_index)
+{
+    ScopedSpinLock lock(m_hard_lock);
+    VERIFY(m_used_command_slots & (1u << slot_index));
+    VERIFY(!(m_issued_command_slots & (1u << slot_index)));
+    m_used_command_slots &= ~(1u << slot_index);
+}
+
+u32 AHCIPort::take_completed_command_slots()
+{
+    ScopedSpinLock lock(m_hard_lock);
+    // A queued command is done once the drive has cleared its bit in PxSACT, everything else once the HBA has cleared it in PxCI.
+    u32 active_slots = m_port_registers.ci | m_port_registers.sact;
+    u32 completed_slots = m_issued_command_slots & ~active_slots;
+    m_issued_command_slots &= ~completed_slots;
+    return completed_slots;
+}
+
 Optional<u8> AHCIPort::try_to_find_unused_command_header()
 {
     VERIFY(m_lock.is_locked());
@@ -684,15 +799,17 @@ void AHCIPort::start_command_list_processing() const
     m_port_registers.cmd = m_port_registers.cmd | 1;
 }
 
-void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index) const
+void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index)
 {
     VERIFY(m_lock.is_locked());
     VERIFY(m_hard_lock.is_locked());
     VERIFY(is_operable());
-    VERIFY(!m_wait_for_completion);
-    m_wait_for_completion = true;
+    VERIFY(!(m_issued_command_slots & (1u << command_header_index)));
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Marking command header at index {} as ready to process.", representative_port_index(), command_header_index);
-    m_port_registers.ci = 1 << command_header_index;
+    m_issued_command_slots |= 1u << command_header_index;
+    if (m_native_command_queuing_enabled)
+        m_port_registers.sact = 1u << command_header_index;
+    m_port_registers.ci = 1u << command_header_index;
 }
 
 void AHCIPort::stop_command_list_processing() const
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <Kernel/Devices/Device.h>
@@ -27,6 +28,7 @@
 namespace Kernel {
 
 class AsyncBlockDeviceRequest;
+struct ATAIdentifyBlock;
 
 class AHCIPortHandler;
 class SATADiskDevice;
@@ -45,6 +47,9 @@ public:
 
     RefPtr<StorageDevice> connected_device() const { return m_connected_device; }
 
+    size_t command_slot_count() const { return m_command_slot_count; }
+    bool is_native_command_queuing_enabled() const { return m_native_command_queuing_enabled; }
+
     bool reset();
     UNMAP_AFTER_INIT bool initialize_without_reset();
     void handle_interrupt();
@@ -70,10 +75,12 @@ private:
     ALWAYS_INLINE void power_on() const;
 
     void start_request(AsyncBlockDeviceRequest&);
-    void complete_current_request(AsyncDeviceRequest::RequestResult);
-    bool access_device(AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
+    void complete_request_in_command_slot(u8 slot_index, AsyncDeviceRequest::RequestResult);
+    void finish_completed_command_slots(u32 completed_slots);
+    void fail_issued_command_slots();
+    bool access_device(AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count, u8 slot_index);
     size_t calculate_descriptors_count(size_t block_count) const;
-    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request);
+    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request, u8 slot_index);
 
     ALWAYS_INLINE bool is_interrupts_enabled() const;
 
@@ -82,7 +89,7 @@ private:
     bool identify_device(ScopedSpinLock<SpinLock<u8>>&);
 
     ALWAYS_INLINE void start_command_list_processing() const;
-    ALWAYS_INLINE void mark_command_header_ready_to_process(u8 command_header_index) const;
+    ALWAYS_INLINE void mark_command_header_ready_to_process(u8 command_header_index);
     ALWAYS_INLINE void stop_command_list_processing() const;
 
     ALWAYS_INLINE void start_fis_receiving() const;
@@ -94,13 +101,16 @@ private:
     void set_interface_state(AHCI::DeviceDetectionInitialization);
 
     Optional<u8> try_to_find_unused_command_header();
+    Optional<u8> try_to_reserve_command_slot();
+    void release_command_slot(u8 slot_index);
+    u32 take_completed_command_slots();
+    void configure_command_slots(const ATAIdentifyBlock&);
 
     ALWAYS_INLINE bool is_interface_disabled() const { return (m_port_registers.ssts & 0xf) == 4; };
 
     // Data members
 
     EntropySource m_entropy_source;
-    RefPtr<AsyncBlockDeviceRequest> m_current_request;
     SpinLock<u8> m_hard_lock;
     Lock m_lock { "AHCIPort" };
 
@@ -120,7 +130,21 @@ private:
     AHCI::PortInterruptStatusBitField m_interrupt_status;
     AHCI::PortInterruptEnableBitField m_interrupt_enable;
 
-    RefPtr<ScatterGatherList> m_current_scatter_list;
+    // Every command header in the command list can have a request in flight. Slots are reserved for a
+    // request when it starts, and issued to the HBA once its command table has been filled in.
+    // NOTE: The slot masks are protected by m_hard_lock, as they are also looked at in the IRQ handler.
+    struct CommandSlot {
+        RefPtr<AsyncBlockDeviceRequest> request;
+        RefPtr<ScatterGatherList> scatter_list;
+    };
+    static constexpr size_t max_command_slots = 32;
+    static constexpr size_t dma_pages_per_command_slot = 1;
+    Array<CommandSlot, max_command_slots> m_command_slots;
+    size_t m_command_slot_count { 1 };
+    u32 m_used_command_slots { 0 };
+    u32 m_issued_command_slots { 0 };
+    bool m_native_command_queuing_enabled { false };
+
     bool m_disabled_by_firmware { false };
 };
 }
@@ -28,6 +28,7 @@ public:
     // ^Device
     virtual mode_t required_mode() const override { return 0600; }
     virtual String device_name() const override;
+    virtual size_t max_concurrent_requests() const override { return m_device->max_concurrent_requests(); }
 
     const DiskPartitionMetadata& metadata() const;
 
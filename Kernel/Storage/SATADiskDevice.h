@@ -32,6 +32,9 @@ public:
     virtual void start_request(AsyncBlockDeviceRequest&) override;
     virtual String device_name() const override;
 
+    // ^Device
+    virtual size_t max_concurrent_requests() const override;
+
 private:
     SATADiskDevice(const AHCIController&, const AHCIPort&, size_t sector_size, u64 max_addressable_block);
 
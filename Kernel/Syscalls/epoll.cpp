@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <AK/Time.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Process.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+KResultOr<FlatPtr> Process::sys$epoll_create1(int flags)
+{
+    REQUIRE_PROMISE(stdio);
+
+    if (flags & ~EPOLL_CLOEXEC)
+        return EINVAL;
+
+    int fd = m_fds.allocate();
+    if (fd < 0)
+        return fd;
+
+    auto event_poll_or_error = EventPoll::create();
+    if (event_poll_or_error.is_error())
+        return event_poll_or_error.error();
+
+    auto description_or_error = FileDescription::create(*event_poll_or_error.value());
+    if (description_or_error.is_error())
+        return description_or_error.error();
+
+    m_fds[fd].set(description_or_error.release_value());
+    m_fds[fd].description()->set_readable(true);
+
+    if (flags & EPOLL_CLOEXEC)
+        m_fds[fd].set_flags(m_fds[fd].flags() | FD_CLOEXEC);
+
+    return fd;
+}
+
+KResultOr<FlatPtr> Process::sys$epoll_ctl(Userspace<const Syscall::SC_epoll_ctl_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+
+    Syscall::SC_epoll_ctl_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    auto epoll_description = fds().file_description(params.epoll_fd);
+    if (!epoll_description)
+        return EBADF;
+    auto* event_poll = epoll_description->event_poll();
+    if (!event_poll)
+        return EINVAL;
+
+    auto description = fds().file_description(params.fd);
+    if (!description)
+        return EBADF;
+    // Nesting would let the block conditions of two EventPolls call into each other.
+    if (description->is_event_poll())
+        return EINVAL;
+
+    epoll_event event {};
+    if (params.op != EPOLL_CTL_DEL && !copy_from_user(&event, params.event))
+        return EFAULT;
+
+    switch (params.op) {
+    case EPOLL_CTL_ADD:
+        return event_poll->add_watch(params.fd, *description, event.events, event.data.u64);
+    case EPOLL_CTL_MOD:
+        return event_poll->modify_watch(params.fd, *description, event.events, event.data.u64);
+    case EPOLL_CTL_DEL:
+        return event_poll->remove_watch(params.fd, *description);
+    default:
+        return EINVAL;
+    }
+}
+
+KResultOr<FlatPtr> Process::sys$epoll_pwait(Userspace<const Syscall::SC_epoll_pwait_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+
+    Syscall::SC_epoll_pwait_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    if (params.max_events <= 0)
+        return EINVAL;
+
+    auto epoll_description = fds().file_description(params.epoll_fd);
+    if (!epoll_description)
+        return EBADF;
+    auto* event_poll = epoll_description->event_poll();
+    if (!event_poll)
+        return EINVAL;
+
+    Thread::BlockTimeout timeout;
+    bool should_block = true;
+    if (params.timeout) {
+        auto timeout_time = copy_time_from_user(params.timeout);
+        if (!timeout_time.has_value())
+            return EFAULT;
+        should_block = timeout_time.value() > Time::zero();
+        // We may have to block more than once, so work out when to give up only once, up front.
+        auto deadline = TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE) + timeout_time.value();
+        timeout = Thread::BlockTimeout(true, &deadline);
+    }
+
+    // There can't be more ready watches than open file descriptors.
+    Vector<epoll_event> events;
+    if (!events.try_resize(min<size_t>(params.max_events, fds().max_open())))
+        return ENOMEM;
+
+    auto current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask) {
+        sigset_t sigmask_copy;
+        if (!copy_from_user(&sigmask_copy, params.sigmask))
+            return EFAULT;
+        previous_signal_mask = current_thread->update_signal_mask(sigmask_copy);
+    }
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    size_t event_count = 0;
+    for (;;) {
+        event_count = event_poll->collect_events(events.span());
+        if (event_count > 0 || !should_block)
+            break;
+
+        // The EventPoll is readable while its ready list isn't empty, but the watches on it may turn out
+        // to not be ready anymore once we look at them, so keep waiting until we actually have something.
+        dbgln_if(POLL_SELECT_DEBUG, "epoll_pwait: waiting for events, timeout={}", params.timeout);
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        auto block_result = current_thread->block<Thread::ReadBlocker>(timeout, *epoll_description, unblock_flags);
+        if (block_result.was_interrupted())
+            return EINTR;
+        if (block_result.timed_out()) {
+            event_count = event_poll->collect_events(events.span());
+            break;
+        }
+    }
+
+    if (event_count > 0 && !copy_to_user(params.events, events.data(), event_count * sizeof(epoll_event)))
+        return EFAULT;
+    return event_count;
+}
+
+}
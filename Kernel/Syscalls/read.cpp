@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NumericLimits.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/Process.h>
@@ -12,9 +13,8 @@ namespace Kernel {
 
 using BlockFlags = Thread::FileBlocker::BlockFlags;
 
-KResultOr<FlatPtr> Process::sys$readv(int fd, Userspace<const struct iovec*> iov, int iov_count)
+KResult Process::copy_io_vectors_from_user(Vector<FileIOVector, 32>& vectors, Userspace<const struct iovec*> iov, int iov_count)
 {
-    REQUIRE_PROMISE(stdio);
     if (iov_count < 0)
         return EINVAL;
 
@@ -22,17 +22,47 @@ KResultOr<FlatPtr> Process::sys$readv(int fd, Userspace<const struct iovec*> iov
     if (iov_count > (int)MiB)
         return EFAULT;
 
-    u64 total_length = 0;
     Vector<iovec, 32> vecs;
     if (!vecs.try_resize(iov_count))
         return ENOMEM;
     if (!copy_n_from_user(vecs.data(), iov, iov_count))
         return EFAULT;
+
+    if (!vectors.try_ensure_capacity(iov_count))
+        return ENOMEM;
+    u64 total_length = 0;
     for (auto& vec : vecs) {
         total_length += vec.iov_len;
         if (total_length > NumericLimits<i32>::max())
             return EINVAL;
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len);
+        if (!buffer.has_value())
+            return EFAULT;
+        vectors.unchecked_append({ buffer.value(), vec.iov_len });
     }
+    return KSuccess;
+}
+
+static KResult block_until_readable(FileDescription& description)
+{
+    if (!description.is_blocking() || description.can_read())
+        return KSuccess;
+    auto unblock_flags = BlockFlags::None;
+    if (Thread::current()->block<Thread::ReadBlocker>({}, description, unblock_flags).was_interrupted())
+        return EINTR;
+    if (!has_flag(unblock_flags, BlockFlags::Read))
+        return EAGAIN;
+    // TODO: handle exceptions in unblock_flags
+    return KSuccess;
+}
+
+KResultOr<FlatPtr> Process::sys$readv(int fd, Userspace<const struct iovec*> iov, int iov_count)
+{
+    REQUIRE_PROMISE(stdio);
+
+    Vector<FileIOVector, 32> vectors;
+    if (auto result = copy_io_vectors_from_user(vectors, iov, iov_count); result.is_error())
+        return result;
 
     auto description = fds().file_description(fd);
     if (!description)
@@ -44,28 +74,49 @@ KResultOr<FlatPtr> Process::sys$readv(int fd, Userspace<const struct iovec*> iov
     if (description->is_directory())
         return EISDIR;
 
-    int nread = 0;
-    for (auto& vec : vecs) {
-        if (description->is_blocking()) {
-            if (!description->can_read()) {
-                auto unblock_flags = BlockFlags::None;
-                if (Thread::current()->block<Thread::ReadBlocker>({}, *description, unblock_flags).was_interrupted())
-                    return EINTR;
-                if (!has_flag(unblock_flags, BlockFlags::Read))
-                    return EAGAIN;
-                // TODO: handle exceptions in unblock_flags
-            }
-        }
-        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len);
-        if (!buffer.has_value())
-            return EFAULT;
-        auto result = description->read(buffer.value(), vec.iov_len);
-        if (result.is_error())
-            return result.error();
-        nread += result.value();
-    }
+    // Like read(), we only wait for the description to become readable once, and then hand the whole list over at once.
+    if (auto result = block_until_readable(*description); result.is_error())
+        return result;
+
+    auto result = description->read_vectored(vectors.span());
+    if (result.is_error())
+        return result.error();
+    return result.value();
+}
+
+KResultOr<FlatPtr> Process::sys$preadv(Userspace<const Syscall::SC_preadv_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+
+    Syscall::SC_preadv_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    if (params.offset < 0)
+        return EINVAL;
+
+    Vector<FileIOVector, 32> vectors;
+    if (auto result = copy_io_vectors_from_user(vectors, Userspace<const struct iovec*>((FlatPtr)params.iov), params.iov_count); result.is_error())
+        return result;
 
-    return nread;
+    dbgln_if(IO_DEBUG, "sys$preadv({}, {}, {}, {})", params.fd, params.iov, params.iov_count, params.offset);
+    auto description = fds().file_description(params.fd);
+    if (!description)
+        return EBADF;
+    if (!description->is_readable())
+        return EBADF;
+    if (description->is_directory())
+        return EISDIR;
+    if (!description->file().is_seekable())
+        return ESPIPE;
+
+    if (auto result = block_until_readable(*description); result.is_error())
+        return result;
+
+    auto result = description->read_vectored(vectors.span(), params.offset);
+    if (result.is_error())
+        return result.error();
+    return result.value();
 }
 
 KResultOr<FlatPtr> Process::sys$read(int fd, Userspace<u8*> buffer, size_t size)
@@ -83,16 +134,8 @@ KResultOr<FlatPtr> Process::sys$read(int fd, Userspace<u8*> buffer, size_t size)
         return EBADF;
     if (description->is_directory())
         return EISDIR;
-    if (description->is_blocking()) {
-        if (!description->can_read()) {
-            auto unblock_flags = BlockFlags::None;
-            if (Thread::current()->block<Thread::ReadBlocker>({}, *description, unblock_flags).was_interrupted())
-                return EINTR;
-            if (!has_flag(unblock_flags, BlockFlags::Read))
-                return EAGAIN;
-            // TODO: handle exceptions in unblock_flags
-        }
-    }
+    if (auto result = block_until_readable(*description); result.is_error())
+        return result;
     auto user_buffer = UserOrKernelBuffer::for_user_buffer(buffer, size);
     if (!user_buffer.has_value())
         return EFAULT;
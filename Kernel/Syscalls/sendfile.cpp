@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// The largest chunk we read from the file before handing it to the output.
+static constexpr size_t sendfile_chunk_size = 64 * KiB;
+
+KResultOr<FlatPtr> Process::sys$sendfile(Userspace<const Syscall::SC_sendfile_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+
+    Syscall::SC_sendfile_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    if (params.count == 0)
+        return 0;
+    if (params.count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = fds().file_description(params.in_fd);
+    if (!in_description)
+        return EBADF;
+    if (!in_description->is_readable())
+        return EBADF;
+    // We read at explicit offsets, so the input has to be an actual file.
+    if (!in_description->inode() || in_description->is_directory() || !in_description->file().is_seekable())
+        return EINVAL;
+
+    auto out_description = fds().file_description(params.out_fd);
+    if (!out_description)
+        return EBADF;
+    if (!out_description->is_writable())
+        return EBADF;
+
+    off_t offset;
+    if (params.offset) {
+        if (!copy_from_user(&offset, params.offset))
+            return EFAULT;
+        if (offset < 0)
+            return EINVAL;
+    } else {
+        offset = in_description->offset();
+    }
+
+    auto buffer = KBuffer::try_create_with_size(min(params.count, sendfile_chunk_size), Region::Access::Read | Region::Access::Write, "sendfile");
+    if (!buffer)
+        return ENOMEM;
+    auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", params.out_fd, params.in_fd, offset, params.count);
+
+    // The data only ever moves between kernel buffers, userspace never has to see it.
+    size_t total_sent = 0;
+    KResult error = KSuccess;
+    while (total_sent < params.count) {
+        auto chunk_size = min(params.count - total_sent, buffer->size());
+        auto nread_or_error = in_description->read(kernel_buffer, offset, chunk_size);
+        if (nread_or_error.is_error()) {
+            error = nread_or_error.error();
+            break;
+        }
+        auto nread = nread_or_error.value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = do_write(*out_description, kernel_buffer, nread);
+        if (nwritten_or_error.is_error()) {
+            error = nwritten_or_error.error();
+            break;
+        }
+        // Whatever the output didn't take (e.g. a non-blocking socket that filled up) stays unsent,
+        // so the caller picks up right after the last byte that actually went out.
+        auto nwritten = nwritten_or_error.value();
+        offset += nwritten;
+        total_sent += nwritten;
+        if (nwritten < nread)
+            break;
+    }
+
+    if (params.offset) {
+        if (!copy_to_user(params.offset, &offset))
+            return EFAULT;
+    } else if (total_sent > 0) {
+        auto seek_result = in_description->seek(offset, SEEK_SET);
+        if (seek_result.is_error())
+            return seek_result.error();
+    }
+
+    if (total_sent == 0 && error.is_error())
+        return error;
+    return total_sent;
+}
+
+}
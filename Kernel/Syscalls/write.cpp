@@ -57,6 +57,38 @@ KResultOr<FlatPtr> Process::sys$writev(int fd, Userspace<const struct iovec*> io
     return nwritten;
 }
 
+KResultOr<FlatPtr> Process::sys$pwritev(Userspace<const Syscall::SC_pwritev_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+
+    Syscall::SC_pwritev_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    if (params.offset < 0)
+        return EINVAL;
+
+    Vector<FileIOVector, 32> vectors;
+    if (auto result = copy_io_vectors_from_user(vectors, Userspace<const struct iovec*>((FlatPtr)params.iov), params.iov_count); result.is_error())
+        return result;
+
+    dbgln_if(IO_DEBUG, "sys$pwritev({}, {}, {}, {})", params.fd, params.iov, params.iov_count, params.offset);
+    auto description = fds().file_description(params.fd);
+    if (!description)
+        return EBADF;
+    if (!description->is_writable())
+        return EBADF;
+    if (!description->file().is_seekable())
+        return ESPIPE;
+
+    // Unlike do_write(), we don't retry partial writes, seekable files take the whole list in one request.
+    // Note that O_APPEND is deliberately ignored: the data goes exactly where the caller asked for it.
+    auto result = description->write_vectored(vectors.span(), params.offset);
+    if (result.is_error())
+        return result.error();
+    return result.value();
+}
+
 KResultOr<FlatPtr> Process::do_write(FileDescription& description, const UserOrKernelBuffer& data, size_t data_size)
 {
     size_t total_nwritten = 0;
@@ -17,9 +17,14 @@ UNMAP_AFTER_INIT void SyncTask::spawn()
     RefPtr<Thread> syncd_thread;
     Process::create_kernel_process(syncd_thread, "SyncTask", [] {
         dbgln("SyncTask is running");
-        for (;;) {
-            VFS::the().sync();
-            (void)Thread::current()->sleep(Time::from_seconds(1));
+        // Write dirty blocks back a little at a time in between the full syncs, which still happen every second.
+        constexpr unsigned writeback_rounds_per_sync = 4;
+        for (unsigned round = 1;; ++round) {
+            if (round % writeback_rounds_per_sync == 0)
+                VFS::the().sync();
+            else
+                FS::write_back_dirty_blocks_everywhere();
+            (void)Thread::current()->sleep(Time::from_milliseconds(250));
         }
     });
 }
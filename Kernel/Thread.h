@@ -119,6 +119,7 @@ class Thread
     friend class Process;
     friend class ProtectedProcessBase;
     friend class Scheduler;
+    friend class ThreadReadyQueues;
     friend struct ThreadReadyQueue;
 
     static SpinLock<u8> g_tid_map_lock;
@@ -1192,6 +1193,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_cpu { 0 };
 
     friend class WaitQueue;
 
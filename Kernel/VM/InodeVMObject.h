@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Bitmap.h>
+#include <Kernel/FileSystem/ReadaheadState.h>
 #include <Kernel/UnixTypes.h>
 #include <Kernel/VM/VMObject.h>
 
@@ -27,6 +28,8 @@ public:
     u32 writable_mappings() const;
     u32 executable_mappings() const;
 
+    ReadaheadState& readahead_state() { return m_readahead_state; }
+
 protected:
     explicit InodeVMObject(Inode&, size_t);
     explicit InodeVMObject(const InodeVMObject&);
@@ -41,6 +44,7 @@ protected:
 
     NonnullRefPtr<Inode> m_inode;
     Bitmap m_dirty_pages;
+    ReadaheadState m_readahead_state;
 };
 
 }
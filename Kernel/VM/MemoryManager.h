@@ -158,6 +158,15 @@ public:
     unsigned super_physical_pages() const { return m_super_physical_pages; }
     unsigned super_physical_pages_used() const { return m_super_physical_pages_used; }
 
+    template<typename Callback>
+    void for_each_physical_region(Callback callback) const
+    {
+        for (auto& region : m_user_physical_regions)
+            callback(region, false);
+        for (auto& region : m_super_physical_regions)
+            callback(region, true);
+    }
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -4,12 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/Bitmap.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefPtr.h>
 #include <AK/Vector.h>
+#include <Kernel/Arch/x86/Processor.h>
 #include <Kernel/Assertions.h>
-#include <Kernel/Random.h>
 #include <Kernel/VM/PhysicalPage.h>
 #include <Kernel/VM/PhysicalRegion.h>
 
@@ -39,133 +38,109 @@ unsigned PhysicalRegion::finalize_capacity()
     VERIFY(!m_pages);
 
     m_pages = (m_upper.get() - m_lower.get()) / PAGE_SIZE;
-    m_bitmap.grow(m_pages, false);
+    if (m_pages)
+        m_zone = make<PhysicalZone>(m_lower, m_pages);
+    m_page_caches.resize(max_processor_count);
 
     return size();
 }
 
-NonnullRefPtrVector<PhysicalPage> PhysicalRegion::take_contiguous_free_pages(size_t count, bool supervisor, size_t physical_alignment)
+PhysicalRegion::PageCache& PhysicalRegion::current_page_cache()
 {
-    VERIFY(m_pages);
-    VERIFY(m_used != m_pages);
-
-    NonnullRefPtrVector<PhysicalPage> physical_pages;
-    physical_pages.ensure_capacity(count);
-
-    auto first_contiguous_page = find_contiguous_free_pages(count, physical_alignment);
-
-    for (size_t index = 0; index < count; index++)
-        physical_pages.append(PhysicalPage::create(m_lower.offset(PAGE_SIZE * (index + first_contiguous_page)), supervisor));
-    return physical_pages;
+    auto id = Processor::id();
+    VERIFY(id < m_page_caches.size());
+    return m_page_caches[id];
 }
 
-unsigned PhysicalRegion::find_contiguous_free_pages(size_t count, size_t physical_alignment)
+size_t PhysicalRegion::cached_page_count() const
 {
-    VERIFY(count != 0);
-    VERIFY(physical_alignment % PAGE_SIZE == 0);
-    // search from the last page we allocated
-    auto range = find_and_allocate_contiguous_range(count, physical_alignment / PAGE_SIZE);
-    VERIFY(range.has_value());
-    return range.value();
+    size_t count = 0;
+    for (auto& cache : m_page_caches)
+        count += cache.count;
+    return count;
 }
 
-Optional<unsigned> PhysicalRegion::find_one_free_page()
+void PhysicalRegion::refill_page_cache(PageCache& cache)
 {
-    if (m_used == m_pages) {
-        // We know we don't have any free pages, no need to check the bitmap
-        // Check if we can draw one from the return queue
-        if (m_recently_returned.size() > 0) {
-            u8 index = get_fast_random<u8>() % m_recently_returned.size();
-            Checked<FlatPtr> local_offset = m_recently_returned[index].get();
-            local_offset -= m_lower.get();
-            m_recently_returned.remove(index);
-            VERIFY(!local_offset.has_overflow());
-            VERIFY(local_offset.value() < (FlatPtr)(m_pages * PAGE_SIZE));
-            return local_offset.value() / PAGE_SIZE;
-        }
-        return {};
+    // Grabbing a whole block at once is cheaper than going page by page, and keeps the pages physically close.
+    if (auto block = m_zone->allocate_block(PageCache::refill_order); block.has_value()) {
+        for (size_t i = 0; i < (1u << PageCache::refill_order); ++i)
+            cache.pages[cache.count++] = block.value().offset(i * PAGE_SIZE);
+        return;
+    }
+    while (cache.count < PageCache::capacity / 2) {
+        auto page = m_zone->allocate_block(0);
+        if (!page.has_value())
+            break;
+        cache.pages[cache.count++] = page.value();
     }
-    auto free_index = m_bitmap.find_one_anywhere_unset(m_free_hint);
-    if (!free_index.has_value())
-        return {};
-
-    auto page_index = free_index.value();
-    m_bitmap.set(page_index, true);
-    m_used++;
-    m_free_hint = free_index.value() + 1; // Just a guess
-    if (m_free_hint >= m_bitmap.size())
-        m_free_hint = 0;
-    return page_index;
 }
 
-Optional<unsigned> PhysicalRegion::find_and_allocate_contiguous_range(size_t count, unsigned alignment)
+void PhysicalRegion::drain_page_caches()
 {
-    VERIFY(count != 0);
-    size_t found_pages_count = 0;
-    // TODO: Improve how we deal with alignment != 1
-    auto first_index = m_bitmap.find_longest_range_of_unset_bits(count + alignment - 1, found_pages_count);
-    if (!first_index.has_value())
-        return {};
-
-    auto page = first_index.value();
-    if (alignment != 1) {
-        auto lower_page = m_lower.get() / PAGE_SIZE;
-        page = ((lower_page + page + alignment - 1) & ~(alignment - 1)) - lower_page;
-    }
-    if (found_pages_count >= count) {
-        m_bitmap.set_range<true>(page, count);
-        m_used += count;
-        m_free_hint = first_index.value() + count + 1; // Just a guess
-        if (m_free_hint >= m_bitmap.size())
-            m_free_hint = 0;
-        return page;
+    for (auto& cache : m_page_caches) {
+        for (size_t i = 0; i < cache.count; ++i)
+            m_zone->deallocate_block(cache.pages[i], 0);
+        cache.count = 0;
     }
-    return {};
 }
 
-RefPtr<PhysicalPage> PhysicalRegion::take_free_page(bool supervisor)
+NonnullRefPtrVector<PhysicalPage> PhysicalRegion::take_contiguous_free_pages(size_t count, bool supervisor, size_t physical_alignment)
 {
     VERIFY(m_pages);
+    VERIFY(count != 0);
 
-    auto free_index = find_one_free_page();
-    if (!free_index.has_value())
-        return nullptr;
+    auto first_page = m_zone->allocate_contiguous_pages(count, physical_alignment);
+    if (!first_page.has_value()) {
+        // Pages sitting in the per-processor caches may be exactly what's keeping blocks from merging.
+        drain_page_caches();
+        first_page = m_zone->allocate_contiguous_pages(count, physical_alignment);
+        if (!first_page.has_value())
+            return {};
+    }
 
-    return PhysicalPage::create(m_lower.offset(free_index.value() * PAGE_SIZE), supervisor);
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    physical_pages.ensure_capacity(count);
+    for (size_t index = 0; index < count; index++)
+        physical_pages.append(PhysicalPage::create(first_page.value().offset(PAGE_SIZE * index), supervisor));
+    return physical_pages;
 }
 
-void PhysicalRegion::free_page_at(PhysicalAddress addr)
+RefPtr<PhysicalPage> PhysicalRegion::take_free_page(bool supervisor)
 {
     VERIFY(m_pages);
 
-    if (m_used == 0) {
-        VERIFY_NOT_REACHED();
-    }
+    auto& cache = current_page_cache();
+    if (!cache.count)
+        refill_page_cache(cache);
 
-    Checked<FlatPtr> local_offset = addr.get();
-    local_offset -= m_lower.get();
-    VERIFY(!local_offset.has_overflow());
-    VERIFY(local_offset.value() < (FlatPtr)(m_pages * PAGE_SIZE));
+    if (!cache.count) {
+        // The buddy allocator has run dry, but other processors may still have some pages cached.
+        for (auto& other_cache : m_page_caches) {
+            if (other_cache.count)
+                return PhysicalPage::create(other_cache.pages[--other_cache.count], supervisor);
+        }
+        return nullptr;
+    }
 
-    auto page = local_offset.value() / PAGE_SIZE;
-    m_bitmap.set(page, false);
-    m_free_hint = page; // We know we can find one here for sure
-    m_used--;
+    return PhysicalPage::create(cache.pages[--cache.count], supervisor);
 }
 
 void PhysicalRegion::return_page(const PhysicalPage& page)
 {
-    auto returned_count = m_recently_returned.size();
-    if (returned_count >= m_recently_returned.capacity()) {
-        // Return queue is full, pick a random entry and free that page
-        // and replace the entry with this page
-        auto& entry = m_recently_returned[get_fast_random<u8>()];
-        free_page_at(entry);
-        entry = page.paddr();
-    } else {
-        // Still filling the return queue, just append it
-        m_recently_returned.append(page.paddr());
+    VERIFY(m_pages);
+
+    auto& cache = current_page_cache();
+    if (cache.count == PageCache::capacity) {
+        // Give the least recently returned half back to the buddy allocator, keeping the most recent (and likely cache-hot) ones.
+        constexpr auto pages_to_release = PageCache::capacity / 2;
+        for (size_t i = 0; i < pages_to_release; ++i)
+            m_zone->deallocate_block(cache.pages[i], 0);
+        for (size_t i = pages_to_release; i < cache.count; ++i)
+            cache.pages[i - pages_to_release] = cache.pages[i];
+        cache.count -= pages_to_release;
     }
+    cache.pages[cache.count++] = page.paddr();
 }
 
 }
@@ -6,11 +6,13 @@
 
 #pragma once
 
-#include <AK/Bitmap.h>
+#include <AK/Array.h>
 #include <AK/NonnullRefPtrVector.h>
-#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
+#include <AK/Vector.h>
 #include <Kernel/VM/PhysicalPage.h>
+#include <Kernel/VM/PhysicalZone.h>
 
 namespace Kernel {
 
@@ -27,29 +29,39 @@ public:
     PhysicalAddress lower() const { return m_lower; }
     PhysicalAddress upper() const { return m_upper; }
     unsigned size() const { return m_pages; }
-    unsigned used() const { return m_used - m_recently_returned.size(); }
-    unsigned free() const { return m_pages - m_used + m_recently_returned.size(); }
+    unsigned used() const { return m_pages - free(); }
+    unsigned free() const { return m_zone ? m_zone->free_page_count() + cached_page_count() : 0; }
     bool contains(const PhysicalPage& page) const { return page.paddr() >= m_lower && page.paddr() <= m_upper; }
 
     RefPtr<PhysicalPage> take_free_page(bool supervisor);
     NonnullRefPtrVector<PhysicalPage> take_contiguous_free_pages(size_t count, bool supervisor, size_t physical_alignment = PAGE_SIZE);
     void return_page(const PhysicalPage& page);
 
+    const PhysicalZone& zone() const { return *m_zone; }
+    size_t cached_page_count() const;
+
 private:
-    unsigned find_contiguous_free_pages(size_t count, size_t physical_alignment = PAGE_SIZE);
-    Optional<unsigned> find_and_allocate_contiguous_range(size_t count, unsigned alignment = 1);
-    Optional<unsigned> find_one_free_page();
-    void free_page_at(PhysicalAddress addr);
+    // Single pages are allocated from and freed to a small per-processor cache first, which is refilled from
+    // (and spills over into) the buddy allocator in batches. Like everything else here, these are protected by s_mm_lock.
+    struct PageCache {
+        static constexpr size_t capacity = 64;
+        static constexpr size_t refill_order = 4;
+
+        size_t count { 0 };
+        Array<PhysicalAddress, capacity> pages;
+    };
+
+    PageCache& current_page_cache();
+    void refill_page_cache(PageCache&);
+    void drain_page_caches();
 
     PhysicalRegion(PhysicalAddress lower, PhysicalAddress upper);
 
     PhysicalAddress m_lower;
     PhysicalAddress m_upper;
     unsigned m_pages { 0 };
-    unsigned m_used { 0 };
-    Bitmap m_bitmap;
-    size_t m_free_hint { 0 };
-    Vector<PhysicalAddress, 256> m_recently_returned;
+    OwnPtr<PhysicalZone> m_zone;
+    Vector<PageCache> m_page_caches;
 };
 
 }
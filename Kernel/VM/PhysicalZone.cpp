@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Format.h>
+#include <Kernel/Assertions.h>
+#include <Kernel/VM/PhysicalZone.h>
+
+namespace Kernel {
+
+static constexpr size_t pages_in_order(size_t order)
+{
+    return 1u << order;
+}
+
+static size_t order_for_page_count(size_t count)
+{
+    size_t order = 0;
+    while (pages_in_order(order) < count)
+        ++order;
+    return order;
+}
+
+PhysicalZone::PhysicalZone(PhysicalAddress lower, size_t page_count)
+    : m_first_page_number(lower.get() / PAGE_SIZE)
+    , m_page_count(page_count)
+{
+    VERIFY(lower.page_base() == lower);
+    VERIFY(page_count > 0);
+
+    m_base_page_number = m_first_page_number & ~(pages_in_order(max_order) - 1);
+    auto span = m_first_page_number + page_count - m_base_page_number;
+    for (size_t order = 0; order <= max_order; ++order) {
+        // NOTE: Bitmap searches look at whole 32-bit words, so make sure there are no partial ones at the end.
+        auto block_count = ceil_div(span, pages_in_order(order));
+        m_buckets[order].free_blocks = Bitmap(round_up_to_power_of_two(block_count, 32), false);
+    }
+
+    deallocate_contiguous_pages(lower, page_count);
+    VERIFY(m_free_page_count == page_count);
+}
+
+size_t PhysicalZone::block_index(PhysicalAddress address, size_t order) const
+{
+    auto page_number = address.get() / PAGE_SIZE;
+    VERIFY(page_number >= m_first_page_number && page_number < m_first_page_number + m_page_count);
+    auto offset = page_number - m_base_page_number;
+    VERIFY(offset % pages_in_order(order) == 0);
+    return offset >> order;
+}
+
+PhysicalAddress PhysicalZone::block_address(size_t index, size_t order) const
+{
+    return PhysicalAddress((m_base_page_number + (index << order)) * PAGE_SIZE);
+}
+
+bool PhysicalZone::is_free(size_t order, size_t index) const
+{
+    auto& bucket = m_buckets[order];
+    return index < bucket.free_blocks.size() && bucket.free_blocks.get(index);
+}
+
+void PhysicalZone::mark_free(size_t order, size_t index)
+{
+    auto& bucket = m_buckets[order];
+    VERIFY(!bucket.free_blocks.get(index));
+    bucket.free_blocks.set(index, true);
+    bucket.free_count++;
+    bucket.hint = index;
+    m_free_page_count += pages_in_order(order);
+}
+
+void PhysicalZone::mark_used(size_t order, size_t index)
+{
+    auto& bucket = m_buckets[order];
+    VERIFY(bucket.free_blocks.get(index));
+    bucket.free_blocks.set(index, false);
+    bucket.free_count--;
+    m_free_page_count -= pages_in_order(order);
+}
+
+Optional<PhysicalAddress> PhysicalZone::allocate_block(size_t order)
+{
+    VERIFY(order <= max_order);
+
+    for (auto current_order = order; current_order <= max_order; ++current_order) {
+        auto& bucket = m_buckets[current_order];
+        if (!bucket.free_count)
+            continue;
+
+        auto index = bucket.free_blocks.find_one_anywhere_set(bucket.hint);
+        VERIFY(index.has_value());
+        mark_used(current_order, index.value());
+
+        // Split the block until it's the requested size, freeing the upper half every time.
+        auto block = index.value();
+        while (current_order > order) {
+            --current_order;
+            block <<= 1;
+            mark_free(current_order, block + 1);
+        }
+        return block_address(block, order);
+    }
+    return {};
+}
+
+void PhysicalZone::deallocate_block(PhysicalAddress address, size_t order)
+{
+    VERIFY(order <= max_order);
+
+    auto block = block_index(address, order);
+    for (; order < max_order; ++order) {
+        auto buddy = block ^ 1;
+        if (!is_free(order, buddy))
+            break;
+        mark_used(order, buddy);
+        block >>= 1;
+    }
+    mark_free(order, block);
+}
+
+Optional<PhysicalAddress> PhysicalZone::allocate_contiguous_pages(size_t count, size_t physical_alignment)
+{
+    VERIFY(count > 0);
+    VERIFY(physical_alignment % PAGE_SIZE == 0);
+
+    auto alignment_in_pages = physical_alignment / PAGE_SIZE;
+    auto order = max(order_for_page_count(count), order_for_page_count(alignment_in_pages));
+    if (order <= max_order) {
+        if (auto address = allocate_block(order); address.has_value()) {
+            // Hand back whatever we got beyond what was asked for.
+            if (pages_in_order(order) > count)
+                deallocate_contiguous_pages(address.value().offset(count * PAGE_SIZE), pages_in_order(order) - count);
+            return address;
+        }
+    }
+
+    // Rounding up to a power of two can ask for more than there is, even though there may be a long enough run of free pages.
+    return allocate_free_run(count, alignment_in_pages);
+}
+
+Optional<PhysicalZone::FreeBlock> PhysicalZone::find_free_block_containing(size_t page_number) const
+{
+    auto offset = page_number - m_base_page_number;
+    for (size_t order = 0; order <= max_order; ++order) {
+        if (is_free(order, offset >> order))
+            return FreeBlock { order, offset >> order };
+    }
+    return {};
+}
+
+Optional<PhysicalAddress> PhysicalZone::allocate_free_run(size_t count, size_t alignment_in_pages)
+{
+    if (m_free_page_count < count)
+        return {};
+
+    // Walk the zone in address order, skipping over whole free blocks at a time.
+    auto end_page_number = m_first_page_number + m_page_count;
+    Optional<size_t> run_start;
+    for (auto page_number = m_first_page_number; page_number < end_page_number;) {
+        auto block = find_free_block_containing(page_number);
+        if (!block.has_value()) {
+            run_start = {};
+            ++page_number;
+            continue;
+        }
+        auto block_end = m_base_page_number + ((block->index + 1) << block->order);
+        if (!run_start.has_value()) {
+            auto aligned_page_number = round_up_to_power_of_two(page_number, alignment_in_pages);
+            if (aligned_page_number < block_end)
+                run_start = aligned_page_number;
+        }
+        if (run_start.has_value() && block_end - run_start.value() >= count) {
+            take_free_run(run_start.value(), count);
+            return PhysicalAddress(run_start.value() * PAGE_SIZE);
+        }
+        page_number = block_end;
+    }
+    return {};
+}
+
+void PhysicalZone::take_free_run(size_t first_page_number, size_t count)
+{
+    auto end_page_number = first_page_number + count;
+
+    // Take every free block overlapping the run before giving back the parts sticking out on either side,
+    // so those can't merge with a block that's part of the run.
+    auto first_block = find_free_block_containing(first_page_number);
+    VERIFY(first_block.has_value());
+    auto first_block_start = m_base_page_number + (first_block->index << first_block->order);
+    size_t last_block_end = 0;
+    for (auto page_number = first_page_number; page_number < end_page_number;) {
+        auto block = find_free_block_containing(page_number);
+        VERIFY(block.has_value());
+        mark_used(block->order, block->index);
+        last_block_end = m_base_page_number + ((block->index + 1) << block->order);
+        page_number = last_block_end;
+    }
+
+    if (first_block_start < first_page_number)
+        deallocate_contiguous_pages(PhysicalAddress(first_block_start * PAGE_SIZE), first_page_number - first_block_start);
+    if (last_block_end > end_page_number)
+        deallocate_contiguous_pages(PhysicalAddress(end_page_number * PAGE_SIZE), last_block_end - end_page_number);
+}
+
+void PhysicalZone::deallocate_contiguous_pages(PhysicalAddress address, size_t count)
+{
+    // Free the range as the largest blocks that are aligned to their own size.
+    auto page_number = address.get() / PAGE_SIZE;
+    auto end_page_number = page_number + count;
+    while (page_number < end_page_number) {
+        size_t order = max_order;
+        while (((page_number - m_base_page_number) & (pages_in_order(order) - 1)) || page_number + pages_in_order(order) > end_page_number)
+            --order;
+        deallocate_block(PhysicalAddress(page_number * PAGE_SIZE), order);
+        page_number += pages_in_order(order);
+    }
+}
+
+Optional<size_t> PhysicalZone::largest_free_order() const
+{
+    for (ssize_t order = max_order; order >= 0; --order) {
+        if (m_buckets[order].free_count)
+            return order;
+    }
+    return {};
+}
+
+}
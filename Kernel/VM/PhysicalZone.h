@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Bitmap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <Kernel/PhysicalAddress.h>
+
+namespace Kernel {
+
+// A binary buddy allocator for a range of physical pages.
+// Free blocks of 2^order pages are tracked in one bitmap per order. Allocating splits the smallest
+// free block that is large enough, and freeing merges a block with its buddy for as long as that is free too.
+// Block addresses are aligned to their size, which is what makes aligned contiguous allocations cheap.
+class PhysicalZone {
+    AK_MAKE_NONCOPYABLE(PhysicalZone);
+    AK_MAKE_NONMOVABLE(PhysicalZone);
+
+public:
+    static constexpr size_t max_order = 10;
+
+    // All pages in the zone start out free.
+    PhysicalZone(PhysicalAddress lower, size_t page_count);
+
+    Optional<PhysicalAddress> allocate_block(size_t order);
+    void deallocate_block(PhysicalAddress, size_t order);
+
+    Optional<PhysicalAddress> allocate_contiguous_pages(size_t count, size_t physical_alignment = PAGE_SIZE);
+    void deallocate_contiguous_pages(PhysicalAddress, size_t count);
+
+    size_t page_count() const { return m_page_count; }
+    size_t free_page_count() const { return m_free_page_count; }
+    size_t free_block_count(size_t order) const { return m_buckets[order].free_count; }
+    Optional<size_t> largest_free_order() const;
+
+private:
+    struct BuddyBucket {
+        Bitmap free_blocks;
+        size_t free_count { 0 };
+        size_t hint { 0 };
+    };
+
+    size_t block_index(PhysicalAddress, size_t order) const;
+    PhysicalAddress block_address(size_t index, size_t order) const;
+
+    bool is_free(size_t order, size_t index) const;
+    void mark_free(size_t order, size_t index);
+    void mark_used(size_t order, size_t index);
+
+    struct FreeBlock {
+        size_t order;
+        size_t index;
+    };
+    Optional<FreeBlock> find_free_block_containing(size_t page_number) const;
+    Optional<PhysicalAddress> allocate_free_run(size_t count, size_t alignment_in_pages);
+    void take_free_run(size_t first_page_number, size_t count);
+
+    // Page frame numbers are counted from the start of the zone rounded down to the largest block size,
+    // so that blocks of every order are physically aligned to their size.
+    size_t m_base_page_number { 0 };
+    size_t m_first_page_number { 0 };
+    size_t m_page_count { 0 };
+    size_t m_free_page_count { 0 };
+
+    Array<BuddyBucket, max_order + 1> m_buckets;
+};
+
+}
@@ -546,6 +546,12 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, Scoped
         ScopedLockRelease release_paging_lock(vmobject().m_paging_lock);
         auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
         result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
+        // Faulting in pages one after the other looks just like a sequential read, so let the
+        // inode pull the upcoming pages into its filesystem's cache in the background.
+        if (!result.is_error()) {
+            if (auto range = inode_vmobject.readahead_state().did_read(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, inode.size()); range.has_value())
+                inode.read_ahead(range->offset, range->size);
+        }
     }
 
     mm_lock.lock();
@@ -16,6 +16,7 @@ set(CHTTPJOB_DEBUG ON)
 set(CNETWORKJOB_DEBUG ON)
 set(COMMIT_DEBUG ON)
 set(COMPOSE_DEBUG ON)
+set(COMPOSE_TIMING_DEBUG ON)
 set(CONTEXT_SWITCH_DEBUG ON)
 set(CONTIGUOUS_VMOBJECT_DEBUG ON)
 set(COPY_DEBUG ON)
@@ -96,6 +97,7 @@ set(KEYBOARD_DEBUG ON)
 set(KEYBOARD_SHORTCUTS_DEBUG ON)
 set(KMALLOC_DEBUG ON)
 set(LANGUAGE_SERVER_DEBUG ON)
+set(LAYOUT_TIMING_DEBUG ON)
 set(LEXER_DEBUG ON)
 set(LINE_EDITOR_DEBUG ON)
 set(LOCAL_SOCKET_DEBUG ON)
@@ -138,6 +140,7 @@ set(PTHREAD_DEBUG ON)
 set(PTMX_DEBUG ON)
 set(REACHABLE_DEBUG ON)
 set(REGEX_DEBUG ON)
+set(REQUESTSERVER_DEBUG ON)
 set(RESIZE_DEBUG ON)
 set(RESOURCE_DEBUG ON)
 set(ROUTING_DEBUG ON)
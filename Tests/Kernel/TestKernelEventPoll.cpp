@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+static int wait_for_events(int epoll_fd, epoll_event* events, int max_events)
+{
+    return epoll_wait(epoll_fd, events, max_events, 0);
+}
+
+TEST_CASE(level_triggered_stays_ready)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = 1234;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+
+    epoll_event events[4];
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 0);
+
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+        EXPECT_EQ(events[0].events, static_cast<u32>(EPOLLIN));
+        EXPECT_EQ(events[0].data.u64, 1234u);
+    }
+
+    char buffer;
+    EXPECT_EQ(read(pipe_fds[0], &buffer, 1), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(edge_triggered_reports_once)
+{
+    int epoll_fd = epoll_create1(0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = pipe_fds[0];
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+
+    epoll_event events[4];
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+    EXPECT_EQ(events[0].data.fd, pipe_fds[0]);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 0);
+
+    // More data is a new edge.
+    EXPECT_EQ(write(pipe_fds[1], "y", 1), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(oneshot_is_rearmed_by_modify)
+{
+    int epoll_fd = epoll_create1(0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+
+    epoll_event events[4];
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 0);
+
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event), 0);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(closed_writer_makes_reader_ready)
+{
+    int epoll_fd = epoll_create1(0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    epoll_event event {};
+    event.events = EPOLLOUT;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[1], &event), 0);
+    event.events = EPOLLIN;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+
+    epoll_event events[4];
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+    EXPECT(events[0].events & EPOLLOUT);
+
+    // The writer's watch goes away with it, and the reader sees end-of-file (or a hang-up).
+    close(pipe_fds[1]);
+    EXPECT_EQ(wait_for_events(epoll_fd, events, 4), 1);
+    EXPECT(events[0].events & (EPOLLIN | EPOLLHUP));
+
+    close(pipe_fds[0]);
+    close(epoll_fd);
+}
+
+TEST_CASE(control_errors)
+{
+    int epoll_fd = epoll_create1(0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event), -1);
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), -1);
+    EXPECT_EQ(errno, EEXIST);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), 0);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    // Closing a watched file forgets about it, even if the fd number is reused.
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+    close(pipe_fds[0]);
+    EXPECT_EQ(dup2(pipe_fds[1], pipe_fds[0]), pipe_fds[0]);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static int create_file_with_contents(char const* contents, size_t size)
+{
+    char path[] = "/tmp/positional-io.XXXXXX";
+    int fd = mkstemp(path);
+    VERIFY(fd >= 0);
+    unlink(path);
+    for (size_t written = 0; written < size;) {
+        auto nwritten = write(fd, contents + written, size - written);
+        VERIFY(nwritten > 0);
+        written += nwritten;
+    }
+    VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+    return fd;
+}
+
+TEST_CASE(pread_leaves_offset_alone)
+{
+    int fd = create_file_with_contents("Hello, friends!", 15);
+
+    char buffer[16] {};
+    EXPECT_EQ(pread(fd, buffer, sizeof(buffer), 7), 8);
+    EXPECT_EQ(StringView(buffer), "friends!");
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), 0);
+
+    EXPECT_EQ(pread(fd, buffer, sizeof(buffer), 15), 0);
+    EXPECT_EQ(pread(fd, buffer, sizeof(buffer), -1), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(fd);
+}
+
+TEST_CASE(pwrite_leaves_offset_alone)
+{
+    int fd = create_file_with_contents("Hello, friends!", 15);
+
+    EXPECT_EQ(pwrite(fd, "FRIENDS", 7, 7), 7);
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), 0);
+
+    char buffer[16] {};
+    EXPECT_EQ(read(fd, buffer, sizeof(buffer)), 15);
+    EXPECT_EQ(StringView(buffer), "Hello, FRIENDS!");
+
+    close(fd);
+}
+
+TEST_CASE(preadv_fills_all_vectors)
+{
+    int fd = create_file_with_contents("Hello, friends!", 15);
+
+    char first[6] {};
+    char second[3] {};
+    char third[8] {};
+    struct iovec iov[3] = {
+        { first, 5 },
+        { second, 2 },
+        { third, sizeof(third) },
+    };
+    EXPECT_EQ(preadv(fd, iov, 3, 0), 15);
+    EXPECT_EQ(StringView(first), "Hello");
+    EXPECT_EQ(StringView(second), ", ");
+    EXPECT_EQ(StringView(third, 8), "friends!");
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), 0);
+
+    close(fd);
+}
+
+TEST_CASE(pwritev_writes_vectors_back_to_back)
+{
+    int fd = create_file_with_contents("Hello, friends!", 15);
+
+    char first[] = "FRI";
+    char second[] = "ENDS";
+    struct iovec iov[2] = {
+        { first, 3 },
+        { second, 4 },
+    };
+    EXPECT_EQ(pwritev(fd, iov, 2, 7), 7);
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), 0);
+
+    char buffer[16] {};
+    EXPECT_EQ(pread(fd, buffer, sizeof(buffer), 0), 15);
+    EXPECT_EQ(StringView(buffer), "Hello, FRIENDS!");
+
+    close(fd);
+}
+
+TEST_CASE(positional_io_needs_a_seekable_file)
+{
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    char buffer[4] {};
+    EXPECT_EQ(pwrite(pipe_fds[1], "abc", 3, 0), -1);
+    EXPECT_EQ(errno, ESPIPE);
+    EXPECT_EQ(pread(pipe_fds[0], buffer, sizeof(buffer), 0), -1);
+    EXPECT_EQ(errno, ESPIPE);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
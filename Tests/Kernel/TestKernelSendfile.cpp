@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int create_file_with_contents(char const* contents, size_t size)
+{
+    char path[] = "/tmp/sendfile.XXXXXX";
+    int fd = mkstemp(path);
+    VERIFY(fd >= 0);
+    unlink(path);
+    for (size_t written = 0; written < size;) {
+        auto nwritten = write(fd, contents + written, size - written);
+        VERIFY(nwritten > 0);
+        written += nwritten;
+    }
+    VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+    return fd;
+}
+
+TEST_CASE(sendfile_with_offset)
+{
+    int file_fd = create_file_with_contents("Hello, friends!", 15);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    off_t offset = 7;
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, &offset, 100), 8);
+    EXPECT_EQ(offset, 15);
+    // The offset of the file itself stays where it was.
+    EXPECT_EQ(lseek(file_fd, 0, SEEK_CUR), 0);
+
+    char buffer[16] {};
+    EXPECT_EQ(read(pipe_fds[0], buffer, sizeof(buffer)), 8);
+    EXPECT_EQ(StringView(buffer), "friends!");
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(file_fd);
+}
+
+TEST_CASE(sendfile_advances_file_offset)
+{
+    int file_fd = create_file_with_contents("Hello, friends!", 15);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, nullptr, 5), 5);
+    EXPECT_EQ(lseek(file_fd, 0, SEEK_CUR), 5);
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, nullptr, 100), 10);
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, nullptr, 100), 0);
+
+    char buffer[16] {};
+    EXPECT_EQ(read(pipe_fds[0], buffer, sizeof(buffer)), 15);
+    EXPECT_EQ(StringView(buffer), "Hello, friends!");
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(file_fd);
+}
+
+TEST_CASE(sendfile_needs_a_file_as_input)
+{
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    EXPECT_EQ(sendfile(pipe_fds[1], pipe_fds[0], nullptr, 1), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+static constexpr size_t benchmark_file_size = 16 * MiB;
+static constexpr size_t benchmark_iterations = 8;
+
+// Returns the sending end of a loopback TCP connection, with a child process reading everything from the other end.
+static int connect_to_draining_child(pid_t& child_pid)
+{
+    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    VERIFY(server_fd >= 0);
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    VERIFY(bind(server_fd, (sockaddr*)&address, sizeof(address)) == 0);
+    VERIFY(listen(server_fd, 1) == 0);
+    socklen_t address_size = sizeof(address);
+    VERIFY(getsockname(server_fd, (sockaddr*)&address, &address_size) == 0);
+
+    child_pid = fork();
+    VERIFY(child_pid >= 0);
+    if (child_pid == 0) {
+        int client_fd = accept(server_fd, nullptr, nullptr);
+        static char buffer[64 * KiB];
+        while (read(client_fd, buffer, sizeof(buffer)) > 0)
+            ;
+        _exit(0);
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    VERIFY(fd >= 0);
+    VERIFY(connect(fd, (sockaddr*)&address, sizeof(address)) == 0);
+    close(server_fd);
+    return fd;
+}
+
+static int create_benchmark_file()
+{
+    auto* contents = static_cast<char*>(malloc(benchmark_file_size));
+    memset(contents, 'x', benchmark_file_size);
+    int fd = create_file_with_contents(contents, benchmark_file_size);
+    free(contents);
+    return fd;
+}
+
+static void finish_benchmark(int socket_fd, int file_fd, pid_t child_pid)
+{
+    close(socket_fd);
+    close(file_fd);
+    int status;
+    waitpid(child_pid, &status, 0);
+}
+
+// These stream a file into a socket the way WebServer serves static files.
+BENCHMARK_CASE(stream_file_with_read_and_write)
+{
+    int file_fd = create_benchmark_file();
+    pid_t child_pid;
+    int socket_fd = connect_to_draining_child(child_pid);
+
+    char buffer[PAGE_SIZE];
+    for (size_t i = 0; i < benchmark_iterations; ++i) {
+        EXPECT_EQ(lseek(file_fd, 0, SEEK_SET), 0);
+        for (;;) {
+            auto nread = read(file_fd, buffer, sizeof(buffer));
+            if (nread <= 0)
+                break;
+            EXPECT_EQ(write(socket_fd, buffer, nread), nread);
+        }
+    }
+
+    finish_benchmark(socket_fd, file_fd, child_pid);
+}
+
+BENCHMARK_CASE(stream_file_with_sendfile)
+{
+    int file_fd = create_benchmark_file();
+    pid_t child_pid;
+    int socket_fd = connect_to_draining_child(child_pid);
+
+    for (size_t i = 0; i < benchmark_iterations; ++i) {
+        off_t offset = 0;
+        while (sendfile(socket_fd, file_fd, &offset, 1 * MiB) > 0)
+            ;
+        EXPECT_EQ(offset, static_cast<off_t>(benchmark_file_size));
+    }
+
+    finish_benchmark(socket_fd, file_fd, child_pid);
+}
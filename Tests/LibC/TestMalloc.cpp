@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Format.h>
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibPthread/pthread.h>
+#include <LibTest/TestCase.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr size_t sizes_to_allocate[] = { 8, 24, 48, 100, 200, 400, 1000, 3000 };
+// Lands in the largest size class, where every chunk has a block to itself and a thread stashes at most one of them.
+static constexpr size_t largest_class_allocation_size = 20000;
+
+static void* churn(void* arg)
+{
+    auto iterations = reinterpret_cast<FlatPtr>(arg);
+    void* live[32] {};
+    for (size_t i = 0; i < iterations; ++i) {
+        auto slot = i % 32;
+        free(live[slot]);
+        auto size = sizes_to_allocate[i % (sizeof(sizes_to_allocate) / sizeof(sizes_to_allocate[0]))];
+        live[slot] = malloc(size);
+        VERIFY(live[slot]);
+        memset(live[slot], (u8)i, size);
+    }
+    for (auto* ptr : live)
+        free(ptr);
+    return nullptr;
+}
+
+static void* free_everything(void* arg)
+{
+    auto** pointers = static_cast<void**>(arg);
+    for (size_t i = 0; pointers[i]; ++i) {
+        EXPECT_EQ(*static_cast<u8*>(pointers[i]), (u8)i);
+        free(pointers[i]);
+    }
+    return nullptr;
+}
+
+static void* free_pointer(void* arg)
+{
+    free(arg);
+    return nullptr;
+}
+
+static void* allocate_and_free_on_another_thread(void*)
+{
+    // We're a fresh thread with nothing stashed, so this comes straight from the shared blocks.
+    auto* ptr = malloc(largest_class_allocation_size);
+    EXPECT(ptr);
+
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, free_pointer, ptr), 0);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    // The other thread stashed the chunk, and must have handed it back when it exited.
+    auto* reused = malloc(largest_class_allocation_size);
+    EXPECT_EQ(reused, ptr);
+    free(reused);
+    return nullptr;
+}
+
+static int run_threads(size_t thread_count, size_t iterations_per_thread)
+{
+    Vector<pthread_t> threads;
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (size_t i = 0; i < thread_count; ++i) {
+        pthread_t thread;
+        EXPECT_EQ(pthread_create(&thread, nullptr, churn, reinterpret_cast<void*>(iterations_per_thread)), 0);
+        threads.append(thread);
+    }
+    for (auto thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    return timer.elapsed();
+}
+
+TEST_CASE(free_on_another_thread)
+{
+    static constexpr size_t count = 1000;
+    void* pointers[count + 1] {};
+    for (size_t i = 0; i < count; ++i) {
+        pointers[i] = malloc(16 + i % 200);
+        memset(pointers[i], (u8)i, 16 + i % 200);
+    }
+
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, free_everything, pointers), 0);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    // Check that a chunk freed elsewhere is actually reused, on a thread of its own so that nothing is stashed yet.
+    EXPECT_EQ(pthread_create(&thread, nullptr, allocate_and_free_on_another_thread, nullptr), 0);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+}
+
+TEST_CASE(concurrent_churn)
+{
+    run_threads(4, 10000);
+}
+
+BENCHMARK_CASE(malloc_throughput)
+{
+    static constexpr size_t iterations_per_thread = 1'000'000;
+    for (size_t thread_count = 1; thread_count <= 8; thread_count *= 2) {
+        auto elapsed_ms = max(run_threads(thread_count, iterations_per_thread), 1);
+        outln("{} thread(s): {} malloc/free pairs/ms", thread_count, thread_count * iterations_per_thread / elapsed_ms);
+    }
+}
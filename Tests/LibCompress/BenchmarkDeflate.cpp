@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteBuffer.h>
+#include <AK/Format.h>
+#include <AK/StringBuilder.h>
+#include <LibCompress/Deflate.h>
+#include <time.h>
+
+// A fixed mix of text-like and binary-like data, generated with a fixed seed so every run compresses the exact same bytes
+static ByteBuffer const& corpus()
+{
+    static ByteBuffer corpus;
+    if (!corpus.is_empty())
+        return corpus;
+
+    static constexpr StringView words[] = {
+        "the"sv, "of"sv, "and"sv, "to"sv, "in"sv, "is"sv, "that"sv, "for"sv, "it"sv, "as"sv, "was"sv, "with"sv, "be"sv,
+        "by"sv, "on"sv, "not"sv, "he"sv, "this"sv, "are"sv, "or"sv, "his"sv, "from"sv, "at"sv, "which"sv, "but"sv,
+        "have"sv, "an"sv, "had"sv, "they"sv, "you"sv, "were"sv, "their"sv, "one"sv, "all"sv, "we"sv, "can"sv, "her"sv,
+        "has"sv, "there"sv, "been"sv, "if"sv, "more"sv, "when"sv, "will"sv, "would"sv, "who"sv, "so"sv, "no"sv,
+        "compression"sv, "window"sv, "serenity"sv, "kernel"sv, "filesystem"sv, "process"sv, "deflate"sv, "buffer"sv,
+    };
+    constexpr size_t text_size = 768 * KiB;
+    constexpr size_t binary_size = 256 * KiB;
+
+    u32 state = 0x5eed;
+    auto next_random = [&] {
+        state = state * 1103515245 + 12345;
+        return state >> 16;
+    };
+
+    StringBuilder builder;
+    while (builder.length() < text_size) {
+        auto sentence_length = 5 + next_random() % 15;
+        for (size_t i = 0; i < sentence_length; i++) {
+            if (i != 0)
+                builder.append(' ');
+            builder.append(words[next_random() % array_size(words)]);
+        }
+        builder.append(next_random() % 4 ? ". "sv : ".\n"sv);
+    }
+    corpus = builder.to_byte_buffer().slice(0, text_size);
+
+    // A table of little-endian records with slowly changing fields and some noise
+    for (u32 i = 0; corpus.size() < text_size + binary_size; i++) {
+        u32 record[4] = { i, i / 16, 0x1000 + (i % 64) * 8, next_random() % 256 };
+        corpus.append(record, sizeof(record));
+    }
+    return corpus;
+}
+
+static void benchmark_level(Compress::DeflateCompressor::CompressionLevel level)
+{
+    auto& input = corpus();
+
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    auto compressed = Compress::DeflateCompressor::compress_all(input, level);
+    timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    EXPECT(compressed.has_value());
+
+    auto elapsed_seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1'000'000'000.0;
+    outln("level {}: {} -> {} bytes ({:.1}%), {:.2} MiB/s", static_cast<int>(level), input.size(), compressed.value().size(),
+        100.0 * compressed.value().size() / input.size(), input.size() / elapsed_seconds / MiB);
+
+    auto decompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(decompressed.has_value());
+    EXPECT(decompressed.value() == input);
+}
+
+#define DEFLATE_BENCHMARK_LEVEL(level)                                                       \
+    BENCHMARK_CASE(deflate_level_##level)                                                    \
+    {                                                                                        \
+        benchmark_level(static_cast<Compress::DeflateCompressor::CompressionLevel>(level)); \
+    }
+
+DEFLATE_BENCHMARK_LEVEL(1)
+DEFLATE_BENCHMARK_LEVEL(2)
+DEFLATE_BENCHMARK_LEVEL(3)
+DEFLATE_BENCHMARK_LEVEL(4)
+DEFLATE_BENCHMARK_LEVEL(5)
+DEFLATE_BENCHMARK_LEVEL(6)
+DEFLATE_BENCHMARK_LEVEL(7)
+DEFLATE_BENCHMARK_LEVEL(8)
+DEFLATE_BENCHMARK_LEVEL(9)
+DEFLATE_BENCHMARK_LEVEL(10)
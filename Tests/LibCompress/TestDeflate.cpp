@@ -154,3 +154,22 @@ TEST_CASE(deflate_compress_literals)
     auto compressed = Compress::DeflateCompressor::compress_all(test, Compress::DeflateCompressor::CompressionLevel::GOOD);
     EXPECT(compressed.has_value());
 }
+
+TEST_CASE(deflate_round_trip_compress_all_levels)
+{
+    // Repeat the random end of the first block at the start of the second one, so the matches have to reach back into the previous block
+    auto block_size = Compress::DeflateCompressor::block_size;
+    auto size = block_size * 3;
+    auto original = ByteBuffer::create_zeroed(size);
+    for (size_t i = 0; i < size; i += 7)
+        original[i] = i % 251;
+    fill_with_random(original.data() + block_size - 4096, 4096);
+    memcpy(original.data() + block_size, original.data() + block_size - 4096, 4096);
+    for (int level = 0; level <= Compress::DeflateCompressor::max_compression_level; level++) {
+        auto compressed = Compress::DeflateCompressor::compress_all(original, static_cast<Compress::DeflateCompressor::CompressionLevel>(level));
+        EXPECT(compressed.has_value());
+        auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+        EXPECT(uncompressed.has_value());
+        EXPECT(uncompressed.value() == original);
+    }
+}
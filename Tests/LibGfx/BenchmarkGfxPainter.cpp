@@ -6,9 +6,11 @@
 
 #include <LibTest/TestCase.h>
 
+#include <LibCore/ElapsedTimer.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/FontDatabase.h>
 #include <LibGfx/Painter.h>
+#include <LibGfx/ScanlineOperations.h>
 #include <stdio.h>
 
 // Make sure that no matter what order tests are run in, we've got some
@@ -61,3 +63,116 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+// Runs a primitive with and without the SIMD scanline operations, and reports how many megapixels per second it got through.
+template<typename Callback>
+static void report_megapixels_per_second(const char* name, size_t pixels_per_run, int run_count, Callback callback)
+{
+    auto was_enabled = Gfx::ScanlineOperations::is_simd_enabled();
+    for (bool enabled : { false, true }) {
+        Gfx::ScanlineOperations::set_simd_enabled(enabled);
+        Core::ElapsedTimer timer;
+        timer.start();
+        for (int run = 0; run < run_count; run++)
+            callback();
+        auto elapsed_ms = max(timer.elapsed(), 1);
+        outln("{} ({}): {} megapixels per second", name, enabled ? "SIMD" : "scalar", (u64)pixels_per_run * run_count / elapsed_ms / 1000);
+    }
+    Gfx::ScanlineOperations::set_simd_enabled(was_enabled);
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_bitmap_with_alpha(int size)
+{
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { size, size }).release_nonnull();
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            // A mix of opaque, transparent and translucent pixels, like a window with rounded corners and a shadow.
+            u8 alpha = x < size / 4 ? 0 : (x < size / 2 ? (x * 255 / size) : 255);
+            bitmap->scanline(y)[x] = Color(x, y, x ^ y, alpha).value();
+        }
+    }
+    return bitmap;
+}
+
+BENCHMARK_CASE(blit_opaque)
+{
+    const int run_count = 200;
+    const int bitmap_size = 1000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    auto source = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    Gfx::Painter painter(*bitmap);
+
+    report_megapixels_per_second("blit_opaque", bitmap_size * bitmap_size, run_count, [&] {
+        painter.blit({}, *source, source->rect());
+    });
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    const int run_count = 100;
+    const int bitmap_size = 1000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    auto source = create_bitmap_with_alpha(bitmap_size);
+    Gfx::Painter painter(*bitmap);
+
+    report_megapixels_per_second("blit_with_alpha", bitmap_size * bitmap_size, run_count, [&] {
+        painter.blit({}, *source, source->rect());
+    });
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    const int run_count = 100;
+    const int bitmap_size = 1000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    auto source = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    Gfx::Painter painter(*bitmap);
+
+    report_megapixels_per_second("blit_with_opacity", bitmap_size * bitmap_size, run_count, [&] {
+        painter.blit({}, *source, source->rect(), 0.5f);
+    });
+}
+
+BENCHMARK_CASE(fill_translucent)
+{
+    const int run_count = 100;
+    const int bitmap_size = 1000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    Gfx::Painter painter(*bitmap);
+
+    report_megapixels_per_second("fill_translucent", bitmap_size * bitmap_size, run_count, [&] {
+        painter.fill_rect(bitmap->rect(), Color(Color::Blue).with_alpha(100));
+    });
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_2x)
+{
+    const int run_count = 50;
+    const int bitmap_size = 1000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    auto source = create_bitmap_with_alpha(bitmap_size / 2);
+    Gfx::Painter painter(*bitmap);
+
+    report_megapixels_per_second("draw_scaled_bitmap_2x", bitmap_size * bitmap_size, run_count, [&] {
+        painter.draw_scaled_bitmap(bitmap->rect(), *source, source->rect());
+    });
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_fractional)
+{
+    const int run_count = 50;
+    const int bitmap_size = 1000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size });
+    auto source = create_bitmap_with_alpha(700);
+    Gfx::Painter painter(*bitmap);
+
+    report_megapixels_per_second("draw_scaled_bitmap_fractional", bitmap_size * bitmap_size, run_count, [&] {
+        painter.draw_scaled_bitmap(bitmap->rect(), *source, source->rect(), 0.8f);
+    });
+}
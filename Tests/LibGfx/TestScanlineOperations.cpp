@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/FontDatabase.h>
+#include <LibGfx/Painter.h>
+#include <LibGfx/ScanlineOperations.h>
+#include <stdlib.h>
+
+// Painter wants a default font, so make sure it can get one without talking to WindowServer.
+static struct FontDatabaseSpoofer {
+    FontDatabaseSpoofer()
+    {
+        Gfx::FontDatabase::the().set_default_font_query("Katica 10 400"sv);
+    }
+} g_spoof;
+
+// Odd sizes, so the SIMD loops also have leftover pixels to deal with.
+static constexpr size_t pixel_count = 1027;
+
+static Vector<Gfx::RGBA32> random_pixels(bool mostly_opaque_or_transparent = false)
+{
+    Vector<Gfx::RGBA32> pixels;
+    pixels.resize(pixel_count);
+    for (auto& pixel : pixels) {
+        pixel = (Gfx::RGBA32)random();
+        if (mostly_opaque_or_transparent && random() % 4 != 0)
+            pixel = random() % 2 ? (pixel | 0xff000000) : (pixel & 0x00ffffff);
+    }
+    return pixels;
+}
+
+// What Painter did for each pixel before it had the scanline operations.
+static Gfx::RGBA32 reference_blend(Gfx::RGBA32 dst, Gfx::RGBA32 src, u8 alpha)
+{
+    return Color::from_rgb(dst).blend(Color::from_rgb(src).with_alpha(alpha)).value();
+}
+
+template<typename Callback>
+static void for_each_simd_setting(Callback callback)
+{
+    auto was_enabled = Gfx::ScanlineOperations::is_simd_enabled();
+    for (bool enabled : { false, true }) {
+        Gfx::ScanlineOperations::set_simd_enabled(enabled);
+        callback();
+    }
+    Gfx::ScanlineOperations::set_simd_enabled(was_enabled);
+}
+
+TEST_CASE(blend_with_source_alpha)
+{
+    for_each_simd_setting([] {
+        for (bool mostly_opaque_or_transparent : { false, true }) {
+            auto dst = random_pixels();
+            auto src = random_pixels(mostly_opaque_or_transparent);
+            auto expected = dst;
+            for (size_t i = 0; i < pixel_count; ++i)
+                expected[i] = reference_blend(dst[i], src[i], src[i] >> 24);
+
+            Gfx::ScanlineOperations::blend_with_source_alpha(dst.data(), src.data(), pixel_count);
+            EXPECT(dst == expected);
+        }
+    });
+}
+
+TEST_CASE(blend_with_source_alpha_and_alpha_table)
+{
+    u8 alpha_table[256];
+    for (int alpha = 0; alpha < 256; ++alpha)
+        alpha_table[alpha] = alpha / 3;
+
+    for_each_simd_setting([&] {
+        auto dst = random_pixels();
+        auto src = random_pixels(true);
+        auto expected = dst;
+        for (size_t i = 0; i < pixel_count; ++i)
+            expected[i] = reference_blend(dst[i], src[i], alpha_table[src[i] >> 24]);
+
+        Gfx::ScanlineOperations::blend_with_source_alpha(dst.data(), src.data(), pixel_count, alpha_table);
+        EXPECT(dst == expected);
+    });
+}
+
+TEST_CASE(blend_with_constant_alpha)
+{
+    for_each_simd_setting([] {
+        for (u8 alpha : { 0, 1, 127, 128, 254, 255 }) {
+            auto dst = random_pixels();
+            auto src = random_pixels();
+            auto expected = dst;
+            for (size_t i = 0; i < pixel_count; ++i)
+                expected[i] = reference_blend(dst[i], src[i], alpha);
+
+            Gfx::ScanlineOperations::blend_with_constant_alpha(dst.data(), src.data(), pixel_count, alpha);
+            EXPECT(dst == expected);
+        }
+    });
+}
+
+TEST_CASE(fill_blended)
+{
+    for_each_simd_setting([] {
+        for (u8 alpha : { 1, 100, 200, 254 }) {
+            auto color = Color::from_rgb(random()).with_alpha(alpha);
+            auto dst = random_pixels();
+            auto expected = dst;
+            for (size_t i = 0; i < pixel_count; ++i)
+                expected[i] = Color::from_rgb(dst[i]).blend(color).value();
+
+            Gfx::ScanlineOperations::fill_blended(dst.data(), pixel_count, color);
+            EXPECT(dst == expected);
+        }
+    });
+}
+
+TEST_CASE(painter_blit_with_opacity_onto_opaque_bitmap)
+{
+    auto source = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 37, 23 });
+    auto target = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 41, 29 });
+    for (int y = 0; y < source->height(); ++y) {
+        for (int x = 0; x < source->width(); ++x)
+            source->scanline(y)[x] = random();
+    }
+    for (int y = 0; y < target->height(); ++y) {
+        for (int x = 0; x < target->width(); ++x)
+            target->scanline(y)[x] = random() | 0xff000000;
+    }
+
+    auto expected = target->clone();
+    float opacity = 0.6f;
+    for (int y = 0; y < source->height(); ++y) {
+        for (int x = 0; x < source->width(); ++x) {
+            auto src_color = Color::from_rgba(source->scanline(y)[x]);
+            float pixel_opacity = src_color.alpha() / 255.0;
+            src_color.set_alpha(255 * (opacity * pixel_opacity));
+            auto& pixel = expected->scanline(y + 3)[x + 2];
+            pixel = Color::from_rgb(pixel).blend(src_color).value();
+        }
+    }
+
+    Gfx::Painter painter(*target);
+    painter.blit({ 2, 3 }, *source, source->rect(), opacity);
+    for (int y = 0; y < target->height(); ++y) {
+        for (int x = 0; x < target->width(); ++x)
+            EXPECT_EQ(target->scanline(y)[x], expected->scanline(y)[x]);
+    }
+}
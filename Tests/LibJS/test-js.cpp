@@ -32,6 +32,12 @@ TESTJS_GLOBAL_FUNCTION(run_queued_promise_jobs, runQueuedPromiseJobs)
     return JS::js_undefined();
 }
 
+TESTJS_GLOBAL_FUNCTION(collect_young_generation, collectYoungGeneration, 0)
+{
+    vm.heap().collect_garbage(JS::Heap::CollectionType::CollectYoungGeneration);
+    return JS::js_undefined();
+}
+
 TESTJS_GLOBAL_FUNCTION(get_weak_set_size, getWeakSetSize)
 {
     auto* object = vm.argument(0).to_object(global_object);
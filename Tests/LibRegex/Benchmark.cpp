@@ -966,4 +966,28 @@ BENCHMARK_CASE(simple_notbol_noteol_benchmark_reference_stdcpp)
 }
 #    endif
 
+#    if defined(REGEX_BENCHMARK_OUR)
+BENCHMARK_CASE(greedy_loop_no_match_benchmark)
+{
+    Regex<ECMA262> re("a*b");
+    String haystack = String::repeated('a', 1000);
+    RegexResult m;
+    for (size_t i = 0; i < BENCHMARK_LOOP_ITERATIONS / 100; ++i) {
+        EXPECT_EQ(re.match(haystack, m), false);
+    }
+}
+#    endif
+
+#    if defined(REGEX_BENCHMARK_OUR)
+BENCHMARK_CASE(literal_prefix_search_benchmark)
+{
+    Regex<ECMA262> re("needle[0-9]+");
+    String haystack = String::formatted("{}needle42", String::repeated('x', 4000));
+    for (size_t i = 0; i < BENCHMARK_LOOP_ITERATIONS / 100; ++i) {
+        auto result = re.search(haystack);
+        EXPECT_EQ(result.count, 1u);
+    }
+}
+#    endif
+
 #endif
@@ -626,3 +626,117 @@ TEST_CASE(case_insensitive_match)
     EXPECT_EQ(result.success, true);
     EXPECT_EQ(result.matches.at(0).column, 4ul);
 }
+
+template<typename Parser>
+static bool bytecode_contains(const Regex<Parser>& re, regex::OpCodeId id)
+{
+    regex::MatchState state;
+    auto& bytecode = re.parser_result.bytecode;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = bytecode.get_opcode(state);
+        if (opcode.opcode_id() == id)
+            return true;
+        state.instruction_position += opcode.size();
+    }
+    return false;
+}
+
+TEST_CASE(optimizer_atomic_loops)
+{
+    struct _test {
+        const char* pattern;
+        const char* subject;
+        bool matches { true };
+        bool is_atomic { true };
+        ECMAScriptFlags options {};
+    };
+    // clang-format off
+    constexpr _test tests[] {
+        { "^a*b$", "aaab" },
+        { "^a+b$", "b", false },
+        { "^[^\"]*\"$", "xyz\"" },
+        { "^\\d+x$", "123x" },
+        { "^a*", "aaaa" },
+        // These need to backtrack into the loop, so it must stay as it is.
+        { "^a*a$", "aaa", true, false },
+        { "^\\d+\\w$", "123", true, false },
+        { "^a*A$", "aaA", true, false, ECMAScriptFlags::Insensitive },
+        { "^[^a]*A$", "xA", true, false },
+    };
+    // clang-format on
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.pattern, test.options);
+        EXPECT_EQ(re.parser_result.error, Error::NoError);
+        EXPECT_EQ(bytecode_contains(re, regex::OpCodeId::AtomicRepeat), test.is_atomic);
+        EXPECT_EQ(re.match(test.subject).success, test.matches);
+    }
+
+    // Without the fork per iteration, long runs no longer exhaust the recursion limit.
+    StringBuilder builder;
+    for (size_t i = 0; i < 2 * regex::c_max_recursion; ++i)
+        builder.append('a');
+    builder.append('b');
+    Regex<ECMA262> re("^a+b$");
+    EXPECT(re.match(builder.string_view()).success);
+}
+
+TEST_CASE(optimizer_lookup_tables)
+{
+    struct _test {
+        const char* pattern;
+        const char* subject;
+        bool matches { true };
+        ECMAScriptFlags options {};
+    };
+    // clang-format off
+    constexpr _test tests[] {
+        { "^(?:a|b|c)+$", "abcab" },
+        { "^(?:a|b|c)+$", "abd", false },
+        { "^[a-cx-z]$", "y" },
+        { "^[a-cx-z]$", "Y", false },
+        { "^[a-cx-z]$", "Y", true, ECMAScriptFlags::Insensitive },
+        { "^[^a-cx]$", "b", false },
+        { "^[^a-cx]$", "d" },
+        { "^[^a-cx]$", "X", false, ECMAScriptFlags::Insensitive },
+    };
+    // clang-format on
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.pattern, test.options);
+        EXPECT_EQ(re.parser_result.error, Error::NoError);
+        EXPECT_EQ(re.match(test.subject).success, test.matches);
+    }
+
+    Regex<ECMA262> re("(a|b)c");
+    auto result = re.search("xxbc");
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.capture_group_matches.at(0).at(0).view.to_string(), "b");
+}
+
+TEST_CASE(optimizer_literal_prefix)
+{
+    Regex<ECMA262> re("hello\\d");
+    EXPECT_EQ(re.optimization_data.literal_prefix, "hello");
+
+    auto result = re.search("say hello1 and hello2, not hellox");
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.count, 2u);
+    EXPECT_EQ(result.matches.at(0).column, 4ul);
+    EXPECT_EQ(result.matches.at(1).column, 15ul);
+
+    u32 code_points[] = { 0xe9, 'h', 'e', 'l', 'l', 'o', '7' };
+    result = re.search(Utf32View { code_points, sizeof(code_points) / sizeof(code_points[0]) });
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.matches.at(0).column, 1ul);
+
+    Regex<ECMA262> anchored("hello");
+    EXPECT_EQ(anchored.match("xhello").success, false);
+
+    Regex<ECMA262> insensitive("hello", ECMAScriptFlags::Insensitive);
+    EXPECT_EQ(insensitive.search("xHeLLo").success, true);
+
+    // Only ASCII can be looked for the same way in byte and code point views.
+    Regex<ECMA262> non_ascii("h\xc3\xa9llo");
+    EXPECT_EQ(non_ascii.optimization_data.literal_prefix, "h");
+}
@@ -37,6 +37,7 @@ public:
     }
 
     static Wasm::AbstractMachine& machine() { return m_machine; }
+    static Wasm::BytecodeInterpreter& interpreter() { return m_interpreter; }
     Wasm::Module& module() { return *m_module; }
     Wasm::ModuleInstance& module_instance() { return *m_module_instance; }
 
@@ -85,11 +86,13 @@ private:
 
     static HashMap<Wasm::Linker::Name, Wasm::ExternValue> s_spec_test_namespace;
     static Wasm::AbstractMachine m_machine;
+    static Wasm::BytecodeInterpreter m_interpreter;
     Optional<Wasm::Module> m_module;
     OwnPtr<Wasm::ModuleInstance> m_module_instance;
 };
 
 Wasm::AbstractMachine WebAssemblyModule::m_machine;
+Wasm::BytecodeInterpreter WebAssemblyModule::m_interpreter;
 HashMap<Wasm::Linker::Name, Wasm::ExternValue> WebAssemblyModule::s_spec_test_namespace;
 
 TESTJS_GLOBAL_FUNCTION(parse_webassembly_module, parseWebAssemblyModule)
@@ -133,6 +136,11 @@ TESTJS_GLOBAL_FUNCTION(parse_webassembly_module, parseWebAssemblyModule)
     return WebAssemblyModule::create(global_object, result.release_value(), imports);
 }
 
+TESTJS_GLOBAL_FUNCTION(executed_wasm_instruction_count, executedWasmInstructionCount)
+{
+    return JS::Value(static_cast<double>(WebAssemblyModule::interpreter().executed_instructions()));
+}
+
 TESTJS_GLOBAL_FUNCTION(compare_typed_arrays, compareTypedArrays)
 {
     auto lhs = vm.argument(0).to_object(global_object);
@@ -252,7 +260,7 @@ JS_DEFINE_NATIVE_FUNCTION(WebAssemblyModule::wasm_invoke)
         }
     }
 
-    auto result = WebAssemblyModule::machine().invoke(function_address, arguments);
+    auto result = WebAssemblyModule::machine().invoke(WebAssemblyModule::interpreter(), function_address, arguments);
     if (result.is_trap()) {
         vm.throw_exception<JS::TypeError>(global_object, String::formatted("Execution trapped: {}", result.trap().reason));
         return {};
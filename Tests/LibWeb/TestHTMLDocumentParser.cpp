@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/StringBuilder.h>
+#include <AK/StringView.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Timer.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/DOM/Element.h>
+#include <LibWeb/HTML/HTMLElement.h>
+#include <LibWeb/HTML/Parser/HTMLDocumentParser.h>
+
+using Web::DOM::Document;
+using Web::HTML::HTMLDocumentParser;
+
+static const URL url { "about:blank" };
+
+static constexpr StringView source = "<!DOCTYPE html>\n"
+                                     "<html><head><title>Caf\xc3\xa9</title></head>\n"
+                                     "<body class=\"a&amp;b\"><p>Hello <b>bold</b> world &notin; &#x1F600;</p>\n"
+                                     "<ul><li>one<li>two</ul><table><tr><td>cell</table>\n"
+                                     "<!-- comment --><p>unclosed\n"
+                                     "</body></html>\n"sv;
+
+static String serialize(Document& document)
+{
+    return document.document_element()->inner_html();
+}
+
+static String parse_in_one_go(const StringView& input)
+{
+    auto document = Web::HTML::parse_html_document(input, url, "utf-8");
+    return serialize(*document);
+}
+
+// Appends the input in pieces that end at the given offsets, one per trip around the event loop so that the
+// parser gets to run out of input in between, and returns the document once the parser says it's done.
+static NonnullRefPtr<Document> parse_split_at(const StringView& input, const Vector<size_t>& split_offsets)
+{
+    Core::EventLoop loop;
+    auto document = Document::create(url);
+    HTMLDocumentParser parser { document, "utf-8" };
+    bool finished = false;
+    parser.on_finish = [&] {
+        EXPECT(!finished);
+        finished = true;
+        loop.quit(0);
+    };
+    parser.run_incrementally(url);
+
+    size_t next_split = 0;
+    size_t offset = 0;
+    bool eof_inserted = false;
+    auto feeder = Core::Timer::create_repeating(0, [&] {
+        if (eof_inserted)
+            return;
+        if (next_split == split_offsets.size()) {
+            parser.append_input(input.substring_view(offset));
+            parser.insert_eof();
+            eof_inserted = true;
+            return;
+        }
+        auto split_offset = split_offsets[next_split++];
+        VERIFY(split_offset >= offset && split_offset <= input.length());
+        parser.append_input(input.substring_view(offset, split_offset - offset));
+        offset = split_offset;
+        // Nothing must be done with the input before we get back to the event loop.
+        EXPECT(!finished);
+    });
+    auto watchdog = Core::Timer::create_single_shot(10000, [&] { loop.quit(1); });
+    feeder->start();
+    watchdog->start();
+    loop.exec();
+
+    EXPECT(finished);
+    EXPECT_EQ(document->ready_state(), "complete");
+    return document;
+}
+
+TEST_CASE(split_at_every_byte_boundary)
+{
+    auto expected = parse_in_one_go(source);
+    for (size_t offset = 0; offset <= source.length(); ++offset)
+        EXPECT_EQ(serialize(parse_split_at(source, { offset })), expected);
+}
+
+TEST_CASE(one_byte_at_a_time)
+{
+    Vector<size_t> split_offsets;
+    for (size_t offset = 1; offset < source.length(); ++offset)
+        split_offsets.append(offset);
+    EXPECT_EQ(serialize(parse_split_at(source, split_offsets)), parse_in_one_go(source));
+}
+
+TEST_CASE(text_arriving_later_is_appended)
+{
+    auto input = "<p>Hello world</p>"sv;
+    auto document = parse_split_at(input, { 6, 9, 12 });
+    EXPECT_EQ(document->body()->inner_html(), "<p>Hello world</p>");
+}
+
+// Big enough that it doesn't get parsed in a single time slice.
+TEST_CASE(document_spanning_several_time_slices)
+{
+    StringBuilder builder;
+    builder.append("<!DOCTYPE html><body>");
+    for (size_t i = 0; i < 50000; ++i)
+        builder.appendff("<p id=p{}>paragraph {}</p>", i, i);
+    auto input = builder.to_string();
+
+    auto document = parse_split_at(input, {});
+    EXPECT_EQ(document->body()->child_count(), 50000);
+    EXPECT_EQ(serialize(document), parse_in_one_go(input));
+}
+
+TEST_CASE(abort_before_end_of_input)
+{
+    Core::EventLoop loop;
+    auto document = Document::create(url);
+    OwnPtr<HTMLDocumentParser> parser = make<HTMLDocumentParser>(document, "utf-8");
+    parser->on_finish = [&] {
+        FAIL("Aborted parser finished");
+    };
+    parser->run_incrementally(url);
+    parser->append_input("<!DOCTYPE html><body><p>first");
+
+    auto abort_timer = Core::Timer::create_single_shot(0, [&] {
+        HTMLDocumentParser::abort_and_destroy(parser.release_nonnull());
+    });
+    auto quit_timer = Core::Timer::create_single_shot(100, [&] { loop.quit(0); });
+    abort_timer->start();
+    quit_timer->start();
+    loop.exec();
+
+    EXPECT(!parser);
+    EXPECT_EQ(document->ready_state(), "loading");
+}
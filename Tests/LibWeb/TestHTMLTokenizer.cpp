@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/StringBuilder.h>
+#include <AK/StringView.h>
+#include <LibWeb/HTML/Parser/HTMLTokenizer.h>
+
+using Web::HTML::HTMLTokenizer;
+
+// Covers everything the tokenizer may have to wait for more input in the middle of: multi-byte UTF-8 sequences,
+// the keywords of a DOCTYPE, named character references (including the longest one there is) and comment starts.
+static constexpr StringView document = "<!DOCTYPE html PUBLIC \"-//W3C//DTD HTML 4.01//EN\" \"http://www.w3.org/TR/html4/strict.dtd\">\n"
+                                       "<html><head><title>Caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80</title></head>\n"
+                                       "<body class=\"a&amp;b\" data-x='&CounterClockwiseContourIntegral;'>\n"
+                                       "&CounterClockwiseContourIntegral; &notin; &notit; &not &#x1F600; &#169 &#xD800;\n"
+                                       "<!-- comment --><!----><!---><!--x--!><!-- a -- b -->\n"
+                                       "<br/><img src=x alt=\"\xce\xbb\"/><p>text</p><?pi?>\n"
+                                       "<!doctype html SYSTEM 'about:legacy-compat'><!DOCTYPE html PUBLIC>\n"
+                                       "</body></html>\n"sv;
+
+static String serialize_tokens(HTMLTokenizer& tokenizer)
+{
+    StringBuilder builder;
+    for (auto token = tokenizer.next_token(); token.has_value(); token = tokenizer.next_token()) {
+        builder.append(token->to_string());
+        builder.append('\n');
+    }
+    return builder.to_string();
+}
+
+static String tokenize_in_one_go(const StringView& input)
+{
+    HTMLTokenizer tokenizer { input, "utf-8" };
+    return serialize_tokens(tokenizer);
+}
+
+// Feeds the input in pieces that end at the given offsets, taking all the tokens we can get after each of them.
+static String tokenize_split_at(const StringView& input, const Vector<size_t>& split_offsets)
+{
+    HTMLTokenizer tokenizer { "utf-8" };
+    StringBuilder builder;
+    size_t offset = 0;
+    for (auto split_offset : split_offsets) {
+        VERIFY(split_offset >= offset && split_offset <= input.length());
+        tokenizer.append_input(input.substring_view(offset, split_offset - offset));
+        builder.append(serialize_tokens(tokenizer));
+        offset = split_offset;
+    }
+    tokenizer.append_input(input.substring_view(offset));
+    tokenizer.insert_eof();
+    builder.append(serialize_tokens(tokenizer));
+    return builder.to_string();
+}
+
+static void expect_same_tokens_when_split_inside(const StringView& needle)
+{
+    auto expected = tokenize_in_one_go(document);
+    size_t occurrences = 0;
+    for (size_t start = 0; start + needle.length() <= document.length(); ++start) {
+        if (document.substring_view(start, needle.length()) != needle)
+            continue;
+        ++occurrences;
+        for (size_t i = 1; i < needle.length(); ++i)
+            EXPECT_EQ(tokenize_split_at(document, { start + i }), expected);
+    }
+    EXPECT(occurrences > 0);
+}
+
+TEST_CASE(split_at_every_byte_boundary)
+{
+    auto expected = tokenize_in_one_go(document);
+    for (size_t offset = 0; offset <= document.length(); ++offset)
+        EXPECT_EQ(tokenize_split_at(document, { offset }), expected);
+}
+
+TEST_CASE(one_byte_at_a_time)
+{
+    Vector<size_t> split_offsets;
+    for (size_t offset = 1; offset < document.length(); ++offset)
+        split_offsets.append(offset);
+    EXPECT_EQ(tokenize_split_at(document, split_offsets), tokenize_in_one_go(document));
+}
+
+TEST_CASE(split_inside_multi_byte_sequence)
+{
+    expect_same_tokens_when_split_inside("\xc3\xa9"sv);
+    expect_same_tokens_when_split_inside("\xe2\x82\xac"sv);
+    expect_same_tokens_when_split_inside("\xf0\x9f\x98\x80"sv);
+}
+
+TEST_CASE(split_inside_doctype_keywords)
+{
+    expect_same_tokens_when_split_inside("<!DOCTYPE html PUBLIC"sv);
+    expect_same_tokens_when_split_inside("<!doctype html SYSTEM"sv);
+}
+
+TEST_CASE(split_inside_character_reference)
+{
+    expect_same_tokens_when_split_inside("&CounterClockwiseContourIntegral;"sv);
+    expect_same_tokens_when_split_inside("&notin;"sv);
+    expect_same_tokens_when_split_inside("&notit;"sv);
+}
+
+TEST_CASE(split_inside_comment_start)
+{
+    expect_same_tokens_when_split_inside("<!--"sv);
+    expect_same_tokens_when_split_inside("<!---->"sv);
+    expect_same_tokens_when_split_inside("--!>"sv);
+}
+
+// The comparisons above only mean something if the document is tokenized the way we think it is.
+TEST_CASE(document_tokenizes_as_expected)
+{
+    auto tokens = tokenize_in_one_go(document);
+    EXPECT(tokens.contains("DOCTYPE { name: 'html', public_identifier: '-//W3C//DTD HTML 4.01//EN', system_identifier: 'http://www.w3.org/TR/html4/strict.dtd' }"));
+    EXPECT(tokens.contains("DOCTYPE { name: 'html', system_identifier: 'about:legacy-compat' }"));
+    EXPECT(tokens.contains("DOCTYPE { name: 'html', force_quirks }"));
+    EXPECT(tokens.contains("Character { data: '\xf0\x9f\x98\x80' }"));
+    EXPECT(tokens.contains("data-x=\"\xe2\x88\xb3\""));
+    EXPECT(tokens.contains("Character { data: '\xe2\x88\xb3' }"));
+    EXPECT(tokens.contains("Character { data: '\xe2\x88\x89' }"));
+    EXPECT(tokens.contains("Comment { data: ' comment ' }"));
+    EXPECT(tokens.contains("StartTag { name: 'br', { }, self_closing }"));
+    EXPECT(tokens.contains("EndOfFile"));
+}
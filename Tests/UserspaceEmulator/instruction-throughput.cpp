@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+// A fixed, CPU-bound workload for measuring how fast UserspaceEmulator executes instructions:
+//
+//     ue --report-instructions-per-second /usr/Tests/UserEmulator/instruction-throughput
+//
+// It mixes tight loops, calls, memory traffic and unpredictable branches, and prints a checksum
+// so that the emulated result can be compared against a native run.
+
+#include <LibCore/ArgsParser.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t s_state = 0x5eed;
+
+[[gnu::noinline]] static uint32_t next_random()
+{
+    s_state = s_state * 1103515245 + 12345;
+    return s_state >> 16;
+}
+
+static uint32_t sieve(size_t limit)
+{
+    static bool composite[65536];
+    memset(composite, 0, sizeof(composite));
+    uint32_t primes = 0;
+    for (size_t i = 2; i < limit; ++i) {
+        if (composite[i])
+            continue;
+        ++primes;
+        for (size_t j = i * i; j < limit; j += i)
+            composite[j] = true;
+    }
+    return primes;
+}
+
+static uint32_t crc32(uint8_t const* data, size_t size)
+{
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < size; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static void insertion_sort(uint32_t* values, size_t count)
+{
+    for (size_t i = 1; i < count; ++i) {
+        auto value = values[i];
+        size_t j = i;
+        for (; j > 0 && values[j - 1] > value; --j)
+            values[j] = values[j - 1];
+        values[j] = value;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int rounds = 10;
+
+    Core::ArgsParser parser;
+    parser.add_option(rounds, "Number of times to run the workload", "rounds", 'r', "count");
+    parser.parse(argc, argv);
+
+    uint32_t checksum = 0;
+    for (int round = 0; round < rounds; ++round) {
+        checksum += sieve(65536);
+
+        uint8_t buffer[16384];
+        for (auto& byte : buffer)
+            byte = next_random();
+        checksum ^= crc32(buffer, sizeof(buffer));
+
+        uint32_t values[1024];
+        for (auto& value : values)
+            value = next_random();
+        insertion_sort(values, 1024);
+        checksum += values[0] + values[1023];
+    }
+
+    printf("checksum: %08x\n", checksum);
+    return 0;
+}
@@ -28,6 +28,7 @@ public:
 
     virtual JS::Value internal_get(JS::PropertyName const&, JS::Value receiver) const override;
     virtual bool internal_set(JS::PropertyName const&, JS::Value value, JS::Value receiver) override;
+    virtual bool has_exotic_property_lookup() const override { return true; }
     virtual void initialize_global_object() override;
 
     JS_DECLARE_NATIVE_FUNCTION(get_real_cell_contents);
@@ -24,7 +24,8 @@ public:
 
     virtual const char* class_name() const override { return m_variable_info.type_name.characters(); }
 
-    bool internal_set(JS::PropertyName const&, JS::Value value, JS::Value receiver) override;
+    virtual bool internal_set(JS::PropertyName const&, JS::Value value, JS::Value receiver) override;
+    virtual bool has_exotic_property_lookup() const override { return true; }
 
 private:
     DebuggerGlobalJSObject& debugger_object() const;
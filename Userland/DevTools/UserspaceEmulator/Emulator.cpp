@@ -216,7 +216,16 @@ int Emulator::exec()
 
     constexpr bool trace = false;
 
+    clock_gettime(CLOCK_MONOTONIC, &m_start_time);
+
     while (!m_shutdown) {
+        if (m_steps_til_pause < 0 && !trace) [[likely]] {
+            if (auto block = m_cpu.decoded_block_at_eip()) {
+                execute_decoded_block(*block);
+                continue;
+            }
+        }
+
         if (m_steps_til_pause) [[likely]] {
             m_cpu.save_base_eip();
             auto insn = X86::Instruction::from_stream(m_cpu, true, true);
@@ -236,6 +245,7 @@ int Emulator::exec()
             }
             if (m_steps_til_pause > 0)
                 m_steps_til_pause--;
+            ++m_instructions_executed;
 
         } else {
             handle_repl();
@@ -245,9 +255,42 @@ int Emulator::exec()
     if (auto* tracer = malloc_tracer())
         tracer->dump_leak_report();
 
+    if (m_report_instructions_per_second)
+        report_instructions_per_second();
+
     return m_exit_status;
 }
 
+void Emulator::execute_decoded_block(DecodedBlock& block)
+{
+    auto generation = m_cpu.decoded_block_generation();
+    for (auto& entry : block.entries) {
+        m_cpu.set_eip(entry.eip);
+        m_cpu.save_base_eip();
+        m_cpu.set_eip(entry.next_eip);
+        (m_cpu.*entry.handler)(entry.instruction);
+        ++m_instructions_executed;
+
+        if (m_pending_signals) [[unlikely]] {
+            dispatch_one_pending_signal();
+            return;
+        }
+        // Leave the block as soon as the instruction went somewhere else, the emulator wants to stop,
+        // or the instruction wrote to code we've decoded (which may well be this very block.)
+        if (m_cpu.eip() != entry.next_eip || m_shutdown || m_steps_til_pause >= 0 || m_cpu.decoded_block_generation() != generation) [[unlikely]]
+            return;
+    }
+}
+
+void Emulator::report_instructions_per_second() const
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    auto elapsed_ms = (now.tv_sec - m_start_time.tv_sec) * 1000 + (now.tv_nsec - m_start_time.tv_nsec) / 1'000'000;
+    reportln("\n=={}==  {} instructions executed in {} ms ({} instructions per second), {} decoded blocks",
+        getpid(), m_instructions_executed, elapsed_ms, m_instructions_executed * 1000 / max<i64>(elapsed_ms, 1), m_cpu.decoded_block_count());
+}
+
 void Emulator::handle_repl()
 {
     // Console interface
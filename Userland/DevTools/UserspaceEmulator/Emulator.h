@@ -21,6 +21,7 @@
 #include <LibX86/Instruction.h>
 #include <signal.h>
 #include <sys/types.h>
+#include <time.h>
 
 namespace UserspaceEmulator {
 
@@ -42,6 +43,7 @@ public:
     u32 virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3);
 
     SoftMMU& mmu() { return m_mmu; }
+    SoftCPU& cpu() { return m_cpu; }
 
     MallocTracer* malloc_tracer() { return m_malloc_tracer; }
 
@@ -81,6 +83,8 @@ public:
 
     void dump_regions() const;
 
+    void set_report_instructions_per_second(bool b) { m_report_instructions_per_second = b; }
+
 private:
     const String m_executable_path;
     const Vector<String> m_arguments;
@@ -191,6 +195,12 @@ private:
     int virt$create_inode_watcher(unsigned);
     int virt$inode_watcher_add_watch(FlatPtr);
     int virt$inode_watcher_remove_watch(int, int);
+    int virt$epoll_create1(int);
+    int virt$epoll_ctl(FlatPtr);
+    int virt$epoll_pwait(FlatPtr);
+    int virt$sendfile(FlatPtr);
+    int virt$preadv(FlatPtr);
+    int virt$pwritev(FlatPtr);
     int virt$readlink(FlatPtr);
     u32 virt$allocate_tls(FlatPtr, size_t);
     int virt$ptsname(int fd, FlatPtr buffer, size_t buffer_size);
@@ -206,6 +216,8 @@ private:
     bool find_malloc_symbols(MmapRegion const& libc_text);
 
     void dispatch_one_pending_signal();
+    void execute_decoded_block(DecodedBlock&);
+    void report_instructions_per_second() const;
     MmapRegion const* find_text_region(FlatPtr address);
     MmapRegion const* load_library_from_adress(FlatPtr address);
     String symbol_at(FlatPtr address);
@@ -215,6 +227,10 @@ private:
     bool m_shutdown { false };
     int m_exit_status { 0 };
 
+    bool m_report_instructions_per_second { false };
+    u64 m_instructions_executed { 0 };
+    struct timespec m_start_time { };
+
     i64 m_steps_til_pause { -1 };
     bool m_run_til_return { false };
     bool m_run_til_call { false };
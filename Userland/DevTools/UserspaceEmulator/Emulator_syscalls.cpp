@@ -13,6 +13,7 @@
 #include <sched.h>
 #include <serenity.h>
 #include <strings.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/select.h>
@@ -228,6 +229,18 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$inode_watcher_add_watch(arg1);
     case SC_inode_watcher_remove_watch:
         return virt$inode_watcher_remove_watch(arg1, arg2);
+    case SC_epoll_create1:
+        return virt$epoll_create1(arg1);
+    case SC_epoll_ctl:
+        return virt$epoll_ctl(arg1);
+    case SC_epoll_pwait:
+        return virt$epoll_pwait(arg1);
+    case SC_sendfile:
+        return virt$sendfile(arg1);
+    case SC_preadv:
+        return virt$preadv(arg1);
+    case SC_pwritev:
+        return virt$pwritev(arg1);
     case SC_clock_nanosleep:
         return virt$clock_nanosleep(arg1);
     case SC_readlink:
@@ -954,6 +967,7 @@ u32 Emulator::virt$mprotect(FlatPtr base, size_t size, int prot)
                 return IterationDecision::Break;
             }
             auto& mmap_region = *(MmapRegion*)region;
+            m_cpu.invalidate_decoded_blocks(mmap_region);
             mmap_region.set_prot(prot);
         }
         return IterationDecision::Continue;
@@ -1421,6 +1435,117 @@ int Emulator::virt$inode_watcher_remove_watch(int fd, int wd)
     return syscall(SC_inode_watcher_add_watch, fd, wd);
 }
 
+int Emulator::virt$epoll_create1(int flags)
+{
+    return syscall(SC_epoll_create1, flags);
+}
+
+int Emulator::virt$epoll_ctl(FlatPtr params_addr)
+{
+    Syscall::SC_epoll_ctl_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+
+    epoll_event event {};
+    if (params.event)
+        mmu().copy_from_vm(&event, (FlatPtr)params.event, sizeof(event));
+
+    Syscall::SC_epoll_ctl_params host_params { params.epoll_fd, params.op, params.fd, params.event ? &event : nullptr };
+    return syscall(SC_epoll_ctl, &host_params);
+}
+
+int Emulator::virt$epoll_pwait(FlatPtr params_addr)
+{
+    Syscall::SC_epoll_pwait_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+
+    if (params.max_events <= 0)
+        return -EINVAL;
+
+    timespec timeout;
+    u32 sigmask;
+    if (params.timeout)
+        mmu().copy_from_vm(&timeout, (FlatPtr)params.timeout, sizeof(timeout));
+    if (params.sigmask)
+        mmu().copy_from_vm(&sigmask, (FlatPtr)params.sigmask, sizeof(sigmask));
+
+    Vector<epoll_event> events;
+    events.resize(min(params.max_events, FD_SETSIZE));
+
+    Syscall::SC_epoll_pwait_params host_params { params.epoll_fd, events.data(), (int)events.size(), params.timeout ? &timeout : nullptr, params.sigmask ? &sigmask : nullptr };
+    int rc = syscall(SC_epoll_pwait, &host_params);
+    if (rc > 0)
+        mmu().copy_to_vm((FlatPtr)params.events, events.data(), rc * sizeof(epoll_event));
+    return rc;
+}
+
+int Emulator::virt$sendfile(FlatPtr params_addr)
+{
+    Syscall::SC_sendfile_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+
+    // The file data never passes through the emulated process, only the offset does.
+    off_t offset;
+    if (params.offset)
+        mmu().copy_from_vm(&offset, (FlatPtr)params.offset, sizeof(offset));
+
+    Syscall::SC_sendfile_params host_params { params.out_fd, params.in_fd, params.offset ? &offset : nullptr, params.count };
+    int rc = syscall(SC_sendfile, &host_params);
+    if (rc >= 0 && params.offset)
+        mmu().copy_to_vm((FlatPtr)params.offset, &offset, sizeof(offset));
+    return rc;
+}
+
+int Emulator::virt$preadv(FlatPtr params_addr)
+{
+    Syscall::SC_preadv_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+    if (params.iov_count < 0)
+        return -EINVAL;
+
+    Vector<iovec, 1> mmu_iovs;
+    mmu_iovs.resize(params.iov_count);
+    mmu().copy_from_vm(mmu_iovs.data(), (FlatPtr)params.iov, params.iov_count * sizeof(iovec));
+    Vector<ByteBuffer, 1> buffers;
+    Vector<iovec, 1> iovs;
+    for (const auto& iov : mmu_iovs) {
+        buffers.append(ByteBuffer::create_uninitialized(iov.iov_len));
+        iovs.append({ buffers.last().data(), buffers.last().size() });
+    }
+
+    Syscall::SC_preadv_params host_params { params.fd, iovs.data(), params.iov_count, params.offset };
+    int rc = syscall(SC_preadv, &host_params);
+    if (rc < 0)
+        return rc;
+
+    size_t remaining = rc;
+    for (size_t i = 0; i < buffers.size() && remaining > 0; ++i) {
+        auto nread = min(remaining, buffers[i].size());
+        mmu().copy_to_vm((FlatPtr)mmu_iovs[i].iov_base, buffers[i].data(), nread);
+        remaining -= nread;
+    }
+    return rc;
+}
+
+int Emulator::virt$pwritev(FlatPtr params_addr)
+{
+    Syscall::SC_pwritev_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+    if (params.iov_count < 0)
+        return -EINVAL;
+
+    Vector<iovec, 1> iovs;
+    iovs.resize(params.iov_count);
+    mmu().copy_from_vm(iovs.data(), (FlatPtr)params.iov, params.iov_count * sizeof(iovec));
+    Vector<ByteBuffer, 1> buffers;
+    for (auto& iov : iovs) {
+        buffers.append(mmu().copy_buffer_from_vm((FlatPtr)iov.iov_base, iov.iov_len));
+        iov = { buffers.last().data(), buffers.last().size() };
+    }
+
+    Syscall::SC_pwritev_params host_params { params.fd, iovs.data(), params.iov_count, params.offset };
+    return syscall(SC_pwritev, &host_params);
+}
+
 int Emulator::virt$clock_nanosleep(FlatPtr params_addr)
 {
     Syscall::SC_clock_nanosleep_params params;
@@ -58,6 +58,10 @@ public:
     void set_writable(bool b) { m_writable = b; }
     void set_executable(bool b) { m_executable = b; }
 
+    // Whether SoftCPU has decoded blocks of instructions from this region, which need to go when it's written to.
+    bool has_decoded_blocks() const { return m_has_decoded_blocks; }
+    void set_has_decoded_blocks(bool b) { m_has_decoded_blocks = b; }
+
     virtual u8* data() = 0;
     virtual u8* shadow_data() = 0;
 
@@ -82,6 +86,7 @@ private:
     bool m_readable { true };
     bool m_writable { true };
     bool m_executable { true };
+    bool m_has_decoded_blocks { false };
 };
 
 }
@@ -97,11 +97,133 @@ void SoftCPU::update_code_cache()
         TODO();
     }
 
-    // FIXME: This cache needs to be invalidated if the code region is ever unmapped.
     m_cached_code_region = region;
     m_cached_code_base_ptr = region->data();
 }
 
+// Reads instruction bytes for the block decoder, without ever going past the end of the region.
+class DecodedBlockStream {
+public:
+    DecodedBlockStream(u8 const* data, size_t offset, size_t size)
+        : m_data(data)
+        , m_offset(offset)
+        , m_size(size)
+    {
+    }
+
+    size_t offset() const { return m_offset; }
+    bool has_overrun() const { return m_has_overrun; }
+
+    u8 read8() { return read<u8>(); }
+    u16 read16() { return read<u16>(); }
+    u32 read32() { return read<u32>(); }
+    u64 read64() { return read<u64>(); }
+
+private:
+    template<typename T>
+    T read()
+    {
+        if (m_offset + sizeof(T) > m_size) {
+            m_has_overrun = true;
+            return 0;
+        }
+        T value;
+        memcpy(&value, m_data + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return value;
+    }
+
+    u8 const* m_data { nullptr };
+    size_t m_offset { 0 };
+    size_t m_size { 0 };
+    bool m_has_overrun { false };
+};
+
+static constexpr size_t max_instructions_per_decoded_block = 64;
+
+// Jumps, calls, returns, and anything that traps into the emulator.
+static bool may_transfer_control(X86::Instruction const& instruction)
+{
+    if (instruction.has_sub_op()) {
+        auto sub_op = instruction.sub_op();
+        return (sub_op >= 0x80 && sub_op <= 0x8f) || sub_op == 0x05 || sub_op == 0x0b || sub_op == 0x34;
+    }
+    switch (instruction.op()) {
+    case 0x70 ... 0x7f: // Jcc
+    case 0x9a:          // CALL far
+    case 0xc2:          // RET imm16
+    case 0xc3:          // RET
+    case 0xca:          // RETF imm16
+    case 0xcb:          // RETF
+    case 0xcc:          // INT3
+    case 0xcd:          // INT imm8
+    case 0xce:          // INTO
+    case 0xcf:          // IRET
+    case 0xe0 ... 0xe3: // LOOPcc, JCXZ
+    case 0xe8:          // CALL
+    case 0xe9:          // JMP
+    case 0xea:          // JMP far
+    case 0xeb:          // JMP short
+    case 0xf4:          // HLT
+        return true;
+    case 0xff: // CALL/JMP (far) indirect
+        return instruction.slash() >= 2 && instruction.slash() <= 5;
+    default:
+        return false;
+    }
+}
+
+RefPtr<DecodedBlock> SoftCPU::decoded_block_at_eip()
+{
+    if (auto it = m_decoded_blocks.find(m_eip); it != m_decoded_blocks.end())
+        return it->value;
+
+    auto* region = m_emulator.mmu().find_region({ cs(), m_eip });
+    if (!region || !region->is_executable())
+        return nullptr;
+
+    auto block = adopt_ref(*new DecodedBlock);
+    DecodedBlockStream stream(region->data(), m_eip - region->base(), region->size());
+    while (block->entries.size() < max_instructions_per_decoded_block) {
+        u32 eip = region->base() + stream.offset();
+        auto instruction = X86::Instruction::from_stream(stream, true, true);
+        if (stream.has_overrun() || !instruction.is_valid())
+            break;
+        block->entries.append({ instruction, instruction.handler(), eip, region->base() + (u32)stream.offset() });
+        if (may_transfer_control(instruction))
+            break;
+    }
+
+    // Instructions that run into the next region (or aren't valid) are left to the instruction stream to deal with.
+    if (block->entries.is_empty())
+        return nullptr;
+
+    region->set_has_decoded_blocks(true);
+    m_decoded_blocks.set(m_eip, block);
+    return block;
+}
+
+void SoftCPU::invalidate_decoded_blocks(Region& region)
+{
+    if (m_cached_code_region == &region) {
+        m_cached_code_region = nullptr;
+        m_cached_code_base_ptr = nullptr;
+    }
+
+    if (!region.has_decoded_blocks())
+        return;
+    region.set_has_decoded_blocks(false);
+    ++m_decoded_block_generation;
+
+    Vector<u32> stale_blocks;
+    for (auto& it : m_decoded_blocks) {
+        if (region.contains(it.key))
+            stale_blocks.append(it.key);
+    }
+    for (auto eip : stale_blocks)
+        m_decoded_blocks.remove(eip);
+}
+
 ValueWithShadow<u8> SoftCPU::read_memory8(X86::LogicalAddress address)
 {
     VERIFY(address.selector() == 0x1b || address.selector() == 0x23 || address.selector() == 0x2b);
@@ -8,6 +8,10 @@
 
 #include "Region.h"
 #include "ValueWithShadow.h"
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/Vector.h>
 #include <LibX86/Instruction.h>
 #include <LibX86/Interpreter.h>
 
@@ -16,6 +20,19 @@ namespace UserspaceEmulator {
 class Emulator;
 class Region;
 
+// A straight run of instructions that were decoded once and are executed from here on.
+// A block ends with the first instruction that may transfer control, so only the last one can leave it early.
+struct DecodedBlock : public RefCounted<DecodedBlock> {
+    struct Entry {
+        X86::Instruction instruction;
+        X86::InstructionHandler handler;
+        u32 eip;
+        u32 next_eip;
+    };
+
+    Vector<Entry> entries;
+};
+
 union PartAddressableRegister {
     struct {
         u32 full_u32;
@@ -54,6 +71,14 @@ public:
         m_eip = eip;
     }
 
+    // Returns the block of decoded instructions starting at EIP, decoding it first if needed.
+    // Returns null if the instruction at EIP can't be decoded ahead of time, in which case it has to go through the regular instruction stream.
+    RefPtr<DecodedBlock> decoded_block_at_eip();
+    void invalidate_decoded_blocks(Region&);
+    // Bumped whenever decoded blocks are thrown away, so a block being executed can tell that it may be stale.
+    u32 decoded_block_generation() const { return m_decoded_block_generation; }
+    size_t decoded_block_count() const { return m_decoded_blocks.size(); }
+
     struct Flags {
         enum Flag {
             CF = 0x0001, // 0b0000'0000'0000'0001
@@ -1206,6 +1231,9 @@ private:
 
     Region* m_cached_code_region { nullptr };
     u8* m_cached_code_base_ptr { nullptr };
+
+    HashMap<u32, NonnullRefPtr<DecodedBlock>> m_decoded_blocks;
+    u32 m_decoded_block_generation { 0 };
 };
 
 ALWAYS_INLINE u8 SoftCPU::read8()
@@ -35,6 +35,8 @@ void SoftMMU::add_region(NonnullOwnPtr<Region> region)
 
 void SoftMMU::remove_region(Region& region)
 {
+    m_emulator.cpu().invalidate_decoded_blocks(region);
+
     size_t first_page_in_region = region.base() / PAGE_SIZE;
     for (size_t i = 0; i < ceil_div(region.size(), PAGE_SIZE); ++i) {
         m_page_to_region_map[first_page_in_region + i] = nullptr;
@@ -62,6 +64,7 @@ void SoftMMU::ensure_split_at(X86::LogicalAddress address)
     // If we get here, we know that the page exists and belongs to a region, that there is
     // a previous page, and that it belongs to the same region.
     auto* old_region = verify_cast<MmapRegion>(m_page_to_region_map[page_index]);
+    m_emulator.cpu().invalidate_decoded_blocks(*old_region);
 
     //dbgln("splitting at {:p}", address.offset());
     //dbgln("    old region: {:p}-{:p}", old_region->base(), old_region->end() - 1);
@@ -90,6 +93,13 @@ void SoftMMU::set_tls_region(NonnullOwnPtr<Region> region)
     m_tls_region = move(region);
 }
 
+ALWAYS_INLINE void SoftMMU::invalidate_decoded_blocks_if_needed(Region& region)
+{
+    // Writing to code we've decoded ahead of time means those decoded instructions may no longer be what's in memory.
+    if (region.has_decoded_blocks()) [[unlikely]]
+        m_emulator.cpu().invalidate_decoded_blocks(region);
+}
+
 ValueWithShadow<u8> SoftMMU::read8(X86::LogicalAddress address)
 {
     auto* region = find_region(address);
@@ -213,6 +223,7 @@ void SoftMMU::write8(X86::LogicalAddress address, ValueWithShadow<u8> value)
         TODO();
     }
     region->write8(address.offset() - region->base(), value);
+    invalidate_decoded_blocks_if_needed(*region);
 }
 
 void SoftMMU::write16(X86::LogicalAddress address, ValueWithShadow<u16> value)
@@ -231,6 +242,7 @@ void SoftMMU::write16(X86::LogicalAddress address, ValueWithShadow<u16> value)
     }
 
     region->write16(address.offset() - region->base(), value);
+    invalidate_decoded_blocks_if_needed(*region);
 }
 
 void SoftMMU::write32(X86::LogicalAddress address, ValueWithShadow<u32> value)
@@ -249,6 +261,7 @@ void SoftMMU::write32(X86::LogicalAddress address, ValueWithShadow<u32> value)
     }
 
     region->write32(address.offset() - region->base(), value);
+    invalidate_decoded_blocks_if_needed(*region);
 }
 
 void SoftMMU::write64(X86::LogicalAddress address, ValueWithShadow<u64> value)
@@ -267,6 +280,7 @@ void SoftMMU::write64(X86::LogicalAddress address, ValueWithShadow<u64> value)
     }
 
     region->write64(address.offset() - region->base(), value);
+    invalidate_decoded_blocks_if_needed(*region);
 }
 
 void SoftMMU::write128(X86::LogicalAddress address, ValueWithShadow<u128> value)
@@ -285,6 +299,7 @@ void SoftMMU::write128(X86::LogicalAddress address, ValueWithShadow<u128> value)
     }
 
     region->write128(address.offset() - region->base(), value);
+    invalidate_decoded_blocks_if_needed(*region);
 }
 
 void SoftMMU::write256(X86::LogicalAddress address, ValueWithShadow<u256> value)
@@ -303,6 +318,7 @@ void SoftMMU::write256(X86::LogicalAddress address, ValueWithShadow<u256> value)
     }
 
     region->write256(address.offset() - region->base(), value);
+    invalidate_decoded_blocks_if_needed(*region);
 }
 
 void SoftMMU::copy_to_vm(FlatPtr destination, const void* source, size_t size)
@@ -348,6 +364,7 @@ bool SoftMMU::fast_fill_memory8(X86::LogicalAddress address, size_t size, ValueW
     size_t offset_in_region = address.offset() - region->base();
     memset(region->data() + offset_in_region, value.value(), size);
     memset(region->shadow_data() + offset_in_region, value.shadow(), size);
+    invalidate_decoded_blocks_if_needed(*region);
     return true;
 }
 
@@ -373,6 +390,7 @@ bool SoftMMU::fast_fill_memory32(X86::LogicalAddress address, size_t count, Valu
     size_t offset_in_region = address.offset() - region->base();
     fast_u32_fill((u32*)(region->data() + offset_in_region), value.value(), count);
     fast_u32_fill((u32*)(region->shadow_data() + offset_in_region), value.shadow(), count);
+    invalidate_decoded_blocks_if_needed(*region);
     return true;
 }
 
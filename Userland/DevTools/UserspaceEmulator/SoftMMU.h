@@ -94,6 +94,8 @@ public:
     }
 
 private:
+    void invalidate_decoded_blocks_if_needed(Region&);
+
     Emulator& m_emulator;
 
     Region* m_page_to_region_map[786432] = { nullptr };
@@ -21,11 +21,13 @@ int main(int argc, char** argv, char** env)
 {
     Vector<String> arguments;
     bool pause_on_startup { false };
+    bool report_instructions_per_second { false };
 
     Core::ArgsParser parser;
     parser.set_stop_on_first_non_option(true);
     parser.add_option(g_report_to_debug, "Write reports to the debug log", "report-to-debug", 0);
     parser.add_option(pause_on_startup, "Pause on startup", "pause", 'p');
+    parser.add_option(report_instructions_per_second, "Report how many instructions were executed per second on exit", "report-instructions-per-second", 0);
 
     parser.add_positional_argument(arguments, "Command to emulate", "command");
 
@@ -66,6 +68,7 @@ int main(int argc, char** argv, char** env)
 
     if (pause_on_startup)
         emulator.pause();
+    emulator.set_report_instructions_per_second(report_instructions_per_second);
 
     return emulator.exec();
 }
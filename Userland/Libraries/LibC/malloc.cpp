@@ -20,8 +20,6 @@
 #include <sys/mman.h>
 #include <syscall.h>
 
-// FIXME: Thread safety.
-
 #define RECYCLE_BIG_ALLOCATIONS
 
 static Threading::Lock& malloc_lock()
@@ -34,6 +32,23 @@ constexpr size_t number_of_hot_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_cold_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
 
+// Each thread keeps a small stash of free chunks for every size class, so that
+// most malloc() and free() calls can be served without taking the malloc lock.
+// The stash is bounded both in chunk count and in bytes, and chunks are moved
+// between it and the shared ChunkedBlocks in batches.
+constexpr size_t thread_cache_max_chunks_per_size_class = 64;
+constexpr size_t thread_cache_max_bytes_per_size_class = 32 * KiB;
+
+static constexpr size_t thread_cache_capacity(size_t size_class)
+{
+    return clamp(thread_cache_max_bytes_per_size_class / size_classes[size_class], (size_t)1, thread_cache_max_chunks_per_size_class);
+}
+
+static constexpr size_t thread_cache_batch_size(size_t size_class)
+{
+    return max(thread_cache_capacity(size_class) / 2, (size_t)1);
+}
+
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
@@ -77,6 +92,9 @@ struct MallocStats {
     size_t number_of_block_allocs;
     size_t number_of_blocks_full;
 
+    size_t number_of_thread_cache_hits;
+    size_t number_of_thread_cache_refills;
+
     size_t number_of_free_calls;
 
     size_t number_of_big_allocator_keeps;
@@ -86,6 +104,9 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_keeps;
+    size_t number_of_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -105,6 +126,25 @@ struct BigAllocator {
     Vector<BigAllocationBlock*, number_of_big_blocks_to_keep_around_per_size_class> blocks;
 };
 
+struct ThreadCache {
+    FreelistEntry* chunks[num_size_classes] { nullptr };
+    size_t chunk_count[num_size_classes] { 0 };
+    bool is_released { false };
+
+    // These are folded into g_malloc_stats whenever we take the malloc lock anyway,
+    // to avoid bouncing the global statistics between CPUs on every call.
+    size_t number_of_malloc_calls { 0 };
+    size_t number_of_free_calls { 0 };
+    size_t number_of_hits { 0 };
+    size_t number_of_keeps { 0 };
+};
+
+// The dynamic loader is single-threaded, so it has no use for a thread cache.
+#ifndef _DYNAMIC_LOADER
+#    define USE_THREAD_CACHE
+static __thread ThreadCache t_thread_cache;
+#endif
+
 // Allocators will be initialized in __malloc_init.
 // We can not rely on global constructors to initialize them,
 // because they must be initialized before other global constructors
@@ -124,6 +164,13 @@ static inline BigAllocator (&big_allocators())[1]
     return reinterpret_cast<BigAllocator(&)[1]>(g_big_allocators_storage);
 }
 
+#ifdef USE_THREAD_CACHE
+static size_t size_class_of(const Allocator& allocator)
+{
+    return &allocator - &allocators()[0];
+}
+#endif
+
 static Allocator* allocator_for_size(size_t size, size_t& good_size)
 {
     for (size_t i = 0; size_classes[i]; ++i) {
@@ -165,60 +212,49 @@ enum class CallerWillInitializeMemory {
     Yes,
 };
 
-static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_initialize_memory)
+static void* allocate_big(size_t size)
 {
     Threading::Locker locker(malloc_lock());
-
-    if (s_log_malloc)
-        dbgln("LibC: malloc({})", size);
-
-    if (!size) {
-        // Legally we could just return a null pointer here, but this is more
-        // compatible with existing software.
-        size = 1;
-    }
-
     g_malloc_stats.number_of_malloc_calls++;
 
-    size_t good_size;
-    auto* allocator = allocator_for_size(size, good_size);
-
-    if (!allocator) {
-        size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size, ChunkedBlock::block_size);
+    size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size, ChunkedBlock::block_size);
 #ifdef RECYCLE_BIG_ALLOCATIONS
-        if (auto* allocator = big_allocator_for_size(real_size)) {
-            if (!allocator->blocks.is_empty()) {
-                g_malloc_stats.number_of_big_allocator_hits++;
-                auto* block = allocator->blocks.take_last();
-                int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
-                bool this_block_was_purged = rc == 1;
-                if (rc < 0) {
-                    perror("madvise");
-                    VERIFY_NOT_REACHED();
-                }
-                if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
-                    perror("mprotect");
-                    VERIFY_NOT_REACHED();
-                }
-                if (this_block_was_purged) {
-                    g_malloc_stats.number_of_big_allocator_purge_hits++;
-                    new (block) BigAllocationBlock(real_size);
-                }
-
-                ue_notify_malloc(&block->m_slot[0], size);
-                return &block->m_slot[0];
+    if (auto* allocator = big_allocator_for_size(real_size)) {
+        if (!allocator->blocks.is_empty()) {
+            g_malloc_stats.number_of_big_allocator_hits++;
+            auto* block = allocator->blocks.take_last();
+            int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
+            bool this_block_was_purged = rc == 1;
+            if (rc < 0) {
+                perror("madvise");
+                VERIFY_NOT_REACHED();
+            }
+            if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
+                perror("mprotect");
+                VERIFY_NOT_REACHED();
             }
+            if (this_block_was_purged) {
+                g_malloc_stats.number_of_big_allocator_purge_hits++;
+                new (block) BigAllocationBlock(real_size);
+            }
+
+            ue_notify_malloc(&block->m_slot[0], size);
+            return &block->m_slot[0];
         }
-#endif
-        g_malloc_stats.number_of_big_allocs++;
-        auto* block = (BigAllocationBlock*)os_alloc(real_size, "malloc: BigAllocationBlock");
-        new (block) BigAllocationBlock(real_size);
-        ue_notify_malloc(&block->m_slot[0], size);
-        return &block->m_slot[0];
     }
+#endif
+    g_malloc_stats.number_of_big_allocs++;
+    auto* block = (BigAllocationBlock*)os_alloc(real_size, "malloc: BigAllocationBlock");
+    new (block) BigAllocationBlock(real_size);
+    ue_notify_malloc(&block->m_slot[0], size);
+    return &block->m_slot[0];
+}
 
+// Takes a single chunk out of the shared ChunkedBlocks of this size class.
+static void* allocate_chunk_locked(Allocator& allocator, size_t good_size)
+{
     ChunkedBlock* block = nullptr;
-    for (auto& current : allocator->usable_blocks) {
+    for (auto& current : allocator.usable_blocks) {
         if (current.free_chunks()) {
             block = &current;
             break;
@@ -235,7 +271,7 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
             snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
             set_mmap_name(block, ChunkedBlock::block_size, buffer);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block && s_cold_empty_block_count) {
@@ -258,7 +294,7 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
             new (block) ChunkedBlock(good_size);
             ue_notify_chunk_size_changed(block, good_size);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block) {
@@ -267,8 +303,8 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
         snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
         block = (ChunkedBlock*)os_alloc(ChunkedBlock::block_size, buffer);
         new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
     }
 
     --block->m_free_chunks;
@@ -283,65 +319,119 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
     if (block->is_full()) {
         g_malloc_stats.number_of_blocks_full++;
         dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
     }
     dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
-
-    if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
-
-    ue_notify_malloc(ptr, size);
     return ptr;
 }
 
-static void free_impl(void* ptr)
+#ifdef USE_THREAD_CACHE
+static void fold_thread_cache_stats_locked(ThreadCache& cache)
 {
-    ScopedValueRollback rollback(errno);
+    g_malloc_stats.number_of_malloc_calls += exchange(cache.number_of_malloc_calls, 0);
+    g_malloc_stats.number_of_free_calls += exchange(cache.number_of_free_calls, 0);
+    g_malloc_stats.number_of_thread_cache_hits += exchange(cache.number_of_hits, 0);
+    g_malloc_stats.number_of_thread_cache_keeps += exchange(cache.number_of_keeps, 0);
+}
 
-    if (!ptr)
-        return;
+// Takes a chunk for the caller, and stashes up to a batch worth of chunks in the
+// thread cache so that the next few allocations don't need the lock.
+static void* refill_thread_cache_and_allocate(ThreadCache& cache, Allocator& allocator, size_t good_size)
+{
+    Threading::Locker locker(malloc_lock());
+    fold_thread_cache_stats_locked(cache);
+    g_malloc_stats.number_of_thread_cache_refills++;
+
+    auto size_class = size_class_of(allocator);
+    auto* ptr = allocate_chunk_locked(allocator, good_size);
+    for (size_t i = 1; i < thread_cache_batch_size(size_class); ++i) {
+        auto* entry = (FreelistEntry*)allocate_chunk_locked(allocator, good_size);
+        entry->next = cache.chunks[size_class];
+        cache.chunks[size_class] = entry;
+        ++cache.chunk_count[size_class];
+    }
+    return ptr;
+}
+#endif
 
-    g_malloc_stats.number_of_free_calls++;
+static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    if (s_log_malloc)
+        dbgln("LibC: malloc({})", size);
 
-    Threading::Locker locker(malloc_lock());
+    if (!size) {
+        // Legally we could just return a null pointer here, but this is more
+        // compatible with existing software.
+        size = 1;
+    }
 
-    void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
-    size_t magic = *(size_t*)block_base;
+    size_t good_size;
+    auto* allocator = allocator_for_size(size, good_size);
 
-    if (magic == MAGIC_BIGALLOC_HEADER) {
-        auto* block = (BigAllocationBlock*)block_base;
-#ifdef RECYCLE_BIG_ALLOCATIONS
-        if (auto* allocator = big_allocator_for_size(block->m_size)) {
-            if (allocator->blocks.size() < number_of_big_blocks_to_keep_around_per_size_class) {
-                g_malloc_stats.number_of_big_allocator_keeps++;
-                allocator->blocks.append(block);
-                size_t this_block_size = block->m_size;
-                if (mprotect(block, this_block_size, PROT_NONE) < 0) {
-                    perror("mprotect");
-                    VERIFY_NOT_REACHED();
-                }
-                if (madvise(block, this_block_size, MADV_SET_VOLATILE) != 0) {
-                    perror("madvise");
-                    VERIFY_NOT_REACHED();
-                }
-                return;
-            }
+    if (!allocator)
+        return allocate_big(size);
+
+    void* ptr = nullptr;
+#ifdef USE_THREAD_CACHE
+    auto& cache = t_thread_cache;
+    if (!cache.is_released) {
+        auto size_class = size_class_of(*allocator);
+        ++cache.number_of_malloc_calls;
+        if (auto* entry = cache.chunks[size_class]) {
+            ++cache.number_of_hits;
+            cache.chunks[size_class] = entry->next;
+            --cache.chunk_count[size_class];
+            ptr = entry;
+        } else {
+            ptr = refill_thread_cache_and_allocate(cache, *allocator, good_size);
         }
+    }
 #endif
-        g_malloc_stats.number_of_big_allocator_frees++;
-        os_free(block, block->m_size);
-        return;
+
+    if (!ptr) {
+        Threading::Locker locker(malloc_lock());
+        g_malloc_stats.number_of_malloc_calls++;
+        ptr = allocate_chunk_locked(*allocator, good_size);
     }
 
-    assert(magic == MAGIC_PAGE_HEADER);
-    auto* block = (ChunkedBlock*)block_base;
+    if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
-    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
+    ue_notify_malloc(ptr, size);
+    return ptr;
+}
 
-    if (s_scrub_free)
-        memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
+static void free_big(BigAllocationBlock* block)
+{
+    Threading::Locker locker(malloc_lock());
+    g_malloc_stats.number_of_free_calls++;
 
+#ifdef RECYCLE_BIG_ALLOCATIONS
+    if (auto* allocator = big_allocator_for_size(block->m_size)) {
+        if (allocator->blocks.size() < number_of_big_blocks_to_keep_around_per_size_class) {
+            g_malloc_stats.number_of_big_allocator_keeps++;
+            allocator->blocks.append(block);
+            size_t this_block_size = block->m_size;
+            if (mprotect(block, this_block_size, PROT_NONE) < 0) {
+                perror("mprotect");
+                VERIFY_NOT_REACHED();
+            }
+            if (madvise(block, this_block_size, MADV_SET_VOLATILE) != 0) {
+                perror("madvise");
+                VERIFY_NOT_REACHED();
+            }
+            return;
+        }
+    }
+#endif
+    g_malloc_stats.number_of_big_allocator_frees++;
+    os_free(block, block->m_size);
+}
+
+// Gives a single chunk back to the ChunkedBlock it was carved out of.
+static void release_chunk_locked(ChunkedBlock* block, void* ptr)
+{
     auto* entry = (FreelistEntry*)ptr;
     entry->next = block->m_freelist;
     block->m_freelist = entry;
@@ -384,6 +474,81 @@ static void free_impl(void* ptr)
     }
 }
 
+#ifdef USE_THREAD_CACHE
+// Hands the `count` least recently freed chunks of a size class back to their blocks.
+// The most recently freed ones stay behind, as they are the most likely to still be in the CPU cache.
+static void flush_thread_cache_locked(ThreadCache& cache, size_t size_class, size_t count)
+{
+    count = min(count, cache.chunk_count[size_class]);
+    if (!count)
+        return;
+
+    FreelistEntry** link = &cache.chunks[size_class];
+    for (size_t i = 0; i < cache.chunk_count[size_class] - count; ++i)
+        link = &(*link)->next;
+
+    auto* entry = exchange(*link, nullptr);
+    cache.chunk_count[size_class] -= count;
+    while (entry) {
+        auto* next = entry->next;
+        auto* block = (ChunkedBlock*)((FlatPtr)entry & ChunkedBlock::block_mask);
+        release_chunk_locked(block, entry);
+        entry = next;
+    }
+}
+#endif
+
+static void free_impl(void* ptr)
+{
+    ScopedValueRollback rollback(errno);
+
+    if (!ptr)
+        return;
+
+    void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
+    size_t magic = *(size_t*)block_base;
+
+    if (magic == MAGIC_BIGALLOC_HEADER) {
+        free_big((BigAllocationBlock*)block_base);
+        return;
+    }
+
+    assert(magic == MAGIC_PAGE_HEADER);
+    auto* block = (ChunkedBlock*)block_base;
+
+    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
+
+    if (s_scrub_free)
+        memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
+
+#ifdef USE_THREAD_CACHE
+    auto& cache = t_thread_cache;
+    if (!cache.is_released) {
+        size_t good_size;
+        auto size_class = size_class_of(*allocator_for_size(block->m_size, good_size));
+        ++cache.number_of_free_calls;
+        ++cache.number_of_keeps;
+
+        auto* entry = (FreelistEntry*)ptr;
+        entry->next = cache.chunks[size_class];
+        cache.chunks[size_class] = entry;
+        if (++cache.chunk_count[size_class] <= thread_cache_capacity(size_class))
+            return;
+
+        // The stash is full, give a batch of it back to the shared blocks.
+        Threading::Locker locker(malloc_lock());
+        fold_thread_cache_stats_locked(cache);
+        g_malloc_stats.number_of_thread_cache_flushes++;
+        flush_thread_cache_locked(cache, size_class, thread_cache_batch_size(size_class));
+        return;
+    }
+#endif
+
+    Threading::Locker locker(malloc_lock());
+    g_malloc_stats.number_of_free_calls++;
+    release_chunk_locked(block, ptr);
+}
+
 [[gnu::flatten]] void* malloc(size_t size)
 {
     void* ptr = malloc_impl(size, CallerWillInitializeMemory::No);
@@ -484,8 +649,29 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_release_thread_cache()
+{
+#ifdef USE_THREAD_CACHE
+    auto& cache = t_thread_cache;
+    if (cache.is_released)
+        return;
+    Threading::Locker locker(malloc_lock());
+    fold_thread_cache_stats_locked(cache);
+    for (size_t i = 0; i < num_size_classes; ++i)
+        flush_thread_cache_locked(cache, i, cache.chunk_count[i]);
+    // Anything this thread frees from here on out goes straight to the shared blocks.
+    cache.is_released = true;
+#endif
+}
+
 void serenity_dump_malloc_stats()
 {
+#ifdef USE_THREAD_CACHE
+    {
+        Threading::Locker locker(malloc_lock());
+        fold_thread_cache_stats_locked(t_thread_cache);
+    }
+#endif
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
     dbgln();
     dbgln("big alloc hits: {}", g_malloc_stats.number_of_big_allocator_hits);
@@ -497,6 +683,8 @@ void serenity_dump_malloc_stats()
     dbgln("empty cold block hits that were purged: {}", g_malloc_stats.number_of_cold_empty_block_purge_hits);
     dbgln("block allocs: {}", g_malloc_stats.number_of_block_allocs);
     dbgln("filled blocks: {}", g_malloc_stats.number_of_blocks_full);
+    dbgln("thread cache hits: {}", g_malloc_stats.number_of_thread_cache_hits);
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
     dbgln();
     dbgln("# free() calls: {}", g_malloc_stats.number_of_free_calls);
     dbgln();
@@ -507,5 +695,7 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln("thread cache keeps: {}", g_malloc_stats.number_of_thread_cache_keeps);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
 }
 }
@@ -508,8 +508,11 @@ DeflateCompressor::DeflateCompressor(OutputStream& stream, CompressionLevel comp
     , m_compression_constants(compression_constants[static_cast<int>(m_compression_level)])
     , m_output_stream(stream)
 {
+    VERIFY(static_cast<int>(compression_level) >= 0 && static_cast<int>(compression_level) <= max_compression_level);
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
+    for (auto& slot : m_hash_head) // initialize chained hash table
+        slot = empty_slot;
 }
 
 DeflateCompressor::~DeflateCompressor()
@@ -554,21 +557,31 @@ size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate
 {
     VERIFY(previous_match_length < maximum_match_length);
 
-    // We firstly check that the match is at least (prev_match_length + 1) long, we check backwards as there's a higher chance the end mismatches
-    for (ssize_t i = previous_match_length; i >= 0; i--) {
-        if (m_rolling_window[start + i] != m_rolling_window[candidate + i])
-            return 0;
+    // Most candidates can't beat the previous match, and the byte right after it is the one most likely to mismatch, so check that one first
+    if (m_rolling_window[start + previous_match_length] != m_rolling_window[candidate + previous_match_length])
+        return 0;
+
+    // Find the actual length, comparing 8 bytes at a time where possible
+    size_t match_length = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (match_length + sizeof(u64) <= maximum_match_length) {
+        u64 start_bytes;
+        u64 candidate_bytes;
+        __builtin_memcpy(&start_bytes, &m_rolling_window[start + match_length], sizeof(u64));
+        __builtin_memcpy(&candidate_bytes, &m_rolling_window[candidate + match_length], sizeof(u64));
+        if (auto difference = start_bytes ^ candidate_bytes; difference != 0) {
+            match_length += __builtin_ctzll(difference) / 8; // the lowest differing byte is the first one that mismatches
+            return match_length > previous_match_length ? match_length : 0;
+        }
+        match_length += sizeof(u64);
     }
-
-    // Find the actual length
-    auto match_length = previous_match_length + 1;
+#endif
     while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length]) {
         match_length++;
     }
 
-    VERIFY(match_length > previous_match_length);
     VERIFY(match_length <= maximum_match_length);
-    return match_length;
+    return match_length > previous_match_length ? match_length : 0;
 }
 
 size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t maximum_match_length, size_t& match_position)
@@ -590,7 +603,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_back_reference_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -600,17 +613,46 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             match_position = candidate;
             previous_match_length = match_length;
 
-            if (match_length == maximum_match_length)
-                return match_length; // bail if we got the maximum possible length
+            if (match_length >= m_compression_constants.great_match_length || match_length == maximum_match_length)
+                return match_length; // bail if we got a great match, or the maximum possible length
         }
 
-        candidate = m_hash_prev[candidate % window_size];
+        candidate = m_hash_prev[candidate];
     }
     if (!match_found)
         return 0;                 // we didn't find any matches
     return previous_match_length; // we found matches, but they were at most previous_match_length long
 }
 
+// Collects every match that is longer than all of the closer ones, so they are ordered by increasing length (and distance)
+void DeflateCompressor::find_back_matches(size_t start, u16 hash, size_t maximum_match_length, Vector<BackReference>& matches)
+{
+    auto max_chain_length = m_compression_constants.max_chain;
+    auto previous_match_length = min_match_length - 1;
+    if (previous_match_length >= maximum_match_length)
+        return;
+
+    auto candidate = m_hash_head[hash];
+    while (max_chain_length--) {
+        if (candidate == empty_slot)
+            break;
+
+        VERIFY(candidate < start);
+        if (start - candidate > max_back_reference_distance)
+            break;
+
+        auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
+        if (match_length != 0) {
+            matches.append({ static_cast<u16>(match_length), static_cast<u16>(start - candidate) });
+            previous_match_length = match_length;
+            if (match_length == maximum_match_length)
+                return;
+        }
+
+        candidate = m_hash_prev[candidate];
+    }
+}
+
 ALWAYS_INLINE u8 DeflateCompressor::distance_to_base(u16 distance)
 {
     return (distance <= 256) ? distance_to_base_lo[distance - 1] : distance_to_base_hi[(distance - 1) >> 7];
@@ -688,48 +730,100 @@ void DeflateCompressor::generate_huffman_lengths(Array<u8, Size>& lengths, const
     }
 }
 
+ALWAYS_INLINE void DeflateCompressor::insert_hash(size_t position, u16 hash)
+{
+    m_hash_prev[position] = m_hash_head[hash];
+    m_hash_head[hash] = position;
+}
+
+ALWAYS_INLINE void DeflateCompressor::emit_literal(u8 literal)
+{
+    VERIFY(m_pending_symbol_size <= block_size + 1);
+    auto index = m_pending_symbol_size++;
+    m_symbol_buffer[index].distance = 0;
+    m_symbol_buffer[index].literal = literal;
+    m_symbol_frequencies[literal]++;
+}
+
+ALWAYS_INLINE void DeflateCompressor::emit_back_reference(u16 distance, u16 length)
+{
+    VERIFY(m_pending_symbol_size <= block_size + 1);
+    auto index = m_pending_symbol_size++;
+    m_symbol_buffer[index].distance = distance;
+    m_symbol_buffer[index].length = length;
+    m_symbol_frequencies[length_to_symbol[length]]++;
+    m_distance_frequencies[distance_to_base(distance)]++;
+}
+
 void DeflateCompressor::lz77_compress_block()
 {
-    for (auto& slot : m_hash_head) { // initialize chained hash table
-        slot = empty_slot;
+    VERIFY(m_compression_constants.great_match_length <= max_match_length);
+
+    switch (m_compression_constants.parsing) {
+    case Parsing::Greedy:
+        lz77_compress_block_greedy();
+        break;
+    case Parsing::Lazy:
+        lz77_compress_block_lazy();
+        break;
+    case Parsing::Optimal:
+        lz77_compress_block_optimal();
+        break;
+    default:
+        VERIFY_NOT_REACHED();
     }
+}
 
-    auto insert_hash = [&](auto pos, auto hash) {
-        auto window_pos = pos % window_size;
-        m_hash_prev[window_pos] = m_hash_head[hash];
-        m_hash_head[hash] = window_pos;
-    };
+// This is the fast path for the lowest levels, it takes every match as soon as it's found
+void DeflateCompressor::lz77_compress_block_greedy()
+{
+    // our block starts at block_size and is m_pending_block_size in length
+    auto block_end = block_size + m_pending_block_size;
+    auto hash_end = block_end - min_match_length + 1;
+    size_t current_position = block_size;
+    while (current_position < hash_end) {
+        auto hash = hash_sequence(&m_rolling_window[current_position]);
+        size_t match_position;
+        auto match_length = find_back_match(current_position, hash, 0, min(max_match_length, block_end - current_position), match_position);
 
-    auto emit_literal = [&](auto literal) {
-        VERIFY(m_pending_symbol_size <= block_size + 1);
-        auto index = m_pending_symbol_size++;
-        m_symbol_buffer[index].distance = 0;
-        m_symbol_buffer[index].literal = literal;
-        m_symbol_frequencies[literal]++;
-    };
+        insert_hash(current_position, hash);
 
-    auto emit_back_reference = [&](auto distance, auto length) {
-        VERIFY(m_pending_symbol_size <= block_size + 1);
-        auto index = m_pending_symbol_size++;
-        m_symbol_buffer[index].distance = distance;
-        m_symbol_buffer[index].length = length;
-        m_symbol_frequencies[length_to_symbol[length]]++;
-        m_distance_frequencies[distance_to_base(distance)]++;
-    };
+        if (match_length == 0) {
+            emit_literal(m_rolling_window[current_position++]);
+            continue;
+        }
+
+        emit_back_reference(current_position - match_position, match_length);
+
+        // hashing every byte of a long match takes a while and rarely finds anything better, so only do it for short ones
+        if (match_length <= m_compression_constants.max_lazy_length) {
+            for (size_t j = current_position + 1; j < min(current_position + match_length, hash_end); j++) {
+                insert_hash(j, hash_sequence(&m_rolling_window[j]));
+            }
+        }
+        current_position += match_length;
+    }
 
+    // output remaining literals
+    while (current_position < block_end) {
+        emit_literal(m_rolling_window[current_position++]);
+    }
+}
+
+void DeflateCompressor::lz77_compress_block_lazy()
+{
     size_t previous_match_length = 0;
     size_t previous_match_position = 0;
 
-    VERIFY(m_compression_constants.great_match_length <= max_match_length);
-
     // our block starts at block_size and is m_pending_block_size in length
     auto block_end = block_size + m_pending_block_size;
+    auto hash_end = block_end - min_match_length + 1;
     size_t current_position;
-    for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
+    for (current_position = block_size; current_position < hash_end; current_position++) {
         auto hash = hash_sequence(&m_rolling_window[current_position]);
         size_t match_position;
         auto match_length = find_back_match(current_position, hash, previous_match_length,
-            min(m_compression_constants.great_match_length, block_end - current_position), match_position);
+            min(max_match_length, block_end - current_position), match_position);
 
         insert_hash(current_position, hash);
 
@@ -738,7 +832,7 @@ void DeflateCompressor::lz77_compress_block()
             emit_back_reference((current_position - 1) - previous_match_position, previous_match_length);
 
             // skip all the bytes that are included in this match
-            for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, block_end - min_match_length + 1); j++) {
+            for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, hash_end); j++) {
                 insert_hash(j, hash_sequence(&m_rolling_window[j]));
             }
             current_position = (current_position - 1) + previous_match_length - 1;
@@ -773,6 +867,113 @@ void DeflateCompressor::lz77_compress_block()
     }
 }
 
+// Picks the combination of literals and back references with the lowest cost in bits for the whole block.
+// Symbol costs depend on the huffman codes, which in turn depend on the chosen symbols, so we first estimate
+// them with the fixed huffman codes, and then refine them with the codes that the first parse would produce.
+void DeflateCompressor::lz77_compress_block_optimal()
+{
+    auto block_end = block_size + m_pending_block_size;
+    auto hash_end = block_end - min_match_length + 1;
+
+    // matches for the position i (relative to the start of the block) are matches[match_offsets[i]] to matches[match_offsets[i + 1]]
+    Vector<BackReference> matches;
+    Vector<u32> match_offsets;
+    match_offsets.resize(m_pending_block_size + 1);
+    size_t skip_until = 0;
+    for (size_t current_position = block_size; current_position < block_end; current_position++) {
+        match_offsets[current_position - block_size] = matches.size();
+        if (current_position >= hash_end)
+            continue;
+
+        auto hash = hash_sequence(&m_rolling_window[current_position]);
+        // inside a great match any other choice is unlikely to be cheaper, so don't bother searching there
+        if (current_position >= skip_until) {
+            auto first_match = matches.size();
+            find_back_matches(current_position, hash, min(max_match_length, block_end - current_position), matches);
+            if (matches.size() != first_match && matches.last().length >= m_compression_constants.great_match_length)
+                skip_until = current_position + matches.last().length;
+        }
+        insert_hash(current_position, hash);
+    }
+    match_offsets[m_pending_block_size] = matches.size();
+
+    Vector<u32> costs;
+    costs.resize(m_pending_block_size + 1);
+    Vector<BackReference> choices; // a distance of 0 means a literal
+    choices.resize(m_pending_block_size);
+
+    auto find_cheapest_parse = [&](const Array<u8, max_huffman_literals>& literal_bit_lengths, const Array<u8, max_huffman_distances>& distance_bit_lengths) {
+        // symbols that weren't used by the previous parse have no code, but can still be picked, so assume the longest one for them
+        auto symbol_cost = [](u8 bit_length) -> u32 { return bit_length ? bit_length : 15; };
+
+        costs[m_pending_block_size] = 0;
+        for (size_t i = m_pending_block_size; i-- > 0;) {
+            costs[i] = costs[i + 1] + symbol_cost(literal_bit_lengths[m_rolling_window[block_size + i]]);
+            choices[i] = { 1, 0 };
+
+            size_t length = min_match_length;
+            for (size_t j = match_offsets[i]; j < match_offsets[i + 1]; j++) {
+                auto distance = matches[j].distance;
+                auto distance_base = distance_to_base(distance);
+                u32 distance_cost = symbol_cost(distance_bit_lengths[distance_base]) + packed_distances[distance_base].extra_bits;
+                // every length that wasn't covered by a closer match can use this distance
+                for (; length <= matches[j].length; length++) {
+                    auto length_symbol = length_to_symbol[length];
+                    auto cost = costs[i + length] + distance_cost + symbol_cost(literal_bit_lengths[length_symbol]) + packed_length_symbols[length_symbol - 257].extra_bits;
+                    if (cost < costs[i]) {
+                        costs[i] = cost;
+                        choices[i] = { static_cast<u16>(length), distance };
+                    }
+                }
+            }
+        }
+    };
+
+    // first pass, estimating costs with the fixed huffman codes
+    find_cheapest_parse(fixed_literal_bit_lengths, fixed_distance_bit_lengths);
+
+    Array<u16, max_huffman_literals> symbol_frequencies {};
+    Array<u16, max_huffman_distances> distance_frequencies {};
+    for (size_t i = 0; i < m_pending_block_size; i += choices[i].length) {
+        if (choices[i].distance == 0) {
+            symbol_frequencies[m_rolling_window[block_size + i]]++;
+            continue;
+        }
+        symbol_frequencies[length_to_symbol[choices[i].length]]++;
+        distance_frequencies[distance_to_base(choices[i].distance)]++;
+    }
+    symbol_frequencies[256]++;
+
+    // second pass, with the codes the first parse would have produced
+    Array<u8, max_huffman_literals> literal_bit_lengths {};
+    Array<u8, max_huffman_distances> distance_bit_lengths {};
+    generate_huffman_lengths(literal_bit_lengths, symbol_frequencies, 15);
+    generate_huffman_lengths(distance_bit_lengths, distance_frequencies, 15);
+    find_cheapest_parse(literal_bit_lengths, distance_bit_lengths);
+
+    for (size_t i = 0; i < m_pending_block_size; i += choices[i].length) {
+        if (choices[i].distance == 0)
+            emit_literal(m_rolling_window[block_size + i]);
+        else
+            emit_back_reference(choices[i].distance, choices[i].length);
+    }
+}
+
+// Once the pending block is moved to the start of the window, every position in the hash table has to move along with it
+void DeflateCompressor::slide_hash_table()
+{
+    auto slide = [](u16 position) -> u16 {
+        if (position == empty_slot || position < block_size)
+            return empty_slot; // this position is now outside the window
+        return position - block_size;
+    };
+
+    for (auto& slot : m_hash_head)
+        slot = slide(slot);
+    for (size_t i = 0; i < block_size; i++)
+        m_hash_prev[i] = slide(m_hash_prev[i + block_size]);
+}
+
 size_t DeflateCompressor::huffman_block_length(const Array<u8, max_huffman_literals>& literal_bit_lengths, const Array<u8, max_huffman_distances>& distance_bit_lengths)
 {
     size_t length = 0;
@@ -1043,6 +1244,8 @@ void DeflateCompressor::flush()
     m_distance_frequencies.fill(0);
     // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
     pending_block().copy_trimmed_to({ m_rolling_window, block_size });
+    // The block we just compressed becomes the dictionary for the next one
+    slide_hash_table();
 }
 
 void DeflateCompressor::final_flush()
@@ -118,31 +118,49 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_back_reference_distance = 32 * KiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
+    enum class Parsing {
+        None,    // The block is stored uncompressed
+        Greedy,  // The longest match at each position is taken right away
+        Lazy,    // Each match is deferred by a byte, in case the next position has a longer one
+        Optimal, // All matches of the block are collected first, and the cheapest combination of them is picked
+    };
+
     struct CompressionConstants {
         size_t good_match_length;  // Once we find a match of at least this length (a good enough match) we reduce max_chain to lower processing time
         size_t max_lazy_length;    // If the match is at least this long we dont defer matching to the next byte (which takes time) as its good enough
+                                   // When parsing greedily, matches longer than this don't get their positions inserted into the hash table instead
         size_t great_match_length; // Once we find a match of at least this length (a great match) we can just stop searching for longer ones
         size_t max_chain;          // We only check the actual length of the max_chain closest matches
+        Parsing parsing;
     };
 
     // These constants were shamelessly "borrowed" from zlib
     static constexpr CompressionConstants compression_constants[] = {
-        { 0, 0, 0, 0 },
-        { 4, 4, 8, 4 },
-        { 8, 16, 128, 128 },
-        { 32, 258, 258, 4096 },
-        { max_match_length, max_match_length, max_match_length, 1 << hash_bits } // disable all limits
+        { 0, 0, 0, 0, Parsing::None },
+        { 4, 4, 8, 4, Parsing::Greedy },
+        { 4, 5, 16, 8, Parsing::Greedy },
+        { 4, 6, 32, 32, Parsing::Greedy },
+        { 4, 4, 16, 16, Parsing::Lazy },
+        { 8, 16, 32, 32, Parsing::Lazy },
+        { 8, 16, 128, 128, Parsing::Lazy },
+        { 8, 32, 128, 256, Parsing::Lazy },
+        { 32, 128, 258, 1024, Parsing::Lazy },
+        { 32, 258, 258, 4096, Parsing::Lazy },
+        { max_match_length, max_match_length, max_match_length, 1 << hash_bits, Parsing::Optimal } // disable all limits
     };
 
+    // Levels 1 through 9 correspond to the zlib levels of the same number, and can be selected by casting that number.
     enum class CompressionLevel : int {
         STORE = 0,
-        FAST,
-        GOOD,
-        GREAT,
-        BEST // WARNING: this one can take an unreasonable amount of time!
+        FAST = 1,
+        GOOD = 6,
+        GREAT = 9,
+        BEST = 10 // WARNING: this one can take an unreasonable amount of time!
     };
+    static constexpr int max_compression_level = static_cast<int>(CompressionLevel::BEST);
 
     DeflateCompressor(OutputStream&, CompressionLevel = CompressionLevel::GOOD);
     ~DeflateCompressor();
@@ -160,7 +178,19 @@ private:
     static u16 hash_sequence(const u8* bytes);
     size_t compare_match_candidate(size_t start, size_t candidate, size_t prev_match_length, size_t max_match_length);
     size_t find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t max_match_length, size_t& match_position);
+    struct BackReference {
+        u16 length;
+        u16 distance;
+    };
+    void find_back_matches(size_t start, u16 hash, size_t max_match_length, Vector<BackReference>& matches);
+    void insert_hash(size_t position, u16 hash);
+    void emit_literal(u8 literal);
+    void emit_back_reference(u16 distance, u16 length);
     void lz77_compress_block();
+    void lz77_compress_block_greedy();
+    void lz77_compress_block_lazy();
+    void lz77_compress_block_optimal();
+    void slide_hash_table();
 
     // Huffman Coding
     struct code_length_symbol {
@@ -8,6 +8,7 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Debug.h>
 #include <AK/Format.h>
+#include <AK/HashTable.h>
 #include <AK/IDAllocator.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
@@ -28,13 +29,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
+// Where it's available, we wait on an epoll instance that remembers the watched fds between iterations,
+// so that waking up doesn't cost more with every notifier. Everything else falls back to select().
+#if defined(__serenity__) || defined(__linux__)
+#    define EVENTLOOP_USE_EPOLL
+#    include <sys/epoll.h>
+#else
+#    include <sys/select.h>
+#endif
+
 namespace Core {
 
 class InspectorServerConnection;
@@ -61,8 +70,21 @@ static EventLoop* s_main_event_loop;
 static Vector<EventLoop&>* s_event_loop_stack;
 static NeverDestroyed<IDAllocator> s_id_allocator;
 static HashMap<int, NonnullOwnPtr<EventLoopTimer>>* s_timers;
-static HashTable<Notifier*>* s_notifiers;
+
+struct NotifiersForFd {
+    Vector<Notifier*, 1> notifiers;
+    // The events we're currently waiting for, the union of the event masks of all notifiers.
+    unsigned event_mask { 0 };
+};
+
+// An fd can have multiple notifiers, but the kernel only knows about it once.
+static HashMap<int, NotifiersForFd>* s_notifiers;
 int EventLoop::s_wake_pipe_fds[2];
+#ifdef EVENTLOOP_USE_EPOLL
+static int s_epoll_fd = -1;
+// The fds being waited on that epoll refuses to watch, like regular files. Those are always ready anyway.
+static HashTable<int>* s_unpollable_fds;
+#endif
 static RefPtr<InspectorServerConnection> s_inspector_server_connection;
 
 class SignalHandlers : public RefCounted<SignalHandlers> {
@@ -259,7 +281,10 @@ EventLoop::EventLoop([[maybe_unused]] MakeInspectable make_inspectable)
     if (!s_event_loop_stack) {
         s_event_loop_stack = new Vector<EventLoop&>;
         s_timers = new HashMap<int, NonnullOwnPtr<EventLoopTimer>>;
-        s_notifiers = new HashTable<Notifier*>;
+        s_notifiers = new HashMap<int, NotifiersForFd>;
+#ifdef EVENTLOOP_USE_EPOLL
+        s_unpollable_fds = new HashTable<int>;
+#endif
     }
 
     if (!s_main_event_loop) {
@@ -555,6 +580,12 @@ void EventLoop::notify_forked(ForkEvent event)
         s_event_loop_stack->clear();
         s_timers->clear();
         s_notifiers->clear();
+#ifdef EVENTLOOP_USE_EPOLL
+        // The epoll instance is shared with the parent, so we have to stop using it before we change anything.
+        close(s_epoll_fd);
+        s_epoll_fd = -1;
+        s_unpollable_fds->clear();
+#endif
         if (auto* info = signals_info<false>()) {
             info->signal_handlers.clear();
             info->next_signal_id = 0;
@@ -569,11 +600,65 @@ void EventLoop::notify_forked(ForkEvent event)
     VERIFY_NOT_REACHED();
 }
 
+#ifdef EVENTLOOP_USE_EPOLL
+// Returns false if epoll can't watch the fd at all.
+static bool epoll_update(int op, int fd, unsigned event_mask)
+{
+    epoll_event event {};
+    if (event_mask & Notifier::Read)
+        event.events |= EPOLLIN;
+    if (event_mask & Notifier::Write)
+        event.events |= EPOLLOUT;
+    event.data.fd = fd;
+
+    int rc = epoll_ctl(s_epoll_fd, op, fd, &event);
+    // The fd may have been closed before its notifiers were disabled, taking the registration along with it.
+    if (rc < 0 && op == EPOLL_CTL_DEL && (errno == EBADF || errno == ENOENT))
+        return true;
+    if (rc < 0 && op == EPOLL_CTL_ADD && errno == EEXIST)
+        rc = epoll_ctl(s_epoll_fd, EPOLL_CTL_MOD, fd, &event);
+    if (rc < 0 && op == EPOLL_CTL_ADD && errno == EPERM)
+        return false;
+    if (rc < 0) {
+        perror("epoll_ctl");
+        VERIFY_NOT_REACHED();
+    }
+    return true;
+}
+
+static void epoll_add(int fd, unsigned event_mask)
+{
+    if (epoll_update(EPOLL_CTL_ADD, fd, event_mask))
+        s_unpollable_fds->remove(fd);
+    else
+        s_unpollable_fds->set(fd);
+}
+
+static void create_epoll_instance(int wake_pipe_fd)
+{
+    VERIFY(s_epoll_fd < 0);
+    s_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (s_epoll_fd < 0) {
+        perror("epoll_create1");
+        VERIFY_NOT_REACHED();
+    }
+
+    epoll_update(EPOLL_CTL_ADD, wake_pipe_fd, Notifier::Read);
+    for (auto& it : *s_notifiers) {
+        if (it.value.event_mask != 0)
+            epoll_add(it.key, it.value.event_mask);
+    }
+}
+#endif
+
 void EventLoop::wait_for_event(WaitMode mode)
 {
+#ifndef EVENTLOOP_USE_EPOLL
     fd_set rfds;
     fd_set wfds;
+#endif
 retry:
+#ifndef EVENTLOOP_USE_EPOLL
     FD_ZERO(&rfds);
     FD_ZERO(&wfds);
 
@@ -584,17 +669,14 @@ retry:
             max_fd = fd;
     };
 
-    int max_fd_added = -1;
     add_fd_to_set(s_wake_pipe_fds[0], rfds);
-    max_fd = max(max_fd, max_fd_added);
-    for (auto& notifier : *s_notifiers) {
-        if (notifier->event_mask() & Notifier::Read)
-            add_fd_to_set(notifier->fd(), rfds);
-        if (notifier->event_mask() & Notifier::Write)
-            add_fd_to_set(notifier->fd(), wfds);
-        if (notifier->event_mask() & Notifier::Exceptional)
-            VERIFY_NOT_REACHED();
+    for (auto& it : *s_notifiers) {
+        if (it.value.event_mask & Notifier::Read)
+            add_fd_to_set(it.key, rfds);
+        if (it.value.event_mask & Notifier::Write)
+            add_fd_to_set(it.key, wfds);
     }
+#endif
 
     bool queued_events_is_empty;
     {
@@ -622,8 +704,21 @@ retry:
         }
     }
 
+#ifdef EVENTLOOP_USE_EPOLL
+    if (s_epoll_fd < 0)
+        create_epoll_instance(s_wake_pipe_fds[0]);
+
+    // Round up, so we don't wake up just before the next timer expires and have to wait again.
+    int timeout_ms = should_wait_forever ? -1 : timeout.tv_sec * 1000 + (timeout.tv_usec + 999) / 1000;
+    if (!s_unpollable_fds->is_empty())
+        timeout_ms = 0;
+    epoll_event events[32];
+try_select_again:
+    int marked_fd_count = epoll_wait(s_epoll_fd, events, array_size(events), timeout_ms);
+#else
 try_select_again:
     int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
+#endif
     if (marked_fd_count < 0) {
         int saved_errno = errno;
         if (saved_errno == EINTR) {
@@ -634,7 +729,17 @@ try_select_again:
         dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::wait_for_event: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
         VERIFY_NOT_REACHED();
     }
-    if (FD_ISSET(s_wake_pipe_fds[0], &rfds)) {
+
+#ifdef EVENTLOOP_USE_EPOLL
+    bool wake_pipe_is_readable = false;
+    for (int i = 0; i < marked_fd_count; ++i) {
+        if (events[i].data.fd == s_wake_pipe_fds[0])
+            wake_pipe_is_readable = true;
+    }
+#else
+    bool wake_pipe_is_readable = FD_ISSET(s_wake_pipe_fds[0], &rfds);
+#endif
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         auto nread = read(s_wake_pipe_fds[0], wake_events, sizeof(wake_events));
         if (nread < 0) {
@@ -684,19 +789,41 @@ try_select_again:
         }
     }
 
+#ifdef EVENTLOOP_USE_EPOLL
+    if (!marked_fd_count && s_unpollable_fds->is_empty())
+        return;
+#else
     if (!marked_fd_count)
         return;
+#endif
 
-    for (auto& notifier : *s_notifiers) {
-        if (FD_ISSET(notifier->fd(), &rfds)) {
-            if (notifier->event_mask() & Notifier::Event::Read)
-                post_event(*notifier, make<NotifierReadEvent>(notifier->fd()));
-        }
-        if (FD_ISSET(notifier->fd(), &wfds)) {
-            if (notifier->event_mask() & Notifier::Event::Write)
-                post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
+    auto post_notifier_events = [&](int fd, bool is_readable, bool is_writable) {
+        auto it = s_notifiers->find(fd);
+        if (it == s_notifiers->end())
+            return;
+        for (auto* notifier : it->value.notifiers) {
+            if (is_readable && (notifier->event_mask() & Notifier::Event::Read))
+                post_event(*notifier, make<NotifierReadEvent>(fd));
+            if (is_writable && (notifier->event_mask() & Notifier::Event::Write))
+                post_event(*notifier, make<NotifierWriteEvent>(fd));
         }
+    };
+
+#ifdef EVENTLOOP_USE_EPOLL
+    for (int i = 0; i < marked_fd_count; ++i) {
+        auto& event = events[i];
+        if (event.data.fd == s_wake_pipe_fds[0])
+            continue;
+        // select() considers errors and hang-ups readable and writable, and so do we, letting read() or write() report them.
+        bool has_error = event.events & (EPOLLERR | EPOLLHUP);
+        post_notifier_events(event.data.fd, has_error || (event.events & EPOLLIN), has_error || (event.events & EPOLLOUT));
     }
+    for (auto fd : *s_unpollable_fds)
+        post_notifier_events(fd, true, true);
+#else
+    for (auto& it : *s_notifiers)
+        post_notifier_events(it.key, FD_ISSET(it.key, &rfds), FD_ISSET(it.key, &wfds));
+#endif
 }
 
 bool EventLoopTimer::has_expired(const timeval& now) const
@@ -757,14 +884,66 @@ bool EventLoop::unregister_timer(int timer_id)
     return true;
 }
 
+static void update_notifiers_for_fd(int fd, NotifiersForFd& notifiers_for_fd, bool has_new_notifier = false)
+{
+    unsigned event_mask = 0;
+    for (auto* notifier : notifiers_for_fd.notifiers) {
+        VERIFY(!(notifier->event_mask() & Notifier::Exceptional));
+        event_mask |= notifier->event_mask();
+    }
+    if (event_mask == notifiers_for_fd.event_mask && !has_new_notifier)
+        return;
+
+#ifdef EVENTLOOP_USE_EPOLL
+    // Without an epoll instance, e.g. right after forking, this happens once the next one is created.
+    if (s_epoll_fd >= 0) {
+        bool is_unpollable = s_unpollable_fds->contains(fd);
+        if (event_mask == 0) {
+            // Errors and hang-ups are reported even without asking for them, so don't watch fds that nobody wants to hear about.
+            if (is_unpollable)
+                s_unpollable_fds->remove(fd);
+            else if (notifiers_for_fd.event_mask != 0)
+                epoll_update(EPOLL_CTL_DEL, fd, event_mask);
+        } else if (notifiers_for_fd.event_mask == 0 || has_new_notifier) {
+            // Closing an fd takes its registration along with it, so if the number has been reused since, the epoll
+            // instance doesn't know about it anymore even though the event mask hasn't changed.
+            epoll_add(fd, event_mask);
+        } else if (!is_unpollable) {
+            epoll_update(EPOLL_CTL_MOD, fd, event_mask);
+        }
+    }
+#else
+    (void)fd;
+#endif
+    notifiers_for_fd.event_mask = event_mask;
+}
+
 void EventLoop::register_notifier(Badge<Notifier>, Notifier& notifier)
 {
-    s_notifiers->set(&notifier);
+    auto& notifiers_for_fd = s_notifiers->ensure(notifier.fd());
+    bool is_new_notifier = !notifiers_for_fd.notifiers.contains_slow(&notifier);
+    if (is_new_notifier)
+        notifiers_for_fd.notifiers.append(&notifier);
+    update_notifiers_for_fd(notifier.fd(), notifiers_for_fd, is_new_notifier);
 }
 
 void EventLoop::unregister_notifier(Badge<Notifier>, Notifier& notifier)
 {
-    s_notifiers->remove(&notifier);
+    auto it = s_notifiers->find(notifier.fd());
+    if (it == s_notifiers->end())
+        return;
+    it->value.notifiers.remove_first_matching([&](auto* entry) { return entry == &notifier; });
+    update_notifiers_for_fd(it->key, it->value);
+    if (it->value.notifiers.is_empty())
+        s_notifiers->remove(it);
+}
+
+void EventLoop::update_notifier(Badge<Notifier>, Notifier& notifier)
+{
+    auto it = s_notifiers->find(notifier.fd());
+    if (it == s_notifiers->end() || !it->value.notifiers.contains_slow(&notifier))
+        return;
+    update_notifiers_for_fd(it->key, it->value);
 }
 
 void EventLoop::wake()
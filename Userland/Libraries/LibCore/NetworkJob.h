@@ -49,6 +49,7 @@ protected:
     void did_finish(NonnullRefPtr<NetworkResponse>&&);
     void did_fail(Error);
     void did_progress(Optional<u32> total_size, u32 downloaded);
+    void clear_error() { m_error = Error::None; }
 
     size_t do_write(ReadonlyBytes bytes) { return m_output_stream.write(bytes); }
 
@@ -11,6 +11,7 @@
 #include "Font.h"
 #include "FontDatabase.h"
 #include "Gamma.h"
+#include "ScanlineOperations.h"
 #include <AK/Assertions.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
@@ -81,10 +82,28 @@ void Painter::fill_rect_with_draw_op(const IntRect& a_rect, Color color)
     RGBA32* dst = m_target->scanline(rect.top()) + rect.left();
     const size_t dst_skip = m_target->pitch() / sizeof(RGBA32);
 
-    for (int i = rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < rect.width(); ++j)
-            set_physical_pixel_with_draw_op(dst[j], color);
-        dst += dst_skip;
+    // Pick the draw op once instead of for every pixel, so the loops below are simple enough to be vectorized.
+    switch (draw_op()) {
+    case DrawOp::Copy:
+        for (int i = rect.height() - 1; i >= 0; --i) {
+            fast_u32_fill(dst, color.value(), rect.width());
+            dst += dst_skip;
+        }
+        break;
+    case DrawOp::Xor:
+        for (int i = rect.height() - 1; i >= 0; --i) {
+            for (int j = 0; j < rect.width(); ++j)
+                dst[j] = color.xored(Color::from_rgba(dst[j])).value();
+            dst += dst_skip;
+        }
+        break;
+    case DrawOp::Invert:
+        for (int i = rect.height() - 1; i >= 0; --i) {
+            for (int j = 0; j < rect.width(); ++j)
+                dst[j] = Color::from_rgba(dst[j]).inverted().value();
+            dst += dst_skip;
+        }
+        break;
     }
 }
 
@@ -112,6 +131,14 @@ void Painter::fill_physical_rect(const IntRect& physical_rect, Color color)
     RGBA32* dst = m_target->scanline(physical_rect.top()) + physical_rect.left();
     const size_t dst_skip = m_target->pitch() / sizeof(RGBA32);
 
+    if (!m_target->has_alpha_channel()) {
+        for (int i = physical_rect.height() - 1; i >= 0; --i) {
+            ScanlineOperations::fill_blended(dst, physical_rect.width(), color);
+            dst += dst_skip;
+        }
+        return;
+    }
+
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
         for (int j = 0; j < physical_rect.width(); ++j)
             dst[j] = Color::from_rgba(dst[j]).blend(color).value();
@@ -765,6 +792,35 @@ static void do_blit_with_opacity(BlitState& state)
     }
 }
 
+// Without an alpha channel in the target, whole rows can go through the scanline operations.
+static void do_blit_with_opacity_onto_opaque_target(BlitState& state, bool use_source_alpha)
+{
+    if (!use_source_alpha) {
+        u8 alpha = state.opacity * 255;
+        for (int row = 0; row < state.row_count; ++row) {
+            ScanlineOperations::blend_with_constant_alpha(state.dst, state.src, state.column_count, alpha);
+            state.dst += state.dst_pitch;
+            state.src += state.src_pitch;
+        }
+        return;
+    }
+
+    // Scale every possible source alpha by the opacity up front, exactly like do_blit_with_opacity() does per pixel.
+    u8 alpha_table[256];
+    bool alpha_is_unchanged = true;
+    for (int alpha = 0; alpha < 256; ++alpha) {
+        float pixel_opacity = alpha / 255.0;
+        alpha_table[alpha] = 255 * (state.opacity * pixel_opacity);
+        alpha_is_unchanged &= alpha_table[alpha] == alpha;
+    }
+
+    for (int row = 0; row < state.row_count; ++row) {
+        ScanlineOperations::blend_with_source_alpha(state.dst, state.src, state.column_count, alpha_is_unchanged ? nullptr : alpha_table);
+        state.dst += state.dst_pitch;
+        state.src += state.src_pitch;
+    }
+}
+
 void Painter::blit_with_opacity(const IntPoint& position, const Gfx::Bitmap& source, const IntRect& a_src_rect, float opacity, bool apply_alpha)
 {
     VERIFY(scale() >= source.scale() && "painter doesn't support downsampling scale factors");
@@ -801,6 +857,11 @@ void Painter::blit_with_opacity(const IntPoint& position, const Gfx::Bitmap& sou
         .opacity = opacity
     };
 
+    if (!m_target->has_alpha_channel()) {
+        do_blit_with_opacity_onto_opaque_target(blit_state, source.has_alpha_channel() && apply_alpha);
+        return;
+    }
+
     if (source.has_alpha_channel() && apply_alpha) {
         if (m_target->has_alpha_channel())
             do_blit_with_opacity<BlitState::BothAlpha>(blit_state);
@@ -1089,6 +1150,69 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, const IntRe
     }
 }
 
+// For 32-bit sources drawn onto an opaque target: gather the source pixels for a whole destination row, then copy or
+// blend the row with the scanline operations. Consecutive rows that sample the same source row only gather once.
+// This picks the same source pixels as do_draw_scaled_bitmap() and do_draw_integer_scaled_bitmap().
+static void do_draw_scaled_bitmap_onto_opaque_target(Gfx::Bitmap& target, const IntRect& dst_rect, const IntRect& clipped_rect, const Gfx::Bitmap& source, const FloatRect& src_rect, float opacity)
+{
+    IntRect int_src_rect = enclosing_int_rect(src_rect);
+    bool is_integer_scale = dst_rect == clipped_rect && int_src_rect == src_rect && !(dst_rect.width() % int_src_rect.width()) && !(dst_rect.height() % int_src_rect.height());
+    int hscale = (src_rect.width() * (1 << 16)) / dst_rect.width();
+    int vscale = (src_rect.height() * (1 << 16)) / dst_rect.height();
+    int src_left = src_rect.left() * (1 << 16);
+    int src_top = src_rect.top() * (1 << 16);
+
+    auto source_x = [&](int x) {
+        if (is_integer_scale)
+            return int_src_rect.left() + (x - dst_rect.x()) / (dst_rect.width() / int_src_rect.width());
+        return ((x - dst_rect.x()) * hscale + src_left) >> 16;
+    };
+    auto source_y = [&](int y) {
+        if (is_integer_scale)
+            return int_src_rect.top() + (y - dst_rect.y()) / (dst_rect.height() / int_src_rect.height());
+        return ((y - dst_rect.y()) * vscale + src_top) >> 16;
+    };
+
+    int width = clipped_rect.width();
+    Vector<int> source_columns;
+    source_columns.resize(width);
+    for (int i = 0; i < width; ++i)
+        source_columns[i] = source_x(clipped_rect.left() + i);
+
+    bool has_opacity = opacity != 1.0f;
+    bool source_has_alpha = source.has_alpha_channel();
+    u8 alpha_table[256];
+    if (has_opacity) {
+        for (int alpha = 0; alpha < 256; ++alpha)
+            alpha_table[alpha] = alpha * opacity;
+    }
+
+    Vector<RGBA32> row;
+    row.resize(width);
+    int gathered_source_y = -1;
+    for (int y = clipped_rect.top(); y <= clipped_rect.bottom(); ++y) {
+        int scaled_y = source_y(y);
+        if (scaled_y != gathered_source_y) {
+            auto* source_scanline = source.scanline(scaled_y);
+            for (int i = 0; i < width; ++i)
+                row[i] = source_scanline[source_columns[i]];
+            if (!source_has_alpha) {
+                for (int i = 0; i < width; ++i)
+                    row[i] |= 0xff000000;
+            }
+            gathered_source_y = scaled_y;
+        }
+
+        auto* dst = target.scanline(y) + clipped_rect.left();
+        if (source_has_alpha)
+            ScanlineOperations::blend_with_source_alpha(dst, row.data(), width, has_opacity ? alpha_table : nullptr);
+        else if (has_opacity)
+            ScanlineOperations::blend_with_constant_alpha(dst, row.data(), width, alpha_table[255]);
+        else
+            fast_u32_copy(dst, row.data(), width);
+    }
+}
+
 void Painter::draw_scaled_bitmap(const IntRect& a_dst_rect, const Gfx::Bitmap& source, const IntRect& a_src_rect, float opacity)
 {
     draw_scaled_bitmap(a_dst_rect, source, FloatRect { a_src_rect }, opacity);
@@ -1106,6 +1230,9 @@ void Painter::draw_scaled_bitmap(const IntRect& a_dst_rect, const Gfx::Bitmap& s
     if (clipped_rect.is_empty())
         return;
 
+    if (!m_target->has_alpha_channel() && (source.format() == BitmapFormat::BGRx8888 || source.format() == BitmapFormat::BGRA8888))
+        return do_draw_scaled_bitmap_onto_opaque_target(*m_target, dst_rect, clipped_rect, source, src_rect, opacity);
+
     if (source.has_alpha_channel() || opacity != 1.0f) {
         switch (source.format()) {
         case BitmapFormat::BGRx8888:
@@ -123,9 +123,9 @@ public:
     }
 
     IntRect clip_rect() const { return state().clip_rect; }
+    IntPoint translation() const { return state().translation; }
 
 protected:
-    IntPoint translation() const { return state().translation; }
     IntRect to_physical(const IntRect& r) const { return r.translated(translation()) * scale(); }
     IntPoint to_physical(const IntPoint& p) const { return p.translated(translation()) * scale(); }
     int scale() const { return state().scale; }
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <AK/SIMD.h>
+#include <LibGfx/ScanlineOperations.h>
+
+#if ARCH(I386) || ARCH(X86_64)
+#    include <cpuid.h>
+#    include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC optimize("O3")
+#endif
+
+namespace Gfx::ScanlineOperations {
+
+static bool s_simd_enabled = true;
+
+bool is_simd_enabled()
+{
+    return s_simd_enabled;
+}
+
+void set_simd_enabled(bool enabled)
+{
+    s_simd_enabled = enabled;
+}
+
+// Color::blend() with an opaque destination boils down to this, for every channel:
+//     (destination * (255 - alpha) + source * alpha) / 255
+// and the result is opaque again.
+ALWAYS_INLINE static RGBA32 blend_pixel(RGBA32 dst, RGBA32 src, u32 alpha)
+{
+    if (alpha == 0xff)
+        return src | 0xff000000;
+    if (alpha == 0)
+        return dst | 0xff000000;
+    u32 inverse_alpha = 255 - alpha;
+    u32 blue = ((dst & 0xff) * inverse_alpha + (src & 0xff) * alpha) / 255;
+    u32 green = (((dst >> 8) & 0xff) * inverse_alpha + ((src >> 8) & 0xff) * alpha) / 255;
+    u32 red = (((dst >> 16) & 0xff) * inverse_alpha + ((src >> 16) & 0xff) * alpha) / 255;
+    return 0xff000000 | (red << 16) | (green << 8) | blue;
+}
+
+#if ARCH(I386) || ARCH(X86_64)
+
+using AK::SIMD::u16x8;
+
+static bool cpu_has_sse2()
+{
+#    if ARCH(X86_64)
+    return true;
+#    else
+    static bool has_sse2 = [] {
+        unsigned eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (edx & bit_SSE2) != 0;
+    }();
+    return has_sse2;
+#    endif
+}
+
+static bool should_use_sse2()
+{
+    return s_simd_enabled && cpu_has_sse2();
+}
+
+// All of the SSE2 loops below work on four pixels at a time. Each half of them is widened to 16 bits per
+// channel, which leaves enough room for channel * alpha, and the division by 255 is done with the exact
+// identity x / 255 == (x + 1 + (x >> 8)) >> 8, which holds for every x up to 255 * 255.
+[[gnu::target("sse2")]] ALWAYS_INLINE static u16x8 divide_by_255(u16x8 x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+[[gnu::target("sse2")]] static void blend_with_source_alpha_sse2(RGBA32* dst, const RGBA32* src, size_t count, const u8* alpha_table)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32(0xff000000);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i source = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i destination = _mm_loadu_si128((const __m128i*)(dst + i));
+
+        u16x8 source_low = (u16x8)_mm_unpacklo_epi8(source, zero);
+        u16x8 source_high = (u16x8)_mm_unpackhi_epi8(source, zero);
+        u16x8 alpha_low;
+        u16x8 alpha_high;
+        if (alpha_table) {
+            u16 a0 = alpha_table[src[i] >> 24];
+            u16 a1 = alpha_table[src[i + 1] >> 24];
+            u16 a2 = alpha_table[src[i + 2] >> 24];
+            u16 a3 = alpha_table[src[i + 3] >> 24];
+            if ((a0 | a1 | a2 | a3) == 0) {
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(destination, alpha_mask));
+                continue;
+            }
+            alpha_low = u16x8 { a0, a0, a0, a0, a1, a1, a1, a1 };
+            alpha_high = u16x8 { a2, a2, a2, a2, a3, a3, a3, a3 };
+        } else {
+            // Most pixels of most bitmaps are either fully opaque or fully transparent, so look for those first.
+            int opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(source, alpha_mask), alpha_mask));
+            if (opaque == 0xffff) {
+                _mm_storeu_si128((__m128i*)(dst + i), source);
+                continue;
+            }
+            int transparent = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(source, alpha_mask), zero));
+            if (transparent == 0xffff) {
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(destination, alpha_mask));
+                continue;
+            }
+            alpha_low = (u16x8)_mm_shufflehi_epi16(_mm_shufflelo_epi16((__m128i)source_low, 0xff), 0xff);
+            alpha_high = (u16x8)_mm_shufflehi_epi16(_mm_shufflelo_epi16((__m128i)source_high, 0xff), 0xff);
+        }
+
+        u16x8 destination_low = (u16x8)_mm_unpacklo_epi8(destination, zero);
+        u16x8 destination_high = (u16x8)_mm_unpackhi_epi8(destination, zero);
+        u16x8 low = destination_low * (255 - alpha_low) + source_low * alpha_low;
+        u16x8 high = destination_high * (255 - alpha_high) + source_high * alpha_high;
+        low = divide_by_255(low);
+        high = divide_by_255(high);
+        __m128i result = _mm_packus_epi16((__m128i)low, (__m128i)high);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(result, alpha_mask));
+    }
+
+    for (; i < count; ++i) {
+        u32 alpha = src[i] >> 24;
+        dst[i] = blend_pixel(dst[i], src[i], alpha_table ? alpha_table[alpha] : alpha);
+    }
+}
+
+[[gnu::target("sse2")]] static void blend_with_constant_alpha_sse2(RGBA32* dst, const RGBA32* src, size_t count, u8 alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32(0xff000000);
+    const u16x8 source_alpha = (u16x8)_mm_set1_epi16(alpha);
+    const u16x8 inverse_alpha = (u16x8)_mm_set1_epi16(255 - alpha);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i source = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i destination = _mm_loadu_si128((const __m128i*)(dst + i));
+        u16x8 low = (u16x8)_mm_unpacklo_epi8(destination, zero) * inverse_alpha + (u16x8)_mm_unpacklo_epi8(source, zero) * source_alpha;
+        u16x8 high = (u16x8)_mm_unpackhi_epi8(destination, zero) * inverse_alpha + (u16x8)_mm_unpackhi_epi8(source, zero) * source_alpha;
+        low = divide_by_255(low);
+        high = divide_by_255(high);
+        __m128i result = _mm_packus_epi16((__m128i)low, (__m128i)high);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(result, alpha_mask));
+    }
+
+    for (; i < count; ++i)
+        dst[i] = blend_pixel(dst[i], src[i], alpha);
+}
+
+[[gnu::target("sse2")]] static void fill_blended_sse2(RGBA32* dst, size_t count, Color color)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32(0xff000000);
+    const u16x8 inverse_alpha = (u16x8)_mm_set1_epi16(255 - color.alpha());
+    const u16x8 premultiplied_color = (u16x8)_mm_unpacklo_epi8(_mm_set1_epi32(color.value()), zero) * (u16)color.alpha();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i destination = _mm_loadu_si128((const __m128i*)(dst + i));
+        u16x8 low = (u16x8)_mm_unpacklo_epi8(destination, zero) * inverse_alpha + premultiplied_color;
+        u16x8 high = (u16x8)_mm_unpackhi_epi8(destination, zero) * inverse_alpha + premultiplied_color;
+        low = divide_by_255(low);
+        high = divide_by_255(high);
+        __m128i result = _mm_packus_epi16((__m128i)low, (__m128i)high);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(result, alpha_mask));
+    }
+
+    for (; i < count; ++i)
+        dst[i] = blend_pixel(dst[i], color.value(), color.alpha());
+}
+
+#endif
+
+void blend_with_source_alpha(RGBA32* dst, const RGBA32* src, size_t count, const u8* alpha_table)
+{
+#if ARCH(I386) || ARCH(X86_64)
+    if (should_use_sse2())
+        return blend_with_source_alpha_sse2(dst, src, count, alpha_table);
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        u32 alpha = src[i] >> 24;
+        dst[i] = blend_pixel(dst[i], src[i], alpha_table ? alpha_table[alpha] : alpha);
+    }
+}
+
+void blend_with_constant_alpha(RGBA32* dst, const RGBA32* src, size_t count, u8 alpha)
+{
+    if (alpha == 0xff) {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = src[i] | 0xff000000;
+        return;
+    }
+#if ARCH(I386) || ARCH(X86_64)
+    if (should_use_sse2())
+        return blend_with_constant_alpha_sse2(dst, src, count, alpha);
+#endif
+    for (size_t i = 0; i < count; ++i)
+        dst[i] = blend_pixel(dst[i], src[i], alpha);
+}
+
+void fill_blended(RGBA32* dst, size_t count, Color color)
+{
+#if ARCH(I386) || ARCH(X86_64)
+    if (should_use_sse2())
+        return fill_blended_sse2(dst, count, color);
+#endif
+    for (size_t i = 0; i < count; ++i)
+        dst[i] = blend_pixel(dst[i], color.value(), color.alpha());
+}
+
+}
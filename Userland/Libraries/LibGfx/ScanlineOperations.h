@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <LibGfx/Color.h>
+
+namespace Gfx {
+
+// The innermost loops of Painter's blit, fill and scale paths, one scanline at a time.
+// They all draw onto an opaque (BGRx8888) target, and give exactly the same results as blending
+// each pixel with Color::blend(), which is what they replace. On x86 processors with SSE2 they
+// blend four pixels at a time; that is checked at runtime, so i686 builds still run everywhere.
+namespace ScanlineOperations {
+
+// Blends `count` pixels from src over dst, using the alpha of each source pixel.
+// If alpha_table isn't null, the source alpha is looked up in it first, which is how opacity is applied.
+void blend_with_source_alpha(RGBA32* dst, const RGBA32* src, size_t count, const u8* alpha_table = nullptr);
+
+// Blends `count` pixels from src over dst, treating every source pixel as having the given alpha.
+void blend_with_constant_alpha(RGBA32* dst, const RGBA32* src, size_t count, u8 alpha);
+
+// Blends a translucent color over `count` pixels of dst.
+void fill_blended(RGBA32* dst, size_t count, Color);
+
+// Whether the SIMD versions get used if the processor supports them. Only for tests and benchmarks.
+bool is_simd_enabled();
+void set_simd_enabled(bool);
+
+}
+
+}
@@ -13,9 +13,22 @@
 
 namespace HTTP {
 void HttpJob::start()
+{
+    auto socket = Core::TCPSocket::construct(this);
+    start(*socket);
+}
+
+void HttpJob::start(Core::Socket& socket)
 {
     VERIFY(!m_socket);
-    m_socket = Core::TCPSocket::construct(this);
+    m_socket = socket;
+    if (m_socket->is_connected()) {
+        dbgln_if(CHTTPJOB_DEBUG, "HttpJob: Reusing previous connection for {}", url());
+        deferred_invoke([this](auto&) {
+            on_socket_connected();
+        });
+        return;
+    }
     m_socket->on_connected = [this] {
         dbgln_if(CHTTPJOB_DEBUG, "HttpJob: on_connected callback");
         on_socket_connected();
@@ -34,7 +47,9 @@ void HttpJob::shutdown()
         return;
     m_socket->on_ready_to_read = nullptr;
     m_socket->on_connected = nullptr;
-    remove_child(*m_socket);
+    // A socket that was handed to us belongs to someone else, who decides whether to keep it around.
+    if (m_socket->parent() == this)
+        remove_child(*m_socket);
     m_socket = nullptr;
 }
 
@@ -28,6 +28,8 @@ public:
     }
 
     virtual void start() override;
+    // Runs the job on the given socket, which may still carry an established connection from an earlier job.
+    void start(Core::Socket&);
     virtual void shutdown() override;
 
 protected:
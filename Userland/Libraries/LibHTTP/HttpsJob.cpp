@@ -15,10 +15,15 @@
 namespace HTTP {
 
 void HttpsJob::start()
+{
+    auto socket = TLS::TLSv12::construct(this);
+    start(*socket);
+}
+
+void HttpsJob::start(TLS::TLSv12& socket)
 {
     VERIFY(!m_socket);
-    m_socket = TLS::TLSv12::construct(this);
-    m_socket->set_root_certificates(m_override_ca_certificates ? *m_override_ca_certificates : DefaultRootCACertificates::the().certificates());
+    m_socket = socket;
     m_socket->on_tls_connected = [this] {
         dbgln_if(HTTPSJOB_DEBUG, "HttpsJob: on_connected callback");
         on_socket_connected();
@@ -39,6 +44,11 @@ void HttpsJob::start()
         }
     };
     m_socket->on_tls_finished = [this] {
+        // The server hung up without answering, which isn't a (very short) response.
+        if (m_state == State::InStatus) {
+            deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+            return;
+        }
         if (!m_has_scheduled_finish)
             finish_up();
     };
@@ -46,7 +56,18 @@ void HttpsJob::start()
         if (on_certificate_requested)
             on_certificate_requested(*this);
     };
-    bool success = ((TLS::TLSv12&)*m_socket).connect(m_request.url().host(), m_request.url().port());
+
+    if (m_socket->is_established()) {
+        // The handshake is long done, so there won't be another on_tls_connected.
+        dbgln_if(HTTPSJOB_DEBUG, "HttpsJob: Reusing previous connection for {}", url());
+        deferred_invoke([this](auto&) {
+            on_socket_connected();
+        });
+        return;
+    }
+
+    m_socket->set_root_certificates(m_override_ca_certificates ? *m_override_ca_certificates : DefaultRootCACertificates::the().certificates());
+    bool success = m_socket->connect(m_request.url().host(), m_request.url().port());
     if (!success) {
         deferred_invoke([this](auto&) {
             return did_fail(Core::NetworkJob::Error::ConnectionFailed);
@@ -59,8 +80,14 @@ void HttpsJob::shutdown()
     if (!m_socket)
         return;
     m_socket->on_tls_ready_to_read = nullptr;
+    m_socket->on_tls_ready_to_write = nullptr;
     m_socket->on_tls_connected = nullptr;
-    remove_child(*m_socket);
+    m_socket->on_tls_error = nullptr;
+    m_socket->on_tls_finished = nullptr;
+    m_socket->on_tls_certificate_request = nullptr;
+    // A socket that was handed to us belongs to someone else, who decides whether to keep it around.
+    if (m_socket->parent() == this)
+        remove_child(*m_socket);
     m_socket = nullptr;
 }
 
@@ -93,6 +120,13 @@ void HttpsJob::register_on_ready_to_write(Function<void()> callback)
     m_socket->on_tls_ready_to_write = [callback = move(callback)](auto&) {
         callback();
     };
+    // An established connection only tells us about being writable after we wrote something, so kick things off ourselves.
+    if (m_socket->is_established()) {
+        deferred_invoke([this](auto&) {
+            if (m_socket && m_socket->on_tls_ready_to_write)
+                m_socket->on_tls_ready_to_write(*m_socket);
+        });
+    }
 }
 
 bool HttpsJob::can_read_line() const
@@ -29,6 +29,8 @@ public:
     }
 
     virtual void start() override;
+    // Runs the job on the given socket, which may still carry an established connection from an earlier job.
+    void start(TLS::TLSv12&);
     virtual void shutdown() override;
     void set_certificate(String certificate, String key);
 
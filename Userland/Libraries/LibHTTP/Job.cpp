@@ -121,233 +121,340 @@ void Job::on_socket_connected()
             deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
     });
     register_on_ready_to_read([&] {
-        if (is_cancelled())
-            return;
+        // On a persistent connection, there is no EOF that keeps waking us up while the response sits
+        // in our buffers, so keep going for as long as we can make progress with what we already have.
+        NonnullRefPtr<Job> protector(*this);
+        do {
+            on_socket_ready_to_read();
+        } while (!is_cancelled() && !has_error() && can_process_buffered_data());
+    });
+}
 
-        if (m_state == State::Finished) {
-            // We have everything we want, at this point, we can either get an EOF, or a bunch of extra newlines
-            // (unless "Connection: close" isn't specified)
-            // So just ignore everything after this.
-            return;
-        }
+bool Job::can_process_buffered_data() const
+{
+    switch (m_state) {
+    case State::InStatus:
+    case State::InHeaders:
+    case State::Trailers:
+        return can_read_line();
+    case State::InBody:
+        if (m_should_read_chunk_ending_line || (m_current_chunk_remaining_size.has_value() && m_current_chunk_remaining_size.value() == -1))
+            return can_read_line();
+        return can_read();
+    case State::Finished:
+        return false;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+bool Job::response_has_no_body() const
+{
+    if (m_request.method() == HttpRequest::Method::HEAD)
+        return true;
+    if (m_code == 204 || m_code == 304)
+        return true;
+    if (m_headers.contains("Transfer-Encoding"))
+        return false;
+    auto content_length = m_headers.get("Content-Length");
+    if (!content_length.has_value())
+        return false;
+    auto length = content_length.value().to_uint();
+    return length.has_value() && length.value() == 0;
+}
+
+bool Job::can_reuse_connection() const
+{
+    return m_request.keep_alive() && m_server_keeps_connection_alive && m_received_complete_response && !has_error() && is_established() && !eof();
+}
+
+bool Job::can_retry_on_new_connection() const
+{
+    if (error() != Core::NetworkJob::Error::TransmissionFailed)
+        return false;
+    if (m_state != State::InStatus || m_code != -1)
+        return false;
+    auto method = m_request.method();
+    return method == HttpRequest::Method::GET || method == HttpRequest::Method::HEAD;
+}
+
+void Job::reset_for_retry()
+{
+    clear_error();
+    m_state = State::InStatus;
+    m_code = -1;
+    m_headers.clear();
+    m_received_buffers.clear();
+    m_buffered_size = 0;
+    m_received_size = 0;
+    m_sent_data = false;
+    m_current_chunk_remaining_size = {};
+    m_current_chunk_total_size = {};
+    m_can_stream_response = true;
+    m_should_read_chunk_ending_line = false;
+    m_has_scheduled_finish = false;
+    m_is_http_1_1 = false;
+    m_server_keeps_connection_alive = false;
+    m_received_complete_response = false;
+}
+
+void Job::on_socket_ready_to_read()
+{
+    if (is_cancelled())
+        return;
 
-        if (m_state == State::InStatus) {
-            if (!can_read_line())
-                return;
-            auto line = read_line(PAGE_SIZE);
-            if (line.is_null()) {
-                warnln("Job: Expected HTTP status");
+    if (m_state == State::Finished) {
+        // We have everything we want, at this point, we can either get an EOF, or a bunch of extra newlines
+        // (unless "Connection: close" isn't specified)
+        // So just ignore everything after this.
+        return;
+    }
+
+    if (m_state == State::InStatus) {
+        if (!can_read_line()) {
+            // The server hung up without answering, there's nothing more coming.
+            if (eof())
                 return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-            }
-            auto parts = line.split_view(' ');
-            if (parts.size() < 3) {
-                warnln("Job: Expected 3-part HTTP status, got '{}'", line);
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto code = parts[1].to_uint();
-            if (!code.has_value()) {
-                warnln("Job: Expected numeric HTTP status");
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            m_code = code.value();
-            m_state = State::InHeaders;
             return;
         }
-        if (m_state == State::InHeaders || m_state == State::Trailers) {
-            if (!can_read_line())
-                return;
-            auto line = read_line(PAGE_SIZE);
-            if (line.is_null()) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
-                }
-                warnln("Job: Expected HTTP header");
-                return did_fail(Core::NetworkJob::Error::ProtocolFailed);
-            }
-            if (line.is_empty()) {
-                if (m_state == State::Trailers) {
-                    return finish_up();
-                } else {
-                    if (on_headers_received)
-                        on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
-                    m_state = State::InBody;
-                }
-                return;
+        auto line = read_line(PAGE_SIZE);
+        if (line.is_null()) {
+            warnln("Job: Expected HTTP status");
+            return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+        }
+        auto parts = line.split_view(' ');
+        if (parts.size() < 3) {
+            warnln("Job: Expected 3-part HTTP status, got '{}'", line);
+            return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+        }
+        auto code = parts[1].to_uint();
+        if (!code.has_value()) {
+            warnln("Job: Expected numeric HTTP status");
+            return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+        }
+        m_code = code.value();
+        m_is_http_1_1 = parts[0] == "HTTP/1.1";
+        m_state = State::InHeaders;
+        return;
+    }
+    if (m_state == State::InHeaders || m_state == State::Trailers) {
+        if (!can_read_line())
+            return;
+        auto line = read_line(PAGE_SIZE);
+        if (line.is_null()) {
+            if (m_state == State::Trailers) {
+                // Some servers like to send two ending chunks
+                // use this fact as an excuse to ignore anything after the last chunk
+                // that is not a valid trailing header.
+                return finish_up();
             }
-            auto parts = line.split_view(':');
-            if (parts.is_empty()) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
+            warnln("Job: Expected HTTP header");
+            return did_fail(Core::NetworkJob::Error::ProtocolFailed);
+        }
+        if (line.is_empty()) {
+            if (m_state == State::Trailers) {
+                m_received_complete_response = true;
+                return finish_up();
+            } else {
+                if (on_headers_received)
+                    on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
+                m_state = State::InBody;
+
+                // HTTP/1.1 connections are persistent unless either side says otherwise, HTTP/1.0 ones have to opt in.
+                auto connection = m_headers.get("Connection");
+                if (m_is_http_1_1)
+                    m_server_keeps_connection_alive = !connection.has_value() || !connection.value().equals_ignoring_case("close");
+                else
+                    m_server_keeps_connection_alive = connection.has_value() && connection.value().equals_ignoring_case("keep-alive");
+
+                // Without a body there is nothing left to wait for, and a persistent connection won't send us an EOF.
+                if (response_has_no_body()) {
+                    m_received_complete_response = true;
                     return finish_up();
                 }
-                warnln("Job: Expected HTTP header with key/value");
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
             }
-            auto name = parts[0];
-            if (line.length() < name.length() + 2) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
-                }
-                warnln("Job: Malformed HTTP header: '{}' ({})", line, line.length());
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+            return;
+        }
+        auto parts = line.split_view(':');
+        if (parts.is_empty()) {
+            if (m_state == State::Trailers) {
+                // Some servers like to send two ending chunks
+                // use this fact as an excuse to ignore anything after the last chunk
+                // that is not a valid trailing header.
+                return finish_up();
             }
-            auto value = line.substring(name.length() + 2, line.length() - name.length() - 2);
-            m_headers.set(name, value);
-            if (name.equals_ignoring_case("Content-Encoding")) {
-                // Assume that any content-encoding means that we can't decode it as a stream :(
-                dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
-                m_can_stream_response = false;
+            warnln("Job: Expected HTTP header with key/value");
+            return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+        }
+        auto name = parts[0];
+        if (line.length() < name.length() + 2) {
+            if (m_state == State::Trailers) {
+                // Some servers like to send two ending chunks
+                // use this fact as an excuse to ignore anything after the last chunk
+                // that is not a valid trailing header.
+                return finish_up();
             }
-            dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
-            return;
+            warnln("Job: Malformed HTTP header: '{}' ({})", line, line.length());
+            return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
         }
-        VERIFY(m_state == State::InBody);
-        VERIFY(can_read());
-
-        read_while_data_available([&] {
-            auto read_size = 64 * KiB;
-            if (m_current_chunk_remaining_size.has_value()) {
-            read_chunk_size:;
-                auto remaining = m_current_chunk_remaining_size.value();
-                if (remaining == -1) {
-                    // read size
-                    auto size_data = read_line(PAGE_SIZE);
-                    if (m_should_read_chunk_ending_line) {
-                        VERIFY(size_data.is_empty());
-                        m_should_read_chunk_ending_line = false;
-                        return IterationDecision::Continue;
-                    }
-                    auto size_lines = size_data.view().lines();
-                    dbgln_if(JOB_DEBUG, "Job: Received a chunk with size '{}'", size_data);
-                    if (size_lines.size() == 0) {
-                        dbgln("Job: Reached end of stream");
+        auto value = line.substring(name.length() + 2, line.length() - name.length() - 2);
+        m_headers.set(name, value);
+        if (name.equals_ignoring_case("Content-Encoding")) {
+            // Assume that any content-encoding means that we can't decode it as a stream :(
+            dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
+            m_can_stream_response = false;
+        }
+        dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
+        return;
+    }
+    VERIFY(m_state == State::InBody);
+    VERIFY(can_read());
+
+    read_while_data_available([&] {
+        auto read_size = 64 * KiB;
+        if (m_current_chunk_remaining_size.has_value()) {
+        read_chunk_size:;
+            auto remaining = m_current_chunk_remaining_size.value();
+            if (remaining == -1) {
+                // read size
+                if (!can_read_line()) {
+                    // The line hasn't fully arrived yet, wait for the rest of it (or the end of the stream).
+                    if (eof())
                         finish_up();
-                        return IterationDecision::Break;
-                    } else {
-                        auto chunk = size_lines[0].split_view(';', true);
-                        String size_string = chunk[0];
-                        char* endptr;
-                        auto size = strtoul(size_string.characters(), &endptr, 16);
-                        if (*endptr) {
-                            // invalid number
-                            deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-                            return IterationDecision::Break;
-                        }
-                        if (size == 0) {
-                            // This is the last chunk
-                            // '0' *[; chunk-ext-name = chunk-ext-value]
-                            // We're going to ignore _all_ chunk extensions
-                            read_size = 0;
-                            m_current_chunk_total_size = 0;
-                            m_current_chunk_remaining_size = 0;
-
-                            dbgln_if(JOB_DEBUG, "Job: Received the last chunk with extensions '{}'", size_string.substring_view(1, size_string.length() - 1));
-                        } else {
-                            m_current_chunk_total_size = size;
-                            m_current_chunk_remaining_size = size;
-                            read_size = size;
-
-                            dbgln_if(JOB_DEBUG, "Job: Chunk of size '{}' started", size);
-                        }
-                    }
-                } else {
-                    read_size = remaining;
-
-                    dbgln_if(JOB_DEBUG, "Job: Resuming chunk with '{}' bytes left over", remaining);
+                    return IterationDecision::Break;
                 }
-            } else {
-                auto transfer_encoding = m_headers.get("Transfer-Encoding");
-                if (transfer_encoding.has_value()) {
-                    // Note: Some servers add extra spaces around 'chunked', see #6302.
-                    auto encoding = transfer_encoding.value().trim_whitespace();
-
-                    dbgln_if(JOB_DEBUG, "Job: This content has transfer encoding '{}'", encoding);
-                    if (encoding.equals_ignoring_case("chunked")) {
-                        m_current_chunk_remaining_size = -1;
-                        goto read_chunk_size;
-                    } else {
-                        dbgln("Job: Unknown transfer encoding '{}', the result will likely be wrong!", encoding);
-                    }
+                auto size_data = read_line(PAGE_SIZE);
+                if (m_should_read_chunk_ending_line) {
+                    VERIFY(size_data.is_empty());
+                    m_should_read_chunk_ending_line = false;
+                    return IterationDecision::Continue;
                 }
-            }
-
-            auto payload = receive(read_size);
-            if (payload.is_empty()) {
-                if (eof()) {
+                auto size_lines = size_data.view().lines();
+                dbgln_if(JOB_DEBUG, "Job: Received a chunk with size '{}'", size_data);
+                if (size_lines.size() == 0) {
+                    dbgln("Job: Reached end of stream");
                     finish_up();
                     return IterationDecision::Break;
+                } else {
+                    auto chunk = size_lines[0].split_view(';', true);
+                    String size_string = chunk[0];
+                    char* endptr;
+                    auto size = strtoul(size_string.characters(), &endptr, 16);
+                    if (*endptr) {
+                        // invalid number
+                        deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+                        return IterationDecision::Break;
+                    }
+                    if (size == 0) {
+                        // This is the last chunk
+                        // '0' *[; chunk-ext-name = chunk-ext-value]
+                        // We're going to ignore _all_ chunk extensions
+                        read_size = 0;
+                        m_current_chunk_total_size = 0;
+                        m_current_chunk_remaining_size = 0;
+
+                        dbgln_if(JOB_DEBUG, "Job: Received the last chunk with extensions '{}'", size_string.substring_view(1, size_string.length() - 1));
+                    } else {
+                        m_current_chunk_total_size = size;
+                        m_current_chunk_remaining_size = size;
+                        read_size = size;
+
+                        dbgln_if(JOB_DEBUG, "Job: Chunk of size '{}' started", size);
+                    }
                 }
+            } else {
+                read_size = remaining;
 
-                if (should_fail_on_empty_payload()) {
-                    deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-                    return IterationDecision::Break;
+                dbgln_if(JOB_DEBUG, "Job: Resuming chunk with '{}' bytes left over", remaining);
+            }
+        } else {
+            auto transfer_encoding = m_headers.get("Transfer-Encoding");
+            if (transfer_encoding.has_value()) {
+                // Note: Some servers add extra spaces around 'chunked', see #6302.
+                auto encoding = transfer_encoding.value().trim_whitespace();
+
+                dbgln_if(JOB_DEBUG, "Job: This content has transfer encoding '{}'", encoding);
+                if (encoding.equals_ignoring_case("chunked")) {
+                    m_current_chunk_remaining_size = -1;
+                    goto read_chunk_size;
+                } else {
+                    dbgln("Job: Unknown transfer encoding '{}', the result will likely be wrong!", encoding);
                 }
             }
+        }
 
-            m_received_buffers.append(payload);
-            m_buffered_size += payload.size();
-            m_received_size += payload.size();
-            flush_received_buffers();
+        auto content_length_header = m_headers.get("Content-Length");
+        Optional<u32> content_length {};
 
-            if (m_current_chunk_remaining_size.has_value()) {
-                auto size = m_current_chunk_remaining_size.value() - payload.size();
+        if (content_length_header.has_value()) {
+            auto length = content_length_header.value().to_uint();
+            if (length.has_value())
+                content_length = length.value();
+        }
 
-                dbgln_if(JOB_DEBUG, "Job: We have {} bytes left over in this chunk", size);
-                if (size == 0) {
-                    dbgln_if(JOB_DEBUG, "Job: Finished a chunk of {} bytes", m_current_chunk_total_size.value());
+        // Don't read past the end of the body, whatever follows it belongs to the next response on this connection.
+        if (!m_current_chunk_remaining_size.has_value() && content_length.has_value() && content_length.value() > m_received_size)
+            read_size = min<size_t>(read_size, content_length.value() - m_received_size);
 
-                    if (m_current_chunk_total_size.value() == 0) {
-                        m_state = State::Trailers;
-                        return IterationDecision::Break;
-                    }
+        auto payload = receive(read_size);
+        if (payload.is_empty()) {
+            if (eof()) {
+                finish_up();
+                return IterationDecision::Break;
+            }
 
-                    // we've read everything, now let's get the next chunk
-                    size = -1;
-                    if (can_read_line()) {
-                        auto line = read_line(PAGE_SIZE);
-                        VERIFY(line.is_empty());
-                    } else {
-                        m_should_read_chunk_ending_line = true;
-                    }
-                }
-                m_current_chunk_remaining_size = size;
+            if (should_fail_on_empty_payload()) {
+                deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+                return IterationDecision::Break;
             }
+        }
 
-            auto content_length_header = m_headers.get("Content-Length");
-            Optional<u32> content_length {};
+        m_received_buffers.append(payload);
+        m_buffered_size += payload.size();
+        m_received_size += payload.size();
+        flush_received_buffers();
 
-            if (content_length_header.has_value()) {
-                auto length = content_length_header.value().to_uint();
-                if (length.has_value())
-                    content_length = length.value();
-            }
+        if (m_current_chunk_remaining_size.has_value()) {
+            auto size = m_current_chunk_remaining_size.value() - payload.size();
 
-            deferred_invoke([this, content_length](auto&) { did_progress(content_length, m_received_size); });
+            dbgln_if(JOB_DEBUG, "Job: We have {} bytes left over in this chunk", size);
+            if (size == 0) {
+                dbgln_if(JOB_DEBUG, "Job: Finished a chunk of {} bytes", m_current_chunk_total_size.value());
 
-            if (content_length.has_value()) {
-                auto length = content_length.value();
-                if (m_received_size >= length) {
-                    m_received_size = length;
-                    finish_up();
+                if (m_current_chunk_total_size.value() == 0) {
+                    m_state = State::Trailers;
                     return IterationDecision::Break;
                 }
+
+                // we've read everything, now let's get the next chunk
+                size = -1;
+                if (can_read_line()) {
+                    auto line = read_line(PAGE_SIZE);
+                    VERIFY(line.is_empty());
+                } else {
+                    m_should_read_chunk_ending_line = true;
+                }
             }
-            return IterationDecision::Continue;
-        });
+            m_current_chunk_remaining_size = size;
+        }
+
+        deferred_invoke([this, content_length](auto&) { did_progress(content_length, m_received_size); });
 
-        if (!is_established()) {
-            dbgln_if(JOB_DEBUG, "Connection appears to have closed, finishing up");
-            finish_up();
+        if (content_length.has_value()) {
+            auto length = content_length.value();
+            if (m_received_size >= length) {
+                m_received_size = length;
+                m_received_complete_response = true;
+                finish_up();
+                return IterationDecision::Break;
+            }
         }
+        return IterationDecision::Continue;
     });
+
+    if (!is_established()) {
+        dbgln_if(JOB_DEBUG, "Connection appears to have closed, finishing up");
+        finish_up();
+    }
 }
 
 void Job::timer_event(Core::TimerEvent& event)
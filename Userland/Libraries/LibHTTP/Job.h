@@ -26,10 +26,24 @@ public:
 
     HttpResponse* response() { return static_cast<HttpResponse*>(Core::NetworkJob::response()); }
     const HttpResponse* response() const { return static_cast<const HttpResponse*>(Core::NetworkJob::response()); }
+    const URL& url() const { return m_request.url(); }
+
+    // Whether the response was read in full and both sides agreed to keep the connection open,
+    // so that another request can be sent over it once this job has been shut down.
+    bool can_reuse_connection() const;
+
+    // Whether the job failed before any of the response arrived, and is safe to send again.
+    // On a reused connection, that usually means the server closed it just as we sent the request.
+    bool can_retry_on_new_connection() const;
+    // Forgets everything about the failed attempt, so the job can be started again.
+    void reset_for_retry();
 
 protected:
     void finish_up();
     void on_socket_connected();
+    void on_socket_ready_to_read();
+    bool can_process_buffered_data() const;
+    bool response_has_no_body() const;
     void flush_received_buffers();
     virtual void register_on_ready_to_read(Function<void()>) = 0;
     virtual void register_on_ready_to_write(Function<void()>) = 0;
@@ -65,6 +79,9 @@ protected:
     bool m_can_stream_response { true };
     bool m_should_read_chunk_ending_line { false };
     bool m_has_scheduled_finish { false };
+    bool m_is_http_1_1 { false };
+    bool m_server_keeps_connection_alive { false };
+    bool m_received_complete_response { false };
 };
 
 }
@@ -40,12 +40,12 @@ void ScopeNode::generate_bytecode(Bytecode::Generator& generator) const
                 declarator.target().visit(
                     [&](const NonnullRefPtr<Identifier>& id) {
                         generator.emit<Bytecode::Op::LoadImmediate>(js_undefined());
-                        generator.emit<Bytecode::Op::PutById>(Bytecode::Register::global_object(), generator.intern_string(id->string()));
+                        generator.emit<Bytecode::Op::PutById>(Bytecode::Register::global_object(), generator.intern_string(id->string()), generator.next_property_lookup_cache());
                     },
                     [&](const NonnullRefPtr<BindingPattern>& binding) {
                         binding->for_each_bound_name([&](const auto& name) {
                             generator.emit<Bytecode::Op::LoadImmediate>(js_undefined());
-                            generator.emit<Bytecode::Op::PutById>(Bytecode::Register::global_object(), generator.intern_string(name));
+                            generator.emit<Bytecode::Op::PutById>(Bytecode::Register::global_object(), generator.intern_string(name), generator.next_property_lookup_cache());
                         });
                     });
             } else {
@@ -392,7 +392,7 @@ void AssignmentExpression::generate_bytecode(Bytecode::Generator& generator) con
         } else {
             m_rhs->generate_bytecode(generator);
             auto identifier_table_ref = generator.intern_string(verify_cast<Identifier>(expression.property()).string());
-            generator.emit<Bytecode::Op::PutById>(object_reg, identifier_table_ref);
+            generator.emit<Bytecode::Op::PutById>(object_reg, identifier_table_ref, generator.next_property_lookup_cache());
         }
         return;
     }
@@ -581,7 +581,7 @@ void ObjectExpression::generate_bytecode(Bytecode::Generator& generator) const
             Bytecode::StringTableIndex key_name = generator.intern_string(string_literal.value());
 
             property.value().generate_bytecode(generator);
-            generator.emit<Bytecode::Op::PutById>(object_reg, key_name);
+            generator.emit<Bytecode::Op::PutById>(object_reg, key_name, generator.next_property_lookup_cache());
         } else {
             property.key().generate_bytecode(generator);
             auto property_reg = generator.allocate_register();
@@ -628,7 +628,7 @@ void MemberExpression::generate_bytecode(Bytecode::Generator& generator) const
         generator.emit<Bytecode::Op::GetByValue>(object_reg);
     } else {
         auto identifier_table_ref = generator.intern_string(verify_cast<Identifier>(property()).string());
-        generator.emit<Bytecode::Op::GetById>(identifier_table_ref);
+        generator.emit<Bytecode::Op::GetById>(identifier_table_ref, generator.next_property_lookup_cache());
     }
 }
 
@@ -679,7 +679,7 @@ static void generate_object_binding_pattern_bytecode(Bytecode::Generator& genera
             }
 
             generator.emit<Bytecode::Op::Load>(value_reg);
-            generator.emit<Bytecode::Op::GetById>(name_index);
+            generator.emit<Bytecode::Op::GetById>(name_index, generator.next_property_lookup_cache());
         } else {
             auto expression = name.get<NonnullRefPtr<Expression>>();
             expression->generate_bytecode(generator);
@@ -930,7 +930,7 @@ void CallExpression::generate_bytecode(Bytecode::Generator& generator) const
             if (!is<Identifier>(member_expression.property()))
                 TODO();
             auto identifier_table_ref = generator.intern_string(static_cast<Identifier const&>(member_expression.property()).string());
-            generator.emit<Bytecode::Op::GetById>(identifier_table_ref);
+            generator.emit<Bytecode::Op::GetById>(identifier_table_ref, generator.next_property_lookup_cache());
             generator.emit<Bytecode::Op::Store>(callee_reg);
         }
     } else {
@@ -1138,7 +1138,7 @@ void TaggedTemplateLiteral::generate_bytecode(Bytecode::Generator& generator) co
     generator.emit<Bytecode::Op::Store>(raw_strings_reg);
 
     generator.emit<Bytecode::Op::Load>(strings_reg);
-    generator.emit<Bytecode::Op::PutById>(raw_strings_reg, generator.intern_string("raw"));
+    generator.emit<Bytecode::Op::PutById>(raw_strings_reg, generator.intern_string("raw"), generator.next_property_lookup_cache());
 
     generator.emit<Bytecode::Op::LoadImmediate>(js_undefined());
     auto this_reg = generator.allocate_register();
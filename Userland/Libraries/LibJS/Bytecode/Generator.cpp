@@ -45,7 +45,9 @@ Executable Generator::generate(ASTNode const& node, bool is_in_generator_functio
             generator.emit<Bytecode::Op::Yield>(nullptr);
         }
     }
-    return { move(generator.m_root_basic_blocks), move(generator.m_string_table), generator.m_next_register };
+    Vector<PropertyLookupCache> property_lookup_caches;
+    property_lookup_caches.resize(generator.m_next_property_lookup_cache);
+    return { move(generator.m_root_basic_blocks), move(generator.m_string_table), generator.m_next_register, move(property_lookup_caches) };
 }
 
 void Generator::grow(size_t additional_size)
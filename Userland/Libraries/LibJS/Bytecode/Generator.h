@@ -12,6 +12,7 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PropertyLookupCache.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Bytecode/StringTable.h>
 #include <LibJS/Forward.h>
@@ -22,8 +23,10 @@ struct Executable {
     NonnullOwnPtrVector<BasicBlock> basic_blocks;
     NonnullOwnPtr<StringTable> string_table;
     size_t number_of_registers { 0 };
+    mutable Vector<PropertyLookupCache> property_lookup_caches;
 
     String const& get_string(StringTableIndex index) const { return string_table->get(index); }
+    PropertyLookupCache& get_property_lookup_cache(PropertyLookupCacheIndex index) const { return property_lookup_caches[index.value()]; }
 };
 
 class Generator {
@@ -109,6 +112,8 @@ public:
         return m_string_table->insert(string);
     }
 
+    PropertyLookupCacheIndex next_property_lookup_cache() { return m_next_property_lookup_cache++; }
+
     bool is_in_generator_function() const { return m_is_in_generator_function; }
     void enter_generator_context() { m_is_in_generator_function = true; }
     void leave_generator_context() { m_is_in_generator_function = false; }
@@ -126,6 +131,7 @@ private:
 
     u32 m_next_register { 2 };
     u32 m_next_block { 1 };
+    size_t m_next_property_lookup_cache { 0 };
     bool m_is_in_generator_function { false };
     Vector<Label> m_continuable_scopes;
     Vector<Label> m_breakable_scopes;
@@ -9,6 +9,7 @@
 #include "Generator.h"
 #include "PassManager.h"
 #include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/PropertyLookupCache.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Cell.h>
@@ -61,6 +62,8 @@ public:
 
     Executable const& current_executable() { return *m_current_executable; }
 
+    PropertyLookupCacheStatistics& property_lookup_cache_statistics() { return m_property_lookup_cache_statistics; }
+
     enum class OptimizationLevel {
         Default,
         __Count,
@@ -81,6 +84,7 @@ private:
     Executable const* m_current_executable { nullptr };
     Vector<UnwindInfo> m_unwind_contexts;
     Handle<Exception> m_saved_exception;
+    PropertyLookupCacheStatistics m_property_lookup_cache_statistics;
 };
 
 }
@@ -227,14 +227,49 @@ void SetVariable::execute_impl(Bytecode::Interpreter& interpreter) const
 
 void GetById::execute_impl(Bytecode::Interpreter& interpreter) const
 {
-    if (auto* object = interpreter.accumulator().to_object(interpreter.global_object()))
-        interpreter.accumulator() = object->get(interpreter.current_executable().get_string(m_property));
+    auto base = interpreter.accumulator();
+    // NOTE: Primitives get a fresh wrapper object every time, so there is nothing to cache for them.
+    if (!base.is_object()) {
+        if (auto* object = base.to_object(interpreter.global_object()))
+            interpreter.accumulator() = object->get(interpreter.current_executable().get_string(m_property));
+        return;
+    }
+
+    auto& object = base.as_object();
+    auto& cache = interpreter.current_executable().get_property_lookup_cache(m_cache_index);
+    auto& statistics = interpreter.property_lookup_cache_statistics();
+    if (auto value = cache.get(object, statistics); value.has_value()) {
+        interpreter.accumulator() = *value;
+        return;
+    }
+
+    PropertyName property_name = interpreter.current_executable().get_string(m_property);
+    interpreter.accumulator() = object.get(property_name);
+    if (!interpreter.vm().exception())
+        cache.update_after_get(object, property_name, statistics);
 }
 
 void PutById::execute_impl(Bytecode::Interpreter& interpreter) const
 {
-    if (auto* object = interpreter.reg(m_base).to_object(interpreter.global_object()))
-        object->set(interpreter.current_executable().get_string(m_property), interpreter.accumulator(), true);
+    auto base = interpreter.reg(m_base);
+    if (!base.is_object()) {
+        if (auto* object = base.to_object(interpreter.global_object()))
+            object->set(interpreter.current_executable().get_string(m_property), interpreter.accumulator(), true);
+        return;
+    }
+
+    auto& object = base.as_object();
+    auto value = interpreter.accumulator();
+    auto& cache = interpreter.current_executable().get_property_lookup_cache(m_cache_index);
+    auto& statistics = interpreter.property_lookup_cache_statistics();
+    if (cache.put(object, value, statistics))
+        return;
+
+    auto& old_shape = object.shape();
+    PropertyName property_name = interpreter.current_executable().get_string(m_property);
+    object.set(property_name, value, true);
+    if (!interpreter.vm().exception())
+        cache.update_after_put(object, old_shape, property_name, statistics);
 }
 
 void Jump::execute_impl(Bytecode::Interpreter& interpreter) const
@@ -549,12 +584,12 @@ String SetVariable::to_string_impl(Bytecode::Executable const& executable) const
 
 String PutById::to_string_impl(Bytecode::Executable const& executable) const
 {
-    return String::formatted("PutById base:{}, property:{} ({})", m_base, m_property, executable.string_table->get(m_property));
+    return String::formatted("PutById base:{}, property:{} ({}), cache:{}", m_base, m_property, executable.string_table->get(m_property), m_cache_index);
 }
 
 String GetById::to_string_impl(Bytecode::Executable const& executable) const
 {
-    return String::formatted("GetById {} ({})", m_property, executable.string_table->get(m_property));
+    return String::formatted("GetById {} ({}), cache:{}", m_property, executable.string_table->get(m_property), m_cache_index);
 }
 
 String Jump::to_string_impl(Bytecode::Executable const&) const
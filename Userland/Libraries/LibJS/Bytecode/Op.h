@@ -11,6 +11,7 @@
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/Bytecode/Instruction.h>
 #include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/PropertyLookupCache.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Bytecode/StringTable.h>
 #include <LibJS/Heap/Cell.h>
@@ -313,9 +314,10 @@ private:
 
 class GetById final : public Instruction {
 public:
-    explicit GetById(StringTableIndex property)
+    GetById(StringTableIndex property, PropertyLookupCacheIndex cache_index)
         : Instruction(Type::GetById)
         , m_property(property)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -325,14 +327,16 @@ public:
 
 private:
     StringTableIndex m_property;
+    PropertyLookupCacheIndex m_cache_index;
 };
 
 class PutById final : public Instruction {
 public:
-    explicit PutById(Register base, StringTableIndex property)
+    PutById(Register base, StringTableIndex property, PropertyLookupCacheIndex cache_index)
         : Instruction(Type::PutById)
         , m_base(base)
         , m_property(property)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -343,6 +347,7 @@ public:
 private:
     Register m_base;
     StringTableIndex m_property;
+    PropertyLookupCacheIndex m_cache_index;
 };
 
 class GetByValue final : public Instruction {
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Format.h>
+#include <LibJS/Bytecode/PropertyLookupCache.h>
+#include <LibJS/Runtime/Object.h>
+
+namespace JS::Bytecode {
+
+static size_t percentage(size_t part, size_t total)
+{
+    return total ? part * 100 / total : 0;
+}
+
+void PropertyLookupCacheStatistics::dump() const
+{
+    auto gets = get_own_property_hits + get_prototype_chain_hits + get_misses;
+    auto puts = put_own_property_hits + put_transition_hits + put_misses;
+    outln("Property lookup caches:");
+    outln("  GetById: {} lookups, {} own property hits, {} prototype chain hits, {} misses ({}% hit rate)",
+        gets, get_own_property_hits, get_prototype_chain_hits, get_misses,
+        percentage(get_own_property_hits + get_prototype_chain_hits, gets));
+    outln("  PutById: {} lookups, {} own property hits, {} transition hits, {} misses ({}% hit rate)",
+        puts, put_own_property_hits, put_transition_hits, put_misses,
+        percentage(put_own_property_hits + put_transition_hits, puts));
+    outln("  {} uncacheable lookups, {} evictions", uncacheable_lookups, evictions);
+}
+
+bool PropertyLookupCache::is_cacheable(Object const& object)
+{
+    return !object.shape().is_unique() && !object.has_exotic_property_lookup();
+}
+
+// Walks the prototype chain as recorded in the entry, returning the last prototype visited,
+// or nullptr if any of the prototypes' shapes has changed since the entry was added.
+Object const* PropertyLookupCache::walk_prototype_chain(Object const& object, Entry const& entry)
+{
+    auto const* current = &object;
+    for (size_t i = 0; i < entry.prototype_chain_depth; ++i) {
+        current = current->shape().prototype();
+        if (!current || &current->shape() != entry.prototype_shapes[i].ptr())
+            return nullptr;
+    }
+    return current;
+}
+
+Optional<Value> PropertyLookupCache::get(Object const& object, PropertyLookupCacheStatistics& statistics) const
+{
+    auto const& shape = object.shape();
+    for (size_t i = 0; i < m_entry_count; ++i) {
+        auto const& entry = m_entries[i];
+        if (entry.shape.ptr() != &shape)
+            continue;
+        // Exotic objects never get cached, but they might share a shape with one that did.
+        if (object.has_exotic_property_lookup())
+            break;
+        auto const* holder = walk_prototype_chain(object, entry);
+        if (!holder)
+            break;
+        auto value = holder->get_direct(entry.offset);
+        if (value.is_accessor() || value.is_native_property())
+            break;
+        if (entry.prototype_chain_depth == 0)
+            ++statistics.get_own_property_hits;
+        else
+            ++statistics.get_prototype_chain_hits;
+        return value;
+    }
+    ++statistics.get_misses;
+    return {};
+}
+
+void PropertyLookupCache::update_after_get(Object const& object, PropertyName const& property_name, PropertyLookupCacheStatistics& statistics)
+{
+    if (!property_name.is_string() || property_name.is_number() || !is_cacheable(object)) {
+        ++statistics.uncacheable_lookups;
+        return;
+    }
+
+    auto key = property_name.to_string_or_symbol();
+    Entry entry;
+    entry.shape = object.shape();
+    auto const* holder = &object;
+    for (;;) {
+        if (auto metadata = holder->shape().lookup(key); metadata.has_value()) {
+            auto value = holder->get_direct(metadata->offset);
+            if (value.is_accessor() || value.is_native_property())
+                break;
+            entry.offset = metadata->offset;
+            add(move(entry), statistics);
+            return;
+        }
+        if (entry.prototype_chain_depth == max_prototype_chain_depth)
+            break;
+        holder = holder->shape().prototype();
+        if (!holder || !is_cacheable(*holder))
+            break;
+        entry.prototype_shapes[entry.prototype_chain_depth++] = holder->shape();
+    }
+    ++statistics.uncacheable_lookups;
+}
+
+bool PropertyLookupCache::put(Object& object, Value value, PropertyLookupCacheStatistics& statistics) const
+{
+    auto const& shape = object.shape();
+    for (size_t i = 0; i < m_entry_count; ++i) {
+        auto const& entry = m_entries[i];
+        if (entry.shape.ptr() != &shape)
+            continue;
+        if (object.has_exotic_property_lookup())
+            break;
+
+        if (!entry.is_transition) {
+            auto existing_value = object.get_direct(entry.offset);
+            if (existing_value.is_accessor() || existing_value.is_native_property())
+                break;
+            object.put_direct(entry.offset, value);
+            ++statistics.put_own_property_hits;
+            return true;
+        }
+
+        if (!entry.new_shape)
+            break;
+
+        // Adding the property is only equivalent to [[Set]] if nothing on the prototype chain has appeared
+        // that would intercept it (a setter or a read-only property), and the object may still grow.
+        auto const* last_prototype = walk_prototype_chain(object, entry);
+        if (!last_prototype || last_prototype->shape().prototype())
+            break;
+        if (!object.is_extensible())
+            break;
+        object.put_direct_with_transition(*entry.new_shape.ptr(), entry.offset, value);
+        ++statistics.put_transition_hits;
+        return true;
+    }
+    ++statistics.put_misses;
+    return false;
+}
+
+void PropertyLookupCache::update_after_put(Object& object, Shape& old_shape, PropertyName const& property_name, PropertyLookupCacheStatistics& statistics)
+{
+    if (!property_name.is_string() || property_name.is_number() || !is_cacheable(object) || old_shape.is_unique()) {
+        ++statistics.uncacheable_lookups;
+        return;
+    }
+
+    auto key = property_name.to_string_or_symbol();
+    auto& new_shape = object.shape();
+    auto metadata = new_shape.lookup(key);
+    if (!metadata.has_value()) {
+        ++statistics.uncacheable_lookups;
+        return;
+    }
+
+    Entry entry;
+    entry.shape = old_shape;
+    entry.offset = metadata->offset;
+
+    if (&new_shape == &old_shape) {
+        // The property already existed and got overwritten in place.
+        auto value = object.get_direct(metadata->offset);
+        if (!metadata->attributes.is_writable() || value.is_accessor() || value.is_native_property()) {
+            ++statistics.uncacheable_lookups;
+            return;
+        }
+        add(move(entry), statistics);
+        return;
+    }
+
+    // The property was added by a put transition, which only happens if it wasn't found anywhere on the prototype chain.
+    if (old_shape.lookup(key).has_value() || new_shape.property_count() != old_shape.property_count() + 1 || new_shape.prototype() != old_shape.prototype()) {
+        ++statistics.uncacheable_lookups;
+        return;
+    }
+    auto const* prototype = old_shape.prototype();
+    while (prototype) {
+        if (entry.prototype_chain_depth == max_prototype_chain_depth || !is_cacheable(*prototype) || prototype->shape().lookup(key).has_value()) {
+            ++statistics.uncacheable_lookups;
+            return;
+        }
+        entry.prototype_shapes[entry.prototype_chain_depth++] = prototype->shape();
+        prototype = prototype->shape().prototype();
+    }
+    entry.is_transition = true;
+    entry.new_shape = new_shape;
+    add(move(entry), statistics);
+}
+
+void PropertyLookupCache::add(Entry entry, PropertyLookupCacheStatistics& statistics)
+{
+    // A stale entry for the same shape (e.g. after a prototype changed) gets replaced rather than duplicated,
+    // and entries for shapes that have been garbage collected are free for reuse.
+    for (size_t i = 0; i < m_entry_count; ++i) {
+        if (m_entries[i].shape.ptr() == entry.shape.ptr() || !m_entries[i].shape) {
+            m_entries[i] = move(entry);
+            return;
+        }
+    }
+
+    if (m_entry_count < max_entries) {
+        m_entries[m_entry_count++] = move(entry);
+        return;
+    }
+
+    // The cache is megamorphic, evict entries round-robin.
+    m_entries[m_next_entry_to_replace] = move(entry);
+    m_next_entry_to_replace = (m_next_entry_to_replace + 1) % max_entries;
+    ++statistics.evictions;
+}
+
+}
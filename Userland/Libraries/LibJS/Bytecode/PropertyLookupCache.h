@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/DistinctNumeric.h>
+#include <AK/Optional.h>
+#include <AK/WeakPtr.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Runtime/PropertyName.h>
+#include <LibJS/Runtime/Shape.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::Bytecode {
+
+TYPEDEF_DISTINCT_NUMERIC_GENERAL(size_t, false, true, false, false, false, false, PropertyLookupCacheIndex);
+
+struct PropertyLookupCacheStatistics {
+    size_t get_own_property_hits { 0 };
+    size_t get_prototype_chain_hits { 0 };
+    size_t get_misses { 0 };
+    size_t put_own_property_hits { 0 };
+    size_t put_transition_hits { 0 };
+    size_t put_misses { 0 };
+    size_t uncacheable_lookups { 0 };
+    size_t evictions { 0 };
+
+    void dump() const;
+};
+
+// A per-instruction inline cache for GetById and PutById, keyed on the shape of the base object.
+// Only non-unique shapes are cached: they never change in place once their object has been initialized,
+// so a shape (and the shapes of the prototypes it was found through) still matching means the cached
+// offset is still valid. Entries hold weak pointers, so shapes that get garbage collected simply miss.
+class PropertyLookupCache {
+public:
+    static constexpr size_t max_entries = 4;
+    static constexpr size_t max_prototype_chain_depth = 4;
+
+    Optional<Value> get(Object const&, PropertyLookupCacheStatistics&) const;
+    void update_after_get(Object const&, PropertyName const&, PropertyLookupCacheStatistics&);
+
+    bool put(Object&, Value, PropertyLookupCacheStatistics&) const;
+    void update_after_put(Object&, Shape& old_shape, PropertyName const&, PropertyLookupCacheStatistics&);
+
+private:
+    struct Entry {
+        WeakPtr<Shape> shape;
+
+        // For gets, the shapes of the prototypes walked up to and including the one holding the property.
+        // For puts that added a property, the shapes of the whole prototype chain, none of which has it.
+        AK::Array<WeakPtr<Shape>, max_prototype_chain_depth> prototype_shapes;
+        size_t prototype_chain_depth { 0 };
+
+        // For puts that added a property, the shape the object transitioned to.
+        // It may get garbage collected before the shape we came from, which makes the entry useless.
+        bool is_transition { false };
+        WeakPtr<Shape> new_shape;
+
+        size_t offset { 0 };
+    };
+
+    static bool is_cacheable(Object const&);
+    static Object const* walk_prototype_chain(Object const&, Entry const&);
+    void add(Entry, PropertyLookupCacheStatistics&);
+
+    AK::Array<Entry, max_entries> m_entries;
+    size_t m_entry_count { 0 };
+    size_t m_next_entry_to_replace { 0 };
+};
+
+}
@@ -15,7 +15,17 @@
 
 namespace JS {
 
+// Declares that every store of a cell pointer into the edges this class visits on top of its base class's
+// goes through Cell::write_barrier(), so that its cells can leave the remembered set again.
+// This only holds for subclasses that don't override visit_edges(), the others have to say so themselves.
+#define JS_DECLARE_WRITE_BARRIERED_EDGES(class_) \
+public:                                          \
+    using WriteBarrieredEdges = class_;          \
+    friend class JS::Heap;
+
 class Cell {
+    JS_DECLARE_WRITE_BARRIERED_EDGES(Cell);
+
     AK_MAKE_NONCOPYABLE(Cell);
     AK_MAKE_NONMOVABLE(Cell);
 
@@ -34,6 +44,28 @@ public:
     State state() const { return m_state; }
     void set_state(State state) { m_state = state; }
 
+    // Cells start out in the young generation, and get promoted to the old generation
+    // when they survive a garbage collection.
+    bool is_old() const { return m_old; }
+    void set_old(bool b) { m_old = b; }
+
+    // Old cells in the remembered set have their edges visited by every young generation collection.
+    bool is_remembered() const { return m_remembered; }
+    void set_remembered(bool b) { m_remembered = b; }
+
+    // Cells whose every edge store goes through write_barrier() can leave the remembered set again,
+    // all others stay in it for as long as they are old. See JS_DECLARE_WRITE_BARRIERED_EDGES.
+    bool has_unbarriered_edges() const { return m_has_unbarriered_edges; }
+    void set_has_unbarriered_edges(bool b) { m_has_unbarriered_edges = b; }
+
+    // Must be called right before storing a pointer to another cell into this one,
+    // without anything that could allocate (and thus collect garbage) in between.
+    ALWAYS_INLINE void write_barrier()
+    {
+        if (m_old && !m_remembered)
+            remember();
+    }
+
     virtual const char* class_name() const = 0;
 
     class Visitor {
@@ -60,8 +92,13 @@ protected:
     Cell() { }
 
 private:
+    void remember();
+
     bool m_mark : 1 { false };
-    State m_state : 7 { State::Live };
+    bool m_old : 1 { false };
+    bool m_remembered : 1 { false };
+    bool m_has_unbarriered_edges : 1 { true };
+    State m_state : 4 { State::Live };
 };
 
 }
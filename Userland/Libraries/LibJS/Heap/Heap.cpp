@@ -55,10 +55,10 @@ ALWAYS_INLINE CellAllocator& Heap::allocator_for_size(size_t cell_size)
 Cell* Heap::allocate_cell(size_t size)
 {
     if (should_collect_on_every_allocation()) {
-        collect_garbage();
+        collect_garbage(CollectionType::CollectYoungGeneration);
     } else if (m_allocations_since_last_gc > m_max_allocations_between_gc) {
         m_allocations_since_last_gc = 0;
-        collect_garbage();
+        collect_garbage(CollectionType::CollectYoungGeneration);
     } else {
         ++m_allocations_since_last_gc;
     }
@@ -74,13 +74,25 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
 
     Core::ElapsedTimer collection_measurement_timer;
     collection_measurement_timer.start();
-    if (collection_type == CollectionType::CollectGarbage) {
+
+    // Cells that survive a young generation collection don't get looked at again until the next full collection,
+    // so do one of those once the old generation has grown by as much as was live after the last one.
+    if (collection_type == CollectionType::CollectYoungGeneration
+        && m_cells_promoted_since_last_full_collection >= max(m_live_cells_after_last_full_collection, m_max_allocations_between_gc * 4)) {
+        collection_type = CollectionType::CollectGarbage;
+    }
+
+    if (collection_type != CollectionType::CollectEverything) {
         if (m_gc_deferrals) {
             m_should_gc_when_deferral_ends = true;
             return;
         }
         HashTable<Cell*> roots;
         gather_roots(roots);
+        if (collection_type == CollectionType::CollectYoungGeneration) {
+            collect_young_generation(roots, print_report, collection_measurement_timer);
+            return;
+        }
         mark_live_cells(roots);
     }
     sweep_dead_cells(print_report, collection_measurement_timer);
@@ -170,6 +182,28 @@ public:
     }
 };
 
+class YoungGenerationMarkingVisitor final : public Cell::Visitor {
+public:
+    explicit YoungGenerationMarkingVisitor(Vector<Cell*>& marked_cells)
+        : m_marked_cells(marked_cells)
+    {
+    }
+
+    virtual void visit_impl(Cell& cell)
+    {
+        // Old cells are assumed to be live, and any young cells they point to are reached through the remembered set.
+        if (cell.is_old() || cell.is_marked())
+            return;
+        dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
+        cell.set_marked(true);
+        m_marked_cells.append(&cell);
+        cell.visit_edges(*this);
+    }
+
+private:
+    Vector<Cell*>& m_marked_cells;
+};
+
 void Heap::mark_live_cells(const HashTable<Cell*>& roots)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
@@ -178,6 +212,77 @@ void Heap::mark_live_cells(const HashTable<Cell*>& roots)
         visitor.visit(root);
 }
 
+void Heap::collect_young_generation(const HashTable<Cell*>& roots, bool print_report, const Core::ElapsedTimer& measurement_timer)
+{
+    dbgln_if(HEAP_DEBUG, "collect_young_generation:");
+
+    // NOTE: This can include cells that are still being constructed, which is why they aren't looked up in m_young_cells.
+    Vector<Cell*> marked_cells;
+    YoungGenerationMarkingVisitor visitor(marked_cells);
+    for (auto* root : roots)
+        visitor.visit(root);
+    for (size_t i = 0; i < m_remembered_cells.size(); ++i)
+        m_remembered_cells[i]->visit_edges(visitor);
+
+    Vector<Cell*> swept_cells;
+    Vector<HeapBlock*, 32> full_blocks_that_became_usable;
+    size_t collected_cells = 0;
+    size_t collected_cell_bytes = 0;
+    for (auto* cell : m_young_cells) {
+        if (cell->is_old() || cell->is_marked())
+            continue;
+        dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+        auto* block = HeapBlock::from_cell(cell);
+        if (block->is_full())
+            full_blocks_that_became_usable.append(block);
+        if (!m_weak_containers.is_empty())
+            swept_cells.append(cell);
+        block->deallocate(cell);
+        ++collected_cells;
+        collected_cell_bytes += block->cell_size();
+    }
+    m_young_cells.clear_with_capacity();
+
+    // Blocks that became empty are left alone until the next full collection, which will give them back.
+    for (auto* block : full_blocks_that_became_usable) {
+        dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
+        allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
+    }
+
+    // Everything that survived gets promoted. Since all of it was reached, none of it can point to a young cell anymore,
+    // so only the cells that can't be tracked through write barriers need to (keep) being remembered.
+    size_t remembered_cells_to_keep = 0;
+    for (auto* cell : m_remembered_cells) {
+        if (cell->has_unbarriered_edges())
+            m_remembered_cells[remembered_cells_to_keep++] = cell;
+        else
+            cell->set_remembered(false);
+    }
+    m_remembered_cells.shrink(remembered_cells_to_keep);
+    for (auto* cell : marked_cells) {
+        cell->set_marked(false);
+        cell->set_old(true);
+        if (cell->has_unbarriered_edges()) {
+            cell->set_remembered(true);
+            m_remembered_cells.append(cell);
+        }
+    }
+    m_cells_promoted_since_last_full_collection += marked_cells.size();
+
+    for (auto* weak_container : m_weak_containers)
+        weak_container->remove_swept_cells({}, swept_cells);
+
+    if (print_report) {
+        dbgln("Young generation collection report");
+        dbgln("=============================================");
+        dbgln("     Time spent: {} ms", measurement_timer.elapsed());
+        dbgln(" Promoted cells: {}", marked_cells.size());
+        dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
+        dbgln("Remembered cells: {}", m_remembered_cells.size());
+        dbgln("=============================================");
+    }
+}
+
 void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
@@ -190,6 +295,10 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
     size_t collected_cell_bytes = 0;
     size_t live_cell_bytes = 0;
 
+    // Everything that survives a full collection ends up in the old generation, and the remembered set gets rebuilt from scratch.
+    m_young_cells.clear_with_capacity();
+    m_remembered_cells.clear_with_capacity();
+
     auto should_store_swept_cells = !m_weak_containers.is_empty();
     for_each_block([&](auto& block) {
         bool block_has_live_cells = false;
@@ -204,6 +313,10 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
                 collected_cell_bytes += block.cell_size();
             } else {
                 cell->set_marked(false);
+                cell->set_old(true);
+                cell->set_remembered(cell->has_unbarriered_edges());
+                if (cell->is_remembered())
+                    m_remembered_cells.append(cell);
                 block_has_live_cells = true;
                 ++live_cells;
                 live_cell_bytes += block.cell_size();
@@ -226,6 +339,9 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
         allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
     }
 
+    m_cells_promoted_since_last_full_collection = 0;
+    m_live_cells_after_last_full_collection = live_cells;
+
     for (auto* weak_container : m_weak_containers)
         weak_container->remove_swept_cells({}, swept_cells);
 
@@ -256,6 +372,18 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
     }
 }
 
+void Heap::remember_cell(Badge<Cell>, Cell& cell)
+{
+    VERIFY(cell.is_old());
+    cell.set_remembered(true);
+    m_remembered_cells.append(&cell);
+}
+
+void Cell::remember()
+{
+    heap().remember_cell({}, *this);
+}
+
 void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
 {
     VERIFY(!m_handles.contains(&impl));
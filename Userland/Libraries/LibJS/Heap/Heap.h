@@ -34,7 +34,9 @@ public:
     {
         auto* memory = allocate_cell(sizeof(T));
         new (memory) T(forward<Args>(args)...);
-        return static_cast<T*>(memory);
+        auto* cell = static_cast<T*>(memory);
+        did_initialize_cell(*cell);
+        return cell;
     }
 
     template<typename T, typename... Args>
@@ -49,11 +51,13 @@ public:
         cell->initialize(global_object);
         if constexpr (is_object)
             static_cast<Object*>(cell)->enable_transitions();
+        did_initialize_cell(*cell);
         return cell;
     }
 
     enum class CollectionType {
         CollectGarbage,
+        CollectYoungGeneration,
         CollectEverything,
     };
 
@@ -78,13 +82,47 @@ public:
 
     BlockAllocator& block_allocator() { return m_block_allocator; }
 
+    void remember_cell(Badge<Cell>, Cell&);
+
 private:
+    template<typename>
+    struct MemberFunctionClass;
+    template<typename C, typename R, typename... Args>
+    struct MemberFunctionClass<R (C::*)(Args...)> {
+        using Type = C;
+    };
+
+    // The edges of a T are the ones visited by the most derived visit_edges() it has, so they are all updated through
+    // Cell::write_barrier() if the class that declares that visit_edges() has said so with JS_DECLARE_WRITE_BARRIERED_EDGES.
+    // (We're a friend of all of those, so a visit_edges() we can't get at means the answer is no.)
+    template<typename T>
+    static constexpr bool has_write_barriers_on_all_edges()
+    {
+        if constexpr (requires { &T::visit_edges; }) {
+            using DeclaringClass = typename MemberFunctionClass<decltype(&T::visit_edges)>::Type;
+            return IsSame<typename DeclaringClass::WriteBarrieredEdges, DeclaringClass>;
+        }
+        return false;
+    }
+
+    template<typename T>
+    void did_initialize_cell(T& cell)
+    {
+        // NOTE: Cells are treated as having unbarriered edges while being constructed, in case they get promoted
+        //       by a collection that happens in the middle of that.
+        if constexpr (has_write_barriers_on_all_edges<T>())
+            cell.set_has_unbarriered_edges(false);
+        if (!cell.is_old())
+            m_young_cells.append(&cell);
+    }
+
     Cell* allocate_cell(size_t);
 
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
     void mark_live_cells(const HashTable<Cell*>& live_cells);
     void sweep_dead_cells(bool print_report, const Core::ElapsedTimer&);
+    void collect_young_generation(const HashTable<Cell*>& roots, bool print_report, const Core::ElapsedTimer&);
 
     CellAllocator& allocator_for_size(size_t);
 
@@ -100,6 +138,16 @@ private:
     size_t m_max_allocations_between_gc { 10000 };
     size_t m_allocations_since_last_gc { 0 };
 
+    // Cells allocated since the last collection, which are the only ones a young generation collection sweeps.
+    Vector<Cell*> m_young_cells;
+
+    // Old cells that may point to young ones, see Cell::write_barrier().
+    Vector<Cell*> m_remembered_cells;
+
+    // Once enough cells have been promoted since the last full collection, the next collection is a full one.
+    size_t m_cells_promoted_since_last_full_collection { 0 };
+    size_t m_live_cells_after_last_full_collection { 0 };
+
     bool m_should_collect_on_every_allocation { false };
 
     VM& m_vm;
@@ -13,6 +13,8 @@
 namespace JS {
 
 class Accessor final : public Cell {
+    JS_DECLARE_WRITE_BARRIERED_EDGES(Accessor);
+
 public:
     static Accessor* create(VM& vm, FunctionObject* getter, FunctionObject* setter)
     {
@@ -26,10 +28,18 @@ public:
     }
 
     FunctionObject* getter() const { return m_getter; }
-    void set_getter(FunctionObject* getter) { m_getter = getter; }
+    void set_getter(FunctionObject* getter)
+    {
+        write_barrier();
+        m_getter = getter;
+    }
 
     FunctionObject* setter() const { return m_setter; }
-    void set_setter(FunctionObject* setter) { m_setter = setter; }
+    void set_setter(FunctionObject* setter)
+    {
+        write_barrier();
+        m_setter = setter;
+    }
 
     Value call_getter(Value this_value)
     {
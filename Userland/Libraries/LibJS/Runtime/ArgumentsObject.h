@@ -33,6 +33,7 @@ public:
 
 private:
     virtual void visit_edges(Cell::Visitor&) override;
+    virtual bool has_exotic_property_lookup() const override { return true; }
 
     Environment& m_environment;
     Object* m_parameter_map { nullptr };
@@ -12,6 +12,7 @@ namespace JS {
 
 class ArrayIterator final : public Object {
     JS_OBJECT(ArrayIterator, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(ArrayIterator);
 
 public:
     static ArrayIterator* create(GlobalObject&, Value array, Object::PropertyKind iteration_kind);
@@ -13,6 +13,7 @@ namespace JS {
 
 class BigIntObject final : public Object {
     JS_OBJECT(BigIntObject, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(BigIntObject);
 
 public:
     static BigIntObject* create(GlobalObject&, BigInt&);
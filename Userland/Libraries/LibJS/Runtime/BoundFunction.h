@@ -12,6 +12,7 @@ namespace JS {
 
 class BoundFunction final : public FunctionObject {
     JS_OBJECT(BoundFunction, FunctionObject);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(BoundFunction);
 
 public:
     BoundFunction(GlobalObject&, FunctionObject& target_function, Value bound_this, Vector<Value> arguments, i32 length, Object* constructor_prototype);
@@ -14,6 +14,7 @@ namespace JS {
 
 class DataView : public Object {
     JS_OBJECT(DataView, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(DataView);
 
 public:
     static DataView* create(GlobalObject&, ArrayBuffer*, size_t byte_length, size_t byte_offset);
@@ -15,6 +15,7 @@ namespace JS {
 
 class DeclarativeEnvironment : public Environment {
     JS_ENVIRONMENT(DeclarativeEnvironment, Environment);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(DeclarativeEnvironment);
 
 public:
     DeclarativeEnvironment();
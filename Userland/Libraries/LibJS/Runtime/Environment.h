@@ -21,6 +21,8 @@ public:                                    \
     virtual char const* class_name() const override { return #class_; }
 
 class Environment : public Cell {
+    JS_DECLARE_WRITE_BARRIERED_EDGES(Environment);
+
 public:
     GlobalObject& global_object() { return *m_global_object; }
     GlobalObject const& global_object() const { return *m_global_object; }
@@ -21,6 +21,8 @@ struct TracebackFrame {
 };
 
 class Exception : public Cell {
+    JS_DECLARE_WRITE_BARRIERED_EDGES(Exception);
+
 public:
     explicit Exception(Value);
     virtual ~Exception() override = default;
@@ -75,6 +75,7 @@ Value FunctionEnvironment::bind_this_value(GlobalObject& global_object, Value th
         vm().throw_exception<ReferenceError>(global_object, ErrorType::ThisIsAlreadyInitialized);
         return {};
     }
+    write_barrier();
     m_this_value = this_value;
     m_this_binding_status = ThisBindingStatus::Initialized;
     return this_value;
@@ -12,6 +12,7 @@ namespace JS {
 
 class FunctionEnvironment final : public DeclarativeEnvironment {
     JS_ENVIRONMENT(FunctionEnvironment, DeclarativeEnvironment);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(FunctionEnvironment);
 
 public:
     enum class ThisBindingStatus : u8 {
@@ -25,10 +26,18 @@ public:
 
     // [[ThisValue]]
     Value this_value() const { return m_this_value; }
-    void set_this_value(Value value) { m_this_value = value; }
+    void set_this_value(Value value)
+    {
+        write_barrier();
+        m_this_value = value;
+    }
 
     // Not a standard operation.
-    void replace_this_binding(Value this_value) { m_this_value = this_value; }
+    void replace_this_binding(Value this_value)
+    {
+        write_barrier();
+        m_this_value = this_value;
+    }
 
     // [[ThisBindingStatus]]
     ThisBindingStatus this_binding_status() const { return m_this_binding_status; }
@@ -37,11 +46,19 @@ public:
     // [[FunctionObject]]
     FunctionObject& function_object() { return *m_function_object; }
     FunctionObject const& function_object() const { return *m_function_object; }
-    void set_function_object(FunctionObject& function) { m_function_object = &function; }
+    void set_function_object(FunctionObject& function)
+    {
+        write_barrier();
+        m_function_object = &function;
+    }
 
     // [[NewTarget]]
     Value new_target() const { return m_new_target; }
-    void set_new_target(Value new_target) { m_new_target = new_target; }
+    void set_new_target(Value new_target)
+    {
+        write_barrier();
+        m_new_target = new_target;
+    }
 
     // Abstract operations
     Value get_super_base() const;
@@ -13,6 +13,7 @@ namespace JS {
 
 class FunctionObject : public Object {
     JS_OBJECT(Function, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(FunctionObject);
 
 public:
     enum class ConstructorKind {
@@ -35,7 +36,11 @@ public:
     const Vector<Value>& bound_arguments() const { return m_bound_arguments; }
 
     Object* home_object() const { return m_home_object; }
-    void set_home_object(Object* home_object) { m_home_object = home_object; }
+    void set_home_object(Object* home_object)
+    {
+        write_barrier();
+        m_home_object = home_object;
+    }
 
     ConstructorKind constructor_kind() const { return m_constructor_kind; };
     void set_constructor_kind(ConstructorKind constructor_kind) { m_constructor_kind = constructor_kind; }
@@ -12,6 +12,7 @@ namespace JS {
 
 class GlobalEnvironment final : public Environment {
     JS_ENVIRONMENT(GlobalEnvironment, Environment);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(GlobalEnvironment);
 
 public:
     explicit GlobalEnvironment(GlobalObject&);
@@ -15,6 +15,7 @@ namespace JS {
 
 class Map : public Object {
     JS_OBJECT(Map, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(Map);
 
 public:
     static Map* create(GlobalObject&);
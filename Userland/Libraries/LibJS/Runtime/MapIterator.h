@@ -14,6 +14,7 @@ namespace JS {
 
 class MapIterator final : public Object {
     JS_OBJECT(MapIterator, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(MapIterator);
 
 public:
     static MapIterator* create(GlobalObject&, Map& map, Object::PropertyKind iteration_kind);
@@ -142,6 +142,7 @@ JS_DEFINE_NATIVE_FUNCTION(MapPrototype::set)
     auto key = vm.argument(0);
     if (key.is_negative_zero())
         key = Value(0);
+    map->write_barrier();
     map->entries().set(key, vm.argument(1));
     return map;
 }
@@ -33,7 +33,7 @@ Object* Object::create(GlobalObject& global_object, Object* prototype)
     else if (prototype == global_object.object_prototype())
         return global_object.heap().allocate<Object>(global_object, *global_object.new_object_shape());
     else
-        return global_object.heap().allocate<Object>(global_object, *prototype);
+        return global_object.heap().allocate<Object>(global_object, *global_object.empty_object_shape()->create_cached_prototype_transition(prototype));
 }
 
 Object::Object(GlobalObjectTag)
@@ -538,10 +538,13 @@ bool Object::internal_set_prototype_of(Object* new_prototype)
 
     // 9. Set O.[[Prototype]] to V.
     auto& shape = this->shape();
-    if (shape.is_unique())
+    if (shape.is_unique()) {
         shape.set_prototype_without_transition(new_prototype);
-    else
-        m_shape = shape.create_prototype_transition(new_prototype);
+    } else {
+        auto* new_shape = shape.create_prototype_transition(new_prototype);
+        write_barrier();
+        m_shape = new_shape;
+    }
 
     // 10. Return true.
     return true;
@@ -945,13 +948,16 @@ void Object::storage_set(PropertyName const& property_name, ValueAndAttributes c
     if (property_name.is_number()) {
         auto index = property_name.as_number();
         if (value.is_native_property()) {
+            write_barrier();
             m_indexed_properties.put(index, value, attributes);
         } else {
             auto existing_value = m_indexed_properties.get(index);
-            if (existing_value.has_value() && existing_value->value.is_native_property())
+            if (existing_value.has_value() && existing_value->value.is_native_property()) {
                 call_native_property_setter(existing_value->value.as_native_property(), this, value);
-            else
+            } else {
+                write_barrier();
                 m_indexed_properties.put(index, value, attributes);
+            }
         }
         return;
     }
@@ -961,6 +967,7 @@ void Object::storage_set(PropertyName const& property_name, ValueAndAttributes c
     if (!m_transitions_enabled && !m_shape->is_unique()) {
         m_shape->add_property_without_transition(property_name, attributes);
         m_storage.resize(m_shape->property_count());
+        write_barrier();
         m_storage[m_shape->property_count() - 1] = value;
         return;
     }
@@ -999,13 +1006,16 @@ void Object::storage_set(PropertyName const& property_name, ValueAndAttributes c
     }
 
     if (value.is_native_property()) {
+        write_barrier();
         m_storage[metadata->offset] = value;
     } else {
         auto existing_value = m_storage[metadata->offset];
-        if (existing_value.is_native_property())
+        if (existing_value.is_native_property()) {
             call_native_property_setter(existing_value.as_native_property(), this, value);
-        else
+        } else {
+            write_barrier();
             m_storage[metadata->offset] = value;
+        }
     }
 }
 
@@ -1029,9 +1039,18 @@ void Object::storage_delete(PropertyName const& property_name)
 void Object::set_shape(Shape& new_shape)
 {
     m_storage.resize(new_shape.property_count());
+    write_barrier();
     m_shape = &new_shape;
 }
 
+void Object::put_direct_with_transition(Shape& new_shape, size_t index, Value value)
+{
+    VERIFY(new_shape.property_count() == shape().property_count() + 1);
+    set_shape(new_shape);
+    write_barrier();
+    m_storage[index] = value;
+}
+
 void Object::define_native_accessor(PropertyName const& property_name, Function<Value(VM&, GlobalObject&)> getter, Function<Value(VM&, GlobalObject&)> setter, PropertyAttributes attribute)
 {
     auto& vm = this->vm();
@@ -1082,7 +1101,9 @@ void Object::ensure_shape_is_unique()
     if (shape().is_unique())
         return;
 
-    m_shape = m_shape->create_unique_clone();
+    auto* new_shape = m_shape->create_unique_clone();
+    write_barrier();
+    m_shape = new_shape;
 }
 
 // Simple side-effect free property lookup, following the prototype chain. Non-standard.
@@ -27,6 +27,8 @@ public:                               \
     virtual const char* class_name() const override { return #class_; }
 
 class Object : public Cell {
+    JS_DECLARE_WRITE_BARRIERED_EDGES(Object);
+
 public:
     static Object* create(GlobalObject&, Object* prototype);
 
@@ -140,6 +142,10 @@ public:
     virtual bool is_native_function() const { return false; }
     virtual bool is_ordinary_function_object() const { return false; }
 
+    // Objects that override the property lookup internal methods must return true here, so the
+    // bytecode interpreter doesn't cache lookups on them that bypass those overrides.
+    virtual bool has_exotic_property_lookup() const { return false; }
+
     // B.3.7 The [[IsHTMLDDA]] Internal Slot, https://tc39.es/ecma262/#sec-IsHTMLDDA-internal-slot
     virtual bool is_htmldda() const { return false; }
 
@@ -151,10 +157,25 @@ public:
     virtual Value value_of() const { return Value(const_cast<Object*>(this)); }
 
     Value get_direct(size_t index) const { return m_storage[index]; }
+    void put_direct(size_t index, Value value)
+    {
+        write_barrier();
+        m_storage[index] = value;
+    }
+    void put_direct_with_transition(Shape& new_shape, size_t index, Value value);
 
     const IndexedProperties& indexed_properties() const { return m_indexed_properties; }
-    IndexedProperties& indexed_properties() { return m_indexed_properties; }
-    void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
+    // NOTE: This assumes the caller is about to store into the indexed properties, so don't allocate before doing that.
+    IndexedProperties& indexed_properties()
+    {
+        write_barrier();
+        return m_indexed_properties;
+    }
+    void set_indexed_property_elements(Vector<Value>&& values)
+    {
+        write_barrier();
+        m_indexed_properties = IndexedProperties(move(values));
+    }
 
     [[nodiscard]] Value invoke_internal(const StringOrSymbol& property_name, Optional<MarkedValueList> arguments);
 
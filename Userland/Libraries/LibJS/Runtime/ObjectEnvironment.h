@@ -12,6 +12,7 @@ namespace JS {
 
 class ObjectEnvironment : public Environment {
     JS_ENVIRONMENT(ObjectEnvironment, Environment);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(ObjectEnvironment);
 
 public:
     enum class IsWithEnvironment {
@@ -14,6 +14,7 @@ namespace JS {
 
 class OrdinaryFunctionObject final : public FunctionObject {
     JS_OBJECT(OrdinaryFunctionObject, FunctionObject);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(OrdinaryFunctionObject);
 
 public:
     static OrdinaryFunctionObject* create(GlobalObject&, const FlyString& name, const Statement& body, Vector<FunctionNode::Parameter> parameters, i32 m_function_length, Environment* parent_scope, FunctionKind, bool is_strict, bool is_arrow_function = false);
@@ -114,6 +114,7 @@ Value Promise::fulfill(Value value)
     VERIFY(m_state == State::Pending);
     VERIFY(!value.is_empty());
     m_state = State::Fulfilled;
+    write_barrier();
     m_result = value;
     trigger_reactions();
     m_fulfill_reactions.clear();
@@ -129,6 +130,7 @@ Value Promise::reject(Value reason)
     VERIFY(!reason.is_empty());
     auto& vm = this->vm();
     m_state = State::Rejected;
+    write_barrier();
     m_result = reason;
     if (!m_is_handled)
         vm.promise_rejection_tracker(*this, RejectionOperation::Reject);
@@ -181,6 +183,7 @@ Value Promise::perform_then(Value on_fulfilled, Value on_rejected, Optional<Prom
     switch (m_state) {
     case Promise::State::Pending:
         dbgln_if(PROMISE_DEBUG, "[Promise @ {} / perform_then()]: state is State::Pending, adding fulfill/reject reactions", this);
+        write_barrier();
         m_fulfill_reactions.append(fulfill_reaction);
         m_reject_reactions.append(reject_reaction);
         break;
@@ -15,6 +15,7 @@ Object* promise_resolve(GlobalObject&, Object& constructor, Value);
 
 class Promise final : public Object {
     JS_OBJECT(Promise, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(Promise);
 
 public:
     enum class State {
@@ -23,6 +23,7 @@ protected:
 
 class PromiseResolvingFunction final : public NativeFunction {
     JS_OBJECT(PromiseResolvingFunction, NativeFunction);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(PromiseResolvingFunction);
 
 public:
     using FunctionType = Function<Value(VM&, GlobalObject&, Promise&, AlreadyResolved&)>;
@@ -13,6 +13,7 @@ namespace JS {
 
 class ProxyObject final : public FunctionObject {
     JS_OBJECT(ProxyObject, FunctionObject);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(ProxyObject);
 
 public:
     static ProxyObject* create(GlobalObject&, Object& target, Object& handler);
@@ -50,6 +51,7 @@ private:
 
     virtual bool is_function() const override { return m_target.is_function(); }
     virtual bool is_proxy_object() const final { return true; }
+    virtual bool has_exotic_property_lookup() const final { return true; }
 
     Object& m_target;
     Object& m_handler;
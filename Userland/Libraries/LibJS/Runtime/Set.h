@@ -15,6 +15,7 @@ namespace JS {
 
 class Set : public Object {
     JS_OBJECT(Set, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(Set);
 
 public:
     static Set* create(GlobalObject&);
@@ -14,6 +14,7 @@ namespace JS {
 
 class SetIterator final : public Object {
     JS_OBJECT(SetIterator, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(SetIterator);
 
 public:
     static SetIterator* create(GlobalObject&, Set& set, Object::PropertyKind iteration_kind);
@@ -64,6 +64,7 @@ JS_DEFINE_NATIVE_FUNCTION(SetPrototype::add)
     auto value = vm.argument(0);
     if (value.is_negative_zero())
         value = Value(0);
+    set->write_barrier();
     set->values().set(value, AK::HashSetExistingEntryBehavior::Keep);
     return set;
 }
@@ -61,6 +61,35 @@ Shape* Shape::create_prototype_transition(Object* new_prototype)
     return heap().allocate_without_global_object<Shape>(*this, new_prototype);
 }
 
+// NOTE: Only objects that don't add properties to their shape during initialize() may share a cached prototype transition,
+//       since those additions happen in-place without a transition.
+Shape* Shape::create_cached_prototype_transition(Object* new_prototype)
+{
+    auto it = m_prototype_transitions.find(new_prototype);
+    if (it != m_prototype_transitions.end()) {
+        if (it->value)
+            return it->value;
+        // The cached prototype transition has gone stale (from garbage collection). Prune it.
+        m_prototype_transitions.remove(it);
+    }
+
+    auto size = m_prototype_transitions.size();
+    if (size >= 64 && (size & (size - 1)) == 0) {
+        // Prototypes come and go without ever being looked up here again, so prune stale entries every now and then.
+        Vector<Object*> stale_prototypes;
+        for (auto& entry : m_prototype_transitions) {
+            if (!entry.value)
+                stale_prototypes.append(entry.key);
+        }
+        for (auto* prototype : stale_prototypes)
+            m_prototype_transitions.remove(prototype);
+    }
+
+    auto* new_shape = create_prototype_transition(new_prototype);
+    m_prototype_transitions.set(new_prototype, new_shape);
+    return new_shape;
+}
+
 Shape::Shape(ShapeWithoutGlobalObjectTag)
 {
 }
@@ -180,6 +209,7 @@ void Shape::add_property_to_unique_shape(const StringOrSymbol& property_name, Pr
     VERIFY(is_unique());
     VERIFY(m_property_table);
     VERIFY(!m_property_table->contains(property_name));
+    write_barrier();
     m_property_table->set(property_name, { m_property_table->size(), attributes });
     ++m_property_count;
 }
@@ -211,6 +241,7 @@ void Shape::add_property_without_transition(StringOrSymbol const& property_name,
 {
     VERIFY(property_name.is_valid());
     ensure_property_table();
+    write_barrier();
     if (m_property_table->set(property_name, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry)
         ++m_property_count;
 }
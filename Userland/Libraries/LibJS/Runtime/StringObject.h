@@ -12,6 +12,7 @@ namespace JS {
 
 class StringObject : public Object {
     JS_OBJECT(StringObject, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(StringObject);
 
 public:
     static StringObject* create(GlobalObject&, PrimitiveString&, Object& prototype);
@@ -32,6 +33,7 @@ private:
     virtual MarkedValueList internal_own_property_keys() const override;
 
     virtual bool is_string_object() const final { return true; }
+    virtual bool has_exotic_property_lookup() const final { return true; }
     virtual void visit_edges(Visitor&) override;
 
     PrimitiveString& m_string;
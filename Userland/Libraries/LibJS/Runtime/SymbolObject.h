@@ -13,6 +13,7 @@ namespace JS {
 
 class SymbolObject : public Object {
     JS_OBJECT(SymbolObject, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(SymbolObject);
 
 public:
     static SymbolObject* create(GlobalObject&, Symbol&);
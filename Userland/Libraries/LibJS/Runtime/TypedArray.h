@@ -19,6 +19,7 @@ namespace JS {
 
 class TypedArrayBase : public Object {
     JS_OBJECT(TypedArrayBase, Object);
+    JS_DECLARE_WRITE_BARRIERED_EDGES(TypedArrayBase);
 
 public:
     enum class ContentType {
@@ -35,7 +36,11 @@ public:
     void set_array_length(u32 length) { m_array_length = length; }
     void set_byte_length(u32 length) { m_byte_length = length; }
     void set_byte_offset(u32 offset) { m_byte_offset = offset; }
-    void set_viewed_array_buffer(ArrayBuffer* array_buffer) { m_viewed_array_buffer = array_buffer; }
+    void set_viewed_array_buffer(ArrayBuffer* array_buffer)
+    {
+        write_barrier();
+        m_viewed_array_buffer = array_buffer;
+    }
 
     virtual size_t element_size() const = 0;
     virtual String element_name() const = 0;
@@ -453,6 +458,7 @@ protected:
 
 private:
     virtual bool is_typed_array() const final { return true; }
+    virtual bool has_exotic_property_lookup() const final { return true; }
 };
 
 #define JS_DECLARE_TYPED_ARRAY(ClassName, snake_name, PrototypeName, ConstructorName, Type) \
@@ -440,9 +440,12 @@ Value VM::construct(FunctionObject& function, FunctionObject& new_target, Option
 
     Value this_argument;
     if (function.constructor_kind() == FunctionObject::ConstructorKind::Base) {
-        this_argument = ordinary_create_from_constructor<Object>(global_object, new_target, &GlobalObject::object_prototype);
+        // NOTE: This is OrdinaryCreateFromConstructor(newTarget, "%Object.prototype%"), but going through Object::create()
+        //       lets all instances of a constructor share their shape transitions.
+        auto* prototype = get_prototype_from_constructor(global_object, new_target, &GlobalObject::object_prototype);
         if (exception())
             return {};
+        this_argument = Object::create(global_object, prototype);
     }
 
     ExecutionContext callee_context;
@@ -0,0 +1,124 @@
+// These store freshly allocated (young) cells into cells that have survived a full collection (old),
+// which minor collections must find through the remembered set rather than by walking the whole heap.
+
+const makeGarbage = () => {
+    for (let i = 0; i < 1000; ++i) ({ i, string: "garbage" + i });
+};
+
+// Stale pointers to young cells left behind on the stack would keep them alive no matter what.
+const clobberStack = (depth = 100) => (depth ? clobberStack(depth - 1) + 1 : 0);
+
+const collectYoungGenerationAndChurn = () => {
+    collectYoungGeneration();
+    makeGarbage();
+    collectYoungGeneration();
+};
+
+test("young objects stored in old objects", () => {
+    const holder = {};
+    gc();
+    holder.child = { value: 42, nested: { string: "foo" + 1 } };
+    collectYoungGenerationAndChurn();
+    expect(holder.child.value).toBe(42);
+    expect(holder.child.nested.string).toBe("foo1");
+});
+
+test("young objects stored in old objects with unique shapes", () => {
+    const holder = { a: 1 };
+    delete holder.a;
+    gc();
+    holder.child = { value: 42 };
+    holder[Symbol("key")] = "bar" + 2;
+    collectYoungGenerationAndChurn();
+    expect(holder.child.value).toBe(42);
+    const symbols = Object.getOwnPropertySymbols(holder);
+    expect(symbols).toHaveLength(1);
+    expect(symbols[0].description).toBe("key");
+    expect(holder[symbols[0]]).toBe("bar2");
+});
+
+test("young prototype of an old object", () => {
+    const object = {};
+    gc();
+    Object.setPrototypeOf(object, { inherited: "baz" + 3 });
+    collectYoungGenerationAndChurn();
+    expect(object.inherited).toBe("baz3");
+});
+
+test("young values stored in old arrays", () => {
+    const array = [];
+    gc();
+    array.push({ value: 1 });
+    array[5] = { value: 2 };
+    array[1000] = { value: 3 };
+    collectYoungGenerationAndChurn();
+    expect(array[0].value).toBe(1);
+    expect(array[5].value).toBe(2);
+    expect(array[1000].value).toBe(3);
+});
+
+test("young values stored in old closures and collections", () => {
+    let captured;
+    const getCaptured = () => captured;
+    const map = new Map();
+    const set = new Set();
+    gc();
+    captured = { value: "captured" };
+    map.set("key", { value: "map" });
+    set.add({ value: "set" });
+    collectYoungGenerationAndChurn();
+    expect(getCaptured().value).toBe("captured");
+    expect(map.get("key").value).toBe("map");
+    expect(set.values().next().value.value).toBe("set");
+});
+
+test("young values stored in old cells that have left the remembered set", () => {
+    let captured;
+    const getCaptured = () => captured;
+    const map = new Map();
+    let resolvePromise;
+    const promise = new Promise(resolve => (resolvePromise = resolve));
+    const object = {};
+    Object.defineProperty(object, "accessor", { get: () => 0, configurable: true });
+    const store = value => {
+        captured = { value };
+        map.set("key", { value });
+    };
+    gc();
+    store("first" + 1);
+    collectYoungGenerationAndChurn();
+    // By now, everything is old again and nothing needs to be remembered anymore.
+    store("second" + 2);
+    (() => {
+        resolvePromise({ value: "promise" + 3 });
+        Object.defineProperty(object, "accessor", { set: value => value + 4 });
+    })();
+    clobberStack();
+    collectYoungGenerationAndChurn();
+    expect(getCaptured().value).toBe("second2");
+    expect(map.get("key").value).toBe("second2");
+    let promiseResult;
+    promise.then(result => (promiseResult = result));
+    runQueuedPromiseJobs();
+    expect(promiseResult.value).toBe("promise3");
+    expect(Object.getOwnPropertyDescriptor(object, "accessor").set(1)).toBe(5);
+});
+
+test("young cells in weak containers", () => {
+    const weakMap = new WeakMap();
+    const weakSet = new WeakSet();
+    const holder = {};
+    gc();
+    {
+        weakMap.set({ a: 1 }, 1);
+        weakSet.add({ a: 1 });
+        holder.key = {};
+        weakMap.set(holder.key, 2);
+    }
+    collectYoungGenerationAndChurn();
+    expect(weakMap.get(holder.key)).toBe(2);
+    // Cells that got promoted before becoming unreachable are only collected by a full collection.
+    gc();
+    expect(getWeakMapSize(weakMap)).toBe(1);
+    expect(getWeakSetSize(weakSet)).toBe(0);
+});
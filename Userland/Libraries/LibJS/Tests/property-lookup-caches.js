@@ -0,0 +1,208 @@
+// These exercise the same property access site with objects whose shapes and prototypes change
+// between executions, which is what the bytecode interpreter's property lookup caches key on.
+
+describe("get", () => {
+    test("own properties with differing shapes", () => {
+        const getX = o => o.x;
+        const objects = [{ x: 1 }, { y: 0, x: 2 }, { z: 0, y: 0, x: 3 }, { x: 4, w: 0 }, { v: 0, x: 5 }, { x: 6 }];
+        for (let i = 0; i < 3; ++i) {
+            expect(objects.map(getX)).toEqual([1, 2, 3, 4, 5, 6]);
+        }
+    });
+
+    test("prototype chain hit is invalidated by shadowing property", () => {
+        const proto = { foo: "proto" };
+        const object = Object.create(proto);
+        const getFoo = o => o.foo;
+        expect(getFoo(object)).toBe("proto");
+        expect(getFoo(object)).toBe("proto");
+        object.foo = "own";
+        expect(getFoo(object)).toBe("own");
+        delete object.foo;
+        expect(getFoo(object)).toBe("proto");
+    });
+
+    test("prototype chain hit is invalidated by changes further up the chain", () => {
+        const grandparent = { foo: "grandparent" };
+        const parent = Object.create(grandparent);
+        const object = Object.create(parent);
+        const getFoo = o => o.foo;
+        expect(getFoo(object)).toBe("grandparent");
+        parent.foo = "parent";
+        expect(getFoo(object)).toBe("parent");
+        grandparent.foo = "changed";
+        expect(getFoo(object)).toBe("parent");
+        delete parent.foo;
+        expect(getFoo(object)).toBe("changed");
+    });
+
+    test("prototype change", () => {
+        const object = {};
+        const getFoo = o => o.foo;
+        Object.setPrototypeOf(object, { foo: 1 });
+        expect(getFoo(object)).toBe(1);
+        Object.setPrototypeOf(object, { foo: 2 });
+        expect(getFoo(object)).toBe(2);
+        Object.setPrototypeOf(object, null);
+        expect(getFoo(object)).toBeUndefined();
+    });
+
+    test("data property replaced by getter", () => {
+        const object = { foo: 1 };
+        const getFoo = o => o.foo;
+        expect(getFoo(object)).toBe(1);
+        Object.defineProperty(object, "foo", {
+            get() {
+                return 2;
+            },
+        });
+        expect(getFoo(object)).toBe(2);
+    });
+
+    test("instances of the same constructor", () => {
+        function Point(x, y) {
+            this.x = x;
+            this.y = y;
+        }
+        Point.prototype.sum = function () {
+            return this.x + this.y;
+        };
+        let total = 0;
+        for (let i = 0; i < 10; ++i) {
+            const point = new Point(i, i);
+            total += point.sum();
+        }
+        expect(total).toBe(90);
+        Point.prototype.sum = function () {
+            return 0;
+        };
+        expect(new Point(1, 2).sum()).toBe(0);
+    });
+
+    test("exotic objects", () => {
+        const getLength = o => o.length;
+        expect(getLength([1, 2, 3])).toBe(3);
+        expect(getLength(new String("ab"))).toBe(2);
+        expect(getLength(new Uint8Array(4))).toBe(4);
+        const proxy = new Proxy({ length: 1 }, { get: () => 42 });
+        expect(getLength(proxy)).toBe(42);
+        expect(getLength(proxy)).toBe(42);
+    });
+});
+
+describe("put", () => {
+    test("adding properties in a constructor", () => {
+        function Foo(value) {
+            this.value = value;
+        }
+        const objects = [];
+        for (let i = 0; i < 5; ++i) objects.push(new Foo(i));
+        expect(objects.map(o => o.value)).toEqual([0, 1, 2, 3, 4]);
+        expect(Object.keys(objects[4])).toEqual(["value"]);
+    });
+
+    test("setter added to the prototype after the property was added", () => {
+        let setterValue;
+        const proto = {};
+        const setFoo = (o, value) => {
+            o.foo = value;
+        };
+        setFoo(Object.create(proto), 1);
+        setFoo(Object.create(proto), 2);
+        Object.defineProperty(proto, "foo", {
+            set(value) {
+                setterValue = value;
+            },
+        });
+        const object = Object.create(proto);
+        setFoo(object, 3);
+        expect(setterValue).toBe(3);
+        expect(Object.getOwnPropertyNames(object)).toEqual([]);
+    });
+
+    test("read-only property added to the prototype after the property was added", () => {
+        "use strict";
+        const proto = {};
+        const setFoo = (o, value) => {
+            o.foo = value;
+        };
+        setFoo(Object.create(proto), 1);
+        Object.defineProperty(proto, "foo", { value: 0, writable: false });
+        expect(() => {
+            setFoo(Object.create(proto), 2);
+        }).toThrow(TypeError);
+    });
+
+    test("non-extensible and frozen objects", () => {
+        "use strict";
+        const setFoo = (o, value) => {
+            o.foo = value;
+        };
+        setFoo({}, 1);
+        const nonExtensible = Object.preventExtensions({});
+        expect(() => {
+            setFoo(nonExtensible, 1);
+        }).toThrow(TypeError);
+        expect(nonExtensible.foo).toBeUndefined();
+
+        const object = { foo: 1 };
+        setFoo(object, 2);
+        expect(object.foo).toBe(2);
+        Object.freeze(object);
+        expect(() => {
+            setFoo(object, 3);
+        }).toThrow(TypeError);
+        expect(object.foo).toBe(2);
+    });
+
+    test("exotic objects", () => {
+        const setFoo = (o, value) => {
+            o.foo = value;
+        };
+        const setValues = [];
+        const target = { foo: 0 };
+        const proxy = new Proxy(target, {
+            set(target, property, value) {
+                setValues.push(value);
+                return true;
+            },
+        });
+        for (let i = 0; i < 3; ++i) {
+            setFoo({ foo: 0 }, i);
+            setFoo(proxy, i);
+        }
+        expect(setValues).toEqual([0, 1, 2]);
+        expect(target.foo).toBe(0);
+    });
+
+    test("shape transitioned to has been garbage collected", () => {
+        function setX(o) {
+            o.x = 1;
+        }
+        (function () {
+            setX({});
+        })();
+        gc();
+        gc();
+        const object = {};
+        setX(object);
+        expect(object.x).toBe(1);
+        expect(Object.keys(object)).toEqual(["x"]);
+    });
+
+    test("overwriting a property that became an accessor", () => {
+        let setterValue;
+        const object = { foo: 1 };
+        const setFoo = (o, value) => {
+            o.foo = value;
+        };
+        setFoo(object, 2);
+        Object.defineProperty(object, "foo", {
+            set(value) {
+                setterValue = value;
+            },
+        });
+        setFoo(object, 3);
+        expect(setterValue).toBe(3);
+    });
+});
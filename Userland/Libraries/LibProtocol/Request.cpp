@@ -44,6 +44,8 @@ void Request::stream_into(OutputStream& stream)
             // FIXME: What do we do here?
             TODO();
         }
+        if (m_internal_buffered_data && nread)
+            did_buffer_data({ buf, nread });
 
         if (m_internal_stream_data->read_stream.eof() && m_internal_stream_data->request_done) {
             m_internal_stream_data->read_notifier->close();
@@ -74,6 +76,11 @@ void Request::set_should_buffer_all_input(bool value)
     on_headers_received = [this](auto& headers, auto response_code) {
         m_internal_buffered_data->response_headers = headers;
         m_internal_buffered_data->response_code = move(response_code);
+        m_internal_buffered_data->has_received_headers = true;
+        if (!m_internal_buffered_data->data_received_before_headers.is_empty()) {
+            auto data = move(m_internal_buffered_data->data_received_before_headers);
+            did_buffer_data(data);
+        }
     };
 
     on_finish = [this](auto success, u32 total_size) {
@@ -89,6 +96,18 @@ void Request::set_should_buffer_all_input(bool value)
     stream_into(m_internal_buffered_data->payload_stream);
 }
 
+void Request::did_buffer_data(ReadonlyBytes data)
+{
+    if (!on_buffered_request_data)
+        return;
+    // Whoever gets the data will want to know what it is first.
+    if (!m_internal_buffered_data->has_received_headers) {
+        m_internal_buffered_data->data_received_before_headers.append(data);
+        return;
+    }
+    on_buffered_request_data(m_internal_buffered_data->response_headers, m_internal_buffered_data->response_code, data);
+}
+
 void Request::did_finish(Badge<RequestClient>, bool success, u32 total_size)
 {
     if (!on_finish)
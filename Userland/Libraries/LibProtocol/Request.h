@@ -45,6 +45,8 @@ public:
 
     /// Note: Must be set before `set_should_buffer_all_input(true)`.
     Function<void(bool success, u32 total_size, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> response_code, ReadonlyBytes payload)> on_buffered_request_finish;
+    /// Note: Optional. While buffering, gets each piece of the payload as it arrives, once the headers have.
+    Function<void(const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> response_code, ReadonlyBytes data)> on_buffered_request_data;
     Function<void(bool success, u32 total_size)> on_finish;
     Function<void(Optional<u32> total_size, u32 downloaded_size)> on_progress;
     Function<void(const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> response_code)> on_headers_received;
@@ -76,8 +78,12 @@ private:
         DuplexMemoryStream payload_stream;
         HashMap<String, String, CaseInsensitiveStringTraits> response_headers;
         Optional<u32> response_code;
+        bool has_received_headers { false };
+        ByteBuffer data_received_before_headers;
     };
 
+    void did_buffer_data(ReadonlyBytes);
+
     struct InternalStreamData {
         InternalStreamData(int fd)
             : read_stream(fd)
@@ -129,6 +129,9 @@ void ByteCode::ensure_opcodes_initialized()
         case OpCodeId::GoBack:
             s_opcodes[i] = make<OpCode_GoBack>();
             break;
+        case OpCodeId::AtomicRepeat:
+            s_opcodes[i] = make<OpCode_AtomicRepeat>();
+            break;
         case OpCodeId::CheckBegin:
             s_opcodes[i] = make<OpCode_CheckBegin>();
             break;
@@ -203,6 +206,30 @@ ALWAYS_INLINE ExecutionResult OpCode_GoBack::execute(const MatchInput&, MatchSta
     return ExecutionResult::Continue;
 }
 
+ALWAYS_INLINE ExecutionResult OpCode_AtomicRepeat::execute(const MatchInput& input, MatchState& state, MatchOutput& output) const
+{
+    MatchState body_state = state;
+    body_state.instruction_position = state.instruction_position + 3;
+    auto& body = m_bytecode->get_opcode(body_state);
+    VERIFY(is<OpCode_Compare>(body));
+
+    size_t count = 0;
+    while (body_state.string_position < input.view.length()) {
+        auto position = body_state.string_position;
+        if (body.execute(input, body_state, output) != ExecutionResult::Continue) {
+            body_state.string_position = position;
+            break;
+        }
+        ++count;
+    }
+
+    if (count < minimum())
+        return ExecutionResult::Failed_ExecuteLowPrioForks;
+
+    state.string_position = body_state.string_position;
+    return ExecutionResult::Continue;
+}
+
 ALWAYS_INLINE ExecutionResult OpCode_FailForks::execute(const MatchInput& input, MatchState&, MatchOutput&) const
 {
     VERIFY(count() > 0);
@@ -461,6 +488,20 @@ ALWAYS_INLINE ExecutionResult OpCode_Compare::execute(const MatchInput& input, M
 
             compare_character_range(input, state, from, to, ch, current_inversion_state(), inverse_matched);
 
+        } else if (compare_type == CharacterCompareType::LookupTable) {
+            size_t sensitive_range_count = m_bytecode->at(offset++);
+            size_t insensitive_range_count = m_bytecode->at(offset++);
+
+            if (input.view.length() - state.string_position < 1)
+                return ExecutionResult::Failed_ExecuteLowPrioForks;
+
+            auto ch = input.view[state.string_position];
+            if (input.regex_options & AllFlags::Insensitive)
+                compare_lookup_table(input, state, offset + sensitive_range_count, insensitive_range_count, to_ascii_lowercase(ch), current_inversion_state(), inverse_matched);
+            else
+                compare_lookup_table(input, state, offset, sensitive_range_count, ch, current_inversion_state(), inverse_matched);
+            offset += sensitive_range_count + insensitive_range_count;
+
         } else if (compare_type == CharacterCompareType::Reference) {
             auto reference_number = (size_t)m_bytecode->at(offset++);
             auto& groups = output.capture_group_matches.at(input.match_index);
@@ -672,6 +713,28 @@ ALWAYS_INLINE void OpCode_Compare::compare_character_range(const MatchInput& inp
     }
 }
 
+ALWAYS_INLINE void OpCode_Compare::compare_lookup_table(const MatchInput&, MatchState& state, size_t offset, size_t range_count, u32 ch, bool inverse, bool& inverse_matched) const
+{
+    // The ranges are sorted and don't overlap, so we can binary search for the one that could contain `ch`.
+    size_t low = 0;
+    size_t high = range_count;
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        auto range = (CharRange)m_bytecode->at(offset + middle);
+        if (ch < range.from) {
+            high = middle;
+        } else if (ch > range.to) {
+            low = middle + 1;
+        } else {
+            if (inverse)
+                inverse_matched = true;
+            else
+                ++state.string_position;
+            return;
+        }
+    }
+}
+
 const String OpCode_Compare::arguments_string() const
 {
     return String::formatted("argc={}, args={} ", arguments_count(), arguments_size());
@@ -742,6 +805,16 @@ const Vector<String> OpCode_Compare::variable_arguments_to_string(Optional<Match
                 result.empend(String::formatted(
                     "compare against: '{}'",
                     input.value().view.substring_view(string_start_offset, state().string_position > view.length() ? 0 : 1).to_string()));
+        } else if (compare_type == CharacterCompareType::LookupTable) {
+            size_t sensitive_range_count = m_bytecode->at(offset++);
+            size_t insensitive_range_count = m_bytecode->at(offset++);
+            StringBuilder builder;
+            for (size_t i = 0; i < sensitive_range_count; ++i) {
+                auto range = (CharRange)m_bytecode->at(offset + i);
+                builder.appendff(" {:x}-{:x}", range.from, range.to);
+            }
+            result.empend(String::formatted("ranges={} ({} when insensitive):{}", sensitive_range_count, insensitive_range_count, builder.string_view()));
+            offset += sensitive_range_count + insensitive_range_count;
         }
     }
     return result;
@@ -39,6 +39,7 @@ using ByteCodeValueType = u64;
     __ENUMERATE_OPCODE(Save)                       \
     __ENUMERATE_OPCODE(Restore)                    \
     __ENUMERATE_OPCODE(GoBack)                     \
+    __ENUMERATE_OPCODE(AtomicRepeat)               \
     __ENUMERATE_OPCODE(Exit)
 
 // clang-format off
@@ -63,6 +64,7 @@ enum class OpCodeId : ByteCodeValueType {
     __ENUMERATE_CHARACTER_COMPARE_TYPE(CharRange)        \
     __ENUMERATE_CHARACTER_COMPARE_TYPE(Reference)        \
     __ENUMERATE_CHARACTER_COMPARE_TYPE(NamedReference)   \
+    __ENUMERATE_CHARACTER_COMPARE_TYPE(LookupTable)      \
     __ENUMERATE_CHARACTER_COMPARE_TYPE(RangeExpressionDummy)
 
 enum class CharacterCompareType : ByteCodeValueType {
@@ -670,6 +672,18 @@ public:
     }
 };
 
+// Repeats the Compare that immediately follows it (and is part of this instruction) as often as it matches,
+// without leaving any forks behind. Only emitted by the optimizer, for loops that can never be backtracked into.
+class OpCode_AtomicRepeat final : public OpCode {
+public:
+    ExecutionResult execute(const MatchInput& input, MatchState& state, MatchOutput& output) const override;
+    ALWAYS_INLINE OpCodeId opcode_id() const override { return OpCodeId::AtomicRepeat; }
+    ALWAYS_INLINE size_t size() const override { return body_size() + 3; }
+    ALWAYS_INLINE size_t minimum() const { return argument(0); }
+    ALWAYS_INLINE size_t body_size() const { return argument(1); }
+    const String arguments_string() const override { return String::formatted("min={}, body_size={}", minimum(), body_size()); }
+};
+
 class OpCode_Compare final : public OpCode {
 public:
     ExecutionResult execute(const MatchInput& input, MatchState& state, MatchOutput& output) const override;
@@ -685,6 +699,7 @@ private:
     ALWAYS_INLINE static bool compare_string(const MatchInput& input, MatchState& state, const char* str, size_t length, bool& had_zero_length_match);
     ALWAYS_INLINE static void compare_character_class(const MatchInput& input, MatchState& state, CharClass character_class, u32 ch, bool inverse, bool& inverse_matched);
     ALWAYS_INLINE static void compare_character_range(const MatchInput& input, MatchState& state, u32 from, u32 to, u32 ch, bool inverse, bool& inverse_matched);
+    ALWAYS_INLINE void compare_lookup_table(const MatchInput& input, MatchState& state, size_t offset, size_t range_count, u32 ch, bool inverse, bool& inverse_matched) const;
 };
 
 template<typename T>
@@ -714,6 +729,12 @@ ALWAYS_INLINE bool is<OpCode_Exit>(const OpCode& opcode)
     return opcode.opcode_id() == OpCodeId::Exit;
 }
 
+template<>
+ALWAYS_INLINE bool is<OpCode_AtomicRepeat>(const OpCode& opcode)
+{
+    return opcode.opcode_id() == OpCodeId::AtomicRepeat;
+}
+
 template<>
 ALWAYS_INLINE bool is<OpCode_Compare>(const OpCode& opcode)
 {
@@ -8,6 +8,7 @@
 #include "RegexDebug.h"
 #include "RegexParser.h"
 #include <AK/Debug.h>
+#include <AK/MemMem.h>
 #include <AK/ScopedValueRollback.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
@@ -27,8 +28,10 @@ Regex<Parser>::Regex(StringView pattern, typename ParserTraits<Parser>::OptionsT
     Parser parser(lexer, regex_options);
     parser_result = parser.parse();
 
-    if (parser_result.error == regex::Error::NoError)
+    if (parser_result.error == regex::Error::NoError) {
+        run_optimization_passes();
         matcher = make<Matcher<Parser>>(*this, regex_options);
+    }
 }
 
 template<class Parser>
@@ -53,6 +56,27 @@ String Regex<Parser>::error_string(Optional<String> message) const
     return eb.build();
 }
 
+static Optional<size_t> find_literal(const RegexStringView& view, const StringView& literal, size_t start)
+{
+    if (view.is_u8_view()) {
+        auto haystack = view.u8view().substring_view(start);
+        auto offset = AK::memmem_optional(haystack.characters_without_null_termination(), haystack.length(), literal.characters_without_null_termination(), literal.length());
+        if (!offset.has_value())
+            return {};
+        return start + offset.value();
+    }
+
+    // The literal is all ASCII (see find_literal_prefix()), so each of its bytes is a code point of its own.
+    for (size_t i = start; i + literal.length() <= view.length(); ++i) {
+        size_t j = 0;
+        while (j < literal.length() && view[i + j] == (u32)literal[j])
+            ++j;
+        if (j == literal.length())
+            return i;
+    }
+    return {};
+}
+
 template<typename Parser>
 RegexResult Matcher<Parser>::match(const RegexStringView& view, Optional<typename ParserTraits<Parser>::OptionsType> regex_options) const
 {
@@ -138,6 +162,9 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
     if (input.regex_options.has_flag_set(AllFlags::Internal_Stateful))
         continue_search = false;
 
+    auto& literal_prefix = m_pattern.optimization_data.literal_prefix;
+    bool can_skip_to_literal_prefix = !literal_prefix.is_empty() && !input.regex_options.has_flag_set(AllFlags::Insensitive);
+
     for (auto& view : views) {
         if (lines_to_skip != 0) {
             ++input.line;
@@ -179,6 +206,18 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
         }
 
         for (; view_index < view_length; ++view_index) {
+            if (can_skip_to_literal_prefix) {
+                // No match can start before the next occurrence of the literal prefix.
+                auto next_candidate = find_literal(view, literal_prefix, view_index);
+                if (!next_candidate.has_value())
+                    break;
+                if (next_candidate.value() != view_index) {
+                    if (!continue_search && !input.regex_options.has_flag_set(AllFlags::Internal_Stateful))
+                        break;
+                    view_index = next_candidate.value();
+                }
+            }
+
             auto& match_length_minimum = m_pattern.parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
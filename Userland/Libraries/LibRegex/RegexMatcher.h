@@ -70,8 +70,14 @@ private:
 template<class Parser>
 class Regex final {
 public:
+    struct OptimizationData {
+        // Every match has to start with this, so the matcher can skip straight to the places where it occurs.
+        String literal_prefix;
+    };
+
     String pattern_value;
     regex::Parser::Result parser_result;
+    OptimizationData optimization_data;
     OwnPtr<Matcher<Parser>> matcher { nullptr };
     mutable size_t start_offset { 0 };
 
@@ -208,6 +214,9 @@ public:
         RegexResult result = matcher->match(views, AllOptions { regex_options.value_or({}) } | AllFlags::SkipSubExprResults);
         return result.success;
     }
+
+private:
+    void run_optimization_passes();
 };
 
 // free standing functions for match, search and has_match
@@ -0,0 +1,630 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "RegexMatcher.h"
+#include <AK/AnyOf.h>
+#include <AK/CharacterTypes.h>
+#include <AK/Debug.h>
+#include <AK/NumericLimits.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+
+namespace regex {
+
+namespace {
+
+struct Instruction {
+    OpCodeId id;
+    size_t position;
+    size_t size;
+    Optional<size_t> jump_target;
+
+    size_t end() const { return position + size; }
+};
+
+struct Replacement {
+    size_t start;
+    size_t end;
+    ByteCode bytecode;
+};
+
+// A closed range of code points. Unlike CharRange, this can be sorted and merged in place.
+struct Range {
+    u32 from;
+    u32 to;
+};
+
+// An over-approximation of the characters a single-character Compare can accept, both as matched
+// normally and (after lowercasing the input character) as matched with the Insensitive flag set.
+struct CharacterSet {
+    bool is_inverted { false };
+    Vector<Range> ranges;
+    Vector<Range> insensitive_ranges;
+};
+
+}
+
+static Vector<Instruction> decode(const ByteCode& bytecode)
+{
+    Vector<Instruction> instructions;
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = bytecode.get_opcode(state);
+        Instruction instruction { opcode.opcode_id(), state.instruction_position, opcode.size(), {} };
+        switch (instruction.id) {
+        case OpCodeId::Jump:
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkStay:
+            instruction.jump_target = instruction.end() + (ssize_t)bytecode[instruction.position + 1];
+            break;
+        default:
+            break;
+        }
+        instructions.append(instruction);
+        state.instruction_position += opcode.size();
+    }
+    return instructions;
+}
+
+static Vector<size_t> count_incoming_jumps(const ByteCode& bytecode, const Vector<Instruction>& instructions)
+{
+    Vector<size_t> incoming_jumps;
+    incoming_jumps.resize(bytecode.size() + 1);
+    for (auto& instruction : instructions) {
+        if (instruction.jump_target.has_value())
+            ++incoming_jumps[instruction.jump_target.value()];
+    }
+    return incoming_jumps;
+}
+
+// Splices the replacements (which must be sorted and must not overlap) into the bytecode, and fixes up all
+// the remaining jumps. Nothing may jump into the middle of a replaced range.
+static void apply_replacements(ByteCode& bytecode, const Vector<Instruction>& instructions, const Vector<Replacement>& replacements)
+{
+    struct Jump {
+        size_t position;
+        size_t old_target;
+    };
+
+    constexpr auto unmapped = NumericLimits<size_t>::max();
+    Vector<size_t> new_positions;
+    new_positions.ensure_capacity(bytecode.size() + 1);
+    for (size_t i = 0; i <= bytecode.size(); ++i)
+        new_positions.unchecked_append(unmapped);
+
+    ByteCode result;
+    Vector<Jump> jumps;
+    size_t replacement_index = 0;
+    for (auto& instruction : instructions) {
+        if (replacement_index < replacements.size() && instruction.position >= replacements[replacement_index].start) {
+            auto& replacement = replacements[replacement_index];
+            if (instruction.position == replacement.start) {
+                new_positions[instruction.position] = result.size();
+                result.extend(replacement.bytecode);
+            }
+            if (instruction.end() >= replacement.end)
+                ++replacement_index;
+            continue;
+        }
+
+        new_positions[instruction.position] = result.size();
+        if (instruction.jump_target.has_value())
+            jumps.append({ result.size(), instruction.jump_target.value() });
+        for (size_t i = instruction.position; i < instruction.end(); ++i)
+            result.append(bytecode[i]);
+    }
+    new_positions[bytecode.size()] = result.size();
+
+    for (auto& jump : jumps) {
+        auto new_target = new_positions[jump.old_target];
+        VERIFY(new_target != unmapped);
+        result[jump.position + 1] = (ByteCodeValueType)((ssize_t)new_target - (ssize_t)(jump.position + 2));
+    }
+
+    bytecode = move(result);
+}
+
+// Returns the arguments of a Compare instruction, as long as every one of them checks a single character.
+static Optional<Vector<CompareTypeAndValuePair>> single_character_compare_arguments(const ByteCode& bytecode, const Instruction& instruction)
+{
+    VERIFY(instruction.id == OpCodeId::Compare);
+    Vector<CompareTypeAndValuePair> arguments;
+    auto offset = instruction.position + 3;
+    auto argument_count = bytecode[instruction.position + 1];
+    for (size_t i = 0; i < argument_count; ++i) {
+        auto type = (CharacterCompareType)bytecode[offset++];
+        switch (type) {
+        case CharacterCompareType::Inverse:
+        case CharacterCompareType::TemporaryInverse:
+        case CharacterCompareType::AnyChar:
+            arguments.append({ type, 0 });
+            break;
+        case CharacterCompareType::Char:
+        case CharacterCompareType::CharClass:
+        case CharacterCompareType::CharRange:
+            arguments.append({ type, bytecode[offset++] });
+            break;
+        default:
+            return {};
+        }
+    }
+    return arguments;
+}
+
+static bool has_inversion(const Vector<CompareTypeAndValuePair>& arguments)
+{
+    return any_of(arguments.begin(), arguments.end(), [](auto& argument) {
+        return argument.type == CharacterCompareType::Inverse || argument.type == CharacterCompareType::TemporaryInverse;
+    });
+}
+
+static void normalize(Vector<Range>& ranges)
+{
+    quick_sort(ranges, [](auto& a, auto& b) { return a.from < b.from; });
+    Vector<Range> merged;
+    for (auto& range : ranges) {
+        if (!merged.is_empty() && (merged.last().to == NumericLimits<u32>::max() || merged.last().to + 1 >= range.from)) {
+            merged.last().to = max(merged.last().to, range.to);
+            continue;
+        }
+        merged.append(range);
+    }
+    ranges = move(merged);
+}
+
+static void append_insensitive_range(Vector<Range>& ranges, u32 from, u32 to)
+{
+    // With the Insensitive flag set, Compare lowercases both the bounds and the input character.
+    auto lower_from = to_ascii_lowercase(from);
+    auto lower_to = to_ascii_lowercase(to);
+    if (lower_from <= lower_to)
+        ranges.append({ lower_from, lower_to });
+}
+
+static bool append_character_class(CharacterSet& set, CharClass character_class)
+{
+    Vector<Range, 4> ranges;
+    switch (character_class) {
+    case CharClass::Alnum:
+        ranges.append({ '0', '9' });
+        [[fallthrough]];
+    case CharClass::Alpha:
+    case CharClass::Lower:
+    case CharClass::Upper:
+        ranges.append({ 'A', 'Z' });
+        ranges.append({ 'a', 'z' });
+        break;
+    case CharClass::Digit:
+        ranges.append({ '0', '9' });
+        break;
+    case CharClass::Space:
+        ranges.append({ '\t', '\r' });
+        ranges.append({ ' ', ' ' });
+        break;
+    case CharClass::Word:
+        ranges.append({ '0', '9' });
+        ranges.append({ 'A', 'Z' });
+        ranges.append({ '_', '_' });
+        ranges.append({ 'a', 'z' });
+        break;
+    case CharClass::Xdigit:
+        ranges.append({ '0', '9' });
+        ranges.append({ 'A', 'F' });
+        ranges.append({ 'a', 'f' });
+        break;
+    default:
+        return false;
+    }
+
+    // Character classes look at the input character as-is, so this is only an over-approximation of
+    // what they accept in the lowercased domain.
+    for (auto& range : ranges) {
+        set.ranges.append(range);
+        set.insensitive_ranges.append(range);
+        append_insensitive_range(set.insensitive_ranges, range.from, range.to);
+    }
+    return true;
+}
+
+static Optional<CharacterSet> character_set_for(const Vector<CompareTypeAndValuePair>& arguments)
+{
+    CharacterSet set;
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        auto& argument = arguments[i];
+        switch (argument.type) {
+        case CharacterCompareType::Inverse:
+            if (i != 0)
+                return {};
+            set.is_inverted = true;
+            break;
+        case CharacterCompareType::Char:
+            set.ranges.append({ (u32)argument.value, (u32)argument.value });
+            append_insensitive_range(set.insensitive_ranges, argument.value, argument.value);
+            break;
+        case CharacterCompareType::CharRange: {
+            CharRange range { argument.value };
+            set.ranges.append({ range.from, range.to });
+            append_insensitive_range(set.insensitive_ranges, range.from, range.to);
+            break;
+        }
+        case CharacterCompareType::CharClass:
+            // An inverted set has to be exact, which a class isn't in the insensitive domain.
+            if (set.is_inverted || !append_character_class(set, (CharClass)argument.value))
+                return {};
+            break;
+        case CharacterCompareType::AnyChar:
+            set.ranges.append({ 0, NumericLimits<u32>::max() });
+            set.insensitive_ranges.append({ 0, NumericLimits<u32>::max() });
+            break;
+        default:
+            return {};
+        }
+    }
+    normalize(set.ranges);
+    normalize(set.insensitive_ranges);
+    return set;
+}
+
+static bool intersects(const Vector<Range>& a, const Vector<Range>& b)
+{
+    for (auto& x : a) {
+        for (auto& y : b) {
+            if (x.from <= y.to && y.from <= x.to)
+                return true;
+        }
+    }
+    return false;
+}
+
+static bool covers(const Vector<Range>& outer, const Vector<Range>& inner)
+{
+    for (auto& range : inner) {
+        if (!any_of(outer.begin(), outer.end(), [&](auto& candidate) { return candidate.from <= range.from && range.to <= candidate.to; }))
+            return false;
+    }
+    return true;
+}
+
+static bool are_disjoint(const Vector<Range>& a, bool a_is_inverted, const Vector<Range>& b, bool b_is_inverted)
+{
+    if (a_is_inverted && b_is_inverted)
+        return false;
+    if (a_is_inverted)
+        return covers(a, b);
+    if (b_is_inverted)
+        return covers(b, a);
+    return !intersects(a, b);
+}
+
+static bool are_disjoint(const CharacterSet& a, const CharacterSet& b)
+{
+    return are_disjoint(a.ranges, a.is_inverted, b.ranges, b.is_inverted)
+        && are_disjoint(a.insensitive_ranges, a.is_inverted, b.insensitive_ranges, b.is_inverted);
+}
+
+// Figures out what the first character consumed after a loop could be, or returns false if we can't tell.
+// `set` stays empty if the pattern simply ends there.
+static bool first_character_after(const ByteCode& bytecode, const Vector<Instruction>& instructions, size_t index, Optional<CharacterSet>& set)
+{
+    for (; index < instructions.size(); ++index) {
+        auto& instruction = instructions[index];
+        switch (instruction.id) {
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveLeftNamedCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+            continue;
+        case OpCodeId::Compare: {
+            if (bytecode[instruction.position + 1] == 1 && (CharacterCompareType)bytecode[instruction.position + 3] == CharacterCompareType::String) {
+                if (bytecode[instruction.position + 4] == 0)
+                    return false;
+                auto first_character = bytecode[instruction.position + 5];
+                set = character_set_for({ { CharacterCompareType::Char, first_character } });
+                return true;
+            }
+            auto arguments = single_character_compare_arguments(bytecode, instruction);
+            if (!arguments.has_value())
+                return false;
+            set = character_set_for(arguments.value());
+            return set.has_value();
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+// (a|b) where both alternatives are single-character Compares becomes a single Compare.
+static Vector<Replacement> merge_single_character_alternations(const ByteCode& bytecode, const Vector<Instruction>& instructions)
+{
+    Vector<Replacement> replacements;
+    auto incoming_jumps = count_incoming_jumps(bytecode, instructions);
+
+    for (size_t i = 0; i + 3 < instructions.size(); ++i) {
+        auto& fork = instructions[i];
+        auto& right = instructions[i + 1];
+        auto& jump = instructions[i + 2];
+        auto& left = instructions[i + 3];
+        if (fork.id != OpCodeId::ForkJump || right.id != OpCodeId::Compare || jump.id != OpCodeId::Jump || left.id != OpCodeId::Compare)
+            continue;
+        if (fork.jump_target.value() != left.position || jump.jump_target.value() != left.end())
+            continue;
+        if (incoming_jumps[right.position] != 0 || incoming_jumps[jump.position] != 0 || incoming_jumps[left.position] != 1)
+            continue;
+
+        auto left_arguments = single_character_compare_arguments(bytecode, left);
+        auto right_arguments = single_character_compare_arguments(bytecode, right);
+        if (!left_arguments.has_value() || !right_arguments.has_value())
+            continue;
+        if (has_inversion(left_arguments.value()) || has_inversion(right_arguments.value()))
+            continue;
+
+        auto arguments = left_arguments.release_value();
+        arguments.extend(right_arguments.release_value());
+
+        ByteCode merged;
+        merged.insert_bytecode_compare_values(move(arguments));
+        replacements.append({ fork.position, left.end(), move(merged) });
+        i += 3;
+    }
+    return replacements;
+}
+
+// Greedy a* and a+ loops around a single-character Compare can never be backtracked into successfully
+// if nothing that follows them can start with a character the loop accepts. Those become AtomicRepeats,
+// which don't leave a fork (or a recursion level) behind for every iteration.
+static Vector<Replacement> make_loops_atomic(const ByteCode& bytecode, const Vector<Instruction>& instructions)
+{
+    Vector<Replacement> replacements;
+    auto incoming_jumps = count_incoming_jumps(bytecode, instructions);
+
+    auto try_make_atomic = [&](const Instruction& body, size_t start, size_t end, size_t next_index, size_t minimum) {
+        auto arguments = single_character_compare_arguments(bytecode, body);
+        if (!arguments.has_value())
+            return false;
+        auto body_set = character_set_for(arguments.value());
+        if (!body_set.has_value())
+            return false;
+
+        Optional<CharacterSet> next_set;
+        if (!first_character_after(bytecode, instructions, next_index, next_set))
+            return false;
+        if (next_set.has_value() && !are_disjoint(body_set.value(), next_set.value()))
+            return false;
+
+        ByteCode atomic_loop;
+        atomic_loop.empend((ByteCodeValueType)OpCodeId::AtomicRepeat);
+        atomic_loop.empend(minimum);
+        atomic_loop.empend(body.size);
+        for (size_t i = body.position; i < body.end(); ++i)
+            atomic_loop.append(bytecode[i]);
+        replacements.append({ start, end, move(atomic_loop) });
+        return true;
+    };
+
+    for (size_t i = 0; i + 1 < instructions.size(); ++i) {
+        // LABEL _START
+        // FORKSTAY _END
+        // COMPARE
+        // JUMP _START
+        // LABEL _END
+        if (i + 2 < instructions.size()) {
+            auto& fork = instructions[i];
+            auto& body = instructions[i + 1];
+            auto& jump = instructions[i + 2];
+            if (fork.id == OpCodeId::ForkStay && body.id == OpCodeId::Compare && jump.id == OpCodeId::Jump
+                && fork.jump_target.value() == jump.end() && jump.jump_target.value() == fork.position
+                && incoming_jumps[body.position] == 0 && incoming_jumps[jump.position] == 0) {
+                if (try_make_atomic(body, fork.position, jump.end(), i + 3, 0)) {
+                    i += 2;
+                    continue;
+                }
+            }
+        }
+
+        // LABEL _START
+        // COMPARE
+        // FORKJUMP _START
+        auto& body = instructions[i];
+        auto& fork = instructions[i + 1];
+        if (body.id == OpCodeId::Compare && fork.id == OpCodeId::ForkJump && fork.jump_target.value() == body.position && incoming_jumps[fork.position] == 0) {
+            if (try_make_atomic(body, body.position, fork.end(), i + 2, 1))
+                ++i;
+        }
+    }
+    return replacements;
+}
+
+// Runs of Char/CharRange arguments in a Compare are folded into a sorted range table.
+static Vector<Replacement> build_lookup_tables(const ByteCode& bytecode, const Vector<Instruction>& instructions)
+{
+    Vector<Replacement> replacements;
+
+    for (auto& instruction : instructions) {
+        if (instruction.id != OpCodeId::Compare)
+            continue;
+
+        ByteCode arguments;
+        size_t argument_count = 0;
+        bool did_build_table = false;
+        Vector<Range> run;
+        Vector<Range> insensitive_run;
+        size_t run_length = 0;
+
+        auto flush_run = [&](size_t run_start) {
+            if (run_length >= 2) {
+                normalize(run);
+                normalize(insensitive_run);
+                arguments.empend((ByteCodeValueType)CharacterCompareType::LookupTable);
+                arguments.empend(run.size());
+                arguments.empend(insensitive_run.size());
+                for (auto& range : run)
+                    arguments.empend(CharRange { range.from, range.to });
+                for (auto& range : insensitive_run)
+                    arguments.empend(CharRange { range.from, range.to });
+                ++argument_count;
+                did_build_table = true;
+            } else {
+                for (size_t j = run_start; j < run_start + run_length * 2; ++j)
+                    arguments.append(bytecode[j]);
+                argument_count += run_length;
+            }
+            run.clear();
+            insensitive_run.clear();
+            run_length = 0;
+        };
+
+        auto offset = instruction.position + 3;
+        size_t run_start = offset;
+        bool previous_was_temporary_inverse = false;
+        auto count = bytecode[instruction.position + 1];
+        for (size_t i = 0; i < count; ++i) {
+            auto argument_start = offset;
+            auto type = (CharacterCompareType)bytecode[offset++];
+            size_t argument_size = 0;
+            switch (type) {
+            case CharacterCompareType::Inverse:
+            case CharacterCompareType::TemporaryInverse:
+            case CharacterCompareType::AnyChar:
+                break;
+            case CharacterCompareType::Char:
+            case CharacterCompareType::CharClass:
+            case CharacterCompareType::CharRange:
+            case CharacterCompareType::Reference:
+                argument_size = 1;
+                break;
+            case CharacterCompareType::String:
+                argument_size = 1 + bytecode[offset];
+                break;
+            case CharacterCompareType::NamedReference:
+                argument_size = 2;
+                break;
+            case CharacterCompareType::LookupTable:
+                argument_size = 2 + bytecode[offset] + bytecode[offset + 1];
+                break;
+            default:
+                VERIFY_NOT_REACHED();
+            }
+            offset += argument_size;
+
+            // A TemporaryInverse only applies to the argument right after it, so that one has to stay on its own.
+            bool can_join_run = (type == CharacterCompareType::Char || type == CharacterCompareType::CharRange) && !previous_was_temporary_inverse;
+            previous_was_temporary_inverse = type == CharacterCompareType::TemporaryInverse;
+
+            if (can_join_run) {
+                if (run_length == 0)
+                    run_start = argument_start;
+                auto value = bytecode[argument_start + 1];
+                if (type == CharacterCompareType::Char) {
+                    run.append({ (u32)value, (u32)value });
+                    append_insensitive_range(insensitive_run, value, value);
+                } else {
+                    CharRange range { value };
+                    run.append({ range.from, range.to });
+                    append_insensitive_range(insensitive_run, range.from, range.to);
+                }
+                ++run_length;
+                continue;
+            }
+
+            flush_run(run_start);
+            for (size_t j = argument_start; j < offset; ++j)
+                arguments.append(bytecode[j]);
+            ++argument_count;
+        }
+        flush_run(run_start);
+
+        if (!did_build_table)
+            continue;
+
+        ByteCode compare;
+        compare.empend((ByteCodeValueType)OpCodeId::Compare);
+        compare.empend(argument_count);
+        compare.empend(arguments.size());
+        compare.extend(move(arguments));
+        replacements.append({ instruction.position, instruction.end(), move(compare) });
+    }
+    return replacements;
+}
+
+static String find_literal_prefix(const ByteCode& bytecode, const Vector<Instruction>& instructions)
+{
+    StringBuilder builder;
+    for (auto& instruction : instructions) {
+        switch (instruction.id) {
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveLeftNamedCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+            continue;
+        case OpCodeId::Compare: {
+            if (bytecode[instruction.position + 1] != 1)
+                return builder.to_string();
+            auto type = (CharacterCompareType)bytecode[instruction.position + 3];
+            if (type == CharacterCompareType::Char) {
+                auto ch = bytecode[instruction.position + 4];
+                if (!is_ascii(ch))
+                    return builder.to_string();
+                builder.append((char)ch);
+                continue;
+            }
+            if (type == CharacterCompareType::String) {
+                auto length = bytecode[instruction.position + 4];
+                for (size_t i = 0; i < length; ++i) {
+                    auto ch = bytecode[instruction.position + 5 + i];
+                    if (!is_ascii(ch))
+                        return builder.to_string();
+                    builder.append((char)ch);
+                }
+                continue;
+            }
+            return builder.to_string();
+        }
+        default:
+            return builder.to_string();
+        }
+    }
+    return builder.to_string();
+}
+
+template<typename Parser>
+void Regex<Parser>::run_optimization_passes()
+{
+    auto& bytecode = parser_result.bytecode;
+
+    // FailForks (used for negative lookarounds) counts the forks that were created inside the lookaround body,
+    // so we must not change how many of them there are.
+    auto instructions = decode(bytecode);
+    bool may_change_forks = !any_of(instructions.begin(), instructions.end(), [](auto& instruction) { return instruction.id == OpCodeId::FailForks; });
+
+    auto run_pass = [&](auto pass) {
+        auto replacements = pass(bytecode, instructions);
+        if (replacements.is_empty())
+            return false;
+        apply_replacements(bytecode, instructions, replacements);
+        instructions = decode(bytecode);
+        return true;
+    };
+
+    if (may_change_forks) {
+        // Merging the innermost alternation can make the one around it mergeable as well.
+        while (run_pass(merge_single_character_alternations)) {
+        }
+        run_pass(make_loops_atomic);
+    }
+    run_pass(build_lookup_tables);
+
+    optimization_data.literal_prefix = find_literal_prefix(bytecode, instructions);
+
+    if constexpr (REGEX_DEBUG) {
+        dbgln("Optimized bytecode for /{}/ has {} instructions, literal prefix '{}'", pattern_value, instructions.size(), optimization_data.literal_prefix);
+    }
+}
+
+template void Regex<PosixExtendedParser>::run_optimization_passes();
+template void Regex<ECMA262Parser>::run_optimization_passes();
+}
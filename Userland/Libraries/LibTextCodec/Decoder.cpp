@@ -203,6 +203,26 @@ String UTF8Decoder::to_utf8(const StringView& input)
     return input;
 }
 
+size_t UTF8Decoder::length_of_incomplete_suffix(const StringView& input) const
+{
+    // Look for the first byte of the last character among the last three bytes, which are as many as can be
+    // missing the rest of a four byte character.
+    for (size_t length = 1; length <= min(input.length(), (size_t)3); ++length) {
+        u8 byte = input[input.length() - length];
+        if ((byte & 0xc0) == 0x80)
+            continue;
+        size_t character_length = 1;
+        if ((byte & 0xe0) == 0xc0)
+            character_length = 2;
+        else if ((byte & 0xf0) == 0xe0)
+            character_length = 3;
+        else if ((byte & 0xf8) == 0xf0)
+            character_length = 4;
+        return character_length > length ? length : 0;
+    }
+    return 0;
+}
+
 String UTF16BEDecoder::to_utf8(const StringView& input)
 {
     StringBuilder builder(input.length() / 2);
@@ -214,6 +234,11 @@ String UTF16BEDecoder::to_utf8(const StringView& input)
     return builder.to_string();
 }
 
+size_t UTF16BEDecoder::length_of_incomplete_suffix(const StringView& input) const
+{
+    return input.length() % 2;
+}
+
 String Latin1Decoder::to_utf8(const StringView& input)
 {
     StringBuilder builder(input.length());
@@ -14,6 +14,10 @@ class Decoder {
 public:
     virtual String to_utf8(const StringView&) = 0;
 
+    // When input is decoded a piece at a time, as it arrives, the last bytes of a piece can be the start of a
+    // character that's cut off. This says how many of them to hold back until the rest of it has arrived.
+    virtual size_t length_of_incomplete_suffix(const StringView&) const { return 0; }
+
 protected:
     virtual ~Decoder() = default;
 };
@@ -21,11 +25,13 @@ protected:
 class UTF8Decoder final : public Decoder {
 public:
     virtual String to_utf8(const StringView&) override;
+    virtual size_t length_of_incomplete_suffix(const StringView&) const override;
 };
 
 class UTF16BEDecoder final : public Decoder {
 public:
     virtual String to_utf8(const StringView&) override;
+    virtual size_t length_of_incomplete_suffix(const StringView&) const override;
 };
 
 class Latin1Decoder final : public Decoder {
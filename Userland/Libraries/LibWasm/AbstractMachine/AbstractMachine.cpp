@@ -12,14 +12,14 @@
 
 namespace Wasm {
 
-Optional<FunctionAddress> Store::allocate(ModuleInstance& module, Module::Function const& function)
+Optional<FunctionAddress> Store::allocate(ModuleInstance& module, Module::Function const& function, NonnullOwnPtr<ControlFlowTable> control_flow)
 {
     FunctionAddress address { m_functions.size() };
-    if (function.type().value() > module.types().size())
+    if (function.type().value() >= module.types().size())
         return {};
 
     auto& type = module.types()[function.type().value()];
-    m_functions.empend(WasmFunction { type, module, function });
+    m_functions.empend(WasmFunction { type, module, function, move(control_flow) });
     return address;
 }
 
@@ -125,16 +125,27 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
 
     BytecodeInterpreter interpreter;
 
+    // Constant expressions go through the same checks as function bodies, as the interpreter relies on them
+    // to never underflow the operand stack.
+    auto evaluate_constant_expression = [&](ModuleInstance const& instance, Expression const& expression, ValueType type) -> Result {
+        FunctionType function_type { {}, { type } };
+        auto control_flow = ControlFlowTable::create(expression, function_type, main_module_instance.types(), {});
+        if (control_flow.is_error())
+            return Trap { control_flow.release_error() };
+        Configuration config { m_store };
+        config.set_frame(Frame {
+            instance,
+            Vector<Value> {},
+            expression,
+            { type },
+            &control_flow.value(),
+        });
+        return config.execute(interpreter);
+    };
+
     module.for_each_section_of_type<GlobalSection>([&](auto& global_section) {
         for (auto& entry : global_section.entries()) {
-            Configuration config { m_store };
-            config.set_frame(Frame {
-                auxiliary_instance,
-                Vector<Value> {},
-                entry.expression(),
-                1,
-            });
-            auto result = config.execute(interpreter);
+            auto result = evaluate_constant_expression(auxiliary_instance, entry.expression(), entry.type().type());
             if (result.is_trap())
                 instantiation_result = InstantiationError { String::formatted("Global value construction trapped: {}", result.trap().reason) };
             else
@@ -152,14 +163,7 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
         for (auto& segment : section.segments()) {
             Vector<Reference> references;
             for (auto& entry : segment.init) {
-                Configuration config { m_store };
-                config.set_frame(Frame {
-                    main_module_instance,
-                    Vector<Value> {},
-                    entry,
-                    entry.instructions().size(),
-                });
-                auto result = config.execute(interpreter);
+                auto result = evaluate_constant_expression(main_module_instance, entry, segment.type);
                 if (result.is_trap()) {
                     instantiation_result = InstantiationError { String::formatted("Element construction trapped: {}", result.trap().reason) };
                     return IterationDecision::Continue;
@@ -203,14 +207,7 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
                 instantiation_result = InstantiationError { "Non-zero table referenced by active element segment" };
                 return IterationDecision::Break;
             }
-            Configuration config { m_store };
-            config.set_frame(Frame {
-                main_module_instance,
-                Vector<Value> {},
-                active_ptr->expression,
-                1,
-            });
-            auto result = config.execute(interpreter);
+            auto result = evaluate_constant_expression(main_module_instance, active_ptr->expression, ValueType { ValueType::I32 });
             if (result.is_trap()) {
                 instantiation_result = InstantiationError { String::formatted("Element section initialisation trapped: {}", result.trap().reason) };
                 return IterationDecision::Break;
@@ -261,14 +258,7 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
         for (auto& segment : data_section.data()) {
             segment.value().visit(
                 [&](DataSection::Data::Active const& data) {
-                    Configuration config { m_store };
-                    config.set_frame(Frame {
-                        main_module_instance,
-                        Vector<Value> {},
-                        data.offset,
-                        1,
-                    });
-                    auto result = config.execute(interpreter);
+                    auto result = evaluate_constant_expression(main_module_instance, data.offset, ValueType { ValueType::I32 });
                     if (result.is_trap()) {
                         instantiation_result = InstantiationError { String::formatted("Data section initialisation trapped: {}", result.trap().reason) };
                         return;
@@ -336,10 +326,35 @@ Optional<InstantiationError> AbstractMachine::allocate_all_initial_phase(Module
             [&](GlobalAddress const& address) { module_instance.globals().append(address); });
     }
 
-    // FIXME: What if this fails?
+    // Resolve the control flow of every function body before allocating any of them,
+    // the types of the imported functions are referred to by pointers into the store.
+    Vector<FunctionType const*> function_types;
+    function_types.ensure_capacity(module_instance.functions().size() + module.functions().size());
+    for (auto& address : module_instance.functions()) {
+        auto* function = m_store.get(address);
+        if (!function)
+            return InstantiationError { "Imported function does not exist" };
+        function->visit([&](auto const& instance) { function_types.append(&instance.type()); });
+    }
+    for (auto& func : module.functions()) {
+        if (func.type().value() >= module_instance.types().size())
+            return InstantiationError { String::formatted("Function has invalid type index {}", func.type().value()) };
+        function_types.append(&module_instance.types()[func.type().value()]);
+    }
+
+    Vector<NonnullOwnPtr<ControlFlowTable>> control_flow_tables;
+    control_flow_tables.ensure_capacity(module.functions().size());
+    for (auto& func : module.functions()) {
+        auto& type = module_instance.types()[func.type().value()];
+        auto control_flow = ControlFlowTable::create(func.body(), type, module_instance.types(), function_types);
+        if (control_flow.is_error())
+            return InstantiationError { String::formatted("Invalid function body: {}", control_flow.error()) };
+        control_flow_tables.append(make<ControlFlowTable>(control_flow.release_value()));
+    }
 
+    size_t function_index = 0;
     for (auto& func : module.functions()) {
-        auto address = m_store.allocate(module_instance, func);
+        auto address = m_store.allocate(module_instance, func, move(control_flow_tables[function_index++]));
         VERIFY(address.has_value());
         module_instance.functions().append(*address);
     }
@@ -9,8 +9,10 @@
 #include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/HashTable.h>
+#include <AK/NumericLimits.h>
 #include <AK/OwnPtr.h>
 #include <AK/Result.h>
+#include <LibWasm/AbstractMachine/ControlFlowTable.h>
 #include <LibWasm/Types.h>
 
 namespace Wasm {
@@ -62,8 +64,37 @@ private:
     RefType m_ref;
 };
 
+// Values are kept as their raw bits, zero-extended to 64 bits, so that the operand stack
+// can hold them without a type tag. The type is known statically wherever they are used.
+template<typename T>
+ALWAYS_INLINE u64 to_raw_value(T value)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<u32>(value);
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<u64>(value);
+    else if constexpr (sizeof(T) <= sizeof(u32))
+        return static_cast<u32>(value);
+    else
+        return static_cast<u64>(value);
+}
+
+template<typename T>
+ALWAYS_INLINE T from_raw_value(u64 raw)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<float>(static_cast<u32>(raw));
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<double>(raw);
+    else
+        return static_cast<T>(raw);
+}
+
 class Value {
 public:
+    // The raw value of a null reference, function and extern addresses can never have this value.
+    static constexpr u64 null_reference = NumericLimits<u64>::max();
+
     Value()
         : m_value(0)
         , m_type(ValueType::I32)
@@ -72,25 +103,41 @@ public:
 
     using AnyValueType = Variant<i32, i64, float, double, Reference>;
     explicit Value(AnyValueType value)
-        : m_value(move(value))
+        : m_value(0)
         , m_type(ValueType::I32)
     {
-        if (m_value.has<i32>())
-            m_type = ValueType { ValueType::I32 };
-        else if (m_value.has<i64>())
-            m_type = ValueType { ValueType::I64 };
-        else if (m_value.has<float>())
-            m_type = ValueType { ValueType::F32 };
-        else if (m_value.has<double>())
-            m_type = ValueType { ValueType::F64 };
-        else if (m_value.has<Reference>() && m_value.get<Reference>().ref().has<Reference::Func>())
-            m_type = ValueType { ValueType::FunctionReference };
-        else if (m_value.has<Reference>() && m_value.get<Reference>().ref().has<Reference::Extern>())
-            m_type = ValueType { ValueType::ExternReference };
-        else if (m_value.has<Reference>())
-            m_type = m_value.get<Reference>().ref().get<Reference::Null>().type;
-        else
-            VERIFY_NOT_REACHED();
+        value.visit(
+            [&](i32 value) {
+                m_value = to_raw_value(value);
+                m_type = ValueType { ValueType::I32 };
+            },
+            [&](i64 value) {
+                m_value = to_raw_value(value);
+                m_type = ValueType { ValueType::I64 };
+            },
+            [&](float value) {
+                m_value = to_raw_value(value);
+                m_type = ValueType { ValueType::F32 };
+            },
+            [&](double value) {
+                m_value = to_raw_value(value);
+                m_type = ValueType { ValueType::F64 };
+            },
+            [&](Reference const& reference) {
+                reference.ref().visit(
+                    [&](Reference::Null const& null) {
+                        m_value = null_reference;
+                        m_type = null.type;
+                    },
+                    [&](Reference::Func const& func) {
+                        m_value = func.address.value();
+                        m_type = ValueType { ValueType::FunctionReference };
+                    },
+                    [&](Reference::Extern const& extern_) {
+                        m_value = extern_.address.value();
+                        m_type = ValueType { ValueType::ExternReference };
+                    });
+            });
     }
 
     template<typename T>
@@ -100,95 +147,106 @@ public:
     {
         switch (type.kind()) {
         case ValueType::Kind::ExternReference:
-            m_value = Reference { Reference::Extern { { bit_cast<u64>(raw_value) } } };
-            break;
         case ValueType::Kind::FunctionReference:
-            m_value = Reference { Reference::Func { { bit_cast<u64>(raw_value) } } };
+        case ValueType::Kind::I64:
+            m_value = bit_cast<u64>(raw_value);
             break;
         case ValueType::Kind::I32:
-            m_value = static_cast<i32>(bit_cast<i64>(raw_value));
-            break;
-        case ValueType::Kind::I64:
-            m_value = static_cast<i64>(bit_cast<u64>(raw_value));
+            m_value = to_raw_value(static_cast<i32>(bit_cast<i64>(raw_value)));
             break;
         case ValueType::Kind::F32:
-            m_value = static_cast<float>(bit_cast<double>(raw_value));
+            m_value = to_raw_value(static_cast<float>(bit_cast<double>(raw_value)));
             break;
         case ValueType::Kind::F64:
-            m_value = bit_cast<double>(raw_value);
+            m_value = bit_cast<u64>(raw_value);
             break;
         case ValueType::Kind::NullFunctionReference:
-            VERIFY(raw_value == 0);
-            m_value = Reference { Reference::Null { ValueType(ValueType::Kind::FunctionReference) } };
-            break;
         case ValueType::Kind::NullExternReference:
             VERIFY(raw_value == 0);
-            m_value = Reference { Reference::Null { ValueType(ValueType::Kind::ExternReference) } };
+            m_value = null_reference;
             break;
         default:
             VERIFY_NOT_REACHED();
         }
     }
 
-    Value(Value const& value)
-        : m_value(AnyValueType { value.m_value })
-        , m_type(value.m_type)
+    // Wraps a value that was taken off the operand stack.
+    ALWAYS_INLINE static Value from_raw(ValueType type, u64 raw_value)
     {
+        Value value;
+        value.m_value = raw_value;
+        value.m_type = type;
+        return value;
     }
 
-    Value(Value&& value)
-        : m_value(move(value.m_value))
-        , m_type(move(value.m_type))
+    template<typename T>
+    Optional<T> to() const
     {
+        switch (m_type.kind()) {
+        case ValueType::Kind::I32:
+            if constexpr (IsSame<T, i32> || IsSame<T, u32>)
+                return from_raw_value<T>(m_value);
+            break;
+        case ValueType::Kind::I64:
+            if constexpr (IsSame<T, i64> || IsSame<T, u64>)
+                return from_raw_value<T>(m_value);
+            break;
+        case ValueType::Kind::F32:
+            if constexpr (IsSame<T, float>)
+                return from_raw_value<T>(m_value);
+            break;
+        case ValueType::Kind::F64:
+            if constexpr (IsSame<T, double>)
+                return from_raw_value<T>(m_value);
+            break;
+        default:
+            if constexpr (IsSame<T, Reference>) {
+                return reference();
+            } else if constexpr (IsSame<T, Reference::Func> || IsSame<T, Reference::Extern> || IsSame<T, Reference::Null>) {
+                if (auto ptr = reference().ref().template get_pointer<T>())
+                    return *ptr;
+            }
+            break;
+        }
+        return {};
     }
 
-    Value& operator=(Value&& value)
-    {
-        m_value = move(value.m_value);
-        m_type = move(value.m_type);
-        return *this;
-    }
+    auto& type() const { return m_type; }
+    auto raw() const { return m_value; }
 
-    Value& operator=(Value const& value)
+    AnyValueType value() const
     {
-        m_value = value.m_value;
-        m_type = value.m_type;
-        return *this;
+        switch (m_type.kind()) {
+        case ValueType::Kind::I32:
+            return from_raw_value<i32>(m_value);
+        case ValueType::Kind::I64:
+            return from_raw_value<i64>(m_value);
+        case ValueType::Kind::F32:
+            return from_raw_value<float>(m_value);
+        case ValueType::Kind::F64:
+            return from_raw_value<double>(m_value);
+        default:
+            return reference();
+        }
     }
 
-    template<typename T>
-    Optional<T> to()
+private:
+    Reference reference() const
     {
-        Optional<T> result;
-        m_value.visit(
-            [&](auto value) {
-                if constexpr (IsSame<T, decltype(value)>)
-                    result = value;
-                else if constexpr (!IsFloatingPoint<T> && IsSame<decltype(value), MakeSigned<T>>)
-                    result = value;
-            },
-            [&](Reference const& value) {
-                if constexpr (IsSame<T, Reference>) {
-                    result = value;
-                } else if constexpr (IsSame<T, Reference::Func>) {
-                    if (auto ptr = value.ref().template get_pointer<Reference::Func>())
-                        result = *ptr;
-                } else if constexpr (IsSame<T, Reference::Extern>) {
-                    if (auto ptr = value.ref().template get_pointer<Reference::Extern>())
-                        result = *ptr;
-                } else if constexpr (IsSame<T, Reference::Null>) {
-                    if (auto ptr = value.ref().template get_pointer<Reference::Null>())
-                        result = *ptr;
-                }
-            });
-        return result;
+        if (m_value == null_reference) {
+            auto kind = m_type.kind();
+            if (kind == ValueType::Kind::NullFunctionReference)
+                kind = ValueType::Kind::FunctionReference;
+            else if (kind == ValueType::Kind::NullExternReference)
+                kind = ValueType::Kind::ExternReference;
+            return Reference { Reference::Null { ValueType { kind } } };
+        }
+        if (m_type.kind() == ValueType::Kind::ExternReference)
+            return Reference { Reference::Extern { { m_value } } };
+        return Reference { Reference::Func { { m_value } } };
     }
 
-    auto& type() const { return m_type; }
-    auto& value() const { return m_value; }
-
-private:
-    AnyValueType m_value;
+    u64 m_value { 0 };
     ValueType m_type;
 };
 
@@ -280,21 +338,25 @@ private:
 
 class WasmFunction {
 public:
-    explicit WasmFunction(FunctionType const& type, ModuleInstance const& module, Module::Function const& code)
+    explicit WasmFunction(FunctionType const& type, ModuleInstance const& module, Module::Function const& code, NonnullOwnPtr<ControlFlowTable> control_flow)
         : m_type(type)
         , m_module(module)
         , m_code(code)
+        , m_control_flow(move(control_flow))
     {
     }
 
     auto& type() const { return m_type; }
     auto& module() const { return m_module; }
     auto& code() const { return m_code; }
+    auto& control_flow() const { return *m_control_flow; }
 
 private:
     FunctionType m_type;
     ModuleInstance const& m_module;
     Module::Function const& m_code;
+    // Kept on the heap so that frames can refer to it while the store grows.
+    NonnullOwnPtr<ControlFlowTable> m_control_flow;
 };
 
 class HostFunction {
@@ -412,7 +474,7 @@ class Store {
 public:
     Store() = default;
 
-    Optional<FunctionAddress> allocate(ModuleInstance& module, Module::Function const& function);
+    Optional<FunctionAddress> allocate(ModuleInstance& module, Module::Function const& function, NonnullOwnPtr<ControlFlowTable>);
     Optional<FunctionAddress> allocate(HostFunction&&);
     Optional<TableAddress> allocate(TableType const&);
     Optional<MemoryAddress> allocate(MemoryType const&);
@@ -433,29 +495,14 @@ private:
     Vector<ElementInstance> m_elements;
 };
 
-class Label {
-public:
-    explicit Label(size_t arity, InstructionPointer continuation)
-        : m_arity(arity)
-        , m_continuation(continuation)
-    {
-    }
-
-    auto continuation() const { return m_continuation; }
-    auto arity() const { return m_arity; }
-
-private:
-    size_t m_arity { 0 };
-    InstructionPointer m_continuation { 0 };
-};
-
 class Frame {
 public:
-    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity)
+    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, Vector<ValueType> result_types, ControlFlowTable const* control_flow = nullptr)
         : m_module(module)
         , m_locals(move(locals))
         , m_expression(expression)
-        , m_arity(arity)
+        , m_result_types(move(result_types))
+        , m_control_flow(control_flow)
     {
     }
 
@@ -463,32 +510,48 @@ public:
     auto& locals() const { return m_locals; }
     auto& locals() { return m_locals; }
     auto& expression() const { return m_expression; }
-    auto arity() const { return m_arity; }
+    auto& result_types() const { return m_result_types; }
+    auto arity() const { return m_result_types.size(); }
+    // Only function bodies have one, constant expressions cannot branch.
+    auto control_flow() const { return m_control_flow; }
+
+    // The operand stack height at which this frame's operands start.
+    auto stack_base() const { return m_stack_base; }
+    void set_stack_base(size_t stack_base) { m_stack_base = stack_base; }
 
 private:
     ModuleInstance const& m_module;
     Vector<Value> m_locals;
     Expression const& m_expression;
-    size_t m_arity { 0 };
+    Vector<ValueType> m_result_types;
+    ControlFlowTable const* m_control_flow { nullptr };
+    size_t m_stack_base { 0 };
 };
 
+// The operand stack, frames are kept separately by the Configuration.
 class Stack {
 public:
-    using EntryType = Variant<Value, Label, Frame>;
     Stack() = default;
 
     [[nodiscard]] ALWAYS_INLINE bool is_empty() const { return m_data.is_empty(); }
-    ALWAYS_INLINE void push(EntryType entry) { m_data.append(move(entry)); }
-    ALWAYS_INLINE auto pop() { return m_data.take_last(); }
-    ALWAYS_INLINE auto& peek() const { return m_data.last(); }
-    ALWAYS_INLINE auto& peek() { return m_data.last(); }
+
+    template<typename T>
+    ALWAYS_INLINE void push(T value) { m_data.append(to_raw_value<T>(value)); }
+    template<typename T = u64>
+    ALWAYS_INLINE T pop() { return from_raw_value<T>(m_data.take_last()); }
+    template<typename T = u64>
+    ALWAYS_INLINE T peek() const { return from_raw_value<T>(m_data.last()); }
+    template<typename T>
+    ALWAYS_INLINE void replace_top(T value) { m_data.last() = to_raw_value<T>(value); }
+
+    ALWAYS_INLINE void shrink(size_t size) { m_data.shrink(size, true); }
 
     ALWAYS_INLINE auto size() const { return m_data.size(); }
     ALWAYS_INLINE auto& entries() const { return m_data; }
     ALWAYS_INLINE auto& entries() { return m_data; }
 
 private:
-    Vector<EntryType, 1024> m_data;
+    Vector<u64, 1024> m_data;
 };
 
 using InstantiationResult = AK::Result<NonnullOwnPtr<ModuleInstance>, InstantiationError>;
@@ -37,6 +37,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
     auto max_ip_value = InstructionPointer { instructions.size() };
     auto& current_ip_value = configuration.ip();
     u64 executed_instructions = 0;
+    ScopeGuard count_instructions { [&] { m_executed_instructions += executed_instructions; } };
 
     while (current_ip_value < max_ip_value) {
         if (executed_instructions++ >= Constants::max_allowed_executed_instructions_per_call) [[unlikely]] {
@@ -53,28 +54,22 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
     }
 }
 
-void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
+void BytecodeInterpreter::branch_to(Configuration& configuration, BranchTarget const& target)
 {
-    dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
-    auto label = configuration.nth_label(index.value());
-    TRAP_IF_NOT(label.has_value());
-    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label->continuation().value(), label->arity());
-    auto results = pop_values(configuration, label->arity());
+    auto& stack = configuration.stack();
+    auto label_height = configuration.frame().stack_base() + target.stack_height;
+    dbgln_if(WASM_TRACE_DEBUG, "Branch to IP {} with {} result(s), truncating the stack to {}", target.ip.value(), target.arity, label_height);
+    TRAP_IF_NOT(stack.size() >= label_height + target.arity);
 
-    size_t drop_count = index.value() + 1;
-    for (; !configuration.stack().is_empty();) {
-        auto& entry = configuration.stack().peek();
-        if (entry.has<Label>()) {
-            if (--drop_count == 0)
-                break;
-        }
-        configuration.stack().pop();
+    // Move the results down to where the label was entered, and drop everything in between.
+    auto results_start = stack.size() - target.arity;
+    if (results_start != label_height) {
+        for (size_t i = 0; i < target.arity; ++i)
+            stack.entries()[label_height + i] = stack.entries()[results_start + i];
+        stack.shrink(label_height + target.arity);
     }
 
-    for (auto& result : results)
-        configuration.stack().push(move(result));
-
-    configuration.ip() = label->continuation();
+    configuration.ip() = target.ip;
 }
 
 template<typename ReadType, typename PushType>
@@ -87,15 +82,8 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
         return;
     }
     auto& arg = instruction.arguments().get<Instruction::MemoryArgument>();
-    TRAP_IF_NOT(!configuration.stack().is_empty());
-    auto& entry = configuration.stack().peek();
-    TRAP_IF_NOT(entry.has<Value>());
-    auto base = entry.get<Value>().to<i32>();
-    if (!base.has_value()) {
-        m_trap = Trap { "Memory access out of bounds" };
-        return;
-    }
-    auto instance_address = base.value() + static_cast<i64>(arg.offset);
+    auto base = configuration.stack().peek<i32>();
+    auto instance_address = base + static_cast<i64>(arg.offset);
     if (instance_address < 0 || static_cast<u64>(instance_address + sizeof(ReadType)) > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected 0 <= {} and {} <= {})", instance_address, instance_address + sizeof(ReadType), memory->size());
@@ -103,7 +91,7 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
     }
     dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> stack", instance_address, sizeof(ReadType));
     auto slice = memory->data().bytes().slice(instance_address, sizeof(ReadType));
-    configuration.stack().peek() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
+    configuration.stack().replace_top(static_cast<PushType>(read_value<ReadType>(slice)));
 }
 
 void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruction const& instruction, ReadonlyBytes data)
@@ -112,12 +100,8 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
     auto memory = configuration.store().get(address);
     TRAP_IF_NOT(memory);
     auto& arg = instruction.arguments().get<Instruction::MemoryArgument>();
-    TRAP_IF_NOT(!configuration.stack().is_empty());
-    auto entry = configuration.stack().pop();
-    TRAP_IF_NOT(entry.has<Value>());
-    auto base = entry.get<Value>().to<i32>();
-    TRAP_IF_NOT(base.has_value());
-    auto instance_address = base.value() + static_cast<i64>(arg.offset);
+    auto base = configuration.stack().pop<i32>();
+    auto instance_address = base + static_cast<i64>(arg.offset);
     if (instance_address < 0 || static_cast<u64>(instance_address + data.size()) > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected 0 <= {} and {} <= {})", instance_address, instance_address + data.size(), memory->size());
@@ -136,17 +120,15 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
     FunctionType const* type { nullptr };
     instance->visit([&](auto const& function) { type = &function.type(); });
     TRAP_IF_NOT(type);
-    TRAP_IF_NOT(configuration.stack().entries().size() > type->parameters().size());
+    auto& parameters = type->parameters();
+    TRAP_IF_NOT(configuration.stack().size() >= configuration.frame().stack_base() + parameters.size());
     Vector<Value> args;
-    args.ensure_capacity(type->parameters().size());
-    auto span = configuration.stack().entries().span().slice_from_end(type->parameters().size());
-    for (auto& entry : span) {
-        auto* ptr = entry.get_pointer<Value>();
-        TRAP_IF_NOT(ptr != nullptr);
-        args.unchecked_append(*ptr);
-    }
+    args.ensure_capacity(parameters.size());
+    auto first_argument = configuration.stack().size() - parameters.size();
+    for (size_t i = 0; i < parameters.size(); ++i)
+        args.unchecked_append(Value::from_raw(parameters[i], configuration.stack().entries()[first_argument + i]));
 
-    configuration.stack().entries().remove(configuration.stack().size() - span.size(), span.size());
+    configuration.stack().shrink(first_argument);
 
     Result result { Trap { ""sv } };
     {
@@ -161,77 +143,52 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
 
     configuration.stack().entries().ensure_capacity(configuration.stack().size() + result.values().size());
     for (auto& entry : result.values())
-        configuration.stack().entries().unchecked_append(move(entry));
+        configuration.stack().entries().unchecked_append(entry.raw());
 }
 
-#define BINARY_NUMERIC_OPERATION(type, operator, cast, ...)                                       \
-    do {                                                                                          \
-        TRAP_IF_NOT(!configuration.stack().is_empty());                                           \
-        auto rhs_entry = configuration.stack().pop();                                             \
-        auto& lhs_entry = configuration.stack().peek();                                           \
-        TRAP_IF_NOT(rhs_entry.has<Value>());                                                      \
-        TRAP_IF_NOT(lhs_entry.has<Value>());                                                      \
-        auto rhs = rhs_entry.get<Value>().to<type>();                                             \
-        auto lhs = lhs_entry.get<Value>().to<type>();                                             \
-        TRAP_IF_NOT(lhs.has_value());                                                             \
-        TRAP_IF_NOT(rhs.has_value());                                                             \
-        __VA_ARGS__;                                                                              \
-        auto result = lhs.value() operator rhs.value();                                           \
-        dbgln_if(WASM_TRACE_DEBUG, "{} {} {} = {}", lhs.value(), #operator, rhs.value(), result); \
-        configuration.stack().peek() = Value(cast(result));                                       \
-        return;                                                                                   \
+#define BINARY_NUMERIC_OPERATION(type, operator, cast, ...)                       \
+    do {                                                                          \
+        auto rhs = configuration.stack().pop<type>();                             \
+        auto lhs = configuration.stack().peek<type>();                            \
+        __VA_ARGS__;                                                              \
+        auto result = lhs operator rhs;                                           \
+        dbgln_if(WASM_TRACE_DEBUG, "{} {} {} = {}", lhs, #operator, rhs, result); \
+        configuration.stack().replace_top(cast(result));                          \
+        return;                                                                   \
     } while (false)
 
-#define OVF_CHECKED_BINARY_NUMERIC_OPERATION(type, operator, cast, ...)                            \
-    do {                                                                                           \
-        TRAP_IF_NOT(!configuration.stack().is_empty());                                            \
-        auto rhs_entry = configuration.stack().pop();                                              \
-        auto& lhs_entry = configuration.stack().peek();                                            \
-        TRAP_IF_NOT(rhs_entry.has<Value>());                                                       \
-        TRAP_IF_NOT(lhs_entry.has<Value>());                                                       \
-        auto rhs = rhs_entry.get<Value>().to<type>();                                              \
-        auto ulhs = lhs_entry.get<Value>().to<type>();                                             \
-        TRAP_IF_NOT(ulhs.has_value());                                                             \
-        TRAP_IF_NOT(rhs.has_value());                                                              \
-        dbgln_if(WASM_TRACE_DEBUG, "{} {} {} = ??", ulhs.value(), #operator, rhs.value());         \
-        __VA_ARGS__;                                                                               \
-        Checked<type> lhs = ulhs.value();                                                          \
-        lhs operator##= rhs.value();                                                               \
-        TRAP_IF_NOT(!lhs.has_overflow());                                                          \
-        auto result = lhs.value();                                                                 \
-        dbgln_if(WASM_TRACE_DEBUG, "{} {} {} = {}", ulhs.value(), #operator, rhs.value(), result); \
-        configuration.stack().peek() = Value(cast(result));                                        \
-        return;                                                                                    \
+#define OVF_CHECKED_BINARY_NUMERIC_OPERATION(type, operator, cast, ...)            \
+    do {                                                                           \
+        auto rhs = configuration.stack().pop<type>();                              \
+        auto ulhs = configuration.stack().peek<type>();                            \
+        dbgln_if(WASM_TRACE_DEBUG, "{} {} {} = ??", ulhs, #operator, rhs);         \
+        __VA_ARGS__;                                                               \
+        Checked<type> lhs = ulhs;                                                  \
+        lhs operator##= rhs;                                                       \
+        TRAP_IF_NOT(!lhs.has_overflow());                                          \
+        auto result = lhs.value();                                                 \
+        dbgln_if(WASM_TRACE_DEBUG, "{} {} {} = {}", ulhs, #operator, rhs, result); \
+        configuration.stack().replace_top(cast(result));                           \
+        return;                                                                    \
     } while (false)
 
-#define BINARY_PREFIX_NUMERIC_OPERATION(type, operation, cast, ...)                                 \
-    do {                                                                                            \
-        TRAP_IF_NOT(!configuration.stack().is_empty());                                             \
-        auto rhs_entry = configuration.stack().pop();                                               \
-        auto& lhs_entry = configuration.stack().peek();                                             \
-        TRAP_IF_NOT(rhs_entry.has<Value>());                                                        \
-        TRAP_IF_NOT(lhs_entry.has<Value>());                                                        \
-        auto rhs = rhs_entry.get<Value>().to<type>();                                               \
-        auto lhs = lhs_entry.get<Value>().to<type>();                                               \
-        TRAP_IF_NOT(lhs.has_value());                                                               \
-        TRAP_IF_NOT(rhs.has_value());                                                               \
-        auto result = operation(lhs.value(), rhs.value());                                          \
-        dbgln_if(WASM_TRACE_DEBUG, "{}({} {}) = {}", #operation, lhs.value(), rhs.value(), result); \
-        configuration.stack().peek() = Value(cast(result));                                         \
-        return;                                                                                     \
+#define BINARY_PREFIX_NUMERIC_OPERATION(type, operation, cast, ...)                 \
+    do {                                                                            \
+        auto rhs = configuration.stack().pop<type>();                               \
+        auto lhs = configuration.stack().peek<type>();                              \
+        auto result = operation(lhs, rhs);                                          \
+        dbgln_if(WASM_TRACE_DEBUG, "{}({} {}) = {}", #operation, lhs, rhs, result); \
+        configuration.stack().replace_top(cast(result));                            \
+        return;                                                                     \
     } while (false)
 
-#define UNARY_MAP(pop_type, operation, ...)                                               \
-    do {                                                                                  \
-        TRAP_IF_NOT(!configuration.stack().is_empty());                                   \
-        auto& entry = configuration.stack().peek();                                       \
-        TRAP_IF_NOT(entry.has<Value>());                                                  \
-        auto value = entry.get<Value>().to<pop_type>();                                   \
-        TRAP_IF_NOT(value.has_value());                                                   \
-        auto result = operation(value.value());                                           \
-        dbgln_if(WASM_TRACE_DEBUG, "map({}) {} = {}", #operation, value.value(), result); \
-        configuration.stack().peek() = Value(__VA_ARGS__(result));                        \
-        return;                                                                           \
+#define UNARY_MAP(pop_type, operation, ...)                                       \
+    do {                                                                          \
+        auto value = configuration.stack().peek<pop_type>();                      \
+        auto result = operation(value);                                           \
+        dbgln_if(WASM_TRACE_DEBUG, "map({}) {} = {}", #operation, value, result); \
+        configuration.stack().replace_top(__VA_ARGS__(result));                   \
+        return;                                                                   \
     } while (false)
 
 #define UNARY_NUMERIC_OPERATION(type, operation) \
@@ -244,10 +201,7 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
 
 #define POP_AND_STORE(pop_type, store_type)                                                   \
     do {                                                                                      \
-        TRAP_IF_NOT(!configuration.stack().is_empty());                                       \
-        auto entry = configuration.stack().pop();                                             \
-        TRAP_IF_NOT(entry.has<Value>());                                                      \
-        auto value = ConvertToRaw<store_type> {}(*entry.get<Value>().to<pop_type>());         \
+        auto value = ConvertToRaw<store_type> {}(configuration.stack().pop<pop_type>());      \
         dbgln_if(WASM_TRACE_DEBUG, "stack({}) -> temporary({}b)", value, sizeof(store_type)); \
         store_to_memory(configuration, instruction, { &value, sizeof(store_type) });          \
         return;                                                                               \
@@ -367,21 +321,6 @@ MakeUnsigned<T> BytecodeInterpreter::checked_unsigned_truncate(V value)
     return true;
 }
 
-Vector<Value> BytecodeInterpreter::pop_values(Configuration& configuration, size_t count)
-{
-    Vector<Value> results;
-    results.resize(count);
-
-    for (size_t i = 0; i < count; ++i) {
-        auto top_of_stack = configuration.stack().pop();
-        if (auto value = top_of_stack.get_pointer<Value>())
-            results[i] = move(*value);
-        else
-            TRAP_IF_NOT_NORETURN(value);
-    }
-    return results;
-}
-
 template<typename T, typename R>
 ALWAYS_INLINE static T rotl(T value, R shift)
 {
@@ -502,127 +441,58 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::nop.value():
         return;
     case Instructions::local_get.value():
-        configuration.stack().push(Value(configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()]));
+        configuration.stack().push(configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()].raw());
         return;
     case Instructions::local_set.value(): {
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto entry = configuration.stack().pop();
-        TRAP_IF_NOT(entry.has<Value>());
-        configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()] = move(entry.get<Value>());
+        auto& local = configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()];
+        local = Value::from_raw(local.type(), configuration.stack().pop());
         return;
     }
     case Instructions::i32_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::I32 }, static_cast<i64>(instruction.arguments().get<i32>())));
+        configuration.stack().push(instruction.arguments().get<i32>());
         return;
     case Instructions::i64_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::I64 }, instruction.arguments().get<i64>()));
+        configuration.stack().push(instruction.arguments().get<i64>());
         return;
     case Instructions::f32_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::F32 }, static_cast<double>(instruction.arguments().get<float>())));
+        configuration.stack().push(instruction.arguments().get<float>());
         return;
     case Instructions::f64_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::F64 }, instruction.arguments().get<double>()));
-        return;
-    case Instructions::block.value(): {
-        size_t arity = 0;
-        auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
-        if (args.block_type.kind() != BlockType::Empty)
-            arity = 1;
-        configuration.stack().push(Label(arity, args.end_ip));
+        configuration.stack().push(instruction.arguments().get<double>());
         return;
-    }
-    case Instructions::loop.value(): {
-        size_t arity = 0;
-        auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
-        if (args.block_type.kind() != BlockType::Empty)
-            arity = 1;
-        configuration.stack().push(Label(arity, ip.value() + 1));
+    case Instructions::block.value():
+    case Instructions::loop.value():
+    case Instructions::structured_end.value():
+        // Labels are resolved ahead of time, entering or leaving a block does not touch the stack.
         return;
-    }
     case Instructions::if_.value(): {
-        size_t arity = 0;
-        auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
-        if (args.block_type.kind() != BlockType::Empty)
-            arity = 1;
-
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto entry = configuration.stack().pop();
-        TRAP_IF_NOT(entry.has<Value>());
-        auto value = entry.get<Value>().to<i32>();
-        TRAP_IF_NOT(value.has_value());
-        auto end_label = Label(arity, args.end_ip.value());
-        if (value.value() == 0) {
-            if (args.else_ip.has_value()) {
-                configuration.ip() = args.else_ip.value();
-                configuration.stack().push(move(end_label));
-            } else {
-                configuration.ip() = args.end_ip.value() + 1;
-            }
-        } else {
-            configuration.stack().push(move(end_label));
-        }
-        return;
-    }
-    case Instructions::structured_end.value():
-    case Instructions::structured_else.value(): {
-        auto label = configuration.nth_label(0);
-        TRAP_IF_NOT(label.has_value());
-        size_t end = configuration.stack().size() - label->arity() - 1;
-        size_t start = end;
-        while (start > 0 && start < configuration.stack().size() && !configuration.stack().entries()[start].has<Label>())
-            --start;
-
-        configuration.stack().entries().remove(start, end - start + 1);
-
-        if (instruction.opcode() == Instructions::structured_end)
+        if (configuration.stack().pop<i32>() != 0)
             return;
-
-        // Jump to the end label
-        configuration.ip() = label->continuation();
+        TRAP_IF_NOT(configuration.frame().control_flow());
+        configuration.ip() = configuration.frame().control_flow()->target(ip).ip;
         return;
     }
-    case Instructions::return_.value(): {
-        auto& frame = configuration.frame();
-        size_t end = configuration.stack().size() - frame.arity();
-        size_t start = end;
-        for (; start + 1 > 0 && start < configuration.stack().size(); --start) {
-            auto& entry = configuration.stack().entries()[start];
-            if (entry.has<Frame>()) {
-                // Leave the frame, _and_ its label.
-                start += 2;
-                break;
-            }
-        }
-
-        configuration.stack().entries().remove(start, end - start);
-
-        // Jump past the call/indirect instruction
-        configuration.ip() = configuration.frame().expression().instructions().size();
+    case Instructions::structured_else.value():
+        // Reaching the else means that the then branch has finished, skip to the end of the block.
+        TRAP_IF_NOT(configuration.frame().control_flow());
+        configuration.ip() = configuration.frame().control_flow()->target(ip).ip;
         return;
-    }
+    case Instructions::return_.value():
     case Instructions::br.value():
-        return branch_to_label(configuration, instruction.arguments().get<LabelIndex>());
+        TRAP_IF_NOT(configuration.frame().control_flow());
+        return branch_to(configuration, configuration.frame().control_flow()->target(ip));
     case Instructions::br_if.value(): {
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto entry = configuration.stack().pop();
-        TRAP_IF_NOT(entry.has<Value>());
-        if (entry.get<Value>().to<i32>().value_or(0) == 0)
+        if (configuration.stack().pop<i32>() == 0)
             return;
-        return branch_to_label(configuration, instruction.arguments().get<LabelIndex>());
+        TRAP_IF_NOT(configuration.frame().control_flow());
+        return branch_to(configuration, configuration.frame().control_flow()->target(ip));
     }
     case Instructions::br_table.value(): {
         auto& arguments = instruction.arguments().get<Instruction::TableBranchArgs>();
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto entry = configuration.stack().pop();
-        TRAP_IF_NOT(entry.has<Value>());
-        auto maybe_i = entry.get<Value>().to<i32>();
-        TRAP_IF_NOT(maybe_i.has_value());
-        if (0 <= *maybe_i) {
-            size_t i = *maybe_i;
-            if (i < arguments.labels.size())
-                return branch_to_label(configuration, arguments.labels[i]);
-        }
-        return branch_to_label(configuration, arguments.default_);
+        TRAP_IF_NOT(configuration.frame().control_flow());
+        auto targets = configuration.frame().control_flow()->table_targets(ip, arguments.labels.size() + 1);
+        auto i = configuration.stack().pop<u32>();
+        return branch_to(configuration, targets[min<size_t>(i, arguments.labels.size())]);
     }
     case Instructions::call.value(): {
         auto index = instruction.arguments().get<FunctionIndex>();
@@ -637,18 +507,13 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         TRAP_IF_NOT(args.table.value() < configuration.frame().module().tables().size());
         auto table_address = configuration.frame().module().tables()[args.table.value()];
         auto table_instance = configuration.store().get(table_address);
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto entry = configuration.stack().pop();
-        TRAP_IF_NOT(entry.has<Value>());
-        auto index = entry.get<Value>().to<i32>();
-        TRAP_IF_NOT(index.has_value());
-        TRAP_IF_NOT(index.value() >= 0);
-        TRAP_IF_NOT(static_cast<size_t>(index.value()) < table_instance->elements().size());
-        auto element = table_instance->elements()[index.value()];
+        auto index = configuration.stack().pop<u32>();
+        TRAP_IF_NOT(index < table_instance->elements().size());
+        auto element = table_instance->elements()[index];
         TRAP_IF_NOT(element.has_value());
         TRAP_IF_NOT(element->ref().has<Reference::Func>());
         auto address = element->ref().get<Reference::Func>().address;
-        dbgln_if(WASM_TRACE_DEBUG, "call_indirect({} -> {})", index.value(), address.value());
+        dbgln_if(WASM_TRACE_DEBUG, "call_indirect({} -> {})", index, address.value());
         call_address(configuration, address);
         return;
     }
@@ -699,14 +564,11 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::i64_store32.value():
         POP_AND_STORE(i64, i32);
     case Instructions::local_tee.value(): {
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto& entry = configuration.stack().peek();
-        TRAP_IF_NOT(entry.has<Value>());
-        auto value = entry.get<Value>();
         auto local_index = instruction.arguments().get<LocalIndex>();
         TRAP_IF_NOT(configuration.frame().locals().size() > local_index.value());
         dbgln_if(WASM_TRACE_DEBUG, "stack:peek -> locals({})", local_index.value());
-        configuration.frame().locals()[local_index.value()] = move(value);
+        auto& local = configuration.frame().locals()[local_index.value()];
+        local = Value::from_raw(local.type(), configuration.stack().peek());
         return;
     }
     case Instructions::global_get.value(): {
@@ -715,20 +577,16 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto address = configuration.frame().module().globals()[global_index.value()];
         dbgln_if(WASM_TRACE_DEBUG, "global({}) -> stack", address.value());
         auto global = configuration.store().get(address);
-        configuration.stack().push(Value(global->value()));
+        configuration.stack().push(global->value().raw());
         return;
     }
     case Instructions::global_set.value(): {
         auto global_index = instruction.arguments().get<GlobalIndex>();
         TRAP_IF_NOT(configuration.frame().module().globals().size() > global_index.value());
         auto address = configuration.frame().module().globals()[global_index.value()];
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto entry = configuration.stack().pop();
-        TRAP_IF_NOT(entry.has<Value>());
-        auto value = entry.get<Value>();
         dbgln_if(WASM_TRACE_DEBUG, "stack -> global({})", address.value());
         auto global = configuration.store().get(address);
-        global->set_value(move(value));
+        global->set_value(Value::from_raw(global->value().type(), configuration.stack().pop()));
         return;
     }
     case Instructions::memory_size.value(): {
@@ -737,7 +595,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto instance = configuration.store().get(address);
         auto pages = instance->size() / Constants::page_size;
         dbgln_if(WASM_TRACE_DEBUG, "memory.size -> stack({})", pages);
-        configuration.stack().push(Value((i32)pages));
+        configuration.stack().push(static_cast<i32>(pages));
         return;
     }
     case Instructions::memory_grow.value(): {
@@ -745,16 +603,12 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto address = configuration.frame().module().memories()[0];
         auto instance = configuration.store().get(address);
         i32 old_pages = instance->size() / Constants::page_size;
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto& entry = configuration.stack().peek();
-        TRAP_IF_NOT(entry.has<Value>());
-        auto new_pages = entry.get<Value>().to<i32>();
-        TRAP_IF_NOT(new_pages.has_value());
-        dbgln_if(WASM_TRACE_DEBUG, "memory.grow({}), previously {} pages...", *new_pages, old_pages);
-        if (instance->grow(new_pages.value() * Constants::page_size))
-            configuration.stack().peek() = Value((i32)old_pages);
+        auto new_pages = configuration.stack().peek<i32>();
+        dbgln_if(WASM_TRACE_DEBUG, "memory.grow({}), previously {} pages...", new_pages, old_pages);
+        if (instance->grow(new_pages * Constants::page_size))
+            configuration.stack().replace_top(old_pages);
         else
-            configuration.stack().peek() = Value((i32)-1);
+            configuration.stack().replace_top(static_cast<i32>(-1));
         return;
     }
     case Instructions::table_get.value():
@@ -763,7 +617,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::ref_null.value(): {
         auto type = instruction.arguments().get<ValueType>();
         TRAP_IF_NOT(type.is_reference());
-        configuration.stack().push(Value(Reference(Reference::Null { type })));
+        configuration.stack().push(Value::null_reference);
         return;
     };
     case Instructions::ref_func.value(): {
@@ -771,38 +625,25 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto& functions = configuration.frame().module().functions();
         TRAP_IF_NOT(functions.size() > index);
         auto address = functions[index];
-        configuration.stack().push(Value(ValueType(ValueType::FunctionReference), address.value()));
+        configuration.stack().push(address.value());
         return;
     }
     case Instructions::ref_is_null.value(): {
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto top = configuration.stack().peek().get_pointer<Value>();
-        TRAP_IF_NOT(top);
-        TRAP_IF_NOT(top->type().is_reference());
-        auto is_null = top->to<Reference::Null>().has_value();
-        configuration.stack().peek() = Value(ValueType(ValueType::I32), static_cast<u64>(is_null ? 1 : 0));
+        auto is_null = configuration.stack().peek() == Value::null_reference;
+        configuration.stack().replace_top(static_cast<i32>(is_null ? 1 : 0));
         return;
     }
     case Instructions::drop.value():
-        TRAP_IF_NOT(!configuration.stack().is_empty());
         configuration.stack().pop();
         return;
     case Instructions::select.value():
     case Instructions::select_typed.value(): {
         // Note: The type seems to only be used for validation.
-        TRAP_IF_NOT(!configuration.stack().is_empty());
-        auto entry = configuration.stack().pop();
-        TRAP_IF_NOT(entry.has<Value>());
-        auto value = entry.get<Value>().to<i32>();
-        TRAP_IF_NOT(value.has_value());
-        dbgln_if(WASM_TRACE_DEBUG, "select({})", value.value());
-        auto rhs_entry = configuration.stack().pop();
-        TRAP_IF_NOT(rhs_entry.has<Value>());
-        auto& lhs_entry = configuration.stack().peek();
-        TRAP_IF_NOT(lhs_entry.has<Value>());
-        auto rhs = move(rhs_entry.get<Value>());
-        auto lhs = move(lhs_entry.get<Value>());
-        configuration.stack().peek() = value.value() != 0 ? move(lhs) : move(rhs);
+        auto value = configuration.stack().pop<i32>();
+        dbgln_if(WASM_TRACE_DEBUG, "select({})", value);
+        auto rhs = configuration.stack().pop();
+        if (value == 0)
+            configuration.stack().replace_top(rhs);
         return;
     }
     case Instructions::i32_eqz.value():
@@ -886,13 +727,13 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::i32_mul.value():
         BINARY_NUMERIC_OPERATION(i32, *, i32);
     case Instructions::i32_divs.value():
-        BINARY_NUMERIC_OPERATION(i32, /, i32, TRAP_IF_NOT(!(Checked<i32>(lhs.value()) /= rhs.value()).has_overflow()));
+        BINARY_NUMERIC_OPERATION(i32, /, i32, TRAP_IF_NOT(!(Checked<i32>(lhs) /= rhs).has_overflow()));
     case Instructions::i32_divu.value():
-        BINARY_NUMERIC_OPERATION(u32, /, i32, TRAP_IF_NOT(rhs.value() != 0));
+        BINARY_NUMERIC_OPERATION(u32, /, i32, TRAP_IF_NOT(rhs != 0));
     case Instructions::i32_rems.value():
-        BINARY_NUMERIC_OPERATION(i32, %, i32, TRAP_IF_NOT(!(Checked<i32>(lhs.value()) /= rhs.value()).has_overflow()));
+        BINARY_NUMERIC_OPERATION(i32, %, i32, TRAP_IF_NOT(!(Checked<i32>(lhs) /= rhs).has_overflow()));
     case Instructions::i32_remu.value():
-        BINARY_NUMERIC_OPERATION(u32, %, i32, TRAP_IF_NOT(rhs.value() != 0));
+        BINARY_NUMERIC_OPERATION(u32, %, i32, TRAP_IF_NOT(rhs != 0));
     case Instructions::i32_and.value():
         BINARY_NUMERIC_OPERATION(i32, &, i32);
     case Instructions::i32_or.value():
@@ -922,13 +763,13 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::i64_mul.value():
         BINARY_NUMERIC_OPERATION(i64, *, i64);
     case Instructions::i64_divs.value():
-        OVF_CHECKED_BINARY_NUMERIC_OPERATION(i64, /, i64, TRAP_IF_NOT(rhs.value() != 0));
+        OVF_CHECKED_BINARY_NUMERIC_OPERATION(i64, /, i64, TRAP_IF_NOT(rhs != 0));
     case Instructions::i64_divu.value():
-        OVF_CHECKED_BINARY_NUMERIC_OPERATION(u64, /, i64, TRAP_IF_NOT(rhs.value() != 0));
+        OVF_CHECKED_BINARY_NUMERIC_OPERATION(u64, /, i64, TRAP_IF_NOT(rhs != 0));
     case Instructions::i64_rems.value():
-        BINARY_NUMERIC_OPERATION(i64, %, i64, TRAP_IF_NOT(!(Checked<i32>(lhs.value()) /= rhs.value()).has_overflow()));
+        BINARY_NUMERIC_OPERATION(i64, %, i64, TRAP_IF_NOT(!(Checked<i32>(lhs) /= rhs).has_overflow()));
     case Instructions::i64_remu.value():
-        BINARY_NUMERIC_OPERATION(u64, %, i64, TRAP_IF_NOT(rhs.value() != 0));
+        BINARY_NUMERIC_OPERATION(u64, %, i64, TRAP_IF_NOT(rhs != 0));
     case Instructions::i64_and.value():
         BINARY_NUMERIC_OPERATION(i64, &, i64);
     case Instructions::i64_or.value():
@@ -18,6 +18,9 @@ struct BytecodeInterpreter : public Interpreter {
     virtual String trap_reason() const override { return m_trap.value().reason; }
     virtual void clear_trap() override { m_trap.clear(); }
 
+    // The number of instructions executed by this interpreter so far, across all calls.
+    u64 executed_instructions() const { return m_executed_instructions; }
+
     struct CallFrameHandle {
         explicit CallFrameHandle(BytecodeInterpreter& interpreter, Configuration& configuration)
             : m_configuration_handle(configuration)
@@ -33,7 +36,7 @@ struct BytecodeInterpreter : public Interpreter {
 
 protected:
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&);
-    void branch_to_label(Configuration&, LabelIndex);
+    void branch_to(Configuration&, BranchTarget const&);
     template<typename ReadT, typename PushT>
     void load_and_push(Configuration&, Instruction const&);
     void store_to_memory(Configuration&, Instruction const&, ReadonlyBytes data);
@@ -48,7 +51,6 @@ protected:
     template<typename T>
     T read_value(ReadonlyBytes data);
 
-    Vector<Value> pop_values(Configuration& configuration, size_t count);
     bool trap_if_not(bool value, StringView reason)
     {
         if (!value)
@@ -57,6 +59,7 @@ protected:
     }
 
     Optional<Trap> m_trap;
+    u64 m_executed_instructions { 0 };
 };
 
 struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
@@ -10,30 +10,14 @@
 
 namespace Wasm {
 
-Optional<Label> Configuration::nth_label(size_t i)
-{
-    for (size_t index = m_stack.size(); index > 0; --index) {
-        auto& entry = m_stack.entries()[index - 1];
-        if (auto ptr = entry.get_pointer<Label>()) {
-            if (i == 0)
-                return *ptr;
-            --i;
-        }
-    }
-    return {};
-}
-
 void Configuration::unwind(Badge<CallFrameHandle>, CallFrameHandle const& frame_handle)
 {
-    if (m_stack.size() == frame_handle.stack_size && frame_handle.frame_index == m_current_frame_index)
-        return;
-
-    VERIFY(m_stack.size() > frame_handle.stack_size);
-    m_stack.entries().remove(frame_handle.stack_size, m_stack.size() - frame_handle.stack_size);
-    m_current_frame_index = frame_handle.frame_index;
+    VERIFY(m_frames.size() >= frame_handle.frame_count);
+    VERIFY(m_stack.size() >= frame_handle.stack_size);
+    m_frames.shrink(frame_handle.frame_count, true);
+    m_stack.shrink(frame_handle.stack_size);
     m_depth--;
     m_ip = frame_handle.ip;
-    VERIFY(m_stack.size() == frame_handle.stack_size);
 }
 
 Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Vector<Value> arguments)
@@ -47,13 +31,14 @@ Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Ve
         for (auto& value : arguments)
             locals.append(Value { value });
         for (auto& type : wasm_function->code().locals())
-            locals.empend(type, 0ull);
+            locals.append(Value::from_raw(type, type.is_reference() ? Value::null_reference : 0));
 
         set_frame(Frame {
             wasm_function->module(),
             move(locals),
             wasm_function->code().body(),
-            wasm_function->type().results().size(),
+            wasm_function->type().results(),
+            &wasm_function->control_flow(),
         });
         m_ip = 0;
         return execute(interpreter);
@@ -70,17 +55,16 @@ Result Configuration::execute(Interpreter& interpreter)
     if (interpreter.did_trap())
         return Trap { interpreter.trap_reason() };
 
-    if (stack().size() <= frame().arity() + 1)
+    auto& result_types = frame().result_types();
+    if (stack().size() < frame().stack_base() + result_types.size())
         return Trap { "Not enough values to return from call" };
 
     Vector<Value> results;
-    results.ensure_capacity(frame().arity());
-    for (size_t i = 0; i < frame().arity(); ++i)
-        results.append(move(stack().pop().get<Value>()));
-    auto label = stack().pop();
-    // ASSERT: label == current frame
-    if (!label.has<Label>())
-        return Trap { "Invalid stack configuration" };
+    results.ensure_capacity(result_types.size());
+    auto first_result = stack().size() - result_types.size();
+    for (size_t i = 0; i < result_types.size(); ++i)
+        results.unchecked_append(Value::from_raw(result_types[i], stack().entries()[first_result + i]));
+    stack().shrink(first_result);
     return Result { move(results) };
 }
 
@@ -92,20 +76,16 @@ void Configuration::dump_stack()
         Printer { memory_stream }.print(vs...);
         dbgln(format.view(), StringView(memory_stream.copy_into_contiguous_buffer()).trim_whitespace());
     };
-    for (auto const& entry : stack().entries()) {
-        entry.visit(
-            [&](Value const& v) {
-                print_value("    {}", v);
-            },
-            [&](Frame const& f) {
-                dbgln("    frame({})", f.arity());
-                for (auto& local : f.locals()) {
-                    print_value("        {}", local);
-                }
-            },
-            [](Label const& l) {
-                dbgln("    label({}) -> {}", l.arity(), l.continuation());
-            });
+    size_t next_frame = 0;
+    for (size_t i = 0; i <= stack().size(); ++i) {
+        for (; next_frame < m_frames.size() && m_frames[next_frame].stack_base() == i; ++next_frame) {
+            auto& frame = m_frames[next_frame];
+            dbgln("    frame({})", frame.arity());
+            for (auto& local : frame.locals())
+                print_value("        {}", local);
+        }
+        if (i < stack().size())
+            dbgln("    {:#x}", stack().entries()[i]);
     }
 }
 
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+#include <LibWasm/AbstractMachine/ControlFlowTable.h>
+#include <LibWasm/Opcode.h>
+#include <LibWasm/Printer/Printer.h>
+
+namespace Wasm {
+
+struct StackEffect {
+    size_t pops { 0 };
+    size_t pushes { 0 };
+};
+
+// The operand stack effect of every instruction that does not depend on its arguments or on the module.
+static Optional<StackEffect> fixed_stack_effect(OpCode opcode)
+{
+    switch (opcode.value()) {
+    case Instructions::nop.value():
+    case Instructions::data_drop.value():
+    case Instructions::elem_drop.value():
+        return StackEffect { 0, 0 };
+    case Instructions::drop.value():
+    case Instructions::local_set.value():
+    case Instructions::global_set.value():
+        return StackEffect { 1, 0 };
+    case Instructions::select.value():
+    case Instructions::select_typed.value():
+        return StackEffect { 3, 1 };
+    case Instructions::local_get.value():
+    case Instructions::global_get.value():
+    case Instructions::memory_size.value():
+    case Instructions::i32_const.value():
+    case Instructions::i64_const.value():
+    case Instructions::f32_const.value():
+    case Instructions::f64_const.value():
+    case Instructions::ref_null.value():
+    case Instructions::ref_func.value():
+    case Instructions::table_size.value():
+        return StackEffect { 0, 1 };
+    case Instructions::local_tee.value():
+    case Instructions::memory_grow.value():
+    case Instructions::ref_is_null.value():
+    case Instructions::table_get.value():
+    case Instructions::i32_trunc_sat_f32_s.value():
+    case Instructions::i32_trunc_sat_f32_u.value():
+    case Instructions::i32_trunc_sat_f64_s.value():
+    case Instructions::i32_trunc_sat_f64_u.value():
+    case Instructions::i64_trunc_sat_f32_s.value():
+    case Instructions::i64_trunc_sat_f32_u.value():
+    case Instructions::i64_trunc_sat_f64_s.value():
+    case Instructions::i64_trunc_sat_f64_u.value():
+        return StackEffect { 1, 1 };
+    case Instructions::table_set.value():
+        return StackEffect { 2, 0 };
+    case Instructions::table_grow.value():
+        return StackEffect { 2, 1 };
+    case Instructions::memory_init.value():
+    case Instructions::memory_copy.value():
+    case Instructions::memory_fill.value():
+    case Instructions::table_init.value():
+    case Instructions::table_copy.value():
+    case Instructions::table_fill.value():
+        return StackEffect { 3, 0 };
+    default:
+        break;
+    }
+
+    auto in_range = [&](OpCode first, OpCode last) { return opcode >= first && opcode <= last; };
+
+    if (in_range(Instructions::i32_load, Instructions::i64_load32_u))
+        return StackEffect { 1, 1 };
+    if (in_range(Instructions::i32_store, Instructions::i64_store32))
+        return StackEffect { 2, 0 };
+
+    // Tests, unary numeric operations and conversions.
+    if (opcode == Instructions::i32_eqz
+        || opcode == Instructions::i64_eqz
+        || in_range(Instructions::i32_clz, Instructions::i32_popcnt)
+        || in_range(Instructions::i64_clz, Instructions::i64_popcnt)
+        || in_range(Instructions::f32_abs, Instructions::f32_sqrt)
+        || in_range(Instructions::f64_abs, Instructions::f64_sqrt)
+        || in_range(Instructions::i32_wrap_i64, Instructions::i64_extend32_s))
+        return StackEffect { 1, 1 };
+
+    // Comparisons and binary numeric operations.
+    if (in_range(Instructions::i32_eq, Instructions::i32_geu)
+        || in_range(Instructions::i64_eq, Instructions::f64_ge)
+        || in_range(Instructions::i32_add, Instructions::i32_rotr)
+        || in_range(Instructions::i64_add, Instructions::i64_rotr)
+        || in_range(Instructions::f32_add, Instructions::f32_copysign)
+        || in_range(Instructions::f64_add, Instructions::f64_copysign))
+        return StackEffect { 2, 1 };
+
+    return {};
+}
+
+AK::Result<ControlFlowTable, String> ControlFlowTable::create(Expression const& body, FunctionType const& type, Vector<FunctionType> const& types, Vector<FunctionType const*> const& function_types)
+{
+    struct Block {
+        enum class Kind {
+            Function,
+            Block,
+            Loop,
+            If,
+        };
+
+        Kind kind { Kind::Function };
+        size_t start_ip { 0 };
+        // The height of the operand stack when the block was entered, without its parameters.
+        size_t stack_height { 0 };
+        size_t parameter_count { 0 };
+        size_t result_count { 0 };
+        // Set after an unconditional branch, anything can be popped from here on until the block ends.
+        bool unreachable { false };
+        // Targets that point to the end of this block, to be resolved once the end is found.
+        Vector<size_t> forward_targets;
+        // The target that `if` takes when its condition is false.
+        Optional<size_t> else_target;
+    };
+
+    auto& instructions = body.instructions();
+    ControlFlowTable table;
+    table.m_first_target.resize(instructions.size());
+
+    Vector<Block, 16> blocks;
+    blocks.append(Block { Block::Kind::Function, 0, 0, 0, type.results().size(), false, {}, {} });
+    size_t stack_height = 0;
+
+    auto pop = [&](size_t count) {
+        auto& block = blocks.last();
+        if (stack_height - block.stack_height < count) {
+            if (!block.unreachable)
+                return false;
+            stack_height = block.stack_height;
+            return true;
+        }
+        stack_height -= count;
+        return true;
+    };
+
+    auto make_unreachable = [&] {
+        stack_height = blocks.last().stack_height;
+        blocks.last().unreachable = true;
+    };
+
+    auto block_arity = [&](BlockType const& block_type, size_t& parameter_count, size_t& result_count) {
+        switch (block_type.kind()) {
+        case BlockType::Empty:
+            parameter_count = 0;
+            result_count = 0;
+            return true;
+        case BlockType::Type:
+            parameter_count = 0;
+            result_count = 1;
+            return true;
+        case BlockType::Index: {
+            auto index = block_type.type_index().value();
+            if (index >= types.size())
+                return false;
+            parameter_count = types[index].parameters().size();
+            result_count = types[index].results().size();
+            return true;
+        }
+        }
+        VERIFY_NOT_REACHED();
+    };
+
+    auto add_target = [&](BranchTarget target) {
+        table.m_targets.append(target);
+        return table.m_targets.size() - 1;
+    };
+
+    // Appends the target of a branch to the label with the given depth, after checking that its values are on the stack.
+    auto add_branch_target = [&](LabelIndex label) -> Optional<String> {
+        if (label.value() >= blocks.size())
+            return String::formatted("Branch to nonexistent label {}", label.value());
+        auto& block = blocks[blocks.size() - label.value() - 1];
+        BranchTarget target;
+        target.stack_height = block.stack_height;
+        target.arity = block.kind == Block::Kind::Loop ? block.parameter_count : block.result_count;
+        if (!blocks.last().unreachable && stack_height - blocks.last().stack_height < target.arity)
+            return String::formatted("Branch to label {} with too few values on the stack", label.value());
+
+        switch (block.kind) {
+        case Block::Kind::Function:
+            target.ip = instructions.size();
+            add_target(target);
+            break;
+        case Block::Kind::Loop:
+            target.ip = block.start_ip;
+            add_target(target);
+            break;
+        case Block::Kind::Block:
+        case Block::Kind::If:
+            block.forward_targets.append(add_target(target));
+            break;
+        }
+        return {};
+    };
+
+    // Checks that exactly the results of the innermost block are left on the stack when falling through its end.
+    auto check_block_results = [&]() -> bool {
+        auto& block = blocks.last();
+        if (block.unreachable)
+            return true;
+        return stack_height == block.stack_height + block.result_count;
+    };
+
+    for (size_t ip = 0; ip < instructions.size(); ++ip) {
+        auto& instruction = instructions[ip];
+        auto opcode = instruction.opcode();
+        table.m_first_target[ip] = table.m_targets.size();
+
+        auto error = [&](StringView reason) {
+            return String::formatted("{} at {} (instruction {})", reason, instruction_name(opcode), ip);
+        };
+
+        switch (opcode.value()) {
+        case Instructions::block.value():
+        case Instructions::loop.value():
+        case Instructions::if_.value(): {
+            auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
+            size_t parameter_count;
+            size_t result_count;
+            if (!block_arity(args.block_type, parameter_count, result_count))
+                return error("Invalid block type");
+            if (opcode == Instructions::if_ && !pop(1))
+                return error("Stack underflow");
+            if (!pop(parameter_count))
+                return error("Stack underflow");
+
+            auto kind = opcode == Instructions::block ? Block::Kind::Block : (opcode == Instructions::loop ? Block::Kind::Loop : Block::Kind::If);
+            Block block { kind, ip, stack_height, parameter_count, result_count, false, {}, {} };
+            if (kind == Block::Kind::If)
+                block.else_target = add_target({});
+            blocks.append(move(block));
+            stack_height += parameter_count;
+            break;
+        }
+        case Instructions::structured_else.value(): {
+            auto& block = blocks.last();
+            if (block.kind != Block::Kind::If || !block.else_target.has_value())
+                return error("Else outside of an if block");
+            if (!check_block_results())
+                return error("Wrong number of values at the end of the block");
+            table.m_targets[block.else_target.release_value()].ip = ip + 1;
+            // The end of the `then` branch jumps over the else branch.
+            block.forward_targets.append(add_target({}));
+            stack_height = block.stack_height + block.parameter_count;
+            block.unreachable = false;
+            break;
+        }
+        case Instructions::structured_end.value(): {
+            if (blocks.size() <= 1)
+                return error("End outside of a block");
+            if (!check_block_results())
+                return error("Wrong number of values at the end of the block");
+            auto block = blocks.take_last();
+            if (block.else_target.has_value()) {
+                // An if without an else must leave its parameters as its results.
+                if (block.parameter_count != block.result_count)
+                    return error("If without else changes the stack height");
+                table.m_targets[block.else_target.value()].ip = ip + 1;
+            }
+            for (auto index : block.forward_targets)
+                table.m_targets[index].ip = ip + 1;
+            stack_height = block.stack_height + block.result_count;
+            break;
+        }
+        case Instructions::unreachable.value():
+            make_unreachable();
+            break;
+        case Instructions::br.value():
+            if (auto result = add_branch_target(instruction.arguments().get<LabelIndex>()); result.has_value())
+                return error(*result);
+            make_unreachable();
+            break;
+        case Instructions::br_if.value():
+            if (!pop(1))
+                return error("Stack underflow");
+            if (auto result = add_branch_target(instruction.arguments().get<LabelIndex>()); result.has_value())
+                return error(*result);
+            break;
+        case Instructions::br_table.value(): {
+            if (!pop(1))
+                return error("Stack underflow");
+            auto& args = instruction.arguments().get<Instruction::TableBranchArgs>();
+            for (auto& label : args.labels) {
+                if (auto result = add_branch_target(label); result.has_value())
+                    return error(*result);
+            }
+            if (auto result = add_branch_target(args.default_); result.has_value())
+                return error(*result);
+            make_unreachable();
+            break;
+        }
+        case Instructions::return_.value():
+            if (auto result = add_branch_target(LabelIndex { blocks.size() - 1 }); result.has_value())
+                return error(*result);
+            make_unreachable();
+            break;
+        case Instructions::call.value(): {
+            auto index = instruction.arguments().get<FunctionIndex>().value();
+            if (index >= function_types.size())
+                return error("Call to nonexistent function");
+            if (!pop(function_types[index]->parameters().size()))
+                return error("Stack underflow");
+            stack_height += function_types[index]->results().size();
+            break;
+        }
+        case Instructions::call_indirect.value(): {
+            auto index = instruction.arguments().get<Instruction::IndirectCallArgs>().type.value();
+            if (index >= types.size())
+                return error("Indirect call with nonexistent type");
+            if (!pop(1) || !pop(types[index].parameters().size()))
+                return error("Stack underflow");
+            stack_height += types[index].results().size();
+            break;
+        }
+        default: {
+            auto effect = fixed_stack_effect(opcode);
+            if (!effect.has_value())
+                return error("Unknown instruction");
+            if (!pop(effect->pops))
+                return error("Stack underflow");
+            stack_height += effect->pushes;
+            break;
+        }
+        }
+
+        if (stack_height > NumericLimits<u32>::max())
+            return error("Operand stack too deep");
+    }
+
+    if (blocks.size() != 1)
+        return String::formatted("Function body ends inside of {} unterminated block(s)", blocks.size() - 1);
+    if (!check_block_results())
+        return String { "Wrong number of values at the end of the function" };
+
+    return table;
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Result.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibWasm/Types.h>
+
+namespace Wasm {
+
+struct BranchTarget {
+    // The instruction to continue at.
+    InstructionPointer ip { 0 };
+    // The operand stack height of the targeted label, relative to the start of the frame.
+    u32 stack_height { 0 };
+    // The number of values carried over to the label.
+    u32 arity { 0 };
+};
+
+// The control flow of a function body, resolved once when the module is instantiated.
+// Every branching instruction (br, br_if, br_table, return, if and else) knows exactly where it goes
+// and how many operands it leaves on the stack, so taking a branch is a jump plus one stack truncation,
+// and structured instructions never have to push or look up labels at runtime.
+class ControlFlowTable {
+public:
+    // `function_types` is the type of every function in the module's function index space, imports first.
+    static AK::Result<ControlFlowTable, String> create(Expression const&, FunctionType const&, Vector<FunctionType> const& types, Vector<FunctionType const*> const& function_types);
+
+    BranchTarget const& target(InstructionPointer ip) const { return m_targets[m_first_target[ip.value()]]; }
+
+    // br_table stores the targets of its labels followed by the default one.
+    Span<BranchTarget const> table_targets(InstructionPointer ip, size_t count) const { return m_targets.span().slice(m_first_target[ip.value()], count); }
+
+private:
+    ControlFlowTable() = default;
+
+    Vector<u32> m_first_target;
+    Vector<BranchTarget> m_targets;
+};
+
+}
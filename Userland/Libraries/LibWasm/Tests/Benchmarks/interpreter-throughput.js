@@ -0,0 +1,105 @@
+// Measures how many instructions per second the interpreter gets through on a few typical workloads.
+// The results are logged, the expectations only make sure that the workloads computed the right thing.
+
+// (module
+//   (memory 1)
+//   (func (export "loop") (param $n i32) (result i32) (local $i i32) (local $sum i32)
+//     (block (loop
+//       (br_if 1 (i32.ge_u (local.get $i) (local.get $n)))
+//       (local.set $sum (i32.add (local.get $sum) (local.get $i)))
+//       (local.set $i (i32.add (local.get $i) (i32.const 1)))
+//       (br 0)))
+//     (local.get $sum))
+//   (func $fib (export "fib") (param i32) (result i32)
+//     (if (result i32) (i32.lt_s (local.get 0) (i32.const 2))
+//       (then (local.get 0))
+//       (else (i32.add (call $fib (i32.sub (local.get 0) (i32.const 1))) (call $fib (i32.sub (local.get 0) (i32.const 2)))))))
+//   (func (export "stateMachine") (param $n i32) (result i32) (local $state i32) (local $i i32) (local $acc i32)
+//     (block (loop
+//       (br_if 1 (i32.ge_u (local.get $i) (local.get $n)))
+//       (local.set $i (i32.add (local.get $i) (i32.const 1)))
+//       (block (block (block (block (br_table 0 1 2 3 (local.get $state)))
+//         (local.set $acc (i32.add (local.get $acc) (i32.const 1))) (local.set $state (i32.const 1)) (br 3))
+//         (local.set $acc (i32.mul (local.get $acc) (i32.const 3))) (local.set $state (i32.const 2)) (br 2))
+//         (local.set $acc (i32.xor (local.get $acc) (local.get $i))) (local.set $state (i32.const 0)) (br 1))
+//       (unreachable)))
+//     (local.get $acc))
+//   (func (export "memory") (param $n i32) (result i32) (local $i i32) (local $sum i32) (local $address i32)
+//     (block (loop
+//       (br_if 1 (i32.ge_u (local.get $i) (local.get $n)))
+//       (i32.store (local.tee $address (i32.shl (i32.and (local.get $i) (i32.const 16383)) (i32.const 2)))
+//         (i32.mul (local.get $i) (local.get $i)))
+//       (local.set $sum (i32.add (local.get $sum) (i32.load (local.get $address))))
+//       (local.set $i (i32.add (local.get $i) (i32.const 1)))
+//       (br 0)))
+//     (local.get $sum)))
+// prettier-ignore
+const benchmarkModule = new Uint8Array([
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x03, 0x05, 0x04, 0x00, 0x00, 0x00, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x26, 0x04, 0x04,
+    0x6c, 0x6f, 0x6f, 0x70, 0x00, 0x00, 0x03, 0x66, 0x69, 0x62, 0x00, 0x01, 0x0c, 0x73, 0x74, 0x61,
+    0x74, 0x65, 0x4d, 0x61, 0x63, 0x68, 0x69, 0x6e, 0x65, 0x00, 0x02, 0x06, 0x6d, 0x65, 0x6d, 0x6f,
+    0x72, 0x79, 0x00, 0x03, 0x0a, 0xd4, 0x01, 0x04, 0x23, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40,
+    0x20, 0x01, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01, 0x6a, 0x21, 0x02, 0x20, 0x01,
+    0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x1c, 0x00, 0x20, 0x00,
+    0x41, 0x02, 0x48, 0x04, 0x7f, 0x20, 0x00, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x10, 0x01, 0x20,
+    0x00, 0x41, 0x02, 0x6b, 0x10, 0x01, 0x6a, 0x0b, 0x0b, 0x56, 0x01, 0x03, 0x7f, 0x02, 0x40, 0x03,
+    0x40, 0x20, 0x02, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x20, 0x02, 0x41, 0x01, 0x6a, 0x21, 0x02, 0x02,
+    0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x20, 0x01, 0x0e, 0x03, 0x00, 0x01, 0x02, 0x03, 0x0b,
+    0x20, 0x03, 0x41, 0x01, 0x6a, 0x21, 0x03, 0x41, 0x01, 0x21, 0x01, 0x0c, 0x03, 0x0b, 0x20, 0x03,
+    0x41, 0x03, 0x6c, 0x21, 0x03, 0x41, 0x02, 0x21, 0x01, 0x0c, 0x02, 0x0b, 0x20, 0x03, 0x20, 0x02,
+    0x73, 0x21, 0x03, 0x41, 0x00, 0x21, 0x01, 0x0c, 0x01, 0x0b, 0x00, 0x0b, 0x0b, 0x20, 0x03, 0x0b,
+    0x3a, 0x01, 0x03, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x20,
+    0x01, 0x41, 0xff, 0xff, 0x00, 0x71, 0x41, 0x02, 0x74, 0x22, 0x03, 0x20, 0x01, 0x20, 0x01, 0x6c,
+    0x36, 0x02, 0x00, 0x20, 0x02, 0x20, 0x03, 0x28, 0x02, 0x00, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41,
+    0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b,
+]);
+
+let module = null;
+
+const benchmark = (name, ...args) => {
+    if (!module) module = parseWebAssemblyModule(benchmarkModule);
+    const instructionsBefore = executedWasmInstructionCount();
+    const start = Date.now();
+    const result = module.invoke(module.getExport(name), ...args);
+    const elapsed = Math.max(Date.now() - start, 1);
+    const instructions = executedWasmInstructionCount() - instructionsBefore;
+    const instructionsPerSecond = Math.round((instructions * 1000) / elapsed);
+    console.log(`${name}: ${instructions} instructions in ${Math.round(elapsed)}ms, ${instructionsPerSecond} instructions/s`);
+    return result;
+};
+
+test("arithmetic loop", () => {
+    const n = 200000;
+    expect(benchmark("loop", n)).toBe(((n * (n - 1)) / 2) | 0);
+});
+
+test("recursive calls", () => {
+    expect(benchmark("fib", 20)).toBe(6765);
+});
+
+test("br_table dispatch", () => {
+    const n = 100000;
+    let state = 0;
+    let acc = 0;
+    for (let i = 1; i <= n; ++i) {
+        if (state === 0) {
+            acc = (acc + 1) | 0;
+            state = 1;
+        } else if (state === 1) {
+            acc = Math.imul(acc, 3);
+            state = 2;
+        } else {
+            acc = acc ^ i;
+            state = 0;
+        }
+    }
+    expect(benchmark("stateMachine", n)).toBe(acc);
+});
+
+test("memory loads and stores", () => {
+    const n = 100000;
+    let sum = 0;
+    for (let i = 0; i < n; ++i) sum = (sum + Math.imul(i, i)) | 0;
+    expect(benchmark("memory", n)).toBe(sum);
+});
@@ -0,0 +1,136 @@
+// (module
+//   (func (export "factorial") (param $n i64) (result i64) (local $acc i64)
+//     (local.set $acc (i64.const 1))
+//     (block (loop
+//       (br_if 1 (i64.le_s (local.get $n) (i64.const 1)))
+//       (local.set $acc (i64.mul (local.get $acc) (local.get $n)))
+//       (local.set $n (i64.sub (local.get $n) (i64.const 1)))
+//       (br 0)))
+//     (local.get $acc))
+//   (func (export "branchWithValue") (param i32) (result i32)
+//     (i32.add (i32.const 99) (block (result i32) (i32.const 5) (local.get 0) (br 0))))
+//   (func (export "dispatch") (param i32) (result i32)
+//     (block (block (block (block (br_table 0 1 2 3 (local.get 0)))
+//       (return (i32.const 10)))
+//       (return (i32.const 20)))
+//       (return (i32.const 30)))
+//     (i32.const 40))
+//   (func (export "sign") (param i32) (result i32)
+//     (if (result i32) (i32.lt_s (local.get 0) (i32.const 0))
+//       (then (i32.const -1))
+//       (else (if (result i32) (i32.eqz (local.get 0)) (then (i32.const 0)) (else (i32.const 1))))))
+//   (func (export "clampToTen") (param i32) (result i32)
+//     (if (i32.gt_s (local.get 0) (i32.const 10)) (then (local.set 0 (i32.const 10))))
+//     (local.get 0))
+//   (func (export "firstMultipleFrom") (param $n i32) (param $k i32) (result i32)
+//     (loop
+//       (if (i32.eqz (i32.rem_u (local.get $n) (local.get $k))) (then (return (local.get $n))))
+//       (local.set $n (i32.add (local.get $n) (i32.const 1)))
+//       (br 0))
+//     (unreachable))
+//   (func $fib (export "fib") (param i32) (result i32)
+//     (if (result i32) (i32.lt_s (local.get 0) (i32.const 2))
+//       (then (local.get 0))
+//       (else (i32.add (call $fib (i32.sub (local.get 0) (i32.const 1))) (call $fib (i32.sub (local.get 0) (i32.const 2)))))))
+//   (func (export "breakOuter") (param $n i32) (result i32) (local $count i32)
+//     (block (result i32)
+//       (loop
+//         (if (i32.ge_s (local.tee $count (i32.add (local.get $count) (i32.const 1))) (local.get $n))
+//           (then (br 2 (i32.add (local.get $count) (i32.const 1000)))))
+//         (br 0))
+//       (i32.const -1))))
+// prettier-ignore
+const controlFlowModule = new Uint8Array([
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x11, 0x03, 0x60, 0x01, 0x7e, 0x01, 0x7e,
+    0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x09, 0x08, 0x00, 0x01,
+    0x01, 0x01, 0x01, 0x02, 0x01, 0x01, 0x07, 0x65, 0x08, 0x09, 0x66, 0x61, 0x63, 0x74, 0x6f, 0x72,
+    0x69, 0x61, 0x6c, 0x00, 0x00, 0x0f, 0x62, 0x72, 0x61, 0x6e, 0x63, 0x68, 0x57, 0x69, 0x74, 0x68,
+    0x56, 0x61, 0x6c, 0x75, 0x65, 0x00, 0x01, 0x08, 0x64, 0x69, 0x73, 0x70, 0x61, 0x74, 0x63, 0x68,
+    0x00, 0x02, 0x04, 0x73, 0x69, 0x67, 0x6e, 0x00, 0x03, 0x0a, 0x63, 0x6c, 0x61, 0x6d, 0x70, 0x54,
+    0x6f, 0x54, 0x65, 0x6e, 0x00, 0x04, 0x11, 0x66, 0x69, 0x72, 0x73, 0x74, 0x4d, 0x75, 0x6c, 0x74,
+    0x69, 0x70, 0x6c, 0x65, 0x46, 0x72, 0x6f, 0x6d, 0x00, 0x05, 0x03, 0x66, 0x69, 0x62, 0x00, 0x06,
+    0x0a, 0x62, 0x72, 0x65, 0x61, 0x6b, 0x4f, 0x75, 0x74, 0x65, 0x72, 0x00, 0x07, 0x0a, 0xe2, 0x01,
+    0x08, 0x27, 0x01, 0x01, 0x7e, 0x42, 0x01, 0x21, 0x01, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00, 0x42,
+    0x01, 0x57, 0x0d, 0x01, 0x20, 0x01, 0x20, 0x00, 0x7e, 0x21, 0x01, 0x20, 0x00, 0x42, 0x01, 0x7d,
+    0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01, 0x0b, 0x0f, 0x00, 0x41, 0xe3, 0x00, 0x02, 0x7f,
+    0x41, 0x05, 0x20, 0x00, 0x0c, 0x00, 0x0b, 0x6a, 0x0b, 0x21, 0x00, 0x02, 0x40, 0x02, 0x40, 0x02,
+    0x40, 0x02, 0x40, 0x20, 0x00, 0x0e, 0x03, 0x00, 0x01, 0x02, 0x03, 0x0b, 0x41, 0x0a, 0x0f, 0x0b,
+    0x41, 0x14, 0x0f, 0x0b, 0x41, 0x1e, 0x0f, 0x0b, 0x41, 0x28, 0x0b, 0x18, 0x00, 0x20, 0x00, 0x41,
+    0x00, 0x48, 0x04, 0x7f, 0x41, 0x7f, 0x05, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x00, 0x05, 0x41,
+    0x01, 0x0b, 0x0b, 0x0b, 0x10, 0x00, 0x20, 0x00, 0x41, 0x0a, 0x4a, 0x04, 0x40, 0x41, 0x0a, 0x21,
+    0x00, 0x0b, 0x20, 0x00, 0x0b, 0x1b, 0x00, 0x03, 0x40, 0x20, 0x00, 0x20, 0x01, 0x70, 0x45, 0x04,
+    0x40, 0x20, 0x00, 0x0f, 0x0b, 0x20, 0x00, 0x41, 0x01, 0x6a, 0x21, 0x00, 0x0c, 0x00, 0x0b, 0x00,
+    0x0b, 0x1c, 0x00, 0x20, 0x00, 0x41, 0x02, 0x48, 0x04, 0x7f, 0x20, 0x00, 0x05, 0x20, 0x00, 0x41,
+    0x01, 0x6b, 0x10, 0x06, 0x20, 0x00, 0x41, 0x02, 0x6b, 0x10, 0x06, 0x6a, 0x0b, 0x0b, 0x23, 0x01,
+    0x01, 0x7f, 0x02, 0x7f, 0x03, 0x40, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x22, 0x01, 0x20, 0x00, 0x4e,
+    0x04, 0x40, 0x20, 0x01, 0x41, 0xe8, 0x07, 0x6a, 0x0c, 0x02, 0x0b, 0x0c, 0x00, 0x0b, 0x41, 0x7f,
+    0x0b, 0x0b,
+]);
+
+let module = null;
+const call = (name, ...args) => {
+    if (!module) module = parseWebAssemblyModule(controlFlowModule);
+    return module.invoke(module.getExport(name), ...args);
+};
+
+test("loops and conditional branches", () => {
+    expect(call("factorial", 1)).toBe(1);
+    expect(call("factorial", 10)).toBe(3628800);
+});
+
+test("branch results replace the rest of the block's operands", () => {
+    expect(call("branchWithValue", 7)).toBe(106);
+});
+
+test("br_table", () => {
+    expect(call("dispatch", 0)).toBe(10);
+    expect(call("dispatch", 1)).toBe(20);
+    expect(call("dispatch", 2)).toBe(30);
+    expect(call("dispatch", 3)).toBe(40);
+    expect(call("dispatch", 1000)).toBe(40);
+    expect(call("dispatch", -1)).toBe(40);
+});
+
+test("if and else", () => {
+    expect(call("sign", -5)).toBe(-1);
+    expect(call("sign", 0)).toBe(0);
+    expect(call("sign", 5)).toBe(1);
+    expect(call("clampToTen", 3)).toBe(3);
+    expect(call("clampToTen", 30)).toBe(10);
+});
+
+test("return from inside a loop", () => {
+    expect(call("firstMultipleFrom", 10, 7)).toBe(14);
+    expect(call("firstMultipleFrom", 21, 7)).toBe(21);
+});
+
+test("recursive calls", () => {
+    expect(call("fib", 0)).toBe(0);
+    expect(call("fib", 15)).toBe(610);
+});
+
+test("branch out of nested blocks with a value", () => {
+    expect(call("breakOuter", 5)).toBe(1005);
+});
+
+test("branch to a nonexistent label", () => {
+    // (module (func (br 1)))
+    // prettier-ignore
+    const binary = new Uint8Array([
+        0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x04, 0x01, 0x60, 0x00, 0x00, 0x03, 0x02,
+        0x01, 0x00, 0x07, 0x05, 0x01, 0x01, 0x66, 0x00, 0x00, 0x0a, 0x06, 0x01, 0x04, 0x00, 0x0c, 0x01,
+        0x0b,
+    ]);
+    expect(() => parseWebAssemblyModule(binary)).toThrowWithMessage(TypeError, "Invalid function body");
+});
+
+test("operand stack underflow", () => {
+    // (module (func (result i32) (i32.add)))
+    // prettier-ignore
+    const binary = new Uint8Array([
+        0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60, 0x00, 0x01, 0x7f, 0x03,
+        0x02, 0x01, 0x00, 0x07, 0x05, 0x01, 0x01, 0x66, 0x00, 0x00, 0x0a, 0x05, 0x01, 0x03, 0x00, 0x6a,
+        0x0b,
+    ]);
+    expect(() => parseWebAssemblyModule(binary)).toThrowWithMessage(TypeError, "Invalid function body");
+});
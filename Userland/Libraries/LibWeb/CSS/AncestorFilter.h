@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/FlyString.h>
+#include <AK/NumericLimits.h>
+#include <AK/Types.h>
+
+namespace Web::CSS {
+
+// A counting Bloom filter of the tag names, ids and classes of the ancestors of the element whose style is
+// being resolved. It can't say for sure that some ancestor has a given class, but it can say for sure that
+// none has, which is enough to reject a selector like ".sidebar a" without walking up the tree.
+class AncestorFilter {
+public:
+    // The same name is hashed differently depending on whether it's a tag name, an id or a class,
+    // so that e.g. "#main" doesn't get mixed up with "main".
+    static u32 hash_for_tag_name(const FlyString& name) { return name.hash() * 13; }
+    static u32 hash_for_id(const FlyString& id) { return id.hash() * 17; }
+    static u32 hash_for_class(const FlyString& name) { return name.hash() * 19; }
+
+    void add(u32 hash)
+    {
+        for (auto index : { first_index(hash), second_index(hash) }) {
+            // A saturated count stays that way, so the filter never forgets something it still contains.
+            if (m_counts[index] != NumericLimits<u8>::max())
+                ++m_counts[index];
+        }
+    }
+
+    void remove(u32 hash)
+    {
+        for (auto index : { first_index(hash), second_index(hash) }) {
+            VERIFY(m_counts[index]);
+            if (m_counts[index] != NumericLimits<u8>::max())
+                --m_counts[index];
+        }
+    }
+
+    bool may_contain(u32 hash) const
+    {
+        return m_counts[first_index(hash)] && m_counts[second_index(hash)];
+    }
+
+private:
+    static constexpr u32 index_bits = 12;
+    static constexpr u32 index_mask = (1 << index_bits) - 1;
+
+    static u32 first_index(u32 hash) { return hash & index_mask; }
+    static u32 second_index(u32 hash) { return (hash >> index_bits) & index_mask; }
+
+    Array<u8, 1 << index_bits> m_counts {};
+};
+
+}
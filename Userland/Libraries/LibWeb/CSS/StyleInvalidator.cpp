@@ -4,52 +4,75 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <LibWeb/CSS/CSSStyleRule.h>
 #include <LibWeb/CSS/StyleInvalidator.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
+#include <LibWeb/HTML/AttributeNames.h>
 
 namespace Web::CSS {
 
-StyleInvalidator::StyleInvalidator(DOM::Document& document)
-    : m_document(document)
+StyleInvalidator::StyleInvalidator(DOM::Element& element, const FlyString& attribute_name)
+    : m_element(element)
+    , m_attribute_name(attribute_name)
+    , m_enabled(element.document().should_invalidate_styles_on_attribute_changes())
 {
-    if (!m_document.should_invalidate_styles_on_attribute_changes())
+    if (!m_enabled)
         return;
-    auto& style_resolver = m_document.style_resolver();
-    m_document.for_each_in_inclusive_subtree_of_type<DOM::Element>([&](auto& element) {
-        m_elements_and_matching_rules_before.set(&element, style_resolver.collect_matching_rules(element));
-        return IterationDecision::Continue;
-    });
+    m_had_attribute = m_element.has_attribute(m_attribute_name);
+    m_old_value = m_element.attribute(m_attribute_name);
+    if (m_attribute_name == HTML::AttributeNames::class_)
+        m_old_class_names = m_element.class_names();
 }
 
 StyleInvalidator::~StyleInvalidator()
 {
-    if (!m_document.should_invalidate_styles_on_attribute_changes())
+    if (!m_enabled)
         return;
-    auto& style_resolver = m_document.style_resolver();
-    m_document.for_each_in_inclusive_subtree_of_type<DOM::Element>([&](auto& element) {
-        auto maybe_matching_rules_before = m_elements_and_matching_rules_before.get(&element);
-        if (!maybe_matching_rules_before.has_value()) {
-            element.set_needs_style_update(true);
-            return IterationDecision::Continue;
+    if (m_element.has_attribute(m_attribute_name) == m_had_attribute && m_element.attribute(m_attribute_name) == m_old_value)
+        return;
+
+    auto& style_resolver = m_element.document().style_resolver();
+    auto invalidation_set = style_resolver.invalidation_set_for_attribute(m_attribute_name);
+
+    if (m_attribute_name == HTML::AttributeNames::class_) {
+        // Only the classes that were added or removed matter.
+        auto& new_class_names = m_element.class_names();
+        for (auto& class_name : m_old_class_names) {
+            if (!new_class_names.contains_slow(class_name))
+                invalidation_set.include(style_resolver.invalidation_set_for_class(class_name));
         }
-        auto& matching_rules_before = maybe_matching_rules_before.value();
-        auto matching_rules_after = style_resolver.collect_matching_rules(element);
-        if (matching_rules_before.size() != matching_rules_after.size()) {
-            element.set_needs_style_update(true);
-            return IterationDecision::Continue;
+        for (auto& class_name : new_class_names) {
+            if (!m_old_class_names.contains_slow(class_name))
+                invalidation_set.include(style_resolver.invalidation_set_for_class(class_name));
         }
-        style_resolver.sort_matching_rules(matching_rules_before);
-        style_resolver.sort_matching_rules(matching_rules_after);
-        for (size_t i = 0; i < matching_rules_before.size(); ++i) {
-            if (matching_rules_before[i].rule != matching_rules_after[i].rule) {
-                element.set_needs_style_update(true);
-                break;
-            }
+    } else if (m_attribute_name == HTML::AttributeNames::id) {
+        if (!m_old_value.is_empty())
+            invalidation_set.include(style_resolver.invalidation_set_for_id(m_old_value));
+        if (auto new_id = m_element.attribute(HTML::AttributeNames::id); !new_id.is_empty())
+            invalidation_set.include(style_resolver.invalidation_set_for_id(new_id));
+    }
+
+    invalidate(invalidation_set);
+}
+
+void StyleInvalidator::invalidate(const InvalidationSet& invalidation_set)
+{
+    if (invalidation_set.invalidates_self)
+        m_element.set_needs_style_update(true);
+
+    if (invalidation_set.invalidates_descendants) {
+        for (auto* child = m_element.first_child_of_type<DOM::Element>(); child; child = child->next_element_sibling())
+            child->invalidate_style();
+    }
+
+    if (invalidation_set.invalidates_siblings || invalidation_set.invalidates_sibling_descendants) {
+        for (auto* sibling = m_element.next_element_sibling(); sibling; sibling = sibling->next_element_sibling()) {
+            if (invalidation_set.invalidates_sibling_descendants)
+                sibling->invalidate_style();
+            else
+                sibling->set_needs_style_update(true);
         }
-        return IterationDecision::Continue;
-    });
+    }
 }
 
 }
@@ -6,21 +6,30 @@
 
 #pragma once
 
-#include <AK/HashMap.h>
+#include <AK/FlyString.h>
+#include <AK/Vector.h>
 #include <LibWeb/CSS/StyleResolver.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 
 namespace Web::CSS {
 
+// Put one of these on the stack around a change to an attribute of an element. Once it goes out of scope,
+// it marks the elements whose style may have changed along with the attribute, as told by the style sheets.
 class StyleInvalidator {
 public:
-    explicit StyleInvalidator(DOM::Document&);
+    StyleInvalidator(DOM::Element&, const FlyString& attribute_name);
     ~StyleInvalidator();
 
 private:
-    DOM::Document& m_document;
-    HashMap<DOM::Element*, Vector<MatchingRule>> m_elements_and_matching_rules_before;
+    void invalidate(const InvalidationSet&);
+
+    DOM::Element& m_element;
+    FlyString m_attribute_name;
+    bool m_enabled { false };
+    bool m_had_attribute { false };
+    String m_old_value;
+    Vector<FlyString> m_old_class_names;
 };
 
 }
@@ -14,6 +14,7 @@
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/Dump.h>
+#include <LibWeb/HTML/AttributeNames.h>
 #include <ctype.h>
 #include <stdio.h>
 
@@ -61,9 +62,117 @@ void StyleResolver::for_each_stylesheet(Callback callback) const
     }
 }
 
-Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& element) const
+void StyleResolver::invalidate_rule_cache()
 {
-    Vector<MatchingRule> matching_rules;
+    m_rule_cache = nullptr;
+}
+
+const StyleResolver::RuleCache& StyleResolver::rule_cache() const
+{
+    if (!m_rule_cache || m_rule_cache->includes_quirks_mode_style_sheet != document().in_quirks_mode())
+        build_rule_cache();
+    return *m_rule_cache;
+}
+
+static bool is_descendant_relation(Selector::ComplexSelector::Relation relation)
+{
+    return relation == Selector::ComplexSelector::Relation::Descendant || relation == Selector::ComplexSelector::Relation::ImmediateChild;
+}
+
+// Which elements an element matched by the compound selector at `index` can make the whole selector match.
+static InvalidationSet invalidation_scope_of_compound_selector(const Selector& selector, size_t index)
+{
+    auto& complex_selectors = selector.complex_selectors();
+    InvalidationSet scope;
+    if (index == complex_selectors.size() - 1) {
+        scope.invalidates_self = true;
+        return scope;
+    }
+    if (is_descendant_relation(complex_selectors[index + 1].relation)) {
+        scope.invalidates_descendants = true;
+        return scope;
+    }
+    // Once among the following siblings, any descendant or child combinator further right leads into their subtrees.
+    for (size_t i = index + 2; i < complex_selectors.size(); ++i) {
+        if (is_descendant_relation(complex_selectors[i].relation)) {
+            scope.invalidates_sibling_descendants = true;
+            return scope;
+        }
+    }
+    scope.invalidates_siblings = true;
+    return scope;
+}
+
+// Where a change ends up if it affects the elements in `first`, and each of those affects the elements in `then`.
+static InvalidationSet combine_invalidation_scopes(const InvalidationSet& first, const InvalidationSet& then)
+{
+    InvalidationSet scope;
+    if (first.invalidates_self)
+        scope.include(then);
+    if (then.is_empty())
+        return scope;
+    if (first.invalidates_descendants)
+        scope.invalidates_descendants = true;
+    if (first.invalidates_siblings) {
+        scope.invalidates_siblings |= then.invalidates_self || then.invalidates_siblings;
+        scope.invalidates_sibling_descendants |= then.invalidates_descendants || then.invalidates_sibling_descendants;
+    }
+    if (first.invalidates_sibling_descendants)
+        scope.invalidates_sibling_descendants = true;
+    return scope;
+}
+
+void StyleResolver::add_invalidation_sets(const Selector& selector, const InvalidationSet& scope) const
+{
+    auto add = [&](auto& invalidation_sets, const FlyString& name, const InvalidationSet& invalidation_set) {
+        invalidation_sets.ensure(name).include(invalidation_set);
+    };
+
+    auto& complex_selectors = selector.complex_selectors();
+    for (size_t i = 0; i < complex_selectors.size(); ++i) {
+        auto compound_scope = combine_invalidation_scopes(invalidation_scope_of_compound_selector(selector, i), scope);
+        for (auto& simple_selector : complex_selectors[i].compound_selector) {
+            if (simple_selector.type == Selector::SimpleSelector::Type::Id)
+                add(m_rule_cache->invalidation_sets_by_id, simple_selector.value, compound_scope);
+            else if (simple_selector.type == Selector::SimpleSelector::Type::Class)
+                add(m_rule_cache->invalidation_sets_by_class, simple_selector.value, compound_scope);
+
+            if (simple_selector.attribute_match_type != Selector::SimpleSelector::AttributeMatchType::None)
+                add(m_rule_cache->invalidation_sets_by_attribute, simple_selector.attribute_name, compound_scope);
+
+            // Some pseudo-classes are really about attributes, see SelectorEngine.
+            switch (simple_selector.pseudo_class) {
+            case Selector::SimpleSelector::PseudoClass::Link: {
+                // Everything inside a link is a link too.
+                InvalidationSet link_scope;
+                link_scope.invalidates_self = true;
+                link_scope.invalidates_descendants = true;
+                add(m_rule_cache->invalidation_sets_by_attribute, HTML::AttributeNames::href, combine_invalidation_scopes(link_scope, compound_scope));
+                break;
+            }
+            case Selector::SimpleSelector::PseudoClass::Disabled:
+            case Selector::SimpleSelector::PseudoClass::Enabled:
+                add(m_rule_cache->invalidation_sets_by_attribute, HTML::AttributeNames::disabled, compound_scope);
+                break;
+            case Selector::SimpleSelector::PseudoClass::Checked:
+                add(m_rule_cache->invalidation_sets_by_attribute, HTML::AttributeNames::checked, compound_scope);
+                break;
+            case Selector::SimpleSelector::PseudoClass::Not:
+                // The selector inside :not() is matched against the same element as the compound selector it's part of.
+                if (auto not_selector = Web::parse_selector(CSS::ParsingContext(document()), simple_selector.not_selector); not_selector.has_value())
+                    add_invalidation_sets(not_selector.value(), compound_scope);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+void StyleResolver::build_rule_cache() const
+{
+    m_rule_cache = make<RuleCache>();
+    m_rule_cache->includes_quirks_mode_style_sheet = document().in_quirks_mode();
 
     size_t style_sheet_index = 0;
     for_each_stylesheet([&](auto& sheet) {
@@ -73,20 +182,205 @@ Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& e
         static_cast<const CSSStyleSheet&>(sheet).for_each_effective_style_rule([&](auto& rule) {
             size_t selector_index = 0;
             for (auto& selector : rule.selectors()) {
-                if (SelectorEngine::matches(selector, element)) {
-                    matching_rules.append({ rule, style_sheet_index, rule_index, selector_index, selector.specificity() });
-                    break;
+                RuleCache::Rule cached_rule { { rule, style_sheet_index, rule_index, selector_index, selector.specificity() } };
+
+                InvalidationSet scope;
+                scope.invalidates_self = true;
+                add_invalidation_sets(selector, scope);
+
+                // Every compound selector to the left of a descendant or child combinator has to match an ancestor.
+                auto& complex_selectors = selector.complex_selectors();
+                for (size_t i = complex_selectors.size() - 1; i > 0 && cached_rule.ancestor_hash_count < cached_rule.ancestor_hashes.size(); --i) {
+                    auto relation = complex_selectors[i].relation;
+                    if (relation != Selector::ComplexSelector::Relation::Descendant && relation != Selector::ComplexSelector::Relation::ImmediateChild)
+                        continue;
+                    for (auto& simple_selector : complex_selectors[i - 1].compound_selector) {
+                        if (cached_rule.ancestor_hash_count == cached_rule.ancestor_hashes.size())
+                            break;
+                        auto& hash = cached_rule.ancestor_hashes[cached_rule.ancestor_hash_count];
+                        switch (simple_selector.type) {
+                        case Selector::SimpleSelector::Type::Id:
+                            hash = AncestorFilter::hash_for_id(simple_selector.value);
+                            break;
+                        case Selector::SimpleSelector::Type::Class:
+                            hash = AncestorFilter::hash_for_class(simple_selector.value);
+                            break;
+                        case Selector::SimpleSelector::Type::TagName:
+                            hash = AncestorFilter::hash_for_tag_name(simple_selector.value);
+                            break;
+                        default:
+                            continue;
+                        }
+                        ++cached_rule.ancestor_hash_count;
+                    }
+                }
+
+                // Bucket the rule by the rightmost compound selector, preferring whatever is going to match the fewest elements.
+                const Selector::SimpleSelector* id_selector = nullptr;
+                const Selector::SimpleSelector* class_selector = nullptr;
+                const Selector::SimpleSelector* tag_name_selector = nullptr;
+                for (auto& simple_selector : complex_selectors.last().compound_selector) {
+                    if (simple_selector.type == Selector::SimpleSelector::Type::Id && !id_selector)
+                        id_selector = &simple_selector;
+                    else if (simple_selector.type == Selector::SimpleSelector::Type::Class && !class_selector)
+                        class_selector = &simple_selector;
+                    else if (simple_selector.type == Selector::SimpleSelector::Type::TagName && !tag_name_selector)
+                        tag_name_selector = &simple_selector;
                 }
+                if (id_selector)
+                    m_rule_cache->rules_by_id.ensure(id_selector->value).append(move(cached_rule));
+                else if (class_selector)
+                    m_rule_cache->rules_by_class.ensure(class_selector->value).append(move(cached_rule));
+                else if (tag_name_selector)
+                    m_rule_cache->rules_by_tag_name.ensure(tag_name_selector->value).append(move(cached_rule));
+                else
+                    m_rule_cache->other_rules.append(move(cached_rule));
+
                 ++selector_index;
             }
             ++rule_index;
         });
         ++style_sheet_index;
     });
+}
+
+InvalidationSet StyleResolver::invalidation_set_for_class(const FlyString& class_name) const
+{
+    return rule_cache().invalidation_sets_by_class.get(class_name).value_or({});
+}
+
+InvalidationSet StyleResolver::invalidation_set_for_id(const FlyString& id) const
+{
+    return rule_cache().invalidation_sets_by_id.get(id).value_or({});
+}
+
+InvalidationSet StyleResolver::invalidation_set_for_attribute(const FlyString& attribute_name) const
+{
+    return rule_cache().invalidation_sets_by_attribute.get(attribute_name).value_or({});
+}
+
+Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& element) const
+{
+    auto& rule_cache = this->rule_cache();
+    bool can_use_ancestor_filter = can_use_ancestor_filter_for(element);
+
+    Vector<MatchingRule> matching_rules;
+    auto add_matching_rules = [&](const Vector<RuleCache::Rule>& rules) {
+        for (auto& rule : rules) {
+            if (can_use_ancestor_filter) {
+                bool rejected = false;
+                for (size_t i = 0; i < rule.ancestor_hash_count; ++i) {
+                    if (!m_ancestor_filter.may_contain(rule.ancestor_hashes[i])) {
+                        rejected = true;
+                        break;
+                    }
+                }
+                if (rejected)
+                    continue;
+            }
+            auto& matching_rule = rule.matching_rule;
+            if (SelectorEngine::matches(matching_rule.rule->selectors()[matching_rule.selector_index], element))
+                matching_rules.append(matching_rule);
+        }
+    };
+
+    if (auto id = element.attribute(HTML::AttributeNames::id); !id.is_empty()) {
+        if (auto it = rule_cache.rules_by_id.find(id.hash(), [&](auto& entry) { return entry.key == id; }); it != rule_cache.rules_by_id.end())
+            add_matching_rules(it->value);
+    }
+    for (auto& class_name : element.class_names()) {
+        if (auto it = rule_cache.rules_by_class.find(class_name); it != rule_cache.rules_by_class.end())
+            add_matching_rules(it->value);
+    }
+    if (auto it = rule_cache.rules_by_tag_name.find(element.local_name()); it != rule_cache.rules_by_tag_name.end())
+        add_matching_rules(it->value);
+    add_matching_rules(rule_cache.other_rules);
+
+    // Put the rules back into the order they appear in, and since a rule only matches once (with the first of its
+    // selectors that does), drop any that matched through more than one selector or bucket.
+    quick_sort(matching_rules, [](auto& a, auto& b) {
+        if (a.style_sheet_index != b.style_sheet_index)
+            return a.style_sheet_index < b.style_sheet_index;
+        if (a.rule_index != b.rule_index)
+            return a.rule_index < b.rule_index;
+        return a.selector_index < b.selector_index;
+    });
+    for (size_t i = 1; i < matching_rules.size();) {
+        if (matching_rules[i].rule == matching_rules[i - 1].rule)
+            matching_rules.remove(i);
+        else
+            ++i;
+    }
 
     return matching_rules;
 }
 
+void StyleResolver::add_ancestor(const DOM::Element& element, bool was_pushed_implicitly)
+{
+    m_ancestors.append({ &element, m_ancestor_hashes.size(), was_pushed_implicitly });
+    m_ancestor_hashes.append(AncestorFilter::hash_for_tag_name(element.local_name()));
+    if (auto id = element.attribute(HTML::AttributeNames::id); !id.is_empty())
+        m_ancestor_hashes.append(AncestorFilter::hash_for_id(id));
+    for (auto& class_name : element.class_names())
+        m_ancestor_hashes.append(AncestorFilter::hash_for_class(class_name));
+    for (size_t i = m_ancestors.last().first_hash_index; i < m_ancestor_hashes.size(); ++i)
+        m_ancestor_filter.add(m_ancestor_hashes[i]);
+}
+
+void StyleResolver::push_ancestor(const DOM::Element& element)
+{
+    if (!can_use_ancestor_filter_for(element)) {
+        // We're not continuing where the last push left off, e.g. because styles are being resolved for a subtree
+        // somewhere in the middle of the document. Start over with the actual ancestors of the element.
+        while (!m_ancestors.is_empty())
+            pop_ancestor(*m_ancestors.last().element);
+        Vector<const DOM::Element*> ancestors;
+        for (auto* ancestor = element.parent_element(); ancestor; ancestor = ancestor->parent_element())
+            ancestors.append(ancestor);
+        for (size_t i = ancestors.size(); i > 0; --i)
+            add_ancestor(*ancestors[i - 1], true);
+    }
+    add_ancestor(element, false);
+}
+
+void StyleResolver::pop_ancestor(const DOM::Element& element)
+{
+    // If someone else has started over in the meantime, the element is already gone.
+    if (m_ancestors.is_empty() || m_ancestors.last().element != &element)
+        return;
+
+    do {
+        auto ancestor = m_ancestors.take_last();
+        for (size_t i = ancestor.first_hash_index; i < m_ancestor_hashes.size(); ++i)
+            m_ancestor_filter.remove(m_ancestor_hashes[i]);
+        m_ancestor_hashes.shrink(ancestor.first_hash_index, true);
+    } while (!m_ancestors.is_empty() && m_ancestors.last().was_pushed_implicitly);
+}
+
+bool StyleResolver::can_use_ancestor_filter_for(const DOM::Element& element) const
+{
+    // The filter has to contain exactly the ancestors of the element, which it does if the parent was pushed last.
+    auto* parent = element.parent_element();
+    if (m_ancestors.is_empty())
+        return !parent;
+    return m_ancestors.last().element == parent;
+}
+
+StyleResolver::ScopedAncestor::ScopedAncestor(StyleResolver& style_resolver, const DOM::Node& node)
+    : m_style_resolver(style_resolver)
+{
+    if (!is<DOM::Element>(node))
+        return;
+    m_element = &verify_cast<DOM::Element>(node);
+    m_style_resolver.push_ancestor(*m_element);
+}
+
+StyleResolver::ScopedAncestor::~ScopedAncestor()
+{
+    if (m_element)
+        m_style_resolver.pop_ancestor(*m_element);
+}
+
 void StyleResolver::sort_matching_rules(Vector<MatchingRule>& matching_rules) const
 {
     quick_sort(matching_rules, [&](MatchingRule& a, MatchingRule& b) {
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
+#include <LibWeb/CSS/AncestorFilter.h>
 #include <LibWeb/CSS/CSSStyleDeclaration.h>
 #include <LibWeb/CSS/StyleProperties.h>
 #include <LibWeb/Forward.h>
@@ -22,6 +24,25 @@ struct MatchingRule {
     u32 specificity { 0 };
 };
 
+// Which elements may need their style recomputed when some element gains or loses a class, id or attribute,
+// relative to that element. Siblings are always the ones following it.
+struct InvalidationSet {
+    bool invalidates_self { false };
+    bool invalidates_descendants { false };
+    bool invalidates_siblings { false };
+    bool invalidates_sibling_descendants { false };
+
+    bool is_empty() const { return !invalidates_self && !invalidates_descendants && !invalidates_siblings && !invalidates_sibling_descendants; }
+
+    void include(const InvalidationSet& other)
+    {
+        invalidates_self |= other.invalidates_self;
+        invalidates_descendants |= other.invalidates_descendants;
+        invalidates_siblings |= other.invalidates_siblings;
+        invalidates_sibling_descendants |= other.invalidates_sibling_descendants;
+    }
+};
+
 class StyleResolver {
 public:
     explicit StyleResolver(DOM::Document&);
@@ -43,11 +64,72 @@ public:
 
     static bool is_inherited_property(CSS::PropertyID);
 
+    // Has to be called whenever the set of style rules changes, i.e. when a style sheet is added or finishes loading.
+    void invalidate_rule_cache();
+
+    // What has to be restyled when an element gains or loses the given class, id or attribute, going by the
+    // selectors that mention it. Used by StyleInvalidator.
+    InvalidationSet invalidation_set_for_class(const FlyString&) const;
+    InvalidationSet invalidation_set_for_id(const FlyString&) const;
+    InvalidationSet invalidation_set_for_attribute(const FlyString&) const;
+
+    // Whoever resolves styles for a whole subtree pushes each element before resolving the styles of its children,
+    // which lets collect_matching_rules() rule out most selectors with descendant combinators right away.
+    // Use ScopedAncestor rather than calling these directly.
+    void push_ancestor(const DOM::Element&);
+    void pop_ancestor(const DOM::Element&);
+
+    class ScopedAncestor {
+    public:
+        ScopedAncestor(StyleResolver&, const DOM::Node&);
+        ~ScopedAncestor();
+
+    private:
+        StyleResolver& m_style_resolver;
+        const DOM::Element* m_element { nullptr };
+    };
+
 private:
     template<typename Callback>
     void for_each_stylesheet(Callback) const;
 
+    // Every selector of every style rule, bucketed by the most specific part of its rightmost compound selector,
+    // so that only the rules which could possibly match an element have to be looked at.
+    struct RuleCache {
+        struct Rule {
+            MatchingRule matching_rule;
+            // Hashes of names that the ancestors of a matching element must have, see AncestorFilter.
+            Array<u32, 4> ancestor_hashes {};
+            size_t ancestor_hash_count { 0 };
+        };
+        HashMap<FlyString, Vector<Rule>> rules_by_id;
+        HashMap<FlyString, Vector<Rule>> rules_by_class;
+        HashMap<FlyString, Vector<Rule>> rules_by_tag_name;
+        Vector<Rule> other_rules;
+        HashMap<FlyString, InvalidationSet> invalidation_sets_by_id;
+        HashMap<FlyString, InvalidationSet> invalidation_sets_by_class;
+        HashMap<FlyString, InvalidationSet> invalidation_sets_by_attribute;
+        bool includes_quirks_mode_style_sheet { false };
+    };
+    const RuleCache& rule_cache() const;
+    void build_rule_cache() const;
+    void add_invalidation_sets(const Selector&, const InvalidationSet& scope) const;
+
+    void add_ancestor(const DOM::Element&, bool was_pushed_implicitly);
+    bool can_use_ancestor_filter_for(const DOM::Element&) const;
+
     DOM::Document& m_document;
+
+    mutable OwnPtr<RuleCache> m_rule_cache;
+
+    struct Ancestor {
+        const DOM::Element* element { nullptr };
+        size_t first_hash_index { 0 };
+        bool was_pushed_implicitly { false };
+    };
+    Vector<Ancestor> m_ancestors;
+    Vector<u32> m_ancestor_hashes;
+    AncestorFilter m_ancestor_filter;
 };
 
 }
@@ -812,6 +812,11 @@ public:
     virtual bool internal_set(const JS::PropertyName&, JS::Value, JS::Value receiver) override;
 )~~~");
     }
+    if (interface.extended_attributes.contains("CustomGet") || interface.extended_attributes.contains("CustomSet")) {
+        generator.append(R"~~~(
+    virtual bool has_exotic_property_lookup() const override { return true; }
+)~~~");
+    }
 
     if (interface.wrapper_base_class == "Wrapper") {
         generator.append(R"~~~(
@@ -1418,8 +1423,10 @@ static @fully_qualified_name@* impl_from(JS::VM& vm, JS::GlobalObject& global_ob
             //        Basically once we have NodeList we can throw this out.
             scoped_generator.append(R"~~~(
     auto* new_array = JS::Array::create(global_object, 0);
-    for (auto& element : retval)
-        new_array->indexed_properties().append(wrap(global_object, element));
+    for (auto& element : retval) {
+        auto* wrapped_element = wrap(global_object, element);
+        new_array->indexed_properties().append(wrapped_element);
+    }
 
     return new_array;
 )~~~");
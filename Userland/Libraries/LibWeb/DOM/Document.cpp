@@ -6,7 +6,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/CharacterTypes.h>
+#include <AK/Debug.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
 #include <LibCore/Timer.h>
@@ -52,6 +54,7 @@
 #include <LibWeb/Namespace.h>
 #include <LibWeb/Origin.h>
 #include <LibWeb/Page/BrowsingContext.h>
+#include <LibWeb/Painting/StackingContext.h>
 #include <LibWeb/SVG/TagNames.h>
 #include <LibWeb/UIEvents/MouseEvent.h>
 
@@ -69,8 +72,8 @@ Document::Document(const URL& url)
         update_style();
     });
 
-    m_forced_layout_timer = Core::Timer::create_single_shot(0, [this] {
-        force_layout();
+    m_layout_update_timer = Core::Timer::create_single_shot(0, [this] {
+        update_layout();
     });
 }
 
@@ -150,11 +153,11 @@ void Document::schedule_style_update()
     m_style_update_timer->start();
 }
 
-void Document::schedule_forced_layout()
+void Document::schedule_layout_update()
 {
-    if (m_forced_layout_timer->is_active())
+    if (m_layout_update_timer->is_active())
         return;
-    m_forced_layout_timer->start();
+    m_layout_update_timer->start();
 }
 
 bool Document::is_child_allowed(const Node& node) const
@@ -320,6 +323,7 @@ void Document::tear_down_layout_tree()
     }
 
     m_layout_root = nullptr;
+    m_layout_tree_rebuild_roots.clear();
 }
 
 Color Document::background_color(const Palette& palette) const
@@ -397,20 +401,99 @@ void Document::force_layout()
     update_layout();
 }
 
+void Document::invalidate_layout_tree_for_children_of(Node& node)
+{
+    if (!m_layout_root || !node.is_connected())
+        return;
+
+    // The layout nodes of the children can only be rebuilt in place below a block container, so go looking for the
+    // nearest one. If some ancestor isn't rendered at all, neither are the children, and there's nothing to rebuild.
+    Node* root = &node;
+    while (!Layout::TreeBuilder::can_rebuild_children_of(*root)) {
+        if (!is<ShadowRoot>(*root) && !root->layout_node())
+            return;
+        root = root->parent_or_shadow_host();
+        if (!root)
+            return;
+    }
+
+    if (!any_of(m_layout_tree_rebuild_roots.begin(), m_layout_tree_rebuild_roots.end(), [&](auto& it) { return it.ptr() == root; }))
+        m_layout_tree_rebuild_roots.append(*root);
+    schedule_layout_update();
+}
+
+static Time monotonic_time()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return Time::from_timespec(now);
+}
+
 void Document::update_layout()
 {
     if (!browsing_context())
         return;
 
+    auto start_time = monotonic_time();
+
     if (!m_layout_root) {
         Layout::TreeBuilder tree_builder;
         m_layout_root = static_ptr_cast<Layout::InitialContainingBlockBox>(tree_builder.build(*this));
+        m_layout_tree_rebuild_roots.clear();
+        ++m_layout_counters.full_layout_tree_build_count;
+    } else if (!m_layout_tree_rebuild_roots.is_empty()) {
+        auto roots = move(m_layout_tree_rebuild_roots);
+        for (auto& root : roots) {
+            // Mutations since the root was recorded may have removed it, or turned it into something that no longer
+            // holds its own children.
+            if (!root || !root->is_connected() || !Layout::TreeBuilder::can_rebuild_children_of(*root))
+                continue;
+            // Rebuilding an ancestor takes care of this one as well.
+            bool has_ancestor_in_roots = false;
+            for (auto* ancestor = root->parent_or_shadow_host(); ancestor && !has_ancestor_in_roots; ancestor = ancestor->parent_or_shadow_host())
+                has_ancestor_in_roots = any_of(roots.begin(), roots.end(), [&](auto& it) { return it.ptr() == ancestor; });
+            if (has_ancestor_in_roots)
+                continue;
+            Layout::TreeBuilder tree_builder;
+            tree_builder.rebuild_children_of(*root);
+            ++m_layout_counters.partial_layout_tree_build_count;
+        }
     }
 
+    auto build_end_time = monotonic_time();
+
+    // Boxes may have come and gone, or moved around, so the stacking contexts have to be worked out again.
+    bool layout_tree_changed = m_layout_root->needs_layout() || m_layout_root->child_needs_layout();
+    if (layout_tree_changed)
+        m_layout_root->invalidate_stacking_context_tree();
+
+    auto laid_out_box_count = m_layout_counters.laid_out_box_count;
+    auto reused_box_count = m_layout_counters.reused_box_count;
+
     Layout::BlockFormattingContext root_formatting_context(*m_layout_root, nullptr);
     root_formatting_context.run(*m_layout_root, Layout::LayoutMode::Default);
+    m_layout_root->clear_needs_layout();
+
+    auto layout_end_time = monotonic_time();
+    ++m_layout_counters.layout_count;
+    m_layout_counters.time_spent_building_layout_trees += build_end_time - start_time;
+    m_layout_counters.time_spent_in_layout += layout_end_time - build_end_time;
+
+    if constexpr (LAYOUT_TIMING_DEBUG) {
+        dbgln("Layout #{}: building the tree took {} us, laying it out took {} us ({} boxes laid out, {} reused)",
+            m_layout_counters.layout_count,
+            (build_end_time - start_time).to_microseconds(),
+            (layout_end_time - build_end_time).to_microseconds(),
+            m_layout_counters.laid_out_box_count - laid_out_box_count,
+            m_layout_counters.reused_box_count - reused_box_count);
+    }
 
-    m_layout_root->set_needs_display();
+    // If every box kept its layout, nothing has moved, and whatever changed in place has asked for a repaint already.
+    if (layout_tree_changed || m_layout_counters.laid_out_box_count != laid_out_box_count) {
+        if (auto* stacking_context = m_layout_root->stacking_context())
+            stacking_context->invalidate_display_list();
+        m_layout_root->set_needs_display();
+    }
 
     if (browsing_context()->is_top_level()) {
         if (auto* page = this->page())
@@ -427,6 +510,7 @@ static void update_style_recursively(DOM::Node& node)
             child.set_needs_style_update(false);
         }
         if (child.child_needs_style_update()) {
+            CSS::StyleResolver::ScopedAncestor ancestor(child.document().style_resolver(), child);
             update_style_recursively(child);
             child.set_child_needs_style_update(false);
         }
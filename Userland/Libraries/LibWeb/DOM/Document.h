@@ -11,6 +11,7 @@
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
 #include <AK/String.h>
+#include <AK/Time.h>
 #include <AK/URL.h>
 #include <AK/WeakPtr.h>
 #include <LibCore/Forward.h>
@@ -141,16 +142,32 @@ public:
     void force_layout();
     void invalidate_layout();
 
+    // Makes the next layout update throw away and rebuild the layout nodes generated by the children of the given node,
+    // instead of the whole layout tree.
+    void invalidate_layout_tree_for_children_of(Node&);
+
     void update_style();
     void update_layout();
 
+    struct LayoutCounters {
+        u64 layout_count { 0 };
+        u64 full_layout_tree_build_count { 0 };
+        u64 partial_layout_tree_build_count { 0 };
+        u64 laid_out_box_count { 0 };
+        u64 reused_box_count { 0 };
+        Time time_spent_building_layout_trees;
+        Time time_spent_in_layout;
+    };
+    LayoutCounters& layout_counters() { return m_layout_counters; }
+    const LayoutCounters& layout_counters() const { return m_layout_counters; }
+
     virtual bool is_child_allowed(const Node&) const override;
 
     const Layout::InitialContainingBlockBox* layout_node() const;
     Layout::InitialContainingBlockBox* layout_node();
 
     void schedule_style_update();
-    void schedule_forced_layout();
+    void schedule_layout_update();
 
     NonnullRefPtr<HTMLCollection> get_elements_by_name(String const&);
     NonnullRefPtr<HTMLCollection> get_elements_by_tag_name(FlyString const&);
@@ -309,13 +326,15 @@ private:
     RefPtr<Window> m_window;
 
     RefPtr<Layout::InitialContainingBlockBox> m_layout_root;
+    Vector<WeakPtr<Node>> m_layout_tree_rebuild_roots;
+    LayoutCounters m_layout_counters;
 
     Optional<Color> m_link_color;
     Optional<Color> m_active_link_color;
     Optional<Color> m_visited_link_color;
 
     RefPtr<Core::Timer> m_style_update_timer;
-    RefPtr<Core::Timer> m_forced_layout_timer;
+    RefPtr<Core::Timer> m_layout_update_timer;
 
     String m_source;
 
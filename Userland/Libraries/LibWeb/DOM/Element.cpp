@@ -25,7 +25,6 @@
 #include <LibWeb/Layout/TableCellBox.h>
 #include <LibWeb/Layout/TableRowBox.h>
 #include <LibWeb/Layout/TableRowGroupBox.h>
-#include <LibWeb/Layout/TreeBuilder.h>
 #include <LibWeb/Namespace.h>
 
 namespace Web::DOM {
@@ -72,7 +71,7 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
     if (name.is_empty())
         return InvalidCharacterError::create("Attribute name must not be empty");
 
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this, name);
 
     if (auto* attribute = find_attribute(name))
         attribute->set_value(value);
@@ -85,7 +84,7 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
 
 void Element::remove_attribute(const FlyString& name)
 {
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this, name);
 
     m_attributes.remove_first_matching([&](auto& attribute) { return attribute.name() == name; });
 }
@@ -168,29 +167,35 @@ enum class StyleDifference {
     None,
     NeedsRepaint,
     NeedsRelayout,
+    NeedsLayoutTreeRebuild,
 };
 
-static StyleDifference compute_style_difference(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style, const Document& document)
+static bool has_property_not_affecting_layout_that_differs(const CSS::StyleProperties& style, const CSS::StyleProperties& other_style)
+{
+    bool differs = false;
+    style.for_each_property([&](auto property_id, auto& value) {
+        if (differs || property_id == CSS::PropertyID::Color || property_id == CSS::PropertyID::BackgroundColor)
+            return;
+        auto other_value = other_style.property(property_id);
+        if (!other_value.has_value() || other_value.value()->type() != value.type() || *other_value.value() != value)
+            differs = true;
+    });
+    return differs;
+}
+
+static StyleDifference compute_style_difference(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style)
 {
     if (old_style == new_style)
         return StyleDifference::None;
 
-    bool needs_repaint = false;
-    bool needs_relayout = false;
+    // These decide what kind of layout node the element gets, if any.
+    if (new_style.display() != old_style.display() || new_style.float_() != old_style.float_())
+        return StyleDifference::NeedsLayoutTreeRebuild;
 
-    if (new_style.display() != old_style.display())
-        needs_relayout = true;
-
-    if (new_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black))
-        needs_repaint = true;
-    else if (new_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black))
-        needs_repaint = true;
-
-    if (needs_relayout)
+    // Colors only matter when painting, but any other property may move things around.
+    if (has_property_not_affecting_layout_that_differs(old_style, new_style) || has_property_not_affecting_layout_that_differs(new_style, old_style))
         return StyleDifference::NeedsRelayout;
-    if (needs_repaint)
-        return StyleDifference::NeedsRepaint;
-    return StyleDifference::None;
+    return StyleDifference::NeedsRepaint;
 }
 
 void Element::recompute_style()
@@ -203,20 +208,25 @@ void Element::recompute_style()
     if (!layout_node()) {
         if (new_specified_css_values->display() == CSS::Display::None)
             return;
-        // We need a new layout tree here!
-        Layout::TreeBuilder tree_builder;
-        tree_builder.build(*this);
+        // We need new layout nodes here, unless the parent isn't rendered either.
+        if (auto* parent = parent_or_shadow_host(); parent && parent->layout_node())
+            document().invalidate_layout_tree_for_children_of(*parent);
         return;
     }
 
-    auto diff = StyleDifference::NeedsRelayout;
+    auto diff = StyleDifference::NeedsLayoutTreeRebuild;
     if (old_specified_css_values)
-        diff = compute_style_difference(*old_specified_css_values, *new_specified_css_values, document());
+        diff = compute_style_difference(*old_specified_css_values, *new_specified_css_values);
     if (diff == StyleDifference::None)
         return;
+    if (diff == StyleDifference::NeedsLayoutTreeRebuild) {
+        document().invalidate_layout_tree_for_children_of(*parent_or_shadow_host());
+        return;
+    }
     layout_node()->apply_style(*new_specified_css_values);
     if (diff == StyleDifference::NeedsRelayout) {
-        document().schedule_forced_layout();
+        layout_node()->set_needs_layout();
+        document().schedule_layout_update();
         return;
     }
     if (diff == StyleDifference::NeedsRepaint) {
@@ -261,7 +271,6 @@ void Element::set_inner_html(StringView markup)
     }
 
     set_needs_style_update(true);
-    document().invalidate_layout();
 }
 
 String Element::inner_html() const
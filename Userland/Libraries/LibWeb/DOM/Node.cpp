@@ -91,7 +91,6 @@ void Node::set_text_content(const String& content)
     }
 
     set_needs_style_update(true);
-    document().invalidate_layout();
 }
 
 RefPtr<Layout::Node> Node::create_layout_node()
@@ -256,6 +255,8 @@ void Node::insert_before(NonnullRefPtr<Node> node, RefPtr<Node> child, bool supp
         });
     }
 
+    document().invalidate_layout_tree_for_children_of(*this);
+
     if (!suppress_observers) {
         // FIXME: queue a tree mutation record for parent with nodes, « », previousSibling, and child.
     }
@@ -313,6 +314,8 @@ void Node::remove(bool suppress_observers)
     // FIXME: Let oldPreviousSibling be node’s previous sibling. (Currently unused so not included)
     // FIXME: Let oldNextSibling be node’s next sibling. (Currently unused so not included)
 
+    document().invalidate_layout_tree_for_children_of(*parent);
+
     parent->remove_child(*this);
 
     // FIXME: If node is assigned, then run assign slottables for node’s assigned slot.
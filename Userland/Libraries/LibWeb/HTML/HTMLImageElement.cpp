@@ -21,12 +21,17 @@ HTMLImageElement::HTMLImageElement(DOM::Document& document, QualifiedName qualif
     , m_image_loader(*this)
 {
     m_image_loader.on_load = [this] {
+        // The intrinsic size of the image is known now.
+        if (layout_node())
+            layout_node()->set_needs_layout();
         this->document().update_layout();
         dispatch_event(DOM::Event::create(EventNames::load));
     };
 
     m_image_loader.on_fail = [this] {
         dbgln("HTMLImageElement: Resource did fail: {}", src());
+        if (layout_node())
+            layout_node()->set_needs_layout();
         this->document().update_layout();
         dispatch_event(DOM::Event::create(EventNames::error));
     };
@@ -5,8 +5,10 @@
  */
 
 #include <AK/Debug.h>
+#include <AK/ScopeGuard.h>
 #include <AK/SourceLocation.h>
 #include <AK/Utf32View.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibTextCodec/Decoder.h>
 #include <LibWeb/DOM/Comment.h>
 #include <LibWeb/DOM/Document.h>
@@ -29,6 +31,12 @@
 
 namespace Web::HTML {
 
+// How long an incremental parse keeps going before it lets the event loop lay out and paint what's there so far.
+static constexpr int time_slice_ms = 16;
+
+// Looking at the clock after every token would be a waste of time, so it's only done this often.
+static constexpr size_t tokens_between_time_checks = 64;
+
 static inline void log_parse_error(const SourceLocation& location = SourceLocation::current())
 {
     dbgln("Parse error! {}", location);
@@ -101,10 +109,16 @@ RefPtr<DOM::Document> parse_html_document(const StringView& data, const URL& url
 }
 
 HTMLDocumentParser::HTMLDocumentParser(DOM::Document& document, const StringView& input, const String& encoding)
-    : m_tokenizer(input, encoding)
+    : HTMLDocumentParser(document, encoding)
+{
+    m_tokenizer.append_input(input);
+    m_tokenizer.insert_eof();
+}
+
+HTMLDocumentParser::HTMLDocumentParser(DOM::Document& document, const String& encoding)
+    : m_tokenizer(encoding)
     , m_document(document)
 {
-    m_document->set_should_invalidate_styles_on_attribute_changes(false);
     auto standardized_encoding = TextCodec::get_standardized_encoding(encoding);
     VERIFY(standardized_encoding.has_value());
     m_document->set_encoding(standardized_encoding.value());
@@ -112,18 +126,107 @@ HTMLDocumentParser::HTMLDocumentParser(DOM::Document& document, const StringView
 
 HTMLDocumentParser::~HTMLDocumentParser()
 {
-    m_document->set_should_invalidate_styles_on_attribute_changes(true);
 }
 
 void HTMLDocumentParser::run(const URL& url)
 {
     m_document->set_url(url);
     m_document->set_source(m_tokenizer.source());
+    process_tokens({});
+    the_end();
+}
+
+void HTMLDocumentParser::run_incrementally(const URL& url)
+{
+    VERIFY(!m_time_slice_timer);
+    m_document->set_url(url);
+    m_time_slice_timer = Core::Timer::create_single_shot(0, [this] {
+        run_for_a_time_slice();
+    });
+    schedule_time_slice();
+}
+
+void HTMLDocumentParser::append_input(const StringView& input)
+{
+    m_tokenizer.append_input(input);
+    schedule_time_slice();
+}
+
+void HTMLDocumentParser::insert_eof()
+{
+    m_tokenizer.insert_eof();
+    schedule_time_slice();
+}
+
+void HTMLDocumentParser::abort_and_destroy(NonnullOwnPtr<HTMLDocumentParser> parser)
+{
+    parser->m_aborted = true;
+    if (parser->m_time_slice_timer)
+        parser->m_time_slice_timer->stop();
+    if (parser->m_is_running_time_slice) {
+        auto& parser_ref = *parser;
+        parser_ref.m_self_until_time_slice_ends = move(parser);
+    }
+}
+
+void HTMLDocumentParser::schedule_time_slice()
+{
+    // Parsing only ever happens in a time slice of its own, straight from the event loop, so that whoever is
+    // appending input doesn't find it running scripts, or the document changing, under their feet.
+    if (m_time_slice_timer && !m_aborted && !m_time_slice_timer->is_active())
+        m_time_slice_timer->start();
+}
+
+void HTMLDocumentParser::run_for_a_time_slice()
+{
+    if (m_is_running_time_slice || m_aborted)
+        return;
+
+    m_is_running_time_slice = true;
+    ScopeGuard guard = [this] {
+        m_is_running_time_slice = false;
+        // If we were aborted during the time slice, this is where we go away; see abort_and_destroy().
+        auto self = move(m_self_until_time_slice_ends);
+    };
 
-    for (;;) {
+    auto outcome = process_tokens(time_slice_ms);
+    if (m_aborted)
+        return;
+
+    switch (outcome) {
+    case ProcessingOutcome::WaitingForInput:
+        // Text that arrives later has to be appended to what's there now, rather than replace it.
+        m_character_insertion_node = nullptr;
+        return;
+    case ProcessingOutcome::OutOfTime:
+        m_character_insertion_node = nullptr;
+        schedule_time_slice();
+        return;
+    case ProcessingOutcome::Finished:
+        m_time_slice_timer = nullptr;
+        m_document->set_source(m_tokenizer.source());
+        the_end();
+        // Scripts run by "the end" may have navigated away, aborting us.
+        if (on_finish && !m_aborted)
+            on_finish();
+        return;
+    }
+}
+
+// Processes tokens until parsing stops, or, if there's a time slice, until either the input that has arrived
+// so far runs out, or the time is up.
+HTMLDocumentParser::ProcessingOutcome HTMLDocumentParser::process_tokens(Optional<int> time_slice_ms)
+{
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (size_t token_count = 1;; ++token_count) {
         auto optional_token = m_tokenizer.next_token();
-        if (!optional_token.has_value())
-            break;
+        if (!optional_token.has_value()) {
+            if (m_tokenizer.is_eof_inserted())
+                break;
+            flush_character_insertions();
+            return ProcessingOutcome::WaitingForInput;
+        }
         auto& token = optional_token.value();
 
         dbgln_if(PARSER_DEBUG, "[{}] {}", insertion_mode_name(), token.to_string());
@@ -133,22 +236,42 @@ void HTMLDocumentParser::run(const URL& url)
         // FIXME: If the adjusted current node is a MathML annotation-xml element and the token is a start tag whose tag name is "svg"
         // FIXME: If the adjusted current node is an HTML integration point and the token is a start tag
         // FIXME: If the adjusted current node is an HTML integration point and the token is a character token
-        if (m_stack_of_open_elements.is_empty()
-            || adjusted_current_node().namespace_() == Namespace::HTML
-            || token.is_end_of_file()) {
-            process_using_the_rules_for(m_insertion_mode, token);
-        } else {
-            process_using_the_rules_for_foreign_content(token);
+        {
+            // The attributes of the elements being created can't affect any style that has been computed yet.
+            // Elements from earlier time slices may already have been styled though, and scripts may change
+            // those at any time, so this is only switched off while a token is being processed.
+            m_document->set_should_invalidate_styles_on_attribute_changes(false);
+            ScopeGuard invalidation_guard = [&] { m_document->set_should_invalidate_styles_on_attribute_changes(true); };
+
+            if (m_stack_of_open_elements.is_empty()
+                || adjusted_current_node().namespace_() == Namespace::HTML
+                || token.is_end_of_file()) {
+                process_using_the_rules_for(m_insertion_mode, token);
+            } else {
+                process_using_the_rules_for_foreign_content(token);
+            }
         }
 
         if (m_stop_parsing) {
             dbgln_if(PARSER_DEBUG, "Stop parsing{}! :^)", m_parsing_fragment ? " fragment" : "");
             break;
         }
+
+        if (m_aborted)
+            return ProcessingOutcome::Finished;
+
+        if (time_slice_ms.has_value() && token_count % tokens_between_time_checks == 0 && timer.elapsed() >= time_slice_ms.value()) {
+            flush_character_insertions();
+            return ProcessingOutcome::OutOfTime;
+        }
     }
 
     flush_character_insertions();
+    return ProcessingOutcome::Finished;
+}
 
+void HTMLDocumentParser::the_end()
+{
     // "The end"
 
     m_document->set_ready_state("interactive");
@@ -724,17 +847,13 @@ void HTMLDocumentParser::flush_character_insertions()
 void HTMLDocumentParser::insert_character(u32 data)
 {
     auto node = find_character_insertion_node();
-    if (node == m_character_insertion_node) {
-        m_character_insertion_builder.append(Utf32View { &data, 1 });
-        return;
-    }
-    if (!m_character_insertion_node) {
+    if (node != m_character_insertion_node) {
+        flush_character_insertions();
         m_character_insertion_node = node;
-        m_character_insertion_builder.append(Utf32View { &data, 1 });
-        return;
+        // The node may have some text in it already, e.g. if an incremental parse stopped halfway through it.
+        if (node)
+            m_character_insertion_builder.append(node->data());
     }
-    flush_character_insertions();
-    m_character_insertion_node = node;
     m_character_insertion_builder.append(Utf32View { &data, 1 });
 }
 
@@ -1930,7 +2049,9 @@ void HTMLDocumentParser::handle_text(HTMLToken& token)
                 VERIFY(script_nesting_level() == 0);
                 increment_script_nesting_level();
 
+                m_document->set_should_invalidate_styles_on_attribute_changes(true);
                 the_script->execute_script();
+                m_document->set_should_invalidate_styles_on_attribute_changes(false);
 
                 decrement_script_nesting_level();
                 VERIFY(script_nesting_level() == 0);
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <LibCore/Timer.h>
 #include <LibWeb/DOM/Node.h>
 #include <LibWeb/HTML/Parser/HTMLTokenizer.h>
 #include <LibWeb/HTML/Parser/ListOfActiveFormattingElements.h>
@@ -44,12 +46,25 @@ RefPtr<DOM::Document> parse_html_document(const StringView&, const URL&, const S
 class HTMLDocumentParser {
 public:
     HTMLDocumentParser(DOM::Document&, const StringView& input, const String& encoding);
+    HTMLDocumentParser(DOM::Document&, const String& encoding);
     ~HTMLDocumentParser();
 
     static NonnullOwnPtr<HTMLDocumentParser> create_with_uncertain_encoding(DOM::Document&, const ByteBuffer& input);
 
     void run(const URL&);
 
+    // Parses the input as it's appended, a slice of time at a time, so that the event loop gets to lay out and
+    // paint what's there so far in between. Once all of it has been appended and parsed, insert_eof() having
+    // been called, runs "the end" and calls on_finish.
+    void run_incrementally(const URL&);
+    void append_input(const StringView&);
+    void insert_eof();
+    Function<void()> on_finish;
+
+    // Stops an incremental parse. If the parser is what got us here, by running a script, it's destroyed
+    // once it has returned to the event loop.
+    static void abort_and_destroy(NonnullOwnPtr<HTMLDocumentParser>);
+
     DOM::Document& document();
 
     static NonnullRefPtrVector<DOM::Node> parse_html_fragment(DOM::Element& context_element, const StringView&);
@@ -65,6 +80,16 @@ public:
     static bool is_special_tag(const FlyString& tag_name, const FlyString& namespace_);
 
 private:
+    enum class ProcessingOutcome {
+        Finished,
+        WaitingForInput,
+        OutOfTime,
+    };
+    ProcessingOutcome process_tokens(Optional<int> time_slice_ms);
+    void run_for_a_time_slice();
+    void schedule_time_slice();
+    void the_end();
+
     const char* insertion_mode_name() const;
 
     DOM::QuirksMode which_quirks_mode(const HTMLToken&) const;
@@ -159,6 +184,7 @@ private:
     bool m_aborted { false };
     bool m_parser_pause_flag { false };
     bool m_stop_parsing { false };
+    bool m_is_running_time_slice { false };
     size_t m_script_nesting_level { 0 };
 
     NonnullRefPtr<DOM::Document> m_document;
@@ -170,6 +196,9 @@ private:
 
     RefPtr<DOM::Text> m_character_insertion_node;
     StringBuilder m_character_insertion_builder;
+
+    RefPtr<Core::Timer> m_time_slice_timer;
+    OwnPtr<HTMLDocumentParser> m_self_until_time_slice_ends;
 };
 
 }
@@ -17,7 +17,14 @@ String HTMLToken::to_string() const
         builder.append("DOCTYPE");
         builder.append(" { name: '");
         builder.append(m_doctype.name.to_string());
-        builder.append("' }");
+        builder.append("'");
+        if (!m_doctype.missing_public_identifier)
+            builder.appendff(", public_identifier: '{}'", m_doctype.public_identifier.string_view());
+        if (!m_doctype.missing_system_identifier)
+            builder.appendff(", system_identifier: '{}'", m_doctype.system_identifier.string_view());
+        if (m_doctype.force_quirks)
+            builder.append(", force_quirks");
+        builder.append(" }");
         break;
     case HTMLToken::Type::StartTag:
         builder.append("StartTag");
@@ -48,7 +55,10 @@ String HTMLToken::to_string() const
             builder.append(attribute.value_builder.to_string());
             builder.append("\" ");
         }
-        builder.append("} }");
+        builder.append("}");
+        if (m_tag.self_closing)
+            builder.append(", self_closing");
+        builder.append(" }");
     }
 
     if (type() == HTMLToken::Type::Comment || type() == HTMLToken::Type::Character) {
@@ -17,8 +17,12 @@ namespace Web::HTML {
 
 #pragma GCC diagnostic ignored "-Wunused-label"
 
-#define CONSUME_NEXT_INPUT_CHARACTER \
-    current_input_character = next_code_point();
+// Until all of the input has arrived, running out of it only means having to wait for more.
+// The current state is then tried again, from the start, once there is some.
+#define CONSUME_NEXT_INPUT_CHARACTER                                  \
+    current_input_character = next_code_point();                      \
+    if (!current_input_character.has_value() && !m_eof_inserted)      \
+        return wait_for_more_input();
 
 #define SWITCH_TO(new_state)              \
     do {                                  \
@@ -86,6 +90,17 @@ namespace Web::HTML {
         restore_to(m_prev_utf8_iterator); \
     } while (0)
 
+// Looking ahead past the input that has arrived so far can't tell anything yet, so put the current
+// input character back, and try again once there's more.
+#define WAIT_FOR_LOOKAHEAD(code_point_count)            \
+    do {                                                \
+        if (!has_lookahead(code_point_count)) {         \
+            m_utf8_iterator = m_prev_utf8_iterator;     \
+            m_source_positions.take_last();             \
+            return wait_for_more_input();               \
+        }                                               \
+    } while (0)
+
 #define ON(code_point) \
     if (current_input_character.has_value() && current_input_character.value() == code_point)
 
@@ -167,6 +182,9 @@ namespace Web::HTML {
     }                     \
     }
 
+// "CounterClockwiseContourIntegral;"
+static constexpr size_t longest_named_character_reference_length = 32;
+
 static inline void log_parse_error(const SourceLocation& location = SourceLocation::current())
 {
     dbgln_if(TOKENIZER_TRACE_DEBUG, "Parse error (tokenization) {}", location);
@@ -174,7 +192,7 @@ static inline void log_parse_error(const SourceLocation& location = SourceLocati
 
 Optional<u32> HTMLTokenizer::next_code_point()
 {
-    if (m_utf8_iterator == m_utf8_view.end())
+    if (m_utf8_iterator == m_utf8_view.end() && !take_pending_input())
         return {};
     skip(1);
     dbgln_if(TOKENIZER_TRACE_DEBUG, "(Tokenizer) Next code_point: {}", (char)*m_prev_utf8_iterator);
@@ -218,7 +236,8 @@ HTMLToken::Position HTMLTokenizer::nth_last_position(size_t n)
 
 Optional<HTMLToken> HTMLTokenizer::next_token()
 {
-    {
+    // If we had to wait for more input, the token we were in the middle of may still need to know where it started.
+    if (!exchange(m_has_waited_for_more_input, false)) {
         auto last_position = m_source_positions.last();
         m_source_positions.clear();
         m_source_positions.append(move(last_position));
@@ -229,6 +248,8 @@ _StartOfFunction:
 
     for (;;) {
         auto current_input_character = next_code_point();
+        if (!current_input_character.has_value() && !m_eof_inserted)
+            return wait_for_more_input();
         switch (m_state) {
             BEGIN_STATE(Data)
             {
@@ -369,6 +390,7 @@ _StartOfFunction:
             BEGIN_STATE(MarkupDeclarationOpen)
             {
                 DONT_CONSUME_NEXT_INPUT_CHARACTER;
+                WAIT_FOR_LOOKAHEAD(max("DOCTYPE"sv.length(), "[CDATA["sv.length()));
                 if (consume_next_if_match("--")) {
                     create_new_token(HTMLToken::Type::Comment);
                     m_current_token.m_start_position = nth_last_position(4);
@@ -541,6 +563,7 @@ _StartOfFunction:
                 }
                 ANYTHING_ELSE
                 {
+                    WAIT_FOR_LOOKAHEAD("UBLIC"sv.length());
                     if (to_ascii_uppercase(current_input_character.value()) == 'P' && consume_next_if_match("UBLIC", CaseSensitivity::CaseInsensitive)) {
                         SWITCH_TO(AfterDOCTYPEPublicKeyword);
                     }
@@ -1539,6 +1562,9 @@ _StartOfFunction:
 
             BEGIN_STATE(NamedCharacterReference)
             {
+                // Enough for the longest one there is, and the code point after it.
+                WAIT_FOR_LOOKAHEAD(longest_named_character_reference_length + 1);
+
                 size_t byte_offset = m_utf8_view.byte_offset_of(m_prev_utf8_iterator);
 
                 auto match = HTML::code_points_from_entity(m_decoded_input.substring_view(byte_offset, m_decoded_input.length() - byte_offset - 1));
@@ -2601,6 +2627,82 @@ bool HTMLTokenizer::consume_next_if_match(const StringView& string, CaseSensitiv
     return true;
 }
 
+bool HTMLTokenizer::has_lookahead(size_t code_point_count)
+{
+    for (;;) {
+        auto it = m_utf8_iterator;
+        size_t available = 0;
+        for (; available < code_point_count && it != m_utf8_view.end(); ++available)
+            ++it;
+        if (available == code_point_count)
+            return true;
+        if (!take_pending_input())
+            return m_eof_inserted;
+    }
+}
+
+bool HTMLTokenizer::take_pending_input()
+{
+    if (m_pending_input.is_empty())
+        return false;
+
+    // Nothing before the last input character will be looked at again, as only that one may have to be reconsumed.
+    size_t offset = m_utf8_view.byte_offset_of(m_utf8_iterator);
+    size_t kept_offset = offset ? m_utf8_view.byte_offset_of(m_prev_utf8_iterator) : 0;
+
+    StringBuilder builder(m_decoded_input.length() - kept_offset + m_pending_input.length());
+    builder.append(m_utf8_view.as_string().substring_view(kept_offset));
+    builder.append(m_pending_input.string_view());
+    m_pending_input.clear();
+
+    m_decoded_input = builder.to_string();
+    m_utf8_view = Utf8View(m_decoded_input);
+    m_prev_utf8_iterator = m_utf8_view.begin();
+    m_utf8_iterator = m_utf8_view.iterator_at_byte_offset(offset - kept_offset);
+    return true;
+}
+
+Optional<HTMLToken> HTMLTokenizer::wait_for_more_input()
+{
+    m_has_waited_for_more_input = true;
+    if (!m_queued_tokens.is_empty())
+        return m_queued_tokens.dequeue();
+    return {};
+}
+
+void HTMLTokenizer::append_input(const StringView& input)
+{
+    VERIFY(!m_eof_inserted);
+
+    // A character may be split between this piece of the input and the next, in which case
+    // its first bytes have to wait for the rest of it.
+    StringView encoded_input = input;
+    ByteBuffer buffer;
+    if (!m_undecoded_input.is_empty()) {
+        buffer = move(m_undecoded_input);
+        buffer.append(input.characters_without_null_termination(), input.length());
+        encoded_input = StringView { buffer };
+    }
+    size_t incomplete_length = m_decoder->length_of_incomplete_suffix(encoded_input);
+    m_undecoded_input = ByteBuffer::copy(encoded_input.substring_view(encoded_input.length() - incomplete_length).bytes());
+
+    auto decoded_input = m_decoder->to_utf8(encoded_input.substring_view(0, encoded_input.length() - incomplete_length));
+    m_pending_input.append(decoded_input);
+    m_source.append(decoded_input);
+}
+
+void HTMLTokenizer::insert_eof()
+{
+    VERIFY(!m_eof_inserted);
+    if (!m_undecoded_input.is_empty()) {
+        auto decoded_input = m_decoder->to_utf8(StringView { m_undecoded_input });
+        m_pending_input.append(decoded_input);
+        m_source.append(decoded_input);
+        m_undecoded_input.clear();
+    }
+    m_eof_inserted = true;
+}
+
 void HTMLTokenizer::create_new_token(HTMLToken::Type type)
 {
     m_current_token = {};
@@ -2620,16 +2722,22 @@ void HTMLTokenizer::create_new_token(HTMLToken::Type type)
     m_current_token.m_start_position = nth_last_position(offset);
 }
 
-HTMLTokenizer::HTMLTokenizer(const StringView& input, const String& encoding)
+HTMLTokenizer::HTMLTokenizer(const String& encoding)
 {
-    auto* decoder = TextCodec::decoder_for(encoding);
-    VERIFY(decoder);
-    m_decoded_input = decoder->to_utf8(input);
+    m_decoder = TextCodec::decoder_for(encoding);
+    VERIFY(m_decoder);
     m_utf8_view = Utf8View(m_decoded_input);
     m_utf8_iterator = m_utf8_view.begin();
     m_source_positions.empend(0u, 0u);
 }
 
+HTMLTokenizer::HTMLTokenizer(const StringView& input, const String& encoding)
+    : HTMLTokenizer(encoding)
+{
+    append_input(input);
+    insert_eof();
+}
+
 void HTMLTokenizer::will_switch_to([[maybe_unused]] State new_state)
 {
     dbgln_if(TOKENIZER_TRACE_DEBUG, "[{}] Switch to {}", state_name(m_state), state_name(new_state));
@@ -6,13 +6,19 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/Queue.h>
+#include <AK/StringBuilder.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <AK/Utf8View.h>
 #include <LibWeb/Forward.h>
 #include <LibWeb/HTML/Parser/HTMLToken.h>
 
+namespace TextCodec {
+class Decoder;
+}
+
 namespace Web::HTML {
 
 #define ENUMERATE_TOKENIZER_STATES                                        \
@@ -99,7 +105,8 @@ namespace Web::HTML {
 
 class HTMLTokenizer {
 public:
-    explicit HTMLTokenizer(const StringView& input, const String& encoding);
+    explicit HTMLTokenizer(const String& encoding);
+    HTMLTokenizer(const StringView& input, const String& encoding);
 
     enum class State {
 #define __ENUMERATE_TOKENIZER_STATE(state) state,
@@ -109,6 +116,13 @@ public:
 
     Optional<HTMLToken> next_token();
 
+    // The input can also be given a piece at a time, as it arrives. Until insert_eof() has been called, running out
+    // of input isn't the end of the file: next_token() returns nothing, and carries on where it left off once more
+    // input has been appended.
+    void append_input(const StringView&);
+    void insert_eof();
+    bool is_eof_inserted() const { return m_eof_inserted; }
+
     void switch_to(Badge<HTMLDocumentParser>, State new_state);
     void switch_to(State new_state)
     {
@@ -118,13 +132,16 @@ public:
     void set_blocked(bool b) { m_blocked = b; }
     bool is_blocked() const { return m_blocked; }
 
-    String source() const { return m_decoded_input; }
+    String source() const { return m_source.to_string(); }
 
 private:
     void skip(size_t count);
     Optional<u32> next_code_point();
     Optional<u32> peek_code_point(size_t offset) const;
     bool consume_next_if_match(const StringView&, CaseSensitivity = CaseSensitivity::CaseSensitive);
+    bool has_lookahead(size_t code_point_count);
+    bool take_pending_input();
+    Optional<HTMLToken> wait_for_more_input();
     void create_new_token(HTMLToken::Type);
     bool current_end_tag_token_is_appropriate() const;
 
@@ -154,8 +171,23 @@ private:
 
     Vector<u32> m_temporary_buffer;
 
+    TextCodec::Decoder* m_decoder { nullptr };
+
+    // The bytes at the end of the input that don't make up a whole character yet.
+    ByteBuffer m_undecoded_input;
+
+    // Decoded input that has arrived since the tokenizer last ran out of it.
+    StringBuilder m_pending_input;
+
+    // Whatever is left of the input, from the last input character on; what came before it has been tokenized.
     String m_decoded_input;
 
+    // All of the decoded input, for view-source.
+    StringBuilder m_source;
+
+    bool m_eof_inserted { false };
+    bool m_has_waited_for_more_input { false };
+
     StringView m_input;
 
     Utf8View m_utf8_view;
@@ -34,6 +34,7 @@ public:
     virtual void split_into_lines(InlineFormattingContext&, LayoutMode) override;
 
     bool is_scrollable() const;
+    bool should_clip_overflow() const;
     const Gfx::FloatPoint& scroll_offset() const { return m_scroll_offset; }
     void set_scroll_offset(const Gfx::FloatPoint&);
 
@@ -42,8 +43,6 @@ private:
     virtual bool wants_mouse_events() const override { return false; }
     virtual bool handle_mousewheel(Badge<EventHandler>, const Gfx::IntPoint&, unsigned buttons, unsigned modifiers, int wheel_delta) override;
 
-    bool should_clip_overflow() const;
-
     Gfx::FloatPoint m_scroll_offset;
 };
 
@@ -5,6 +5,7 @@
  */
 
 #include <LibWeb/CSS/Length.h>
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Node.h>
 #include <LibWeb/Layout/BlockBox.h>
 #include <LibWeb/Layout/BlockFormattingContext.h>
@@ -396,9 +397,27 @@ void BlockFormattingContext::layout_block_level_children(Box& box, LayoutMode la
         }
 
         compute_width(child_box);
-        layout_inside(child_box, layout_mode);
+        bool had_floating_boxes = has_floating_boxes();
+        bool reused_layout = can_reuse_layout_of(child_box, layout_mode);
+        if (reused_layout)
+            ++child_box.document().layout_counters().reused_box_count;
+        else
+            layout_inside(child_box, layout_mode);
         compute_height(child_box);
 
+        if (reused_layout && child_box.height() != child_box.layout_cache()->height) {
+            // The height came out differently after all (e.g. a percentage of a containing block that has changed),
+            // and the contents may depend on it.
+            reused_layout = false;
+            layout_inside(child_box, layout_mode);
+            compute_height(child_box);
+        }
+
+        // Floats that were around while laying out the contents (or that they left behind) shape the line boxes,
+        // so those contents can't be reused without them.
+        if (!reused_layout && layout_mode == LayoutMode::Default && (creates_block_formatting_context(child_box) || (!had_floating_boxes && !has_floating_boxes())))
+            child_box.layout_cache() = Box::LayoutCache { child_box.width(), child_box.height(), {} };
+
         if (child_box.computed_values().position() == CSS::Position::Relative)
             compute_position(child_box);
 
@@ -423,6 +442,42 @@ void BlockFormattingContext::layout_block_level_children(Box& box, LayoutMode la
     }
 }
 
+static bool has_positioned_descendants_relative_to_outside(const Box& box)
+{
+    bool found = false;
+    box.for_each_in_inclusive_subtree_of_type<Box>([&](auto& descendant) {
+        if (&descendant == &box || !descendant.is_absolutely_positioned())
+            return IterationDecision::Continue;
+        const Node* ancestor = descendant.containing_block();
+        while (ancestor && ancestor != &box)
+            ancestor = ancestor->parent();
+        if (!ancestor) {
+            found = true;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    return found;
+}
+
+bool BlockFormattingContext::can_reuse_layout_of(Box& box, LayoutMode layout_mode)
+{
+    if (layout_mode != LayoutMode::Default)
+        return false;
+    if (box.needs_layout() || box.child_needs_layout())
+        return false;
+
+    auto& layout_cache = box.layout_cache();
+    if (!layout_cache.has_value() || layout_cache->width != box.width())
+        return false;
+    if (!creates_block_formatting_context(box) && has_floating_boxes())
+        return false;
+
+    if (!layout_cache->has_positioned_descendants_relative_to_outside.has_value())
+        layout_cache->has_positioned_descendants_relative_to_outside = has_positioned_descendants_relative_to_outside(box);
+    return !layout_cache->has_positioned_descendants_relative_to_outside.value();
+}
+
 void BlockFormattingContext::place_block_level_replaced_element_in_normal_flow(Box& child_box, Box& containing_block)
 {
     VERIFY(!containing_block.is_absolutely_positioned());
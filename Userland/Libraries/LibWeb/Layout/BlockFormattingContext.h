@@ -41,6 +41,8 @@ private:
     void layout_initial_containing_block(LayoutMode);
 
     void layout_block_level_children(Box&, LayoutMode);
+    bool can_reuse_layout_of(Box&, LayoutMode);
+    bool has_floating_boxes() const { return !m_left_floating_boxes.is_empty() || !m_right_floating_boxes.is_empty(); }
     void layout_inline_children(Box&, LayoutMode);
 
     void place_block_level_replaced_element_in_normal_flow(Box& child, Box& container);
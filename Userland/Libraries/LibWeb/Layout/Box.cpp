@@ -10,6 +10,7 @@
 #include <LibWeb/HTML/HTMLHtmlElement.h>
 #include <LibWeb/Layout/BlockBox.h>
 #include <LibWeb/Layout/Box.h>
+#include <LibWeb/Layout/SVGBox.h>
 #include <LibWeb/Page/BrowsingContext.h>
 #include <LibWeb/Painting/BorderPainting.h>
 
@@ -290,10 +291,51 @@ HitTestResult Box::hit_test(const Gfx::IntPoint& position, HitTestType type) con
     return result;
 }
 
+Optional<Gfx::IntRect> Box::paint_bounds() const
+{
+    // SVG boxes have their own idea of geometry.
+    if (is<SVGBox>(*this))
+        return {};
+    // The root element paints its background over the whole viewport.
+    if (is_root_element())
+        return {};
+    // Fixed position boxes get moved along with the viewport while painting.
+    for (const Node* ancestor = this; ancestor; ancestor = ancestor->parent()) {
+        if (ancestor->is_fixed_position())
+            return {};
+    }
+
+    // The margin box is included for the inspector overlay.
+    auto margin_box = box_model().margin_box();
+    Gfx::FloatRect bounds {
+        absolute_x() - margin_box.left,
+        absolute_y() - margin_box.top,
+        width() + margin_box.left + margin_box.right,
+        height() + margin_box.top + margin_box.bottom,
+    };
+    bounds = bounds.united(bordered_rect());
+
+    if (is<BlockBox>(*this) && children_are_inline()) {
+        auto& block = verify_cast<BlockBox>(*this);
+        // Contents that don't fit are either clipped to the box or spill out of it.
+        if (!block.should_clip_overflow()) {
+            block.for_each_fragment([&](auto& fragment) {
+                bounds = bounds.united(fragment.absolute_rect());
+                return IterationDecision::Continue;
+            });
+        }
+    }
+
+    // Glyphs and anti-aliased edges can stick out a little from the boxes they belong to.
+    constexpr int slack = 4;
+    return enclosing_int_rect(bounds).inflated(slack * 2, slack * 2);
+}
+
 void Box::set_needs_display()
 {
     if (!is_inline()) {
-        browsing_context().set_needs_display(enclosing_int_rect(absolute_rect()));
+        // Backgrounds and borders paint outside the content box, so repaint everything the box may have painted.
+        browsing_context().set_needs_display(paint_bounds().value_or(browsing_context().viewport_rect()));
         return;
     }
 
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <LibGfx/Rect.h>
 #include <LibWeb/Layout/LineBox.h>
@@ -100,6 +101,9 @@ public:
     virtual HitTestResult hit_test(const Gfx::IntPoint&, HitTestType) const override;
     virtual void set_needs_display() override;
 
+    // Where painting this box can draw, in the coordinates of the layout tree, if that's easy enough to tell.
+    Optional<Gfx::IntRect> paint_bounds() const;
+
     bool is_body() const;
 
     void set_containing_line_box_fragment(LineBoxFragment&);
@@ -107,6 +111,7 @@ public:
     StackingContext* stacking_context() { return m_stacking_context; }
     const StackingContext* stacking_context() const { return m_stacking_context; }
     void set_stacking_context(NonnullOwnPtr<StackingContext> context) { m_stacking_context = move(context); }
+    void clear_stacking_context() { m_stacking_context = nullptr; }
     StackingContext* enclosing_stacking_context();
 
     virtual void paint(PaintContext&, PaintPhase) override;
@@ -121,6 +126,17 @@ public:
 
     virtual float width_of_logical_containing_block() const;
 
+    // What the last layout of this box's contents was based on. As long as none of it has changed and nothing inside
+    // needs layout, laying the contents out again would give the same result, so BlockFormattingContext skips it.
+    struct LayoutCache {
+        float width { 0 };
+        float height { 0 };
+        // Whether any absolutely positioned descendant has its containing block outside of this box, which the box
+        // can't tell has changed. Worked out when it's first needed.
+        Optional<bool> has_positioned_descendants_relative_to_outside;
+    };
+    Optional<LayoutCache>& layout_cache() { return m_layout_cache; }
+
     struct BorderRadiusData {
         // FIXME: Use floats here
         int top_left { 0 };
@@ -158,6 +174,8 @@ private:
     WeakPtr<LineBoxFragment> m_containing_line_box_fragment;
 
     OwnPtr<StackingContext> m_stacking_context;
+
+    Optional<LayoutCache> m_layout_cache;
 };
 
 template<>
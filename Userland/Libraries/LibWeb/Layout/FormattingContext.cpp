@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/Dump.h>
 #include <LibWeb/Layout/BlockFormattingContext.h>
 #include <LibWeb/Layout/Box.h>
@@ -67,6 +68,10 @@ bool FormattingContext::creates_block_formatting_context(const Box& box)
 
 void FormattingContext::layout_inside(Box& box, LayoutMode layout_mode)
 {
+    // Whatever the contents of the box were laid out for before, it's not going to be that anymore.
+    box.layout_cache().clear();
+    ++box.document().layout_counters().laid_out_box_count;
+
     if (creates_block_formatting_context(box)) {
         BlockFormattingContext context(box, this);
         context.run(box, layout_mode);
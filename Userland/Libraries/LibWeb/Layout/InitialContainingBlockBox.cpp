@@ -42,6 +42,14 @@ void InitialContainingBlockBox::build_stacking_context_tree()
     });
 }
 
+void InitialContainingBlockBox::invalidate_stacking_context_tree()
+{
+    for_each_in_inclusive_subtree_of_type<Box>([&](Box& box) {
+        box.clear_stacking_context();
+        return IterationDecision::Continue;
+    });
+}
+
 void InitialContainingBlockBox::paint_all_phases(PaintContext& context)
 {
     context.painter().translate(-context.viewport_rect().location());
@@ -27,6 +27,7 @@ public:
     void set_selection_end(const LayoutPosition&);
 
     void build_stacking_context_tree();
+    void invalidate_stacking_context_tree();
 
     void recompute_selection_states();
 
@@ -22,7 +22,9 @@ ListItemBox::~ListItemBox()
 void ListItemBox::layout_marker()
 {
     if (m_marker) {
-        remove_child(*m_marker);
+        // The marker is already gone if our children have been rebuilt since it was added.
+        if (m_marker->parent() == this)
+            remove_child(*m_marker);
         m_marker = nullptr;
     }
 
@@ -33,6 +33,25 @@ Node::~Node()
         m_dom_node->set_layout_node({}, nullptr);
 }
 
+void Node::set_needs_layout()
+{
+    m_needs_layout = true;
+    for (auto* ancestor = parent(); ancestor && !ancestor->m_child_needs_layout; ancestor = ancestor->parent())
+        ancestor->m_child_needs_layout = true;
+}
+
+void Node::clear_needs_layout()
+{
+    if (!m_needs_layout && !m_child_needs_layout)
+        return;
+    m_needs_layout = false;
+    m_child_needs_layout = false;
+    // Nodes that were created since the last layout update are dirty without their parent knowing, so look at all children.
+    for_each_child([](auto& child) {
+        child.clear_needs_layout();
+    });
+}
+
 bool Node::can_contain_boxes_with_position_absolute() const
 {
     return computed_values().position() != CSS::Position::Static || is<InitialContainingBlockBox>(*this);
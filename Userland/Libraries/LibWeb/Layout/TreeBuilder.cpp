@@ -4,11 +4,13 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibWeb/CSS/StyleResolver.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/DOM/ParentNode.h>
 #include <LibWeb/DOM/ShadowRoot.h>
 #include <LibWeb/Dump.h>
+#include <LibWeb/Layout/BlockBox.h>
 #include <LibWeb/Layout/InitialContainingBlockBox.h>
 #include <LibWeb/Layout/Node.h>
 #include <LibWeb/Layout/TableBox.h>
@@ -103,17 +105,24 @@ void TreeBuilder::create_layout_tree(DOM::Node& dom_node)
         }
     }
 
+    if (layout_node->can_have_children())
+        create_layout_trees_for_children(dom_node, verify_cast<NodeWithStyle>(*layout_node));
+}
+
+void TreeBuilder::create_layout_trees_for_children(DOM::Node& dom_node, Layout::NodeWithStyle& layout_node)
+{
     auto* shadow_root = is<DOM::Element>(dom_node) ? verify_cast<DOM::Element>(dom_node).shadow_root() : nullptr;
+    if (!dom_node.has_children() && !shadow_root)
+        return;
 
-    if ((dom_node.has_children() || shadow_root) && layout_node->can_have_children()) {
-        push_parent(verify_cast<NodeWithStyle>(*layout_node));
-        if (shadow_root)
-            create_layout_tree(*shadow_root);
-        verify_cast<DOM::ParentNode>(dom_node).for_each_child([&](auto& dom_child) {
-            create_layout_tree(dom_child);
-        });
-        pop_parent();
-    }
+    push_parent(layout_node);
+    CSS::StyleResolver::ScopedAncestor ancestor(dom_node.document().style_resolver(), dom_node);
+    if (shadow_root)
+        create_layout_tree(*shadow_root);
+    verify_cast<DOM::ParentNode>(dom_node).for_each_child([&](auto& dom_child) {
+        create_layout_tree(dom_child);
+    });
+    pop_parent();
 }
 
 RefPtr<Node> TreeBuilder::build(DOM::Node& dom_node)
@@ -132,6 +141,41 @@ RefPtr<Node> TreeBuilder::build(DOM::Node& dom_node)
     return move(m_layout_root);
 }
 
+bool TreeBuilder::can_rebuild_children_of(const DOM::Node& dom_node)
+{
+    auto* layout_node = dom_node.layout_node();
+    return layout_node && is<BlockBox>(*layout_node) && layout_node->can_have_children();
+}
+
+void TreeBuilder::rebuild_children_of(DOM::Node& dom_node)
+{
+    VERIFY(can_rebuild_children_of(dom_node));
+    auto& layout_node = verify_cast<BlockBox>(*dom_node.layout_node());
+
+    {
+        // Get rid of the old layout nodes before building new ones, so that no DOM node is left pointing at one.
+        NonnullRefPtrVector<Layout::Node> old_layout_nodes;
+        layout_node.for_each_in_inclusive_subtree([&](auto& old_layout_node) {
+            if (&old_layout_node != &layout_node)
+                old_layout_nodes.append(old_layout_node);
+            return IterationDecision::Continue;
+        });
+        for (auto& old_layout_node : old_layout_nodes)
+            old_layout_node.parent()->remove_child(old_layout_node);
+        // The line boxes refer to the layout nodes that were just removed.
+        layout_node.line_boxes().clear();
+        layout_node.set_children_are_inline(false);
+    }
+
+    for (auto* ancestor = layout_node.parent(); ancestor; ancestor = ancestor->parent())
+        m_parent_stack.prepend(verify_cast<NodeWithStyle>(ancestor));
+    create_layout_trees_for_children(dom_node, layout_node);
+    m_parent_stack.clear();
+
+    fixup_tables(*dom_node.document().layout_node());
+    layout_node.set_needs_layout();
+}
+
 template<CSS::Display display, typename Callback>
 void TreeBuilder::for_each_in_tree_with_display(NodeWithStyle& root, Callback callback)
 {
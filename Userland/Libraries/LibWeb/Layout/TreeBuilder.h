@@ -18,8 +18,17 @@ public:
 
     RefPtr<Layout::Node> build(DOM::Node&);
 
+    // Throws away the layout nodes below the layout node of the given DOM node, and builds them again from its
+    // children. Only works for DOM nodes that can_rebuild_children_of().
+    void rebuild_children_of(DOM::Node&);
+
+    // Whether all the layout nodes generated by the children of a DOM node end up below its own layout node.
+    // That's the case for block containers, but not for inline nodes, which leave block-level children to their parents.
+    static bool can_rebuild_children_of(const DOM::Node&);
+
 private:
     void create_layout_tree(DOM::Node&);
+    void create_layout_trees_for_children(DOM::Node&, Layout::NodeWithStyle&);
 
     void push_parent(Layout::NodeWithStyle& node) { m_parent_stack.append(&node); }
     void pop_parent() { m_parent_stack.take_last(); }
@@ -15,6 +15,7 @@
 #include <LibWeb/DOM/Text.h>
 #include <LibWeb/HTML/HTMLIFrameElement.h>
 #include <LibWeb/HTML/Parser/HTMLDocumentParser.h>
+#include <LibWeb/HTML/Parser/HTMLEncodingDetection.h>
 #include <LibWeb/Loader/FrameLoader.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Namespace.h>
@@ -23,6 +24,10 @@
 
 namespace Web {
 
+// As many bytes as the encoding sniffing algorithm looks at, which is what we wait for before starting to parse
+// a document that arrives without an encoding.
+static constexpr size_t encoding_sniffing_byte_count = 1024;
+
 FrameLoader::FrameLoader(BrowsingContext& browsing_context)
     : m_browsing_context(browsing_context)
 {
@@ -30,6 +35,7 @@ FrameLoader::FrameLoader(BrowsingContext& browsing_context)
 
 FrameLoader::~FrameLoader()
 {
+    discard_parser();
 }
 
 static bool build_markdown_document(DOM::Document& document, const ByteBuffer& data)
@@ -148,7 +154,14 @@ bool FrameLoader::load(const LoadRequest& request, Type type)
             page->client().page_did_start_loading(url);
     }
 
-    set_resource(ResourceLoader::the().load_resource(Resource::Type::Generic, request));
+    // Whatever was still arriving for the previous document won't anymore.
+    discard_parser();
+    m_data_for_encoding_sniffing.clear();
+
+    auto resource = ResourceLoader::the().load_resource(Resource::Type::Generic, request);
+    // If someone else is already getting the resource, we've missed the start of it, and have to wait for all of it.
+    m_can_parse_incrementally = resource && !resource->has_received_data();
+    set_resource(resource);
 
     if (type == Type::IFrame)
         return true;
@@ -197,6 +210,7 @@ void FrameLoader::load_html(const StringView& html, const URL& url)
     auto document = DOM::Document::create(url);
     HTML::HTMLDocumentParser parser(document, html, "utf-8");
     parser.run(url);
+    discard_parser();
     browsing_context().set_document(&parser.document());
 }
 
@@ -217,6 +231,7 @@ void FrameLoader::load_error_page(const URL& failed_url, const String& error)
             generator.append(data);
             auto document = HTML::parse_html_document(generator.as_string_view(), failed_url, "utf-8");
             VERIFY(document);
+            discard_parser();
             browsing_context().set_document(document);
         },
         [](auto& error, auto) {
@@ -225,6 +240,42 @@ void FrameLoader::load_error_page(const URL& failed_url, const String& error)
         });
 }
 
+void FrameLoader::resource_did_receive_data(ReadonlyBytes data)
+{
+    if (m_parser) {
+        m_parser->append_input(StringView { data });
+        return;
+    }
+
+    if (!m_can_parse_incrementally)
+        return;
+
+    // Redirects are followed once the load has finished, and other kinds of documents are built all at once.
+    auto& mime_type = resource()->mime_type();
+    if (resource()->response_headers().contains("Location") || (mime_type != "text/html" && mime_type != "image/svg+xml")) {
+        m_can_parse_incrementally = false;
+        return;
+    }
+
+    m_data_for_encoding_sniffing.append(data);
+    if (!resource()->has_encoding() && m_data_for_encoding_sniffing.size() < encoding_sniffing_byte_count)
+        return;
+
+    auto document = create_document_for_resource();
+    auto encoding = document->has_encoding() ? document->encoding().value() : HTML::run_encoding_sniffing_algorithm(m_data_for_encoding_sniffing);
+    dbgln_if(PARSER_DEBUG, "Parsing '{}' as it arrives, with encoding '{}'", document->url(), encoding);
+
+    m_parser = make<HTML::HTMLDocumentParser>(*document, encoding);
+    m_parser->on_finish = [this, url = document->url()] {
+        // We're still on the parser's stack here, so it only goes away once its time slice is over.
+        discard_parser();
+        document_did_finish_loading(url);
+    };
+    m_parser->append_input(StringView { m_data_for_encoding_sniffing });
+    m_parser->run_incrementally(document->url());
+    m_data_for_encoding_sniffing.clear();
+}
+
 void FrameLoader::resource_did_load()
 {
     auto url = resource()->url();
@@ -243,6 +294,13 @@ void FrameLoader::resource_did_load()
     }
     m_redirects_count = 0;
 
+    // The parser has seen most of it already, and carries on with the rest in its own time.
+    if (m_parser) {
+        m_parser->insert_eof();
+        return;
+    }
+    m_data_for_encoding_sniffing.clear();
+
     if (!resource()->has_encoded_data()) {
         load_error_page(url, "No data");
         return;
@@ -254,23 +312,35 @@ void FrameLoader::resource_did_load()
         dbgln("This content has MIME type '{}', encoding unknown", resource()->mime_type());
     }
 
-    auto document = DOM::Document::create();
-    document->set_url(url);
-    document->set_encoding(resource()->encoding());
-    document->set_content_type(resource()->mime_type());
-
-    browsing_context().set_document(document);
-
+    auto document = create_document_for_resource();
     if (!parse_document(*document, resource()->encoded_data())) {
         load_error_page(url, "Failed to parse content.");
         return;
     }
 
+    document_did_finish_loading(url);
+}
+
+NonnullRefPtr<DOM::Document> FrameLoader::create_document_for_resource()
+{
+    discard_parser();
+
+    auto document = DOM::Document::create();
+    document->set_url(resource()->url());
+    document->set_encoding(resource()->encoding());
+    document->set_content_type(resource()->mime_type());
+
     // FIXME: Support multiple instances of the Set-Cookie response header.
     auto set_cookie = resource()->response_headers().get("Set-Cookie");
     if (set_cookie.has_value())
         document->set_cookie(set_cookie.value(), Cookie::Source::Http);
 
+    browsing_context().set_document(document);
+    return document;
+}
+
+void FrameLoader::document_did_finish_loading(const URL& url)
+{
     if (!url.fragment().is_empty())
         browsing_context().scroll_to_anchor(url.fragment());
 
@@ -283,6 +353,12 @@ void FrameLoader::resource_did_load()
         page->client().page_did_finish_loading(url);
 }
 
+void FrameLoader::discard_parser()
+{
+    if (m_parser)
+        HTML::HTMLDocumentParser::abort_and_destroy(m_parser.release_nonnull());
+}
+
 void FrameLoader::resource_did_fail()
 {
     load_error_page(resource()->url(), resource()->error());
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/Forward.h>
+#include <AK/OwnPtr.h>
 #include <LibWeb/Forward.h>
 #include <LibWeb/Loader/Resource.h>
 
@@ -36,14 +38,23 @@ public:
 
 private:
     // ^ResourceClient
+    virtual void resource_did_receive_data(ReadonlyBytes) override;
     virtual void resource_did_load() override;
     virtual void resource_did_fail() override;
 
     void load_error_page(const URL& failed_url, const String& error_message);
     bool parse_document(DOM::Document&, const ByteBuffer& data);
+    NonnullRefPtr<DOM::Document> create_document_for_resource();
+    void document_did_finish_loading(const URL&);
+    void discard_parser();
 
     BrowsingContext& m_browsing_context;
     size_t m_redirects_count { 0 };
+
+    // HTML documents are parsed as they arrive, unless the resource was already on its way before we got it.
+    bool m_can_parse_incrementally { false };
+    ByteBuffer m_data_for_encoding_sniffing;
+    OwnPtr<HTML::HTMLDocumentParser> m_parser;
 };
 
 }
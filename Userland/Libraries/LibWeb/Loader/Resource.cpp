@@ -65,13 +65,36 @@ static String mime_type_from_content_type(const String& content_type)
     return content_type;
 }
 
+void Resource::did_receive_data(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap<String, String, CaseInsensitiveStringTraits>& headers, Optional<u32> status_code)
+{
+    VERIFY(!m_loaded);
+    if (!m_has_received_data) {
+        did_receive_response(headers, status_code);
+        m_has_received_data = true;
+    }
+
+    for_each_client([&](auto& client) {
+        client.resource_did_receive_data(data);
+    });
+}
+
 void Resource::did_load(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap<String, String, CaseInsensitiveStringTraits>& headers, Optional<u32> status_code)
 {
     VERIFY(!m_loaded);
     m_encoded_data = ByteBuffer::copy(data);
+    m_loaded = true;
+    m_has_received_data = true;
+    did_receive_response(headers, status_code);
+
+    for_each_client([](auto& client) {
+        client.resource_did_load();
+    });
+}
+
+void Resource::did_receive_response(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, Optional<u32> status_code)
+{
     m_response_headers = headers;
     m_status_code = move(status_code);
-    m_loaded = true;
 
     auto content_type = headers.get("Content-Type");
 
@@ -98,10 +121,6 @@ void Resource::did_load(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap
             m_encoding = encoding.value();
         }
     }
-
-    for_each_client([](auto& client) {
-        client.resource_did_load();
-    });
 }
 
 void Resource::did_fail(Badge<ResourceLoader>, const String& error, Optional<u32> status_code)
@@ -44,6 +44,9 @@ public:
 
     bool has_encoded_data() const { return !m_encoded_data.is_empty(); }
 
+    // Whether some of the data has arrived, though maybe not all of it yet.
+    bool has_received_data() const { return m_has_received_data; }
+
     const URL& url() const { return m_request.url(); }
     const ByteBuffer& encoded_data() const { return m_encoded_data; }
 
@@ -58,6 +61,7 @@ public:
 
     void for_each_client(Function<void(ResourceClient&)>);
 
+    void did_receive_data(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap<String, String, CaseInsensitiveStringTraits>& headers, Optional<u32> status_code);
     void did_load(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap<String, String, CaseInsensitiveStringTraits>& headers, Optional<u32> status_code);
     void did_fail(Badge<ResourceLoader>, const String& error, Optional<u32> status_code);
 
@@ -65,11 +69,14 @@ protected:
     explicit Resource(Type, const LoadRequest&);
 
 private:
+    void did_receive_response(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, Optional<u32> status_code);
+
     LoadRequest m_request;
     ByteBuffer m_encoded_data;
     Type m_type { Type::Generic };
     bool m_loaded { false };
     bool m_failed { false };
+    bool m_has_received_data { false };
     String m_error;
     Optional<String> m_encoding;
 
@@ -83,6 +90,8 @@ class ResourceClient : public Weakable<ResourceClient> {
 public:
     virtual ~ResourceClient();
 
+    // Called with each piece of the data as it arrives over the network, before resource_did_load().
+    virtual void resource_did_receive_data(ReadonlyBytes) { }
     virtual void resource_did_load() { }
     virtual void resource_did_fail() { }
 
@@ -84,12 +84,15 @@ RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRe
         },
         [=](auto& error, auto status_code) {
             const_cast<Resource&>(*resource).did_fail({}, error, status_code);
+        },
+        [=](auto data, auto& headers, auto status_code) {
+            const_cast<Resource&>(*resource).did_receive_data({}, data, headers, status_code);
         });
 
     return resource;
 }
 
-void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback)
+void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> data_callback)
 {
     auto& url = request.url();
 
@@ -174,9 +177,15 @@ void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyByte
             deferred_invoke([protocol_request](auto&) {
                 // Clear circular reference of `protocol_request` captured by copy
                 const_cast<Protocol::Request&>(*protocol_request).on_buffered_request_finish = nullptr;
+                const_cast<Protocol::Request&>(*protocol_request).on_buffered_request_data = nullptr;
             });
             success_callback(payload, response_headers, status_code);
         };
+        if (data_callback) {
+            protocol_request->on_buffered_request_data = [data_callback = move(data_callback)](auto& response_headers, auto status_code, ReadonlyBytes data) {
+                data_callback(data, response_headers, status_code);
+            };
+        }
         protocol_request->set_should_buffer_all_input(true);
         protocol_request->on_certificate_requested = []() -> Protocol::Request::CertificateAndKey {
             return {};
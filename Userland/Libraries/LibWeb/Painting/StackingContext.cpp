@@ -6,7 +6,9 @@
 
 #include <AK/QuickSort.h>
 #include <AK/StringBuilder.h>
+#include <LibGfx/Painter.h>
 #include <LibWeb/DOM/Node.h>
+#include <LibWeb/Layout/BlockBox.h>
 #include <LibWeb/Layout/Box.h>
 #include <LibWeb/Layout/InitialContainingBlockBox.h>
 #include <LibWeb/Painting/StackingContext.h>
@@ -29,74 +31,142 @@ StackingContext::StackingContext(Box& box, StackingContext* parent)
     }
 }
 
-void StackingContext::paint_descendants(PaintContext& context, Node& box, StackingContextPaintPhase phase)
+// Where painting the node can draw, in the coordinates of the layout tree, if that's easy enough to tell.
+static Optional<Gfx::IntRect> paint_bounds(const Node& node)
+{
+    // Inline nodes paint all of their descendants.
+    if (!is<Box>(node))
+        return {};
+    return verify_cast<Box>(node).paint_bounds();
+}
+
+void StackingContext::record_paint(Node& node, PaintPhase phase, DisplayListItem::Type type)
+{
+    DisplayListItem item;
+    item.type = type;
+    item.node = &node;
+    item.phase = phase;
+    if (type == DisplayListItem::Type::Paint)
+        item.bounds = paint_bounds(node);
+    m_display_list.append(move(item));
+}
+
+void StackingContext::record_descendants(Node& box, StackingContextPaintPhase phase)
 {
     box.for_each_child([&](auto& child) {
         switch (phase) {
         case StackingContextPaintPhase::BackgroundAndBorders:
             if (!child.is_floating() && !child.is_positioned()) {
-                child.paint(context, PaintPhase::Background);
-                child.paint(context, PaintPhase::Border);
-                paint_descendants(context, child, phase);
+                record_paint(child, PaintPhase::Background);
+                record_paint(child, PaintPhase::Border);
+                record_descendants(child, phase);
             }
             break;
         case StackingContextPaintPhase::Floats:
             if (!child.is_positioned()) {
                 if (child.is_floating()) {
-                    child.paint(context, PaintPhase::Background);
-                    child.paint(context, PaintPhase::Border);
-                    paint_descendants(context, child, StackingContextPaintPhase::BackgroundAndBorders);
+                    record_paint(child, PaintPhase::Background);
+                    record_paint(child, PaintPhase::Border);
+                    record_descendants(child, StackingContextPaintPhase::BackgroundAndBorders);
                 }
-                paint_descendants(context, child, phase);
+                record_descendants(child, phase);
             }
             break;
         case StackingContextPaintPhase::Foreground:
             if (!child.is_positioned()) {
-                child.paint(context, PaintPhase::Foreground);
-                child.before_children_paint(context, PaintPhase::Foreground);
-                paint_descendants(context, child, phase);
-                child.after_children_paint(context, PaintPhase::Foreground);
+                record_paint(child, PaintPhase::Foreground);
+                record_paint(child, PaintPhase::Foreground, DisplayListItem::Type::BeforeChildrenPaint);
+                record_descendants(child, phase);
+                record_paint(child, PaintPhase::Foreground, DisplayListItem::Type::AfterChildrenPaint);
             }
             break;
         case StackingContextPaintPhase::FocusAndOverlay:
-            if (context.has_focus()) {
-                child.paint(context, PaintPhase::FocusOutline);
-            }
-            child.paint(context, PaintPhase::Overlay);
-            paint_descendants(context, child, phase);
+            record_paint(child, PaintPhase::FocusOutline);
+            m_display_list.last().only_with_focus = true;
+            record_paint(child, PaintPhase::Overlay);
+            record_descendants(child, phase);
             break;
         }
     });
 }
 
-void StackingContext::paint(PaintContext& context)
+void StackingContext::record_display_list()
 {
+    m_display_list.clear();
+
+    auto record_stacking_context = [&](StackingContext& stacking_context) {
+        DisplayListItem item;
+        item.type = DisplayListItem::Type::PaintStackingContext;
+        item.stacking_context = &stacking_context;
+        m_display_list.append(move(item));
+    };
+
     // For a more elaborate description of the algorithm, see CSS 2.1 Appendix E
     // Draw the background and borders for the context root (steps 1, 2)
-    m_box.paint(context, PaintPhase::Background);
-    m_box.paint(context, PaintPhase::Border);
+    record_paint(m_box, PaintPhase::Background);
+    record_paint(m_box, PaintPhase::Border);
     // Draw positioned descendants with negative z-indices (step 3)
     for (auto* child : m_children) {
         if (child->m_box.computed_values().z_index().has_value() && child->m_box.computed_values().z_index().value() < 0)
-            child->paint(context);
+            record_stacking_context(*child);
     }
     // Draw the background and borders for block-level children (step 4)
-    paint_descendants(context, m_box, StackingContextPaintPhase::BackgroundAndBorders);
+    record_descendants(m_box, StackingContextPaintPhase::BackgroundAndBorders);
     // Draw the non-positioned floats (step 5)
-    paint_descendants(context, m_box, StackingContextPaintPhase::Floats);
+    record_descendants(m_box, StackingContextPaintPhase::Floats);
     // Draw inline content, replaced content, etc. (steps 6, 7)
-    m_box.paint(context, PaintPhase::Foreground);
-    paint_descendants(context, m_box, StackingContextPaintPhase::Foreground);
+    record_paint(m_box, PaintPhase::Foreground);
+    record_descendants(m_box, StackingContextPaintPhase::Foreground);
     // Draw other positioned descendants (steps 8, 9)
     for (auto* child : m_children) {
         if (child->m_box.computed_values().z_index().has_value() && child->m_box.computed_values().z_index().value() < 0)
             continue;
-        child->paint(context);
+        record_stacking_context(*child);
     }
 
-    m_box.paint(context, PaintPhase::FocusOutline);
-    m_box.paint(context, PaintPhase::Overlay);
-    paint_descendants(context, m_box, StackingContextPaintPhase::FocusAndOverlay);
+    record_paint(m_box, PaintPhase::FocusOutline);
+    record_paint(m_box, PaintPhase::Overlay);
+    record_descendants(m_box, StackingContextPaintPhase::FocusAndOverlay);
+
+    m_has_display_list = true;
+}
+
+void StackingContext::invalidate_display_list()
+{
+    m_display_list.clear();
+    m_has_display_list = false;
+    for (auto* child : m_children)
+        child->invalidate_display_list();
+}
+
+void StackingContext::paint(PaintContext& context)
+{
+    if (!m_has_display_list)
+        record_display_list();
+
+    auto& painter = context.painter();
+    auto dirty_rect = painter.clip_rect().translated(-painter.translation());
+
+    for (auto& item : m_display_list) {
+        switch (item.type) {
+        case DisplayListItem::Type::Paint:
+            if (item.only_with_focus && !context.has_focus())
+                break;
+            if (item.bounds.has_value() && !item.bounds->intersects(dirty_rect))
+                break;
+            item.node->paint(context, item.phase);
+            break;
+        case DisplayListItem::Type::BeforeChildrenPaint:
+            item.node->before_children_paint(context, item.phase);
+            break;
+        case DisplayListItem::Type::AfterChildrenPaint:
+            item.node->after_children_paint(context, item.phase);
+            break;
+        case DisplayListItem::Type::PaintStackingContext:
+            item.stacking_context->paint(context);
+            break;
+        }
+    }
 }
 
 HitTestResult StackingContext::hit_test(const Gfx::IntPoint& position, HitTestType type) const
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <AK/Vector.h>
+#include <LibGfx/Rect.h>
 #include <LibWeb/Layout/Node.h>
 
 namespace Web::Layout {
@@ -25,16 +27,45 @@ public:
         FocusAndOverlay,
     };
 
-    void paint_descendants(PaintContext&, Node&, StackingContextPaintPhase);
     void paint(PaintContext&);
     HitTestResult hit_test(const Gfx::IntPoint&, HitTestType) const;
 
+    // Throws away the recorded display lists of this stacking context and the ones inside it.
+    // They have to go whenever boxes may have moved around.
+    void invalidate_display_list();
+
     void dump(int indent = 0) const;
 
 private:
+    // The order in which paint() visits the boxes only changes with layout, so it's worked out once and recorded as a
+    // list of paint calls, each with the area it can draw into. Replaying the list then skips the calls that can't
+    // touch the part of the page that is actually being painted.
+    struct DisplayListItem {
+        enum class Type {
+            Paint,
+            BeforeChildrenPaint,
+            AfterChildrenPaint,
+            PaintStackingContext,
+        };
+        Type type { Type::Paint };
+        Node* node { nullptr };
+        PaintPhase phase { PaintPhase::Background };
+        StackingContext* stacking_context { nullptr };
+        bool only_with_focus { false };
+        // If there are no bounds, the item is always replayed.
+        Optional<Gfx::IntRect> bounds;
+    };
+
+    void record_display_list();
+    void record_descendants(Node&, StackingContextPaintPhase);
+    void record_paint(Node&, PaintPhase, DisplayListItem::Type = DisplayListItem::Type::Paint);
+
     Box& m_box;
     StackingContext* const m_parent { nullptr };
     Vector<StackingContext*> m_children;
+
+    Vector<DisplayListItem> m_display_list;
+    bool m_has_display_list { false };
 };
 
 }
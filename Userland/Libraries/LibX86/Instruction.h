@@ -467,6 +467,7 @@ public:
     String mnemonic() const;
 
     u8 op() const { return m_op; }
+    u8 sub_op() const { return m_sub_op; }
     u8 rm() const { return m_modrm.m_rm; }
     u8 slash() const { return (rm() >> 3) & 7; }
 
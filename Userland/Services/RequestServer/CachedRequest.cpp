@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <RequestServer/CachedRequest.h>
+
+namespace RequestServer {
+
+CachedRequest::CachedRequest(ClientConnection& client, HttpCache::Entry entry, int body_fd)
+    : Request(client)
+    , m_entry(move(entry))
+{
+    set_request_fd(body_fd);
+
+    // The client doesn't know about this request until start_request() has returned, so respond on the next turn of the event loop.
+    m_timer = Core::Timer::create_single_shot(0, [this] {
+        did_load_from_cache(m_entry);
+    });
+    m_timer->start();
+}
+
+CachedRequest::~CachedRequest()
+{
+    m_timer->stop();
+}
+
+NonnullOwnPtr<CachedRequest> CachedRequest::create(ClientConnection& client, HttpCache::Entry entry, int body_fd)
+{
+    return adopt_own(*new CachedRequest(client, move(entry), body_fd));
+}
+
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <LibCore/Timer.h>
+#include <RequestServer/HttpCache.h>
+#include <RequestServer/Request.h>
+
+namespace RequestServer {
+
+// A request answered from the HTTP cache without going to the network.
+// The client reads the body straight from the cached file, so we never touch it.
+class CachedRequest final : public Request {
+public:
+    virtual ~CachedRequest() override;
+    static NonnullOwnPtr<CachedRequest> create(ClientConnection&, HttpCache::Entry, int body_fd);
+
+private:
+    explicit CachedRequest(ClientConnection&, HttpCache::Entry, int body_fd);
+
+    HttpCache::Entry m_entry;
+    RefPtr<Core::Timer> m_timer;
+};
+
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Debug.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/String.h>
+#include <AK/StdLibExtras.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <LibCore/Timer.h>
+#include <LibTLS/TLSv12.h>
+
+namespace RequestServer {
+
+// How many connections we keep open to a single host and port at the same time. Further requests wait for one of them to become free.
+constexpr size_t max_connections_per_host = 4;
+// How long an idle connection is kept around, waiting for another request.
+constexpr int idle_connection_timeout_ms = 10'000;
+
+struct ConnectionCacheStatistics {
+    u64 connections_opened { 0 };
+    u64 connections_reused { 0 };
+    u64 connections_expired { 0 };
+    u64 jobs_queued { 0 };
+    u64 jobs_retried { 0 };
+};
+
+// Keeps persistent HTTP/1.1 connections around, so requests to the same origin don't pay for
+// a new TCP connection (and, for HTTPS, a new TLS handshake) every time.
+// Jobs hold on to their connection from start_job() until release_job(), one job per connection at a time.
+template<typename JobType, typename SocketType>
+class ConnectionCache {
+public:
+    explicit ConnectionCache(const char* name)
+        : m_name(name)
+    {
+    }
+
+    void start_job(JobType& job)
+    {
+        auto& pool = ensure_pool(job.url());
+
+        for (auto& connection : pool.connections) {
+            if (connection->current_job)
+                continue;
+            connection->idle_timer->stop();
+            connection->reused = true;
+            ++m_statistics.connections_reused;
+            run_job_on_connection(job, *connection);
+            return;
+        }
+
+        if (pool.connections.size() < max_connections_per_host) {
+            auto& connection = open_connection(pool);
+            run_job_on_connection(job, connection);
+            return;
+        }
+
+        dbgln_if(REQUESTSERVER_DEBUG, "ConnectionCache({}): All connections to {} are busy, queueing job", m_name, key_for(job.url()));
+        ++m_statistics.jobs_queued;
+        pool.waiting_jobs.append(job);
+    }
+
+    // Must be called once the job is done with its connection, whether it succeeded, failed or was cancelled.
+    void release_job(JobType& job)
+    {
+        auto key = key_for(job.url());
+        auto it = m_pools.find(key);
+        if (it == m_pools.end()) {
+            job.shutdown();
+            return;
+        }
+        auto& pool = *it->value;
+
+        if (pool.waiting_jobs.remove_first_matching([&](auto& waiting_job) { return waiting_job.ptr() == &job; })) {
+            job.shutdown();
+            return;
+        }
+
+        auto index = find_connection(pool, [&](auto& connection) { return connection.current_job == &job; });
+        if (!index.has_value()) {
+            job.shutdown();
+            return;
+        }
+
+        auto reusable = job.can_reuse_connection();
+        job.shutdown();
+
+        auto& connection = *pool.connections[index.value()];
+        connection.current_job = nullptr;
+        if (!reusable) {
+            dbgln_if(REQUESTSERVER_DEBUG, "ConnectionCache({}): Connection to {} can't be reused, closing it", m_name, key);
+            close_connection(pool, index.value());
+        } else {
+            make_idle(key, connection);
+        }
+
+        if (!pool.waiting_jobs.is_empty()) {
+            auto next_job = pool.waiting_jobs.take_first();
+            start_job(*next_job);
+        }
+    }
+
+    // The server may close a kept-alive connection at any point while it's idle, and we only find out once we've
+    // sent another request over it. Such a request gets one more go on a fresh connection, if it's safe to send twice.
+    // Returns whether the job was restarted, in which case it hasn't really finished.
+    bool retry_on_new_connection(JobType& job)
+    {
+        if (!job.can_retry_on_new_connection())
+            return false;
+        auto key = key_for(job.url());
+        auto it = m_pools.find(key);
+        if (it == m_pools.end())
+            return false;
+        auto& pool = *it->value;
+
+        // A fresh connection failing is not something another one would fix, which also limits this to one retry.
+        auto index = find_connection(pool, [&](auto& connection) { return connection.current_job == &job; });
+        if (!index.has_value() || !pool.connections[index.value()]->reused)
+            return false;
+
+        dbgln_if(REQUESTSERVER_DEBUG, "ConnectionCache({}): Reused connection to {} was closed by the server, retrying on a new one", m_name, key);
+        ++m_statistics.jobs_retried;
+        job.shutdown();
+        close_connection(pool, index.value());
+
+        // Take the slot right away, so no waiting job gets it in the meantime.
+        auto& connection = open_connection(pool);
+        connection.current_job = job;
+        NonnullRefPtr<SocketType> socket = connection.socket;
+        NonnullRefPtr<JobType> protector = job;
+        // We're still inside the job's failure handling, which shuts the job down once we return.
+        job.deferred_invoke([this, key, socket, protector](auto&) mutable {
+            // The request may have gone away since, taking the job's claim on the connection with it.
+            auto it = m_pools.find(key);
+            if (it == m_pools.end())
+                return;
+            if (!find_connection(*it->value, [&](auto& connection) { return connection.socket.ptr() == socket.ptr() && connection.current_job == protector.ptr(); }).has_value())
+                return;
+            protector->reset_for_retry();
+            protector->start(*socket);
+        });
+        return true;
+    }
+
+    const ConnectionCacheStatistics& statistics() const { return m_statistics; }
+
+    void dump_statistics() const
+    {
+        if constexpr (REQUESTSERVER_DEBUG) {
+            dbgln("ConnectionCache({}): {} connections opened, {} reused, {} expired while idle, {} jobs had to wait, {} retried on a new connection",
+                m_name, m_statistics.connections_opened, m_statistics.connections_reused, m_statistics.connections_expired, m_statistics.jobs_queued, m_statistics.jobs_retried);
+            if constexpr (IsSame<SocketType, TLS::TLSv12>)
+                dbgln("ConnectionCache({}): {} TLS handshakes saved", m_name, m_statistics.connections_reused);
+        }
+    }
+
+private:
+    struct Connection {
+        NonnullRefPtr<SocketType> socket;
+        NonnullRefPtr<Core::Timer> idle_timer;
+        RefPtr<JobType> current_job;
+        // Whether it has been handed out again after its first job, and so might have been closed by the server while idle.
+        bool reused { false };
+    };
+
+    struct Pool {
+        Vector<NonnullOwnPtr<Connection>> connections;
+        Vector<NonnullRefPtr<JobType>> waiting_jobs;
+    };
+
+    static String key_for(const URL& url)
+    {
+        return String::formatted("{}:{}", url.host(), url.port());
+    }
+
+    Pool& ensure_pool(const URL& url)
+    {
+        auto key = key_for(url);
+        if (auto it = m_pools.find(key); it != m_pools.end())
+            return *it->value;
+        auto pool = make<Pool>();
+        auto& pool_ref = *pool;
+        m_pools.set(key, move(pool));
+        return pool_ref;
+    }
+
+    template<typename Callback>
+    static Optional<size_t> find_connection(Pool& pool, Callback callback)
+    {
+        for (size_t i = 0; i < pool.connections.size(); ++i) {
+            if (callback(*pool.connections[i]))
+                return i;
+        }
+        return {};
+    }
+
+    Connection& open_connection(Pool& pool)
+    {
+        auto socket = SocketType::construct(nullptr);
+        auto idle_timer = Core::Timer::create_single_shot(idle_connection_timeout_ms, nullptr);
+        pool.connections.append(make<Connection>(Connection { move(socket), move(idle_timer), {}, false }));
+        ++m_statistics.connections_opened;
+        return *pool.connections.last();
+    }
+
+    void close_connection(Pool& pool, size_t index)
+    {
+        auto& connection = *pool.connections[index];
+        connection.idle_timer->stop();
+        connection.idle_timer->on_timeout = nullptr;
+        clear_idle_callbacks(*connection.socket);
+        connection.socket->close();
+        pool.connections.remove(index);
+    }
+
+    // Drops the connection that uses the given socket, unless a job has taken it over in the meantime.
+    void expire_idle_connection(const String& key, SocketType* socket)
+    {
+        auto it = m_pools.find(key);
+        if (it == m_pools.end())
+            return;
+        auto& pool = *it->value;
+        auto index = find_connection(pool, [&](auto& connection) { return connection.socket.ptr() == socket && !connection.current_job; });
+        if (!index.has_value())
+            return;
+        dbgln_if(REQUESTSERVER_DEBUG, "ConnectionCache({}): Dropping idle connection to {}", m_name, key);
+        ++m_statistics.connections_expired;
+        close_connection(pool, index.value());
+        if (pool.connections.is_empty() && pool.waiting_jobs.is_empty())
+            m_pools.remove(key);
+        // Everything we had open has gone quiet, which is a good time to report how well the cache did.
+        if (m_pools.is_empty())
+            dump_statistics();
+    }
+
+    void make_idle(const String& key, Connection& connection)
+    {
+        SocketType* socket = connection.socket.ptr();
+        // Removing the connection destroys the socket, so never do that from inside one of its callbacks.
+        auto expire_later = [this, key, socket] {
+            socket->deferred_invoke([this, key, socket](auto&) {
+                expire_idle_connection(key, socket);
+            });
+        };
+
+        // While idle, anything the server sends us is either the connection being closed or garbage, both of which end it.
+        if constexpr (IsSame<SocketType, TLS::TLSv12>) {
+            socket->on_tls_ready_to_read = [expire_later](auto&) { expire_later(); };
+            socket->on_tls_finished = [expire_later] { expire_later(); };
+            socket->on_tls_error = [expire_later](auto) { expire_later(); };
+        } else {
+            socket->on_ready_to_read = [expire_later] { expire_later(); };
+        }
+
+        connection.idle_timer->on_timeout = [this, key, socket] {
+            expire_idle_connection(key, socket);
+        };
+        connection.idle_timer->restart(idle_connection_timeout_ms);
+    }
+
+    static void clear_idle_callbacks(SocketType& socket)
+    {
+        if constexpr (IsSame<SocketType, TLS::TLSv12>) {
+            socket.on_tls_ready_to_read = nullptr;
+            socket.on_tls_finished = nullptr;
+            socket.on_tls_error = nullptr;
+        } else {
+            socket.on_ready_to_read = nullptr;
+        }
+    }
+
+    void run_job_on_connection(JobType& job, Connection& connection)
+    {
+        clear_idle_callbacks(*connection.socket);
+        connection.current_job = job;
+        job.start(*connection.socket);
+    }
+
+    const char* m_name { nullptr };
+    HashMap<String, NonnullOwnPtr<Pool>> m_pools;
+    ConnectionCacheStatistics m_statistics;
+};
+
+}
@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/DateTime.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <RequestServer/HttpCache.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+namespace RequestServer {
+
+static u32 s_next_temporary_file_id = 0;
+
+// Headers that only describe the connection the response came in on, so they make no sense to store.
+static constexpr StringView hop_by_hop_headers[] = {
+    "Connection",
+    "Keep-Alive",
+    "Proxy-Connection",
+    "TE",
+    "Trailer",
+    "Transfer-Encoding",
+    "Upgrade",
+};
+
+static bool is_hop_by_hop_header(StringView name)
+{
+    for (auto header : hop_by_hop_headers) {
+        if (name.equals_ignoring_case(header))
+            return true;
+    }
+    return false;
+}
+
+static Optional<String> find_request_header(HashMap<String, String> const& headers, StringView name)
+{
+    for (auto& it : headers) {
+        if (it.key.equals_ignoring_case(name))
+            return it.value;
+    }
+    return {};
+}
+
+// Looks for a Cache-Control directive like "no-store" or "max-age=60", returning its argument (if any) when found.
+static Optional<StringView> find_cache_control_directive(Optional<String> const& cache_control, StringView name)
+{
+    if (!cache_control.has_value())
+        return {};
+    for (auto directive : cache_control->split_view(',')) {
+        directive = directive.trim_whitespace();
+        auto equals = directive.find('=');
+        auto directive_name = equals.has_value() ? directive.substring_view(0, equals.value()).trim_whitespace() : directive;
+        if (!directive_name.equals_ignoring_case(name))
+            continue;
+        if (!equals.has_value())
+            return StringView { "" };
+        auto argument = directive.substring_view(equals.value() + 1).trim_whitespace();
+        if (argument.length() >= 2 && argument.starts_with('"') && argument.ends_with('"'))
+            argument = argument.substring_view(1, argument.length() - 2);
+        return argument;
+    }
+    return {};
+}
+
+static Optional<time_t> parse_http_date(Optional<String> const& value)
+{
+    if (!value.has_value())
+        return {};
+    // FIXME: Also accept the obsolete RFC 850 and asctime() formats.
+    auto date = Core::DateTime::parse("%a, %d %b %Y %T GMT", value.value());
+    if (!date.has_value())
+        return {};
+    return date->timestamp();
+}
+
+static String sha256_hex(ReadonlyBytes bytes)
+{
+    auto digest = Crypto::Hash::SHA256::hash(bytes.data(), bytes.size());
+    return encode_hex({ digest.immutable_data(), digest.data_length() });
+}
+
+static bool write_file_atomically(String const& directory, String const& path, ReadonlyBytes contents)
+{
+    auto temporary_path = String::formatted("{}/tmp/{}.{}", directory, getpid(), s_next_temporary_file_id++);
+    int fd = open(temporary_path.characters(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        dbgln("HttpCache: Couldn't create {}: {}", temporary_path, strerror(errno));
+        return false;
+    }
+    for (size_t written = 0; written < contents.size();) {
+        auto nwritten = write(fd, contents.data() + written, contents.size() - written);
+        if (nwritten <= 0) {
+            close(fd);
+            unlink(temporary_path.characters());
+            return false;
+        }
+        written += nwritten;
+    }
+    close(fd);
+    if (rename(temporary_path.characters(), path.characters()) < 0) {
+        unlink(temporary_path.characters());
+        return false;
+    }
+    return true;
+}
+
+HttpCache& HttpCache::the()
+{
+    static HttpCache cache;
+    return cache;
+}
+
+void HttpCache::set_directory(String const& directory)
+{
+    for (auto* subdirectory : { "entries", "bodies", "tmp" }) {
+        auto path = String::formatted("{}/{}", directory, subdirectory);
+        if (!Core::File::ensure_parent_directories(path) || (mkdir(path.characters(), 0700) < 0 && errno != EEXIST)) {
+            dbgln("HttpCache: Couldn't create {}, running without a cache", path);
+            return;
+        }
+    }
+    m_directory = directory;
+    evict_if_needed();
+}
+
+// The fragment never makes it to the server, so it has no business being part of the key.
+static URL without_fragment(URL const& url)
+{
+    auto result = url;
+    result.set_fragment({});
+    return result;
+}
+
+String HttpCache::key_for(URL const& url)
+{
+    return sha256_hex(without_fragment(url).to_string().bytes());
+}
+
+String HttpCache::entry_path(String const& key) const
+{
+    return String::formatted("{}/entries/{}", m_directory, key);
+}
+
+String HttpCache::body_path(String const& body_hash) const
+{
+    return String::formatted("{}/bodies/{}", m_directory, body_hash);
+}
+
+bool HttpCache::can_use_for_request(String const& method, HashMap<String, String> const& request_headers) const
+{
+    if (!is_enabled() || !method.equals_ignoring_case("GET"))
+        return false;
+    // Responses to authorized or partial requests aren't something we know how to store.
+    if (find_request_header(request_headers, "Authorization").has_value() || find_request_header(request_headers, "Range").has_value())
+        return false;
+    return !find_cache_control_directive(find_request_header(request_headers, "Cache-Control"), "no-store").has_value();
+}
+
+Optional<HttpCache::Entry> HttpCache::read_entry(String const& path) const
+{
+    auto file_or_error = Core::File::open(path, Core::OpenMode::ReadOnly);
+    if (file_or_error.is_error())
+        return {};
+    auto contents = file_or_error.value()->read_all();
+    auto lines = StringView { contents }.lines();
+    if (lines.size() < 2)
+        return {};
+
+    Entry entry;
+    entry.url = lines[0];
+    auto fields = lines[1].split_view(' ');
+    if (fields.size() != 5)
+        return {};
+    auto status_code = fields[0].to_uint();
+    auto request_time = fields[1].to_uint<u64>();
+    auto response_time = fields[2].to_uint<u64>();
+    auto body_size = fields[4].to_uint<u64>();
+    if (!entry.url.is_valid() || !status_code.has_value() || !request_time.has_value() || !response_time.has_value() || !body_size.has_value())
+        return {};
+    entry.status_code = status_code.value();
+    entry.request_time = request_time.value();
+    entry.response_time = response_time.value();
+    entry.body_hash = fields[3];
+    entry.body_size = body_size.value();
+
+    for (size_t i = 2; i < lines.size(); ++i) {
+        auto colon = lines[i].find(':');
+        if (!colon.has_value())
+            return {};
+        entry.response_headers.set(lines[i].substring_view(0, colon.value()), lines[i].substring_view(colon.value() + 1).trim_whitespace());
+    }
+    return entry;
+}
+
+bool HttpCache::write_entry(Entry const& entry)
+{
+    StringBuilder builder;
+    builder.appendff("{}\n", entry.url);
+    builder.appendff("{} {} {} {} {}\n", entry.status_code, (u64)entry.request_time, (u64)entry.response_time, entry.body_hash, entry.body_size);
+    for (auto& header : entry.response_headers)
+        builder.appendff("{}: {}\n", header.key, header.value);
+    return write_file_atomically(m_directory, entry_path(key_for(entry.url)), builder.string_view().bytes());
+}
+
+Optional<HttpCache::Entry> HttpCache::lookup(URL const& url)
+{
+    if (!is_enabled())
+        return {};
+    auto path = entry_path(key_for(url));
+    auto entry = read_entry(path);
+    if (!entry.has_value() || entry->url != without_fragment(url))
+        return {};
+    // The modification time of an entry is when it was last used, that's what eviction goes by.
+    utime(path.characters(), nullptr);
+    return entry;
+}
+
+bool HttpCache::is_fresh(Entry const& entry, HashMap<String, String> const& request_headers) const
+{
+    if (find_cache_control_directive(find_request_header(request_headers, "Cache-Control"), "no-cache").has_value())
+        return false;
+    if (auto pragma = find_request_header(request_headers, "Pragma"); pragma.has_value() && pragma->equals_ignoring_case("no-cache"))
+        return false;
+
+    auto cache_control = entry.response_headers.get("Cache-Control");
+    if (find_cache_control_directive(cache_control, "no-cache").has_value())
+        return false;
+
+    // See RFC 7234, 4.2.1 Calculating Freshness Lifetime.
+    auto date = parse_http_date(entry.response_headers.get("Date")).value_or(entry.response_time);
+    Optional<i64> freshness_lifetime;
+    if (auto max_age = find_cache_control_directive(cache_control, "max-age"); max_age.has_value())
+        freshness_lifetime = max_age->to_uint<u64>().value_or(0);
+    else if (auto expires = entry.response_headers.get("Expires"); expires.has_value())
+        freshness_lifetime = (i64)parse_http_date(expires).value_or(0) - date;
+    else if (auto last_modified = parse_http_date(entry.response_headers.get("Last-Modified")); last_modified.has_value())
+        freshness_lifetime = max<i64>(0, date - last_modified.value()) / 10; // See RFC 7234, 4.2.2 Calculating Heuristic Freshness.
+    if (!freshness_lifetime.has_value() || freshness_lifetime.value() <= 0)
+        return false;
+
+    // See RFC 7234, 4.2.3 Calculating Age.
+    i64 age_value = 0;
+    if (auto age = entry.response_headers.get("Age"); age.has_value())
+        age_value = age->to_uint<u64>().value_or(0);
+    auto apparent_age = max<i64>(0, entry.response_time - date);
+    auto response_delay = entry.response_time - entry.request_time;
+    auto corrected_initial_age = max(apparent_age, age_value + response_delay);
+    auto current_age = corrected_initial_age + (time(nullptr) - entry.response_time);
+
+    return freshness_lifetime.value() > current_age;
+}
+
+bool HttpCache::add_validators(Entry const& entry, HashMap<String, String>& request_headers)
+{
+    auto etag = entry.response_headers.get("ETag");
+    auto last_modified = entry.response_headers.get("Last-Modified");
+    if (etag.has_value())
+        request_headers.set("If-None-Match", etag.value());
+    if (last_modified.has_value())
+        request_headers.set("If-Modified-Since", last_modified.value());
+    return etag.has_value() || last_modified.has_value();
+}
+
+int HttpCache::open_body(Entry const& entry)
+{
+    int fd = open(body_path(entry.body_hash).characters(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        dbgln_if(REQUESTSERVER_DEBUG, "HttpCache: Body of {} has been evicted", entry.url);
+        remove(entry.url);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (u64)st.st_size != entry.body_size) {
+        close(fd);
+        remove(entry.url);
+        return -1;
+    }
+    return fd;
+}
+
+OwnPtr<HttpCache::Writer> HttpCache::begin_store(URL const& url, u32 status_code, Headers const& response_headers, time_t request_time)
+{
+    if (!is_enabled() || status_code != 200)
+        return nullptr;
+
+    // See RFC 7234, 3. Storing Responses in Caches.
+    auto cache_control = response_headers.get("Cache-Control");
+    if (find_cache_control_directive(cache_control, "no-store").has_value())
+        return nullptr;
+    // We don't keep the request headers around, so we can't tell variants apart.
+    // Accept-Encoding is fine, since it's the same for every request we make.
+    if (auto vary = response_headers.get("Vary"); vary.has_value() && !vary->equals_ignoring_case("Accept-Encoding"))
+        return nullptr;
+    // If there's neither a lifetime nor a way to revalidate, the entry would never be used.
+    if (!find_cache_control_directive(cache_control, "max-age").has_value()
+        && !response_headers.contains("Expires")
+        && !response_headers.contains("ETag")
+        && !response_headers.contains("Last-Modified"))
+        return nullptr;
+    if (auto content_length = response_headers.get("Content-Length"); content_length.has_value()) {
+        if (content_length->to_uint<u64>().value_or(0) > max_entry_size)
+            return nullptr;
+    }
+
+    Entry entry;
+    entry.url = without_fragment(url);
+    entry.status_code = status_code;
+    entry.request_time = request_time;
+    entry.response_time = time(nullptr);
+    for (auto& header : response_headers) {
+        if (!is_hop_by_hop_header(header.key))
+            entry.response_headers.set(header.key, header.value);
+    }
+
+    auto temporary_path = String::formatted("{}/tmp/{}.{}", m_directory, getpid(), s_next_temporary_file_id++);
+    int fd = open(temporary_path.characters(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        dbgln("HttpCache: Couldn't create {}: {}", temporary_path, strerror(errno));
+        return nullptr;
+    }
+    return adopt_own(*new Writer(*this, move(entry), move(temporary_path), fd));
+}
+
+HttpCache::Entry HttpCache::update_after_revalidation(Entry entry, Headers const& response_headers, time_t request_time)
+{
+    // See RFC 7234, 4.3.4. Freshening Stored Responses upon Validation.
+    for (auto& header : response_headers) {
+        if (!is_hop_by_hop_header(header.key) && !header.key.equals_ignoring_case("Content-Length"))
+            entry.response_headers.set(header.key, header.value);
+    }
+    entry.request_time = request_time;
+    entry.response_time = time(nullptr);
+    write_entry(entry);
+    return entry;
+}
+
+void HttpCache::remove(URL const& url)
+{
+    if (is_enabled())
+        unlink(entry_path(key_for(url)).characters());
+}
+
+void HttpCache::did_store_body(u64 size)
+{
+    m_size += size;
+    if (m_size > max_size)
+        evict_if_needed();
+}
+
+void HttpCache::evict_if_needed()
+{
+    HashMap<String, u64> body_sizes;
+    u64 total_size = 0;
+    Core::DirIterator bodies(String::formatted("{}/bodies", m_directory), Core::DirIterator::SkipDots);
+    while (bodies.has_next()) {
+        auto name = bodies.next_path();
+        struct stat st;
+        if (stat(body_path(name).characters(), &st) < 0)
+            continue;
+        body_sizes.set(name, st.st_size);
+        total_size += st.st_size;
+    }
+    m_size = total_size;
+    if (total_size <= max_size)
+        return;
+
+    struct EntryFile {
+        String path;
+        String body_hash;
+        time_t last_used { 0 };
+    };
+    Vector<EntryFile> entries;
+    HashMap<String, size_t> body_references;
+    Core::DirIterator entry_files(String::formatted("{}/entries", m_directory), Core::DirIterator::SkipDots);
+    while (entry_files.has_next()) {
+        auto path = entry_files.next_full_path();
+        struct stat st;
+        if (stat(path.characters(), &st) < 0)
+            continue;
+        auto entry = read_entry(path);
+        if (!entry.has_value()) {
+            unlink(path.characters());
+            continue;
+        }
+        body_references.set(entry->body_hash, body_references.get(entry->body_hash).value_or(0) + 1);
+        entries.append({ path, entry->body_hash, st.st_mtime });
+    }
+    quick_sort(entries, [](auto& a, auto& b) { return a.last_used < b.last_used; });
+
+    auto remove_body = [&](String const& body_hash) {
+        if (unlink(body_path(body_hash).characters()) == 0)
+            total_size -= body_sizes.get(body_hash).value_or(0);
+        body_sizes.remove(body_hash);
+    };
+
+    // Bodies nobody refers to anymore go first, then the least recently used entries,
+    // until we're comfortably below the limit again so this doesn't run on every store.
+    for (auto& it : body_sizes) {
+        if (!body_references.contains(it.key) && unlink(body_path(it.key).characters()) == 0)
+            total_size -= it.value;
+    }
+    size_t evicted_entries = 0;
+    for (auto& entry : entries) {
+        if (total_size <= max_size / 4 * 3)
+            break;
+        unlink(entry.path.characters());
+        ++evicted_entries;
+        auto references = body_references.get(entry.body_hash).value_or(1) - 1;
+        body_references.set(entry.body_hash, references);
+        if (references == 0)
+            remove_body(entry.body_hash);
+    }
+    dbgln_if(REQUESTSERVER_DEBUG, "HttpCache: Evicted {} entries, {} bytes left", evicted_entries, total_size);
+    m_size = total_size;
+}
+
+HttpCache::Writer::Writer(HttpCache& cache, Entry entry, String temporary_path, int fd)
+    : m_cache(cache)
+    , m_entry(move(entry))
+    , m_temporary_path(move(temporary_path))
+    , m_fd(fd)
+{
+}
+
+HttpCache::Writer::~Writer()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+    if (!m_temporary_path.is_null())
+        unlink(m_temporary_path.characters());
+}
+
+void HttpCache::Writer::append(ReadonlyBytes bytes)
+{
+    if (m_failed)
+        return;
+    if (m_entry.body_size + bytes.size() > max_entry_size) {
+        m_failed = true;
+        return;
+    }
+    for (size_t written = 0; written < bytes.size();) {
+        auto nwritten = write(m_fd, bytes.data() + written, bytes.size() - written);
+        if (nwritten <= 0) {
+            m_failed = true;
+            return;
+        }
+        written += nwritten;
+    }
+    m_hash.update(bytes);
+    m_entry.body_size += bytes.size();
+}
+
+void HttpCache::Writer::commit()
+{
+    if (m_failed)
+        return;
+    close(m_fd);
+    m_fd = -1;
+
+    auto digest = m_hash.digest();
+    m_entry.body_hash = encode_hex({ digest.immutable_data(), digest.data_length() });
+
+    // The entry goes first: eviction (possibly in another RequestServer) deletes bodies that no entry refers to,
+    // and would otherwise be free to take ours, or the one somebody else stored, before we get to refer to it.
+    if (!m_cache.write_entry(m_entry))
+        return;
+
+    // Somebody else may have stored the same body already, in which case we simply point at theirs.
+    auto path = m_cache.body_path(m_entry.body_hash);
+    bool is_new_body = access(path.characters(), F_OK) < 0;
+    if (is_new_body) {
+        if (rename(m_temporary_path.characters(), path.characters()) < 0) {
+            m_cache.remove(m_entry.url);
+            return;
+        }
+        m_temporary_path = {};
+    }
+    dbgln_if(REQUESTSERVER_DEBUG, "HttpCache: Stored {} ({} bytes)", m_entry.url, m_entry.body_size);
+    // Only account for the body once an entry refers to it, eviction would consider it garbage before that.
+    if (is_new_body)
+        m_cache.did_store_body(m_entry.body_size);
+}
+
+}
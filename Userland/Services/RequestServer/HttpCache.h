@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FileStream.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
+#include <AK/String.h>
+#include <AK/URL.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <time.h>
+
+namespace RequestServer {
+
+// A private, persistent HTTP cache (RFC 7234) shared by all RequestServer instances of a user.
+//
+// The cache lives in a directory with three subdirectories:
+// - entries/ holds one small text file per cached URL, named after the SHA-256 of the URL.
+//   It records the response status and headers, when the response was received, and which body it has.
+// - bodies/ holds the response bodies, named after the SHA-256 of their contents, so identical bodies
+//   are only stored once. Bodies are never modified after being written, which lets us hand their
+//   file descriptors straight to clients.
+// - tmp/ holds bodies that are still being downloaded.
+// Every file is written under a temporary name and renamed into place, so other instances never see half of one.
+class HttpCache {
+public:
+    using Headers = HashMap<String, String, CaseInsensitiveStringTraits>;
+
+    // Everything we'll keep around at most, and the largest single response we're willing to store.
+    static constexpr u64 max_size = 64 * MiB;
+    static constexpr u64 max_entry_size = max_size / 8;
+
+    struct Entry {
+        URL url;
+        u32 status_code { 0 };
+        Headers response_headers;
+        // When we sent the request and when we got the response headers, used to compute the age.
+        time_t request_time { 0 };
+        time_t response_time { 0 };
+        String body_hash;
+        u64 body_size { 0 };
+    };
+
+    class Writer {
+    public:
+        ~Writer();
+
+        void append(ReadonlyBytes);
+        // Stores the entry, to be called once the whole body has been appended.
+        void commit();
+
+    private:
+        friend class HttpCache;
+        Writer(HttpCache&, Entry, String temporary_path, int fd);
+
+        HttpCache& m_cache;
+        Entry m_entry;
+        String m_temporary_path;
+        int m_fd { -1 };
+        Crypto::Hash::SHA256 m_hash;
+        bool m_failed { false };
+    };
+
+    static HttpCache& the();
+
+    // The cache stays disabled until it's been given a directory.
+    void set_directory(String const&);
+    bool is_enabled() const { return !m_directory.is_null(); }
+
+    // Whether a response for this request may come from (or go into) the cache at all.
+    bool can_use_for_request(String const& method, HashMap<String, String> const& request_headers) const;
+
+    Optional<Entry> lookup(URL const&);
+    bool is_fresh(Entry const&, HashMap<String, String> const& request_headers) const;
+    // Adds If-None-Match and If-Modified-Since, so the server can tell us that our copy is still good.
+    static bool add_validators(Entry const&, HashMap<String, String>& request_headers);
+    // Returns a read-only file descriptor for the entry's body, or -1 if it's gone.
+    int open_body(Entry const&);
+
+    // Starts storing a response, returns null if it isn't cacheable.
+    OwnPtr<Writer> begin_store(URL const&, u32 status_code, Headers const& response_headers, time_t request_time);
+    // Updates a stored entry with the headers of a 304 (Not Modified) response.
+    Entry update_after_revalidation(Entry, Headers const& response_headers, time_t request_time);
+    void remove(URL const&);
+
+private:
+    HttpCache() = default;
+
+    static String key_for(URL const&);
+    String entry_path(String const& key) const;
+    String body_path(String const& body_hash) const;
+
+    bool write_entry(Entry const&);
+    Optional<Entry> read_entry(String const& path) const;
+    void did_store_body(u64 size);
+    void evict_if_needed();
+
+    String m_directory;
+    // Our idea of how much all bodies take up. Other instances add to it behind our back,
+    // so it's re-counted from disk whenever we evict.
+    u64 m_size { 0 };
+};
+
+// The stream a job writes its response body into: the client's end of the request pipe,
+// and, if the response is being cached, a HttpCache::Writer.
+class CachingOutputFileStream final : public OutputFileStream {
+public:
+    explicit CachingOutputFileStream(int fd)
+        : OutputFileStream(fd)
+    {
+    }
+
+    virtual size_t write(ReadonlyBytes bytes) override
+    {
+        auto nwritten = OutputFileStream::write(bytes);
+        if (m_cache_writer)
+            m_cache_writer->append(bytes.trim(nwritten));
+        return nwritten;
+    }
+
+    bool is_caching() const { return m_cache_writer; }
+    void set_cache_writer(OwnPtr<HttpCache::Writer> writer) { m_cache_writer = move(writer); }
+    OwnPtr<HttpCache::Writer> take_cache_writer() { return move(m_cache_writer); }
+
+private:
+    OwnPtr<HttpCache::Writer> m_cache_writer;
+};
+
+}
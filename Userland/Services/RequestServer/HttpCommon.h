@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/Debug.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
@@ -14,22 +15,57 @@
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <LibHTTP/HttpRequest.h>
+#include <RequestServer/CachedRequest.h>
 #include <RequestServer/ClientConnection.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Request.h>
+#include <time.h>
+#include <unistd.h>
 
 namespace RequestServer::Detail {
 
-template<typename TSelf, typename TJob>
-void init(TSelf* self, TJob job)
+template<typename TSelf, typename TJob, typename TConnectionCache>
+void init(TSelf* self, TJob job, TConnectionCache& connection_cache)
 {
     job->on_headers_received = [self](auto& headers, auto response_code) {
+        // Our copy is still good, the client gets that instead once the job is done.
+        if (self->cache_entry_being_revalidated().has_value() && response_code == 304u)
+            return;
+        // This is called again for trailers, by which point we've long made up our minds.
+        if (auto* caching_stream = self->caching_stream(); caching_stream && response_code.has_value() && !self->status_code().has_value())
+            caching_stream->set_cache_writer(HttpCache::the().begin_store(self->job().url(), response_code.value(), headers, self->request_time()));
         if (response_code.has_value())
             self->set_status_code(response_code.value());
         self->set_response_headers(headers);
     };
 
-    job->on_finish = [self](bool success) {
-        if (auto* response = self->job().response()) {
+    job->on_finish = [self, &connection_cache](bool success) {
+        // A kept-alive connection that the server closed under us doesn't count as the request failing.
+        if (!success && connection_cache.retry_on_new_connection(self->job()))
+            return;
+
+        // Hand the connection back first, finishing the request below may well destroy it along with the job.
+        connection_cache.release_job(self->job());
+
+        auto* response = self->job().response();
+        if (auto& cache_entry = self->cache_entry_being_revalidated(); cache_entry.has_value() && success && response && response->code() == 304) {
+            auto entry = HttpCache::the().update_after_revalidation(cache_entry.value(), response->headers(), self->request_time());
+            if (int body_fd = HttpCache::the().open_body(entry); body_fd >= 0) {
+                self->send_cached_response(entry, body_fd);
+                return;
+            }
+            // The body has been evicted in the meantime, all we can do is give up on this one.
+            self->did_progress(0, 0);
+            self->did_finish(false);
+            return;
+        }
+
+        if (auto* caching_stream = self->caching_stream()) {
+            if (auto cache_writer = caching_stream->take_cache_writer(); cache_writer && success)
+                cache_writer->commit();
+        }
+
+        if (response) {
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
             self->set_downloaded_size(self->output_stream().size());
@@ -62,21 +98,56 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ClientConnection& clie
         return {};
     }
 
+    auto& cache = HttpCache::the();
+    auto request_time = time(nullptr);
+    auto request_headers = headers;
+    Optional<HttpCache::Entry> cache_entry;
+    bool may_use_cache = cache.can_use_for_request(method, headers);
+    if (may_use_cache) {
+        cache_entry = cache.lookup(url);
+        if (cache_entry.has_value() && cache.is_fresh(cache_entry.value(), headers)) {
+            if (int body_fd = cache.open_body(cache_entry.value()); body_fd >= 0) {
+                dbgln_if(REQUESTSERVER_DEBUG, "HttpCache: Serving {} from the cache", url);
+                close(pipe_result.value().read_fd);
+                close(pipe_result.value().write_fd);
+                return CachedRequest::create(client, cache_entry.release_value(), body_fd);
+            }
+            cache_entry.clear();
+        }
+        // Leave conditional requests the client made itself alone, it wants to see their answer.
+        bool is_conditional = false;
+        for (auto& it : headers)
+            is_conditional |= it.key.equals_ignoring_case("If-None-Match") || it.key.equals_ignoring_case("If-Modified-Since");
+        if (cache_entry.has_value() && (is_conditional || !HttpCache::add_validators(cache_entry.value(), request_headers)))
+            cache_entry.clear();
+    } else if (!method.equals_ignoring_case("get") && !method.equals_ignoring_case("head")) {
+        // See RFC 7234, 4.4. Invalidation.
+        cache.remove(url);
+    }
+
     HTTP::HttpRequest request;
     if (method.equals_ignoring_case("post"))
         request.set_method(HTTP::HttpRequest::Method::POST);
     else
         request.set_method(HTTP::HttpRequest::Method::GET);
     request.set_url(url);
-    request.set_headers(headers);
+    request.set_headers(request_headers);
     request.set_body(body);
+    request.set_keep_alive(true);
 
-    auto output_stream = make<OutputFileStream>(pipe_result.value().write_fd);
+    auto output_stream = make<CachingOutputFileStream>(pipe_result.value().write_fd);
     output_stream->make_unbuffered();
+    auto& caching_stream = *output_stream;
     auto job = TJob::construct(request, *output_stream);
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
     protocol_request->set_request_fd(pipe_result.value().read_fd);
-    job->start();
+    protocol_request->set_response_write_fd(pipe_result.value().write_fd);
+    protocol_request->set_request_time(request_time);
+    if (may_use_cache)
+        protocol_request->set_caching_stream(caching_stream);
+    if (cache_entry.has_value())
+        protocol_request->set_cache_entry_being_revalidated(cache_entry.release_value());
+    TBadgedProtocol::Type::connection_cache().start_job(*job);
     return protocol_request;
 }
 
@@ -24,6 +24,12 @@ HttpProtocol::HttpProtocol()
 {
 }
 
+HttpProtocol::ConnectionCacheType& HttpProtocol::connection_cache()
+{
+    static ConnectionCacheType cache("http");
+    return cache;
+}
+
 OwnPtr<Request> HttpProtocol::start_request(ClientConnection& client, const String& method, const URL& url, const HashMap<String, String>& headers, ReadonlyBytes body)
 {
     return Detail::start_request(Badge<HttpProtocol> {}, client, method, url, headers, body, get_pipe_for_request());
@@ -11,8 +11,10 @@
 #include <AK/OwnPtr.h>
 #include <AK/String.h>
 #include <AK/URL.h>
+#include <LibCore/TCPSocket.h>
 #include <LibHTTP/HttpJob.h>
 #include <RequestServer/ClientConnection.h>
+#include <RequestServer/ConnectionCache.h>
 #include <RequestServer/HttpRequest.h>
 #include <RequestServer/Protocol.h>
 #include <RequestServer/Request.h>
@@ -23,6 +25,9 @@ class HttpProtocol final : public Protocol {
 public:
     using JobType = HTTP::HttpJob;
     using RequestType = HttpRequest;
+    using ConnectionCacheType = ConnectionCache<HTTP::HttpJob, Core::TCPSocket>;
+
+    static ConnectionCacheType& connection_cache();
 
     HttpProtocol();
     ~HttpProtocol() override = default;
@@ -15,14 +15,14 @@ HttpRequest::HttpRequest(ClientConnection& client, NonnullRefPtr<HTTP::HttpJob>
     : Request(client, move(output_stream))
     , m_job(job)
 {
-    Detail::init(this, job);
+    Detail::init(this, job, HttpProtocol::connection_cache());
 }
 
 HttpRequest::~HttpRequest()
 {
     m_job->on_finish = nullptr;
     m_job->on_progress = nullptr;
-    m_job->shutdown();
+    HttpProtocol::connection_cache().release_job(*m_job);
 }
 
 NonnullOwnPtr<HttpRequest> HttpRequest::create_with_job(Badge<HttpProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
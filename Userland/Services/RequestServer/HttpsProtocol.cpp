@@ -24,6 +24,12 @@ HttpsProtocol::HttpsProtocol()
 {
 }
 
+HttpsProtocol::ConnectionCacheType& HttpsProtocol::connection_cache()
+{
+    static ConnectionCacheType cache("https");
+    return cache;
+}
+
 OwnPtr<Request> HttpsProtocol::start_request(ClientConnection& client, const String& method, const URL& url, const HashMap<String, String>& headers, ReadonlyBytes body)
 {
     return Detail::start_request(Badge<HttpsProtocol> {}, client, method, url, headers, body, get_pipe_for_request());
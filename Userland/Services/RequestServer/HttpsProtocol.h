@@ -13,6 +13,7 @@
 #include <AK/URL.h>
 #include <LibHTTP/HttpsJob.h>
 #include <RequestServer/ClientConnection.h>
+#include <RequestServer/ConnectionCache.h>
 #include <RequestServer/HttpsRequest.h>
 #include <RequestServer/Protocol.h>
 #include <RequestServer/Request.h>
@@ -23,6 +24,9 @@ class HttpsProtocol final : public Protocol {
 public:
     using JobType = HTTP::HttpsJob;
     using RequestType = HttpsRequest;
+    using ConnectionCacheType = ConnectionCache<HTTP::HttpsJob, TLS::TLSv12>;
+
+    static ConnectionCacheType& connection_cache();
 
     HttpsProtocol();
     ~HttpsProtocol() override = default;
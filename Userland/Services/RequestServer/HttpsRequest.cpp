@@ -15,7 +15,7 @@ HttpsRequest::HttpsRequest(ClientConnection& client, NonnullRefPtr<HTTP::HttpsJo
     : Request(client, move(output_stream))
     , m_job(job)
 {
-    Detail::init(this, job);
+    Detail::init(this, job, HttpsProtocol::connection_cache());
 }
 
 void HttpsRequest::set_certificate(String certificate, String key)
@@ -27,7 +27,7 @@ HttpsRequest::~HttpsRequest()
 {
     m_job->on_finish = nullptr;
     m_job->on_progress = nullptr;
-    m_job->shutdown();
+    HttpsProtocol::connection_cache().release_job(*m_job);
 }
 
 NonnullOwnPtr<HttpsRequest> HttpsRequest::create_with_job(Badge<HttpsProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpsJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
@@ -7,6 +7,7 @@
 #include <AK/Badge.h>
 #include <RequestServer/ClientConnection.h>
 #include <RequestServer/Request.h>
+#include <unistd.h>
 
 namespace RequestServer {
 
@@ -20,8 +21,18 @@ Request::Request(ClientConnection& client, NonnullOwnPtr<OutputFileStream>&& out
 {
 }
 
+Request::Request(ClientConnection& client)
+    : m_client(client)
+    , m_id(s_next_id++)
+{
+}
+
 Request::~Request()
 {
+    if (m_cached_body_notifier)
+        m_cached_body_notifier->close();
+    if (m_cached_body_fd >= 0)
+        close(m_cached_body_fd);
 }
 
 void Request::stop()
@@ -51,6 +62,48 @@ void Request::did_progress(Optional<u32> total_size, u32 downloaded_size)
     m_client.did_progress_request({}, *this);
 }
 
+void Request::did_load_from_cache(const HttpCache::Entry& entry)
+{
+    set_status_code(entry.status_code);
+    set_response_headers(entry.response_headers);
+    did_progress(entry.body_size, entry.body_size);
+    did_finish(true);
+}
+
+void Request::send_cached_response(const HttpCache::Entry& entry, int body_fd)
+{
+    VERIFY(m_output_stream);
+    VERIFY(m_response_write_fd >= 0);
+    m_cached_body_fd = body_fd;
+    set_status_code(entry.status_code);
+    set_response_headers(entry.response_headers);
+
+    // The pipe is non-blocking, so copy a chunk whenever the client has made room for it.
+    m_cached_body_notifier = Core::Notifier::construct(m_response_write_fd, Core::Notifier::Write);
+    m_cached_body_notifier->on_ready_to_write = [this, entry] {
+        if (m_pending_cached_body.is_empty()) {
+            auto buffer = ByteBuffer::create_uninitialized(64 * KiB);
+            auto nread = read(m_cached_body_fd, buffer.data(), buffer.size());
+            if (nread < 0) {
+                m_cached_body_notifier->close();
+                did_progress(entry.body_size, m_output_stream->size());
+                did_finish(false);
+                return;
+            }
+            if (nread == 0) {
+                m_cached_body_notifier->close();
+                did_progress(entry.body_size, m_output_stream->size());
+                did_finish(m_output_stream->size() == entry.body_size);
+                return;
+            }
+            m_pending_cached_body = buffer.slice(0, nread);
+        }
+        auto nwritten = m_output_stream->write(m_pending_cached_body);
+        m_output_stream->handle_any_error();
+        m_pending_cached_body = m_pending_cached_body.slice(nwritten, m_pending_cached_body.size() - nwritten);
+    };
+}
+
 void Request::did_request_certificates()
 {
     m_client.did_request_certificates({}, *this);
@@ -12,7 +12,9 @@
 #include <AK/Optional.h>
 #include <AK/RefCounted.h>
 #include <AK/URL.h>
+#include <LibCore/Notifier.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/HttpCache.h>
 
 namespace RequestServer {
 
@@ -34,6 +36,8 @@ public:
     // FIXME: Want Badge<Protocol>, but can't make one from HttpProtocol, etc.
     void set_request_fd(int fd) { m_request_fd = fd; }
     int request_fd() const { return m_request_fd; }
+    // The end of the request pipe that the response body is written into.
+    void set_response_write_fd(int fd) { m_response_write_fd = fd; }
 
     void did_finish(bool success);
     void did_progress(Optional<u32> total_size, u32 downloaded_size);
@@ -43,19 +47,40 @@ public:
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
     const OutputFileStream& output_stream() const { return *m_output_stream; }
 
+    // Set for requests whose response may be stored in the HTTP cache.
+    CachingOutputFileStream* caching_stream() { return m_caching_stream; }
+    void set_caching_stream(CachingOutputFileStream& stream) { m_caching_stream = &stream; }
+    time_t request_time() const { return m_request_time; }
+    void set_request_time(time_t request_time) { m_request_time = request_time; }
+    // Set when we asked the server whether this cached response is still good, see HttpCache.
+    const Optional<HttpCache::Entry>& cache_entry_being_revalidated() const { return m_cache_entry_being_revalidated; }
+    void set_cache_entry_being_revalidated(HttpCache::Entry entry) { m_cache_entry_being_revalidated = move(entry); }
+    // Answers the request with a cached response whose body the client is already reading from the request fd.
+    void did_load_from_cache(const HttpCache::Entry&);
+    // Answers the request with a cached response, copying its body from body_fd (which we take ownership of) into the request pipe.
+    void send_cached_response(const HttpCache::Entry&, int body_fd);
+
 protected:
     explicit Request(ClientConnection&, NonnullOwnPtr<OutputFileStream>&&);
+    explicit Request(ClientConnection&);
 
 private:
     ClientConnection& m_client;
     i32 m_id { 0 };
     int m_request_fd { -1 }; // Passed to client.
+    int m_response_write_fd { -1 };
     URL m_url;
     Optional<u32> m_status_code;
     Optional<u32> m_total_size {};
     size_t m_downloaded_size { 0 };
-    NonnullOwnPtr<OutputFileStream> m_output_stream;
+    OwnPtr<OutputFileStream> m_output_stream;
     HashMap<String, String, CaseInsensitiveStringTraits> m_response_headers;
+    CachingOutputFileStream* m_caching_stream { nullptr };
+    time_t m_request_time { 0 };
+    Optional<HttpCache::Entry> m_cache_entry_being_revalidated;
+    int m_cached_body_fd { -1 };
+    RefPtr<Core::Notifier> m_cached_body_notifier;
+    ByteBuffer m_pending_cached_body;
 };
 
 }
@@ -8,6 +8,7 @@
 #include <AK/Debug.h>
 #include <AK/JsonObject.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/DisjointRectSet.h>
 #include <LibGfx/FontDatabase.h>
 #include <LibGfx/SystemTheme.h>
 #include <LibJS/Console.h>
@@ -65,12 +66,14 @@ void ClientConnection::update_system_theme(const Core::AnonymousBuffer& theme_bu
     Gfx::set_system_theme(theme_buffer);
     auto impl = Gfx::PaletteImpl::create_with_anonymous_buffer(theme_buffer);
     m_page_host->set_palette_impl(*impl);
+    invalidate_all_backing_stores();
 }
 
 void ClientConnection::update_system_fonts(String const& default_font_query, String const& fixed_width_font_query)
 {
     Gfx::FontDatabase::set_default_font_query(default_font_query);
     Gfx::FontDatabase::set_fixed_width_font_query(fixed_width_font_query);
+    invalidate_all_backing_stores();
 }
 
 void ClientConnection::update_screen_rects(const Vector<Gfx::IntRect>& rects, u32 main_screen)
@@ -103,16 +106,46 @@ void ClientConnection::set_viewport_rect(const Gfx::IntRect& rect)
 {
     dbgln_if(SPAM_DEBUG, "handle: WebContentServer::SetViewportRect: rect={}", rect);
     m_page_host->set_viewport_rect(rect);
+    // Invalidations outside of the viewport don't get reported, so whatever a backing store shows of the old one may be stale.
+    invalidate_all_backing_stores();
 }
 
 void ClientConnection::add_backing_store(i32 backing_store_id, const Gfx::ShareableBitmap& bitmap)
 {
     m_backing_stores.set(backing_store_id, *bitmap.bitmap());
+    m_backing_store_damage.set(backing_store_id, {});
 }
 
 void ClientConnection::remove_backing_store(i32 backing_store_id)
 {
     m_backing_stores.remove(backing_store_id);
+    m_backing_store_damage.remove(backing_store_id);
+}
+
+void ClientConnection::invalidate_backing_stores(const Gfx::IntRect& content_rect)
+{
+    // Past this many rects, painting everything is about as cheap as keeping track.
+    static constexpr size_t max_invalidated_rects = 32;
+
+    for (auto& it : m_backing_store_damage) {
+        auto& damage = it.value;
+        if (!damage.painted_content_rect.has_value() || !damage.painted_content_rect->intersects(content_rect))
+            continue;
+        if (damage.invalidated_rects.size() == max_invalidated_rects) {
+            damage.painted_content_rect = {};
+            damage.invalidated_rects.clear();
+            continue;
+        }
+        damage.invalidated_rects.append(content_rect);
+    }
+}
+
+void ClientConnection::invalidate_all_backing_stores()
+{
+    for (auto& it : m_backing_store_damage) {
+        it.value.painted_content_rect = {};
+        it.value.invalidated_rects.clear();
+    }
 }
 
 void ClientConnection::paint(const Gfx::IntRect& content_rect, i32 backing_store_id)
@@ -138,7 +171,18 @@ void ClientConnection::paint(const Gfx::IntRect& content_rect, i32 backing_store
 void ClientConnection::flush_pending_paint_requests()
 {
     for (auto& pending_paint : m_pending_paint_requests) {
-        m_page_host->paint(pending_paint.content_rect, *pending_paint.bitmap);
+        auto& damage = m_backing_store_damage.ensure(pending_paint.bitmap_id);
+        if (damage.painted_content_rect != pending_paint.content_rect) {
+            m_page_host->paint(pending_paint.content_rect, *pending_paint.bitmap);
+        } else {
+            Gfx::DisjointRectSet dirty_rects;
+            for (auto& rect : damage.invalidated_rects)
+                dirty_rects.add(rect.intersected(pending_paint.content_rect));
+            for (auto& rect : dirty_rects.rects())
+                m_page_host->paint(pending_paint.content_rect, *pending_paint.bitmap, rect);
+        }
+        damage.painted_content_rect = pending_paint.content_rect;
+        damage.invalidated_rects.clear();
         async_did_paint(pending_paint.content_rect, pending_paint.bitmap_id);
     }
     m_pending_paint_requests.clear();
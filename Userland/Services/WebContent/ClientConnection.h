@@ -28,6 +28,10 @@ public:
 
     virtual void die() override;
 
+    // Makes the next paints of the backing stores repaint the given part of the page, or all of it.
+    void invalidate_backing_stores(const Gfx::IntRect& content_rect);
+    void invalidate_all_backing_stores();
+
 private:
     Web::Page& page();
     const Web::Page& page() const;
@@ -65,6 +69,14 @@ private:
 
     HashMap<i32, NonnullRefPtr<Gfx::Bitmap>> m_backing_stores;
 
+    // The client flips between its backing stores, so each of them remembers which content rect it shows and which parts
+    // of that have been invalidated since. Painting it for the same content rect again then only has to redo those.
+    struct BackingStoreDamage {
+        Optional<Gfx::IntRect> painted_content_rect;
+        Vector<Gfx::IntRect> invalidated_rects;
+    };
+    HashMap<i32, BackingStoreDamage> m_backing_store_damage;
+
     WeakPtr<JS::Interpreter> m_interpreter;
     OwnPtr<WebContentConsoleClient> m_console_client;
 };
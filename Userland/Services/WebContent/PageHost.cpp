@@ -54,10 +54,12 @@ Web::Layout::InitialContainingBlockBox* PageHost::layout_root()
     return document->layout_node();
 }
 
-void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
+void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target, Optional<Gfx::IntRect> dirty_content_rect)
 {
     Gfx::Painter painter(target);
     Gfx::IntRect bitmap_rect { {}, content_rect.size() };
+    if (dirty_content_rect.has_value())
+        painter.add_clip_rect(dirty_content_rect->translated(-content_rect.location()));
 
     auto* layout_root = this->layout_root();
     if (!layout_root) {
@@ -78,11 +80,13 @@ void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
 
 void PageHost::page_did_invalidate(const Gfx::IntRect& content_rect)
 {
+    m_client.invalidate_backing_stores(content_rect);
     m_client.async_did_invalidate_content_rect(content_rect);
 }
 
 void PageHost::page_did_change_selection()
 {
+    m_client.invalidate_all_backing_stores();
     m_client.async_did_change_selection();
 }
 
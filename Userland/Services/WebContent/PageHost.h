@@ -24,7 +24,8 @@ public:
     Web::Page& page() { return *m_page; }
     const Web::Page& page() const { return *m_page; }
 
-    void paint(const Gfx::IntRect& content_rect, Gfx::Bitmap&);
+    // Paints the content rect of the page into the bitmap. If there is a dirty rect, only that part of it gets painted again.
+    void paint(const Gfx::IntRect& content_rect, Gfx::Bitmap&, Optional<Gfx::IntRect> dirty_content_rect = {});
 
     void set_palette_impl(const Gfx::PaletteImpl&);
     void set_viewport_rect(const Gfx::IntRect&);
@@ -16,13 +16,14 @@
 #include <LibCore/DateTime.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
-#include <LibCore/FileStream.h>
 #include <LibCore/MimeData.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <errno.h>
 #include <stdio.h>
+#include <sys/sendfile.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -45,6 +46,9 @@ void Client::die()
 void Client::start()
 {
     m_socket->on_ready_to_read = [this] {
+        // We only ever serve a single request per connection.
+        m_socket->on_ready_to_read = nullptr;
+
         StringBuilder builder;
         for (;;) {
             auto line = m_socket->read_line();
@@ -57,7 +61,9 @@ void Client::start()
         auto request = builder.to_byte_buffer();
         dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", String::copy(request));
         handle_request(request);
-        die();
+        // A file may still be on its way out, in which case we're done once all of it has been sent.
+        if (!m_file_being_sent)
+            die();
     };
 }
 
@@ -131,12 +137,10 @@ void Client::handle_request(ReadonlyBytes raw_request)
         return;
     }
 
-    Core::InputFileStream stream { file };
-
-    send_response(stream, request, Core::guess_mime_type_based_on_filename(real_path));
+    send_response(*file, request, Core::guess_mime_type_based_on_filename(real_path));
 }
 
-void Client::send_response(InputStream& response, HTTP::HttpRequest const& request, String const& content_type)
+void Client::send_response_headers(String const& content_type)
 {
     StringBuilder builder;
     builder.append("HTTP/1.0 200 OK\r\n");
@@ -150,6 +154,11 @@ void Client::send_response(InputStream& response, HTTP::HttpRequest const& reque
     builder.append("\r\n");
 
     m_socket->write(builder.to_string());
+}
+
+void Client::send_response(InputStream& response, HTTP::HttpRequest const& request, String const& content_type)
+{
+    send_response_headers(content_type);
     log_response(200, request);
 
     char buffer[PAGE_SIZE];
@@ -162,6 +171,47 @@ void Client::send_response(InputStream& response, HTTP::HttpRequest const& reque
     } while (true);
 }
 
+void Client::send_response(Core::File& file, HTTP::HttpRequest const& request, String const& content_type)
+{
+    send_response_headers(content_type);
+    log_response(200, request);
+
+    // Let the kernel move the file straight into the socket instead of copying it through our address space.
+    m_file_being_sent = file;
+    m_file_offset = 0;
+    send_file_contents();
+}
+
+void Client::send_file_contents()
+{
+    for (;;) {
+        auto nsent = sendfile(m_socket->fd(), m_file_being_sent->fd(), &m_file_offset, 1 * MiB);
+        if (nsent > 0)
+            continue;
+        if (nsent < 0 && errno == EINTR)
+            continue;
+        if (nsent < 0 && errno == EAGAIN) {
+            // The socket is non-blocking and full. Pick up where we left off once it has drained,
+            // rather than holding up every other client on the event loop until then.
+            if (!m_write_notifier) {
+                m_write_notifier = Core::Notifier::construct(m_socket->fd(), Core::Notifier::Event::Write, this);
+                m_write_notifier->on_ready_to_write = [this] {
+                    send_file_contents();
+                };
+            }
+            return;
+        }
+        if (nsent < 0)
+            perror("sendfile");
+        break;
+    }
+
+    if (m_write_notifier)
+        m_write_notifier->set_enabled(false);
+    m_file_being_sent = nullptr;
+    die();
+}
+
 void Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
 {
     StringBuilder builder;
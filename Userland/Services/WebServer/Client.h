@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <LibCore/File.h>
+#include <LibCore/Notifier.h>
 #include <LibCore/Object.h>
 #include <LibCore/TCPSocket.h>
 #include <LibHTTP/Forward.h>
@@ -22,7 +24,10 @@ private:
     Client(NonnullRefPtr<Core::TCPSocket>, Core::Object* parent);
 
     void handle_request(ReadonlyBytes);
+    void send_response_headers(String const& content_type);
     void send_response(InputStream&, HTTP::HttpRequest const&, String const& content_type);
+    void send_response(Core::File&, HTTP::HttpRequest const&, String const& content_type);
+    void send_file_contents();
     void send_redirect(StringView redirect, HTTP::HttpRequest const&);
     void send_error_response(unsigned code, HTTP::HttpRequest const&, Vector<String> const& headers = {});
     void die();
@@ -31,6 +36,11 @@ private:
     bool verify_credentials(Vector<HTTP::HttpRequest::Header> const&);
 
     NonnullRefPtr<Core::TCPSocket> m_socket;
+
+    // A file response that didn't fit into the socket in one go, and the offset to continue from once it has drained.
+    RefPtr<Core::File> m_file_being_sent;
+    off_t m_file_offset { 0 };
+    RefPtr<Core::Notifier> m_write_notifier;
 };
 
 }
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "ComposeWorkerPool.h"
+
+namespace WindowServer {
+
+ComposeWorkerPool::ComposeWorkerPool(size_t worker_count)
+{
+    pthread_mutex_init(&m_mutex, nullptr);
+    pthread_cond_init(&m_jobs_available, nullptr);
+    pthread_cond_init(&m_jobs_finished, nullptr);
+
+    for (size_t i = 0; i < worker_count; ++i) {
+        auto worker = Threading::Thread::construct([this] { return worker_main(); }, "ComposeWorker");
+        worker->start();
+        m_workers.append(move(worker));
+    }
+}
+
+ComposeWorkerPool::~ComposeWorkerPool()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_exiting = true;
+    pthread_cond_broadcast(&m_jobs_available);
+    pthread_mutex_unlock(&m_mutex);
+
+    for (auto& worker : m_workers)
+        (void)worker.join();
+
+    pthread_cond_destroy(&m_jobs_finished);
+    pthread_cond_destroy(&m_jobs_available);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void ComposeWorkerPool::run(Vector<Function<void()>>& jobs)
+{
+    if (jobs.is_empty())
+        return;
+
+    if (m_workers.is_empty() || jobs.size() == 1) {
+        for (auto& job : jobs)
+            job();
+        return;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    VERIFY(!m_jobs);
+    m_jobs = &jobs;
+    m_job_count = jobs.size();
+    m_next_job = 0;
+    m_finished_job_count = 0;
+    pthread_cond_broadcast(&m_jobs_available);
+
+    // Help out instead of just sitting here.
+    while (m_next_job < m_job_count) {
+        auto& job = jobs[m_next_job++];
+        pthread_mutex_unlock(&m_mutex);
+        job();
+        pthread_mutex_lock(&m_mutex);
+        ++m_finished_job_count;
+    }
+
+    while (m_finished_job_count < m_job_count)
+        pthread_cond_wait(&m_jobs_finished, &m_mutex);
+
+    // Every job has been handed out and finished, so no worker is holding on to any of them anymore.
+    m_jobs = nullptr;
+    m_job_count = 0;
+    m_next_job = 0;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+intptr_t ComposeWorkerPool::worker_main()
+{
+    pthread_mutex_lock(&m_mutex);
+    for (;;) {
+        while (!m_exiting && m_next_job >= m_job_count)
+            pthread_cond_wait(&m_jobs_available, &m_mutex);
+        if (m_exiting)
+            break;
+
+        auto& job = (*m_jobs)[m_next_job++];
+        pthread_mutex_unlock(&m_mutex);
+        job();
+        pthread_mutex_lock(&m_mutex);
+        if (++m_finished_job_count == m_job_count)
+            pthread_cond_signal(&m_jobs_finished);
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return 0;
+}
+
+}
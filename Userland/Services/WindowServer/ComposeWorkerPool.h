@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Noncopyable.h>
+#include <AK/Vector.h>
+#include <LibThreading/Thread.h>
+#include <pthread.h>
+
+namespace WindowServer {
+
+// A handful of threads that help the compositor render a frame. The compositor hands over a batch
+// of independent jobs (the tiles of each screen) and waits for all of them to be done before it
+// goes back to the event loop, so nothing a job looks at can change while the workers are busy.
+class ComposeWorkerPool {
+    AK_MAKE_NONCOPYABLE(ComposeWorkerPool);
+    AK_MAKE_NONMOVABLE(ComposeWorkerPool);
+
+public:
+    explicit ComposeWorkerPool(size_t worker_count);
+    ~ComposeWorkerPool();
+
+    size_t worker_count() const { return m_workers.size(); }
+
+    // Runs every job, on the workers as well as on the calling thread, and returns once they have all finished.
+    void run(Vector<Function<void()>>& jobs);
+
+private:
+    intptr_t worker_main();
+
+    NonnullRefPtrVector<Threading::Thread> m_workers;
+
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_jobs_available;
+    pthread_cond_t m_jobs_finished;
+
+    Vector<Function<void()>>* m_jobs { nullptr };
+    size_t m_job_count { 0 };
+    size_t m_next_job { 0 };
+    size_t m_finished_job_count { 0 };
+    bool m_exiting { false };
+};
+
+}
@@ -16,14 +16,32 @@
 #include <AK/Debug.h>
 #include <AK/Memory.h>
 #include <AK/ScopeGuard.h>
+#include <AK/Time.h>
 #include <LibCore/Timer.h>
 #include <LibGfx/Font.h>
 #include <LibGfx/Painter.h>
 #include <LibGfx/StylePainter.h>
 #include <LibThreading/BackgroundAction.h>
+#include <time.h>
+#include <unistd.h>
 
 namespace WindowServer {
 
+// Never use more threads than this to render a frame, no matter how many processors there are.
+static constexpr size_t max_worker_count = 7;
+
+// Only split up a screen's repaint into tiles when it covers at least this many pixels,
+// and never make a tile shorter than this.
+static constexpr int minimum_area_for_tiling = 256 * 256;
+static constexpr int minimum_tile_height = 32;
+
+static Time monotonic_time()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return Time::from_timespec(now);
+}
+
 Compositor& Compositor::the()
 {
     static Compositor s_the;
@@ -63,6 +81,11 @@ Compositor::Compositor()
         },
         this);
 
+    // Leave one processor for the clients that are drawing into their backing stores in the meantime.
+    auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t worker_count = processor_count > 2 ? min<size_t>(processor_count - 2, max_worker_count) : 0;
+    m_worker_pool = make<ComposeWorkerPool>(worker_count);
+
     init_bitmaps();
 }
 
@@ -164,6 +187,8 @@ void Compositor::compose()
         return;
     }
 
+    auto start_time = monotonic_time();
+
     if (m_occlusions_dirty) {
         m_occlusions_dirty = false;
         recompute_occlusions();
@@ -293,7 +318,10 @@ void Compositor::compose()
     if (!m_screen_data[cursor_screen.index()].m_cursor_back_bitmap || m_invalidated_cursor)
         check_restore_cursor_back(cursor_screen, cursor_rect);
 
-    auto paint_wallpaper = [&](Screen& screen, Gfx::Painter& painter, const Gfx::IntRect& rect, const Gfx::IntRect& screen_rect) {
+    // NOTE: Everything below only records what to paint, the painting itself happens in render_recorded_commands().
+    //       The recorded commands may run on another thread, so they must not hold on to anything that only lives
+    //       during this function.
+    auto paint_wallpaper = [this, background_color](Screen& screen, Gfx::Painter& painter, const Gfx::IntRect& rect, const Gfx::IntRect& screen_rect) {
         // FIXME: If the wallpaper is opaque and covers the whole rect, no need to fill with color!
         painter.fill_rect(rect, background_color);
         if (m_wallpaper) {
@@ -321,10 +349,11 @@ void Compositor::compose()
             auto screen_rect = screen.rect();
             auto screen_render_rect = screen_rect.intersected(render_rect);
             if (!screen_render_rect.is_empty()) {
-                auto& back_painter = *m_screen_data[screen.index()].m_back_painter;
                 dbgln_if(COMPOSE_DEBUG, "  render wallpaper opaque: {} on screen #{}", screen_render_rect, screen.index());
                 prepare_rect(screen, render_rect);
-                paint_wallpaper(screen, back_painter, render_rect, screen_rect);
+                m_screen_data[screen.index()].record(RenderTarget::BackBuffer, [&screen, paint_wallpaper, render_rect, screen_rect](Gfx::Painter& painter) {
+                    paint_wallpaper(screen, painter, render_rect, screen_rect);
+                });
             }
             return IterationDecision::Continue;
         });
@@ -344,41 +373,23 @@ void Compositor::compose()
         dbgln_if(COMPOSE_DEBUG, "  window {} frame rect: {}", window.title(), frame_rect);
 
         RefPtr<Gfx::Bitmap> backing_store = window.backing_store();
-        auto compose_window_rect = [&](Screen& screen, Gfx::Painter& painter, const Gfx::IntRect& rect) {
-            if (!window.is_fullscreen()) {
-                rect.for_each_intersected(frame_rects, [&](const Gfx::IntRect& intersected_rect) {
-                    Gfx::PainterStateSaver saver(painter);
-                    painter.add_clip_rect(intersected_rect);
-                    painter.translate(transition_offset);
-                    dbgln_if(COMPOSE_DEBUG, "    render frame: {}", intersected_rect);
-                    window.frame().paint(screen, painter, intersected_rect.translated(-transition_offset));
-                    return IterationDecision::Continue;
-                });
-            }
-
-            auto clear_window_rect = [&](const Gfx::IntRect& clear_rect) {
-                auto fill_color = wm.palette().window();
-                if (!window.is_opaque())
-                    fill_color.set_alpha(255 * window.opacity());
-                painter.fill_rect(clear_rect, fill_color);
-            };
-
-            if (!backing_store) {
-                clear_window_rect(window_rect.intersected(rect));
-                return;
-            }
 
-            // Decide where we would paint this window's backing store.
-            // This is subtly different from widow.rect(), because window
-            // size may be different from its backing store size. This
-            // happens when the window has been resized and the client
-            // has not yet attached a new backing store. In this case,
-            // we want to try to blit the backing store at the same place
-            // it was previously, and fill the rest of the window with its
-            // background color.
-            Gfx::IntRect backing_rect;
+        auto fill_color = wm.palette().window();
+        if (!window.is_opaque())
+            fill_color.set_alpha(255 * window.opacity());
+
+        // Decide where we would paint this window's backing store.
+        // This is subtly different from widow.rect(), because window
+        // size may be different from its backing store size. This
+        // happens when the window has been resized and the client
+        // has not yet attached a new backing store. In this case,
+        // we want to try to blit the backing store at the same place
+        // it was previously, and fill the rest of the window with its
+        // background color.
+        Gfx::IntRect backing_rect;
+        if (backing_store) {
             backing_rect.set_size(backing_store->size());
-            switch (WindowManager::the().resize_direction_of_window(window)) {
+            switch (wm.resize_direction_of_window(window)) {
             case ResizeDirection::None:
             case ResizeDirection::Right:
             case ResizeDirection::Down:
@@ -400,6 +411,34 @@ void Compositor::compose()
                 backing_rect.set_top(window_rect.top());
                 break;
             }
+        }
+
+        bool is_unresponsive = window.client() && window.client()->is_unresponsive();
+
+        // The frame is rendered into a cache the first time it's needed. That has to happen here rather than
+        // in a recorded command, since two tiles (or screens with the same scale) would otherwise race for it.
+        auto frame_cache_for_screen = [&](Screen& screen) -> WindowFrame::PerScaleRenderedCache* {
+            if (window.is_fullscreen())
+                return nullptr;
+            return window.frame().render_to_cache(screen);
+        };
+
+        auto compose_window_rect = [&window, transition_offset, window_rect, frame_rects, backing_store, backing_rect, fill_color, is_unresponsive](WindowFrame::PerScaleRenderedCache* frame_cache, Gfx::Painter& painter, const Gfx::IntRect& rect) {
+            if (frame_cache) {
+                rect.for_each_intersected(frame_rects, [&](const Gfx::IntRect& intersected_rect) {
+                    Gfx::PainterStateSaver saver(painter);
+                    painter.add_clip_rect(intersected_rect);
+                    painter.translate(transition_offset);
+                    dbgln_if(COMPOSE_DEBUG, "    render frame: {}", intersected_rect);
+                    frame_cache->paint(window.frame(), painter, intersected_rect.translated(-transition_offset));
+                    return IterationDecision::Continue;
+                });
+            }
+
+            if (!backing_store) {
+                painter.fill_rect(window_rect.intersected(rect), fill_color);
+                return;
+            }
 
             Gfx::IntRect dirty_rect_in_backing_coordinates = rect.intersected(window_rect)
                                                                  .intersected(backing_rect)
@@ -408,7 +447,7 @@ void Compositor::compose()
             if (!dirty_rect_in_backing_coordinates.is_empty()) {
                 auto dst = backing_rect.location().translated(dirty_rect_in_backing_coordinates.location());
 
-                if (window.client() && window.client()->is_unresponsive()) {
+                if (is_unresponsive) {
                     if (window.is_opaque()) {
                         painter.blit_filtered(dst, *backing_store, dirty_rect_in_backing_coordinates, [](Color src) {
                             return src.to_grayscale().darkened(0.75f);
@@ -427,7 +466,7 @@ void Compositor::compose()
             }
 
             for (auto background_rect : window_rect.shatter(backing_rect))
-                clear_window_rect(background_rect);
+                painter.fill_rect(background_rect, fill_color);
         };
 
         auto& dirty_rects = window.dirty_rects();
@@ -452,10 +491,10 @@ void Compositor::compose()
                     dbgln_if(COMPOSE_DEBUG, "    render opaque: {} on screen #{}", screen_render_rect, screen->index());
 
                     prepare_rect(*screen, screen_render_rect);
-                    auto& back_painter = *m_screen_data[screen->index()].m_back_painter;
-                    Gfx::PainterStateSaver saver(back_painter);
-                    back_painter.add_clip_rect(screen_render_rect);
-                    compose_window_rect(*screen, back_painter, screen_render_rect);
+                    m_screen_data[screen->index()].record(RenderTarget::BackBuffer, [compose_window_rect, frame_cache = frame_cache_for_screen(*screen), screen_render_rect](Gfx::Painter& painter) {
+                        painter.add_clip_rect(screen_render_rect);
+                        compose_window_rect(frame_cache, painter, screen_render_rect);
+                    });
                 }
                 return IterationDecision::Continue;
             });
@@ -473,9 +512,10 @@ void Compositor::compose()
                         continue;
                     dbgln_if(COMPOSE_DEBUG, "    render wallpaper: {} on screen #{}", screen_render_rect, screen->index());
 
-                    auto& temp_painter = *m_screen_data[screen->index()].m_temp_painter;
                     prepare_transparency_rect(*screen, screen_render_rect);
-                    paint_wallpaper(*screen, temp_painter, screen_render_rect, screen_rect);
+                    m_screen_data[screen->index()].record(RenderTarget::TemporaryBuffer, [screen, paint_wallpaper, screen_render_rect, screen_rect](Gfx::Painter& painter) {
+                        paint_wallpaper(*screen, painter, screen_render_rect, screen_rect);
+                    });
                 }
                 return IterationDecision::Continue;
             });
@@ -491,10 +531,10 @@ void Compositor::compose()
                     dbgln_if(COMPOSE_DEBUG, "    render transparent: {} on screen #{}", screen_render_rect, screen->index());
 
                     prepare_transparency_rect(*screen, screen_render_rect);
-                    auto& temp_painter = *m_screen_data[screen->index()].m_temp_painter;
-                    Gfx::PainterStateSaver saver(temp_painter);
-                    temp_painter.add_clip_rect(screen_render_rect);
-                    compose_window_rect(*screen, temp_painter, screen_render_rect);
+                    m_screen_data[screen->index()].record(RenderTarget::TemporaryBuffer, [compose_window_rect, frame_cache = frame_cache_for_screen(*screen), screen_render_rect](Gfx::Painter& painter) {
+                        painter.add_clip_rect(screen_render_rect);
+                        compose_window_rect(frame_cache, painter, screen_render_rect);
+                    });
                 }
                 return IterationDecision::Continue;
             });
@@ -535,7 +575,13 @@ void Compositor::compose()
             });
             return is_overlapping;
         }());
+    }
 
+    auto prepare_end_time = monotonic_time();
+    auto tile_count = render_recorded_commands();
+    auto render_end_time = monotonic_time();
+
+    if (m_invalidated_window) {
         if (!m_overlay_list.is_empty()) {
             // Render everything to the temporary buffer before we copy it back
             render_overlays();
@@ -551,6 +597,8 @@ void Compositor::compose()
         });
     }
 
+    auto overlays_end_time = monotonic_time();
+
     m_invalidated_any = false;
     m_invalidated_window = false;
     m_invalidated_cursor = false;
@@ -577,6 +625,78 @@ void Compositor::compose()
         flush(screen);
         return IterationDecision::Continue;
     });
+
+    ++m_frame_count;
+    if constexpr (COMPOSE_TIMING_DEBUG) {
+        auto end_time = monotonic_time();
+        dbgln("Compositor: frame {} took {}us: prepare {}us, render {}us ({} tiles on {} threads), overlays {}us, flush {}us",
+            m_frame_count,
+            (end_time - start_time).to_microseconds(),
+            (prepare_end_time - start_time).to_microseconds(),
+            (render_end_time - prepare_end_time).to_microseconds(),
+            tile_count,
+            m_worker_pool->worker_count() + 1,
+            (overlays_end_time - render_end_time).to_microseconds(),
+            (end_time - overlays_end_time).to_microseconds());
+    }
+}
+
+size_t Compositor::render_recorded_commands()
+{
+    // Split the area that is being repainted on each screen into horizontal bands, and let each band replay all
+    // of the screen's commands with painters clipped to it. The bands don't overlap, so they can be painted at
+    // the same time without any locking, and within a band everything is still painted in the recorded order.
+    Vector<Function<void()>> jobs;
+    Screen::for_each([&](auto& screen) {
+        auto& screen_data = m_screen_data[screen.index()];
+        if (screen_data.m_render_commands.is_empty())
+            return IterationDecision::Continue;
+
+        // Every recorded command only paints within a rect that was added to one of these.
+        Gfx::IntRect render_rect;
+        for (auto* flush_rects : { &screen_data.m_flush_rects, &screen_data.m_flush_transparent_rects, &screen_data.m_flush_special_rects }) {
+            for (auto& rect : flush_rects->rects())
+                render_rect = render_rect.united(rect);
+        }
+        auto screen_rect = screen.rect();
+        render_rect.intersect(screen_rect);
+        if (render_rect.is_empty())
+            return IterationDecision::Continue;
+
+        // Small updates, like the cursor moving around, aren't worth waking anybody up for.
+        size_t band_count = 1;
+        if (render_rect.width() * render_rect.height() >= minimum_area_for_tiling)
+            band_count = clamp<size_t>(render_rect.height() / minimum_tile_height, 1, m_worker_pool->worker_count() + 1);
+
+        int band_top = render_rect.top();
+        for (size_t i = 0; i < band_count; ++i) {
+            int band_bottom = render_rect.top() + (int)(render_rect.height() * (i + 1) / band_count);
+            Gfx::IntRect tile_rect { render_rect.x(), band_top, render_rect.width(), band_bottom - band_top };
+            band_top = band_bottom;
+
+            jobs.append([&screen_data, screen_rect, tile_rect] {
+                dbgln_if(COMPOSE_DEBUG, "  render tile: {}", tile_rect);
+                Gfx::Painter back_painter(*screen_data.m_back_bitmap);
+                Gfx::Painter temp_painter(*screen_data.m_temp_bitmap);
+                for (auto* painter : { &back_painter, &temp_painter }) {
+                    painter->translate(-screen_rect.location());
+                    painter->add_clip_rect(tile_rect);
+                }
+                for (auto& command : screen_data.m_render_commands) {
+                    auto& painter = command.target == RenderTarget::BackBuffer ? back_painter : temp_painter;
+                    Gfx::PainterStateSaver saver(painter);
+                    command.paint(painter);
+                }
+            });
+        }
+        return IterationDecision::Continue;
+    });
+
+    m_worker_pool->run(jobs);
+
+    for (auto& screen_data : m_screen_data)
+        screen_data.m_render_commands.clear_with_capacity();
+    return jobs.size();
 }
 
 void Compositor::flush(Screen& screen)
@@ -917,7 +1037,9 @@ bool Compositor::ScreenData::restore_cursor_back(Screen& screen, Gfx::IntRect& l
         return false;
 
     last_cursor_rect = m_last_cursor_rect.intersected(screen.rect());
-    m_back_painter->blit(last_cursor_rect.location(), *m_cursor_back_bitmap, { { 0, 0 }, last_cursor_rect.size() });
+    record(RenderTarget::BackBuffer, [cursor_back_bitmap = m_cursor_back_bitmap, last_cursor_rect](Gfx::Painter& painter) {
+        painter.blit(last_cursor_rect.location(), *cursor_back_bitmap, { { 0, 0 }, last_cursor_rect.size() });
+    });
     m_flush_special_rects.add(last_cursor_rect.intersected(screen.rect()));
     m_have_flush_rects = true;
     m_cursor_back_is_valid = false;
@@ -6,12 +6,14 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <LibCore/Object.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/DisjointRectSet.h>
 #include <LibGfx/Font.h>
+#include <WindowServer/ComposeWorkerPool.h>
 #include <WindowServer/Overlays.h>
 
 namespace WindowServer {
@@ -141,6 +143,7 @@ private:
     void recompute_occlusions();
     void change_cursor(const Cursor*);
     void flush(Screen&);
+    size_t render_recorded_commands();
     Gfx::IntPoint window_transition_offset(Window&);
     void update_animations(Screen&, Gfx::DisjointRectSet& flush_rects);
     void create_window_stack_switch_overlay(WindowStack&);
@@ -158,6 +161,17 @@ private:
     bool m_invalidated_cursor { false };
     bool m_overlay_rects_changed { false };
 
+    // compose() first works out what needs to be painted where on the main thread, recording it as a list
+    // of commands for each screen, and then replays those commands tile by tile on the worker pool.
+    enum class RenderTarget {
+        BackBuffer,
+        TemporaryBuffer,
+    };
+    struct RenderCommand {
+        RenderTarget target;
+        Function<void(Gfx::Painter&)> paint;
+    };
+
     struct ScreenData {
         RefPtr<Gfx::Bitmap> m_front_bitmap;
         RefPtr<Gfx::Bitmap> m_back_bitmap;
@@ -180,6 +194,13 @@ private:
         Gfx::DisjointRectSet m_flush_transparent_rects;
         Gfx::DisjointRectSet m_flush_special_rects;
 
+        Vector<RenderCommand> m_render_commands;
+
+        void record(RenderTarget target, Function<void(Gfx::Painter&)> paint)
+        {
+            m_render_commands.append({ target, move(paint) });
+        }
+
         Gfx::Painter& overlay_painter() { return *m_temp_painter; }
 
         void init_bitmaps(Compositor&, Screen&);
@@ -239,6 +260,9 @@ private:
     Optional<Gfx::Color> m_custom_background_color;
 
     HashTable<Animation*> m_animations;
+
+    OwnPtr<ComposeWorkerPool> m_worker_pool;
+    u64 m_frame_count { 0 };
 };
 
 }
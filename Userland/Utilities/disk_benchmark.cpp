@@ -12,8 +12,10 @@
 #include <LibCore/ElapsedTimer.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -39,11 +41,11 @@ static Result average_result(const Vector<Result>& results)
 
 static void exit_with_usage(int rc)
 {
-    warnln("Usage: disk_benchmark [-h] [-d directory] [-t time_per_benchmark] [-f file_size1,file_size2,...] [-b block_size1,block_size2,...]");
+    warnln("Usage: disk_benchmark [-h] [-d directory] [-t time_per_benchmark] [-f file_size1,file_size2,...] [-b block_size1,block_size2,...] [-q queue_depth1,queue_depth2,...]");
     exit(rc);
 }
 
-static Optional<Result> benchmark(const String& filename, int file_size, int block_size, ByteBuffer& buffer, bool allow_cache);
+static Optional<Result> benchmark(const String& filename, int file_size, int block_size, ByteBuffer& buffer, bool allow_cache, int queue_depth);
 
 int main(int argc, char** argv)
 {
@@ -51,10 +53,11 @@ int main(int argc, char** argv)
     int time_per_benchmark = 10;
     Vector<size_t> file_sizes;
     Vector<size_t> block_sizes;
+    Vector<size_t> queue_depths;
     bool allow_cache = false;
 
     int opt;
-    while ((opt = getopt(argc, argv, "chd:t:f:b:")) != -1) {
+    while ((opt = getopt(argc, argv, "chd:t:f:b:q:")) != -1) {
         switch (opt) {
         case 'h':
             exit_with_usage(0);
@@ -76,6 +79,14 @@ int main(int argc, char** argv)
             for (const auto& size : String(optarg).split(','))
                 block_sizes.append(atoi(size.characters()));
             break;
+        case 'q':
+            for (const auto& depth : String(optarg).split(',')) {
+                auto queue_depth = atoi(depth.characters());
+                if (queue_depth < 1)
+                    exit_with_usage(1);
+                queue_depths.append(queue_depth);
+            }
+            break;
         }
     }
 
@@ -85,6 +96,9 @@ int main(int argc, char** argv)
     if (block_sizes.size() == 0) {
         block_sizes = { 8192, 32768, 65536 };
     }
+    if (queue_depths.size() == 0) {
+        queue_depths = { 1 };
+    }
 
     umask(0644);
 
@@ -95,37 +109,129 @@ int main(int argc, char** argv)
             if (block_size > file_size)
                 continue;
 
-            auto buffer = ByteBuffer::create_uninitialized(block_size);
-            Vector<Result> results;
-
-            outln("Running: file_size={} block_size={}", file_size, block_size);
-            Core::ElapsedTimer timer;
-            timer.start();
-            while (timer.elapsed() < time_per_benchmark * 1000) {
-                out(".");
-                fflush(stdout);
-                auto result = benchmark(filename, file_size, block_size, buffer, allow_cache);
-                if (!result.has_value())
-                    return 1;
-                results.append(result.release_value());
-                usleep(100);
-            }
-            auto average = average_result(results);
-            outln("Finished: runs={} time={}ms write_bps={} read_bps={}", results.size(), timer.elapsed(), average.write_bps, average.read_bps);
+            for (auto queue_depth : queue_depths) {
+                auto buffer = ByteBuffer::create_uninitialized(block_size);
+                Vector<Result> results;
+
+                outln("Running: file_size={} block_size={} queue_depth={}", file_size, block_size, queue_depth);
+                Core::ElapsedTimer timer;
+                timer.start();
+                while (timer.elapsed() < time_per_benchmark * 1000) {
+                    out(".");
+                    fflush(stdout);
+                    auto result = benchmark(filename, file_size, block_size, buffer, allow_cache, queue_depth);
+                    if (!result.has_value())
+                        return 1;
+                    results.append(result.release_value());
+                    usleep(100);
+                }
+                auto average = average_result(results);
+                outln("Finished: runs={} time={}ms write_bps={} read_bps={}", results.size(), timer.elapsed(), average.write_bps, average.read_bps);
 
-            sleep(1);
+                sleep(1);
+            }
         }
     }
 
     return 0;
 }
 
-Optional<Result> benchmark(const String& filename, int file_size, int block_size, ByteBuffer& buffer, bool allow_cache)
+enum class Direction {
+    Read,
+    Write,
+};
+
+struct TransferThread {
+    pthread_t thread {};
+    String filename;
+    int flags { 0 };
+    Direction direction { Direction::Read };
+    int size { 0 };
+    int block_size { 0 };
+    bool success { false };
+};
+
+static void* transfer_thread_entry(void* argument)
+{
+    auto& transfer = *static_cast<TransferThread*>(argument);
+    int fd = open(transfer.filename.characters(), transfer.flags, 0644);
+    if (fd < 0) {
+        perror("open");
+        return nullptr;
+    }
+    ScopeGuard fd_cleanup = [fd] { close(fd); };
+
+    auto buffer = ByteBuffer::create_uninitialized(transfer.block_size);
+    for (int offset = 0; offset < transfer.size; offset += transfer.block_size) {
+        auto ntransferred = transfer.direction == Direction::Write ? write(fd, buffer.data(), transfer.block_size) : read(fd, buffer.data(), transfer.block_size);
+        if (ntransferred < 0) {
+            perror(transfer.direction == Direction::Write ? "write" : "read");
+            return nullptr;
+        }
+    }
+    transfer.success = true;
+    return nullptr;
+}
+
+// Keeps queue_depth transfers in flight by running that many threads at once, each with a share of the blocks.
+// Every thread has a file of its own so that they don't end up waiting on each other for the same inode; what's
+// left for them to share is the file system and the device underneath it, which is what we want to measure.
+static bool transfer_concurrently(const Vector<String>& filenames, int flags, Direction direction, int file_size, int block_size)
+{
+    int queue_depth = filenames.size();
+    int blocks = (file_size + block_size - 1) / block_size;
+    Vector<TransferThread> transfers;
+    transfers.resize(queue_depth);
+    for (int index = 0; index < queue_depth; ++index) {
+        auto& transfer = transfers[index];
+        int blocks_for_thread = blocks / queue_depth + (index < blocks % queue_depth ? 1 : 0);
+        transfer = { {}, filenames[index], flags, direction, blocks_for_thread * block_size, block_size, false };
+        if (int rc = pthread_create(&transfer.thread, nullptr, transfer_thread_entry, &transfer); rc != 0) {
+            warnln("pthread_create: {}", strerror(rc));
+            exit(1);
+        }
+    }
+
+    bool success = true;
+    for (auto& transfer : transfers) {
+        pthread_join(transfer.thread, nullptr);
+        success &= transfer.success;
+    }
+    return success;
+}
+
+Optional<Result> benchmark(const String& filename, int file_size, int block_size, ByteBuffer& buffer, bool allow_cache, int queue_depth)
 {
     int flags = O_CREAT | O_TRUNC | O_RDWR;
     if (!allow_cache)
         flags |= O_DIRECT;
 
+    if (queue_depth > 1) {
+        Vector<String> filenames;
+        for (int index = 0; index < queue_depth; ++index)
+            filenames.append(String::formatted("{}.{}", filename, index));
+        auto files_cleanup = ScopeGuard([&filenames] {
+            for (auto& filename : filenames) {
+                if (unlink(filename.characters()) < 0)
+                    perror("unlink");
+            }
+        });
+
+        Result result;
+        Core::ElapsedTimer timer;
+
+        timer.start();
+        if (!transfer_concurrently(filenames, flags, Direction::Write, file_size, block_size))
+            return {};
+        result.write_bps = (u64)(timer.elapsed() ? (file_size / timer.elapsed()) : file_size) * 1000;
+
+        timer.start();
+        if (!transfer_concurrently(filenames, flags & ~(O_CREAT | O_TRUNC), Direction::Read, file_size, block_size))
+            return {};
+        result.read_bps = (u64)(timer.elapsed() ? (file_size / timer.elapsed()) : file_size) * 1000;
+        return result;
+    }
+
     int fd = open(filename.characters(), flags, 0644);
     if (fd == -1) {
         perror("open");
@@ -142,6 +248,7 @@ Optional<Result> benchmark(const String& filename, int file_size, int block_size
     Result result;
 
     Core::ElapsedTimer timer;
+
     timer.start();
 
     ssize_t total_written = 0;
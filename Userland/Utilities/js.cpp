@@ -588,6 +588,8 @@ static bool parse_and_run(JS::Interpreter& interpreter, StringView const& source
             if (s_run_bytecode) {
                 JS::Bytecode::Interpreter bytecode_interpreter(interpreter.global_object());
                 bytecode_interpreter.run(unit);
+                if (s_dump_bytecode)
+                    bytecode_interpreter.property_lookup_cache_statistics().dump();
             } else {
                 return true;
             }
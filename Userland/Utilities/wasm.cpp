@@ -86,7 +86,7 @@ static bool pre_interpret_hook(Wasm::Configuration& config, Wasm::InstructionPoi
             warnln("- [h]elp                     Print this help");
             warnln();
             warnln("Print:");
-            warnln("- print [s]tack              Print the contents of the stack, including frames and labels");
+            warnln("- print [s]tack              Print the contents of the stack, including frames");
             warnln("- print [[m]em]ory <index>   Print the contents of the memory identified by <index>");
             warnln("- print [[i]nstr]uction      Print the current instruction");
             warnln("- print [[f]unc]tion <index> Print the function identified by <index>");
@@ -435,7 +435,7 @@ int main(int argc, char* argv[])
                 *module_instance,
                 Vector<Wasm::Value> {},
                 expression,
-                0,
+                {},
             });
             Wasm::Instruction instr { Wasm::Instructions::nop };
             Wasm::InstructionPointer ip { 0 };